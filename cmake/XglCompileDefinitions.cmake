@@ -39,6 +39,11 @@ macro(xgl_set_compile_definitions)
         target_compile_definitions(xgl PRIVATE ICD_MEMTRACK)
     endif()
 
+    # Turn on the swap chain acquire and present timing instrumentation if enabled.
+    if(ICD_PRESENT_TIMING)
+        target_compile_definitions(xgl PRIVATE ICD_PRESENT_TIMING=1)
+    endif()
+
     # Enable relevant GPUOpen preprocessor definitions
     if(ICD_GPUOPEN_DEVMODE_BUILD)
         target_compile_definitions(xgl PRIVATE ICD_GPUOPEN_DEVMODE_BUILD)
@@ -74,6 +74,8 @@ macro(xgl_options)
 
     option(ICD_MEMTRACK "Turn on memory tracking?" ${CMAKE_BUILD_TYPE_DEBUG})
 
+    option(ICD_PRESENT_TIMING "Record acquire and present timings of swap chains?" OFF)
+
     if (NOT WIN32)
         option(BUILD_WAYLAND_SUPPORT "Build XGL with Wayland support" ON)
 
@@ -76,6 +76,19 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyShaderModule(
     }
 }
 
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkGetShaderModuleIdentifierEXT(
+    VkDevice                                    device,
+    VkShaderModule                              shaderModule,
+    VkShaderModuleIdentifierEXT*                pIdentifier)
+{
+    Device* pDevice = ApiDevice::ObjectFromHandle(device);
+    AsyncLayer* pAsyncLayer = pDevice->GetAsyncLayer();
+    vk::async::ShaderModule* pModule = vk::async::ShaderModule::ObjectFromHandle(shaderModule);
+
+    ASYNC_CALL_NEXT_LAYER(vkGetShaderModuleIdentifierEXT)(device, pModule->GetNextLayerModule(), pIdentifier);
+}
+
 // =====================================================================================================================
 VKAPI_ATTR VkResult VKAPI_CALL vkCreateGraphicsPipelines(
     VkDevice                            device,
@@ -97,8 +110,13 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateGraphicsPipelines(
         for (uint32_t stage = 0; stage < createInfo.stageCount; ++stage)
         {
             stages[stage] = createInfo.pStages[stage];
-            vk::async::ShaderModule* pModule = vk::async::ShaderModule::ObjectFromHandle(stages[stage].module);
-            stages[stage].module = pModule->GetNextLayerModule();
+
+            // Stages given by a shader module identifier have no module
+            if (stages[stage].module != VK_NULL_HANDLE)
+            {
+                vk::async::ShaderModule* pModule = vk::async::ShaderModule::ObjectFromHandle(stages[stage].module);
+                stages[stage].module = pModule->GetNextLayerModule();
+            }
         }
         createInfo.pStages = stages;
         result = ASYNC_CALL_NEXT_LAYER(vkCreateGraphicsPipelines)(device,
@@ -128,9 +146,11 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateComputePipelines(
     for (uint32_t i = 0; (i < createInfoCount) && (result == VK_SUCCESS); ++i)
     {
         VkComputePipelineCreateInfo createInfo = pCreateInfos[i];
-        VK_ASSERT(createInfo.stage.module != VK_NULL_HANDLE);
-        vk::async::ShaderModule* pModule = vk::async::ShaderModule::ObjectFromHandle(createInfo.stage.module);
-        createInfo.stage.module = pModule->GetNextLayerModule();
+        if (createInfo.stage.module != VK_NULL_HANDLE)
+        {
+            vk::async::ShaderModule* pModule = vk::async::ShaderModule::ObjectFromHandle(createInfo.stage.module);
+            createInfo.stage.module = pModule->GetNextLayerModule();
+        }
         result = ASYNC_CALL_NEXT_LAYER(vkCreateComputePipelines)(device,
                                                                  pipelineCache,
                                                                  1,
@@ -209,6 +229,7 @@ void AsyncLayer::OverrideDispatchTable(
 
     ASYNC_OVERRIDE_ENTRY(vkCreateShaderModule);
     ASYNC_OVERRIDE_ENTRY(vkDestroyShaderModule);
+    ASYNC_OVERRIDE_ENTRY(vkGetShaderModuleIdentifierEXT);
     ASYNC_OVERRIDE_ENTRY(vkCreateGraphicsPipelines);
     ASYNC_OVERRIDE_ENTRY(vkCreateComputePipelines);
 }
@@ -1798,6 +1798,14 @@ void DevModeMgr::DestroyRGPTracing(TraceState* pState)
         m_pInstance->FreeMem(pState->pCmdAllocator);
     }
 
+    for (uint32_t queue = 0; queue < pState->queueCount; ++queue)
+    {
+        if (pState->queueState[queue].pApiCmdBufIds != nullptr)
+        {
+            m_pInstance->FreeMem(pState->queueState[queue].pApiCmdBufIds);
+        }
+    }
+
     pState->queueCount       = 0;
     pState->queueFamilyCount = 0;
 
@@ -1869,6 +1877,9 @@ Pal::Result DevModeMgr::InitTraceQueueResources(
         pQueueState->pQueue = pQueue;
         pQueueState->pFamily = pFamilyState;
         pQueueState->timingSupported = false;
+        pQueueState->pApiCmdBufIds = nullptr;
+        pQueueState->pSqttCmdBufIds = nullptr;
+        pQueueState->cmdBufIdCapacity = 0;
         pQueueState->queueId = reinterpret_cast<Pal::uint64>(ApiQueue::FromObject(pQueue));
 
         // Get the OS context handle for this queue (this is a thing that RGP needs on DX clients;
@@ -1905,6 +1916,11 @@ Pal::Result DevModeMgr::InitTraceQueueResources(
                 pQueueState->queueContext) == Pal::Result::Success)
             {
                 pQueueState->timingSupported = true;
+
+                if (auxQueue == false)
+                {
+                    pState->pTimedQueues[pQueue->GetFamilyIndex()][pQueue->GetIndex()] = pQueueState;
+                }
             }
         }
     }
@@ -2369,29 +2385,26 @@ void DevModeMgr::PreDeviceDestroy(Device* pDevice)
 }
 
 // =====================================================================================================================
-bool DevModeMgr::QueueSupportsTiming(
+// Returns the trace state of the given queue if it was successfully registered for timed operations, or nullptr if
+// operations on the queue can't be timed.  Only queues of the tracing device are ever registered.
+DevModeMgr::TraceQueueState* DevModeMgr::FindTimedQueueState(
     uint32_t     deviceIdx,
     const Queue* pQueue)
 {
     VK_ASSERT(IsQueueTimingActive(pQueue->VkDevice()));
     VK_ASSERT(deviceIdx == DefaultDeviceIndex); // MGPU tracing is not supported
 
-    bool timingSupported = (deviceIdx == DefaultDeviceIndex) &&
-                           (pQueue->VkDevice()->VkPhysicalDevice(DefaultDeviceIndex) ==
-                               m_trace.pDevice->VkPhysicalDevice(DefaultDeviceIndex));
+    TraceQueueState* pTraceQueue = nullptr;
 
-    // Make sure this queue was successfully registered
-    if (timingSupported)
+    if ((deviceIdx == DefaultDeviceIndex) && (pQueue->VkDevice() == m_trace.pDevice))
     {
-        const TraceQueueState* pTraceQueueState = FindTraceQueueState(&m_trace, pQueue);
+        VK_ASSERT(pQueue->GetFamilyIndex() < MaxTraceQueueFamilies);
+        VK_ASSERT(pQueue->GetIndex() < Queue::MaxQueuesPerFamily);
 
-        if (pTraceQueueState == nullptr || pTraceQueueState->timingSupported == false)
-        {
-            timingSupported = false;
-        }
+        pTraceQueue = m_trace.pTimedQueues[pQueue->GetFamilyIndex()][pQueue->GetIndex()];
     }
 
-    return timingSupported;
+    return pTraceQueue;
 }
 
 // =====================================================================================================================
@@ -2470,82 +2483,93 @@ bool DevModeMgr::IsTracingEnabled() const
 }
 
 // =====================================================================================================================
-Pal::Result DevModeMgr::TimedQueueSubmit(
-    uint32_t                     deviceIdx,
-    Queue*                       pQueue,
-    uint32_t                     cmdBufferCount,
-    const VkCommandBuffer*       pCommandBuffers,
-    const Pal::SubmitInfo&       submitInfo,
-    VirtualStackFrame*           pVirtStackFrame)
+// Returns the array the SQTT command buffer IDs of a timed submit of the given number of command buffers on the queue
+// are gathered in, or nullptr if the submit can't be timed.  The array of API command buffer IDs is returned through
+// ppApiCmdBufIds.  Both arrays belong to the queue's trace state and are only reallocated when a submit has more
+// command buffers than any before it.
+Pal::uint32* DevModeMgr::GetTimedSubmitCmdBufIds(
+    uint32_t      deviceIdx,
+    const Queue*  pQueue,
+    uint32_t      cmdBufferCount,
+    Pal::uint64** ppApiCmdBufIds)
 {
-    VK_ASSERT(cmdBufferCount == submitInfo.pPerSubQueueInfo[0].cmdBufferCount);
+    TraceQueueState* pTraceQueue    = FindTimedQueueState(deviceIdx, pQueue);
+    Pal::uint32*     pSqttCmdBufIds = nullptr;
 
-    bool timingSupported = QueueSupportsTiming(deviceIdx, pQueue) && (submitInfo.pPerSubQueueInfo[0].cmdBufferCount > 0);
+    *ppApiCmdBufIds = nullptr;
 
-    // Fill in extra meta-data information to associate the API command buffer data with the generated
-    // timing information.
-    GpuUtil::TimedSubmitInfo timedSubmitInfo = {};
-    Pal::uint64* pApiCmdBufIds  = nullptr;
-    Pal::uint32* pSqttCmdBufIds = nullptr;
-
-    if (timingSupported)
+    if ((pTraceQueue != nullptr) && (cmdBufferCount > 0))
     {
-        pApiCmdBufIds  = pVirtStackFrame->AllocArray<Pal::uint64>(cmdBufferCount);
-        pSqttCmdBufIds = pVirtStackFrame->AllocArray<Pal::uint32>(cmdBufferCount);
-
-        timedSubmitInfo.pApiCmdBufIds  = pApiCmdBufIds;
-        timedSubmitInfo.pSqttCmdBufIds = pSqttCmdBufIds;
-        timedSubmitInfo.frameIndex     = m_globalFrameIndex;
+        if (cmdBufferCount > pTraceQueue->cmdBufIdCapacity)
+        {
+            const uint32_t capacity = Util::Pow2Pad(cmdBufferCount);
 
-        timingSupported &= (pApiCmdBufIds != nullptr) && (pSqttCmdBufIds != nullptr);
-    }
+            if (pTraceQueue->pApiCmdBufIds != nullptr)
+            {
+                m_pInstance->FreeMem(pTraceQueue->pApiCmdBufIds);
+            }
 
-    Pal::Result result = Pal::Result::NotReady;
+            // The API IDs come first to keep them 64-bit aligned
+            pTraceQueue->pApiCmdBufIds = static_cast<Pal::uint64*>(
+                m_pInstance->AllocMem(capacity * (sizeof(Pal::uint64) + sizeof(Pal::uint32)),
+                                      VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE));
 
-    Pal::IQueue* pPalQueue = pQueue->PalQueue(deviceIdx);
+            if (pTraceQueue->pApiCmdBufIds != nullptr)
+            {
+                pTraceQueue->pSqttCmdBufIds   = reinterpret_cast<Pal::uint32*>(pTraceQueue->pApiCmdBufIds + capacity);
+                pTraceQueue->cmdBufIdCapacity = capacity;
+            }
+            else
+            {
+                pTraceQueue->pSqttCmdBufIds   = nullptr;
+                pTraceQueue->cmdBufIdCapacity = 0;
+            }
+        }
 
-    if (timingSupported)
-    {
-        for (uint32_t cbIdx = 0; cbIdx < cmdBufferCount; ++cbIdx)
+        if (pTraceQueue->pApiCmdBufIds != nullptr)
         {
-            uintptr_t intHandle = reinterpret_cast<uintptr_t>(pCommandBuffers[cbIdx]);
+            *ppApiCmdBufIds = pTraceQueue->pApiCmdBufIds;
+            pSqttCmdBufIds  = pTraceQueue->pSqttCmdBufIds;
+        }
+    }
 
-            pApiCmdBufIds[cbIdx] = intHandle;
+    return pSqttCmdBufIds;
+}
 
-            CmdBuffer* pCmdBuf = ApiCmdBuffer::ObjectFromHandle(pCommandBuffers[cbIdx]);
+// =====================================================================================================================
+// Does a timed submit of command buffers on a queue GetTimedSubmitCmdBufIds() returned ID arrays for.  The caller fills
+// both arrays in submission order: the API IDs with the command buffer handles and the SQTT IDs with the IDs the
+// command buffers cached at End() time.
+Pal::Result DevModeMgr::TimedQueueSubmit(
+    uint32_t                     deviceIdx,
+    Queue*                       pQueue,
+    const Pal::uint64*           pApiCmdBufIds,
+    const Pal::uint32*           pSqttCmdBufIds,
+    const Pal::SubmitInfo&       submitInfo)
+{
+    VK_ASSERT((pApiCmdBufIds != nullptr) && (pSqttCmdBufIds != nullptr));
 
-            pSqttCmdBufIds[cbIdx] = 0;
+    // Fill in extra meta-data information to associate the API command buffer data with the generated
+    // timing information.
+    GpuUtil::TimedSubmitInfo timedSubmitInfo = {};
 
-            if (pCmdBuf->GetSqttState() != nullptr)
-            {
-                pSqttCmdBufIds[cbIdx] = pCmdBuf->GetSqttState()->GetId().u32All;
-            }
+    timedSubmitInfo.pApiCmdBufIds  = pApiCmdBufIds;
+    timedSubmitInfo.pSqttCmdBufIds = pSqttCmdBufIds;
+    timedSubmitInfo.frameIndex     = m_globalFrameIndex;
 
-            VK_ASSERT(pCmdBuf->PalCmdBuffer(DefaultDeviceIndex) == submitInfo.pPerSubQueueInfo[0].ppCmdBuffers[cbIdx]);
-        }
+    Pal::IQueue* pPalQueue = pQueue->PalQueue(deviceIdx);
 
-        // Do a timed submit of all the command buffers
-        result = m_trace.pGpaSession->TimedSubmit(pPalQueue, submitInfo, timedSubmitInfo);
+    // Do a timed submit of all the command buffers
+    Pal::Result result = m_trace.pGpaSession->TimedSubmit(pPalQueue, submitInfo, timedSubmitInfo);
 
-        VK_ASSERT(result == Pal::Result::Success);
-    }
+    VK_ASSERT(result == Pal::Result::Success);
 
-    // Punt to non-timed submit if a timed submit fails (or is not supported)
+    // Punt to non-timed submit if a timed submit fails
     if (result != Pal::Result::Success)
     {
         result = pPalQueue->Submit(submitInfo);
     }
 
-    if (pApiCmdBufIds != nullptr)
-    {
-        pVirtStackFrame->FreeArray(pApiCmdBufIds);
-    }
-
-    if (pSqttCmdBufIds != nullptr)
-    {
-        pVirtStackFrame->FreeArray(pSqttCmdBufIds);
-    }
-
     return result;
 }
 
@@ -157,13 +157,18 @@ public:
 
     bool IsTracingEnabled() const;
 
+    Pal::uint32* GetTimedSubmitCmdBufIds(
+        uint32_t               deviceIdx,
+        const Queue*           pQueue,
+        uint32_t               cmdBufferCount,
+        Pal::uint64**          ppApiCmdBufIds);
+
     Pal::Result TimedQueueSubmit(
         uint32_t               deviceIdx,
         Queue*                 pQueue,
-        uint32_t               cmdBufferCount,
-        const VkCommandBuffer* pCommandBuffers,
-        const Pal::SubmitInfo& submitInfo,
-        VirtualStackFrame*     pVirtStackFrame);
+        const Pal::uint64*     pApiCmdBufIds,
+        const Pal::uint32*     pSqttCmdBufIds,
+        const Pal::SubmitInfo& submitInfo);
 
     Pal::Result TimedSignalQueueSemaphore(
         uint32_t                       deviceIdx,
@@ -245,6 +250,10 @@ private:
         Pal::uint64            queueId;
         Pal::uint64            queueContext;
         bool                   timingSupported;
+        Pal::uint64*           pApiCmdBufIds;        // Scratch array of API command buffer IDs of timed submits, which
+                                                     // also holds pSqttCmdBufIds
+        Pal::uint32*           pSqttCmdBufIds;       // Scratch array of SQTT command buffer IDs of timed submits
+        uint32_t               cmdBufIdCapacity;     // Number of entries of pApiCmdBufIds and pSqttCmdBufIds
     };
 
     static constexpr uint32_t MaxTraceQueueFamilies = Queue::MaxQueueFamilies;
@@ -280,6 +289,9 @@ private:
         uint32_t              queueFamilyCount;
         TraceQueueFamilyState queueFamilyState[MaxTraceQueueFamilies];
 
+        // Queues of the tracing device that support timed operations, indexed by queue family and queue index
+        TraceQueueState*      pTimedQueues[MaxTraceQueueFamilies][Queue::MaxQueuesPerFamily];
+
         uint32_t              activeCmdBufCount;   // Number of command buffers in below list
         Pal::ICmdBuffer*      pActiveCmdBufs[4];   // List of command buffers that need to be reset at end of trace
         uint32_t              preparedFrameCount;  // Number of frames counted while preparing for a trace
@@ -310,7 +322,9 @@ private:
     Pal::Result InitTraceQueueFamilyResources(TraceState* pTraceState, TraceQueueFamilyState* pFamilyState);
     void DestroyTraceQueueFamilyResources(TraceQueueFamilyState* pState);
     TraceQueueState* FindTraceQueueState(TraceState* pState, const Queue* pQueue);
-    bool QueueSupportsTiming(uint32_t deviceIdx, const Queue* pQueue);
+    TraceQueueState* FindTimedQueueState(uint32_t deviceIdx, const Queue* pQueue);
+    VK_INLINE bool QueueSupportsTiming(uint32_t deviceIdx, const Queue* pQueue)
+        { return (FindTimedQueueState(deviceIdx, pQueue) != nullptr); }
 
 #if VKI_GPUOPEN_PROTOCOL_ETW_CLIENT
     Pal::Result InitEtwClient();
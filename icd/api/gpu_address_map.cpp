@@ -0,0 +1,447 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2021 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ ***********************************************************************************************************************
+ * @file  gpu_address_map.cpp
+ * @brief Contains the implementation of the GPU virtual address to object map.
+ ***********************************************************************************************************************
+ */
+
+#include "include/gpu_address_map.h"
+#include "include/vk_instance.h"
+#include "include/vk_memory.h"
+
+namespace vk
+{
+
+// =====================================================================================================================
+GpuAddressMap::GpuAddressMap(
+    Instance* pInstance)
+    :
+    m_pInstance(pInstance)
+{
+    for (uint32_t deviceIdx = 0; deviceIdx < MaxPalDevices; deviceIdx++)
+    {
+        for (uint32_t typeIdx = 0; typeIdx < static_cast<uint32_t>(ObjectType::Count); typeIdx++)
+        {
+            Tree* pTree = &m_trees[deviceIdx][typeIdx];
+
+            pTree->pRoot      = nullptr;
+            pTree->pFreeNodes = nullptr;
+            pTree->pChunks    = nullptr;
+            pTree->chunkUsed  = NodesPerChunk;
+            pTree->count      = 0;
+            pTree->seed       = 0x9E3779B9u + (deviceIdx * 2) + typeIdx;
+        }
+    }
+}
+
+// =====================================================================================================================
+GpuAddressMap::~GpuAddressMap()
+{
+    for (uint32_t deviceIdx = 0; deviceIdx < MaxPalDevices; deviceIdx++)
+    {
+        for (uint32_t typeIdx = 0; typeIdx < static_cast<uint32_t>(ObjectType::Count); typeIdx++)
+        {
+            NodeChunk* pChunk = m_trees[deviceIdx][typeIdx].pChunks;
+
+            while (pChunk != nullptr)
+            {
+                NodeChunk* pNext = pChunk->pNext;
+
+                m_pInstance->FreeMem(pChunk);
+
+                pChunk = pNext;
+            }
+        }
+    }
+}
+
+// =====================================================================================================================
+// Hands out an unused node of the given tree, reusing removed nodes first.  Must be called with the tree's lock held for
+// writing.
+GpuAddressMap::Node* GpuAddressMap::AllocNode(
+    Tree* pTree)
+{
+    Node* pNode = pTree->pFreeNodes;
+
+    if (pNode != nullptr)
+    {
+        pTree->pFreeNodes = pNode->pRight;
+    }
+    else
+    {
+        if (pTree->chunkUsed == NodesPerChunk)
+        {
+            NodeChunk* pChunk = static_cast<NodeChunk*>(
+                m_pInstance->AllocMem(sizeof(NodeChunk), VK_SYSTEM_ALLOCATION_SCOPE_DEVICE));
+
+            if (pChunk != nullptr)
+            {
+                pChunk->pNext    = pTree->pChunks;
+                pTree->pChunks   = pChunk;
+                pTree->chunkUsed = 0;
+            }
+        }
+
+        if (pTree->chunkUsed < NodesPerChunk)
+        {
+            pNode = &pTree->pChunks->nodes[pTree->chunkUsed++];
+        }
+    }
+
+    if (pNode != nullptr)
+    {
+        // xorshift32
+        pTree->seed ^= pTree->seed << 13;
+        pTree->seed ^= pTree->seed >> 17;
+        pTree->seed ^= pTree->seed << 5;
+
+        pNode->priority = pTree->seed;
+        pNode->pLeft    = nullptr;
+        pNode->pRight   = nullptr;
+    }
+
+    return pNode;
+}
+
+// =====================================================================================================================
+// Adds the range owned by an object to the map of the given device.  An object may only register one range per start
+// address.  The map is only used for diagnostics, so a range that can't be tracked for lack of memory is dropped.
+void GpuAddressMap::Insert(
+    uint32_t     deviceIdx,
+    const Range& range)
+{
+    if (range.size > 0)
+    {
+        Tree* pTree = GetTree(deviceIdx, range.type);
+
+        Util::RWLockAuto<Util::RWLock::LockType::ReadWrite> writeLock(&pTree->lock);
+
+        Node* pNode = AllocNode(pTree);
+
+        if (pNode != nullptr)
+        {
+            pNode->range  = range;
+            pNode->maxEnd = range.gpuVirtAddr + range.size;
+
+            pTree->pRoot = InsertNode(pTree->pRoot, pNode);
+            pTree->count++;
+        }
+    }
+}
+
+// =====================================================================================================================
+// Removes a range registered with Insert().  Ranges that were never registered are ignored.
+void GpuAddressMap::Remove(
+    uint32_t     deviceIdx,
+    const Range& range)
+{
+    Tree* pTree = GetTree(deviceIdx, range.type);
+
+    Util::RWLockAuto<Util::RWLock::LockType::ReadWrite> writeLock(&pTree->lock);
+
+    Node* pRemoved = nullptr;
+
+    pTree->pRoot = RemoveNode(pTree->pRoot, range, &pRemoved);
+
+    if (pRemoved != nullptr)
+    {
+        pRemoved->pRight  = pTree->pFreeNodes;
+        pTree->pFreeNodes = pRemoved;
+        pTree->count--;
+    }
+}
+
+// =====================================================================================================================
+// Looks up the innermost range containing the given address.  When a memory object and a buffer bound to all of it
+// cover the same range, the buffer is returned.
+bool GpuAddressMap::Find(
+    uint32_t     deviceIdx,
+    Pal::gpusize gpuVirtAddr,
+    Range*       pRange)
+{
+    bool found = false;
+
+    // Buffers are looked up last so that they win over memory objects of the same size
+    for (uint32_t typeIdx = 0; typeIdx < static_cast<uint32_t>(ObjectType::Count); typeIdx++)
+    {
+        Tree* pTree = &m_trees[deviceIdx][typeIdx];
+
+        Util::RWLockAuto<Util::RWLock::LockType::ReadOnly> readLock(&pTree->lock);
+
+        const Node* pNode = FindInnermost(pTree->pRoot, gpuVirtAddr);
+
+        if ((pNode != nullptr) && ((found == false) || (pNode->range.size <= pRange->size)))
+        {
+            *pRange = pNode->range;
+            found   = true;
+        }
+    }
+
+    return found;
+}
+
+// =====================================================================================================================
+// Reads a dword through a CPU mapping of the memory object the address belongs to.  Fails if no memory object covers
+// the address or its memory can't be mapped.  The read lock is held while reading so the memory object can't be freed
+// underneath; buffer ranges are ignored because a buffer may outlive the memory it was bound to.
+bool GpuAddressMap::ReadDword(
+    uint32_t     deviceIdx,
+    Pal::gpusize gpuVirtAddr,
+    uint32_t*    pValue)
+{
+    Tree* pTree = GetTree(deviceIdx, ObjectType::Memory);
+
+    Util::RWLockAuto<Util::RWLock::LockType::ReadOnly> readLock(&pTree->lock);
+
+    const Node* pBest = FindInnermost(pTree->pRoot, gpuVirtAddr);
+
+    bool success = false;
+
+    if ((pBest != nullptr) && ((gpuVirtAddr + sizeof(uint32_t)) <= (pBest->range.gpuVirtAddr + pBest->range.size)))
+    {
+        Pal::IGpuMemory* pPalMemory = static_cast<const Memory*>(pBest->range.pObject)->PalMemory(deviceIdx);
+
+        void* pData = nullptr;
+
+        if ((pPalMemory != nullptr) && (pPalMemory->Map(&pData) == Pal::Result::Success))
+        {
+            *pValue = *static_cast<const volatile uint32_t*>(
+                Util::VoidPtrInc(pData, static_cast<size_t>(gpuVirtAddr - pBest->range.gpuVirtAddr)));
+
+            pPalMemory->Unmap();
+
+            success = true;
+        }
+    }
+
+    return success;
+}
+
+// =====================================================================================================================
+// Inserts a node into the subtree and returns the new root of the subtree.
+GpuAddressMap::Node* GpuAddressMap::InsertNode(
+    Node* pRoot,
+    Node* pNode)
+{
+    if (pRoot == nullptr)
+    {
+        pRoot = pNode;
+    }
+    else if (IsBefore(pNode->range, pRoot->range))
+    {
+        pRoot->pLeft = InsertNode(pRoot->pLeft, pNode);
+
+        if (pRoot->pLeft->priority > pRoot->priority)
+        {
+            pRoot = RotateRight(pRoot);
+        }
+    }
+    else
+    {
+        pRoot->pRight = InsertNode(pRoot->pRight, pNode);
+
+        if (pRoot->pRight->priority > pRoot->priority)
+        {
+            pRoot = RotateLeft(pRoot);
+        }
+    }
+
+    UpdateMaxEnd(pRoot);
+
+    return pRoot;
+}
+
+// =====================================================================================================================
+// Removes the node of the given key from the subtree and returns the new root of the subtree.  The node is sunk by
+// rotating its higher priority child above it until it has at most one child left.
+GpuAddressMap::Node* GpuAddressMap::RemoveNode(
+    Node*        pRoot,
+    const Range& range,
+    Node**       ppRemoved)
+{
+    if (pRoot != nullptr)
+    {
+        if ((pRoot->range.gpuVirtAddr == range.gpuVirtAddr) &&
+            (pRoot->range.size        == range.size)        &&
+            (pRoot->range.pObject     == range.pObject))
+        {
+            if (pRoot->pLeft == nullptr)
+            {
+                *ppRemoved = pRoot;
+                pRoot      = pRoot->pRight;
+            }
+            else if (pRoot->pRight == nullptr)
+            {
+                *ppRemoved = pRoot;
+                pRoot      = pRoot->pLeft;
+            }
+            else if (pRoot->pLeft->priority > pRoot->pRight->priority)
+            {
+                pRoot         = RotateRight(pRoot);
+                pRoot->pRight = RemoveNode(pRoot->pRight, range, ppRemoved);
+            }
+            else
+            {
+                pRoot        = RotateLeft(pRoot);
+                pRoot->pLeft = RemoveNode(pRoot->pLeft, range, ppRemoved);
+            }
+        }
+        else if (IsBefore(range, pRoot->range))
+        {
+            pRoot->pLeft = RemoveNode(pRoot->pLeft, range, ppRemoved);
+        }
+        else
+        {
+            pRoot->pRight = RemoveNode(pRoot->pRight, range, ppRemoved);
+        }
+
+        if (pRoot != nullptr)
+        {
+            UpdateMaxEnd(pRoot);
+        }
+    }
+
+    return pRoot;
+}
+
+// =====================================================================================================================
+// Returns the range of the subtree that contains the address and comes last in tree order, which is the innermost one.
+// Only nodes starting at or before the address can contain it, so this follows the search path for the address and
+// checks, from the last candidate backwards, the right subtree, the node itself and then the left subtree.  A subtree
+// is only entered if its highest end address lies past the address, so at most one subtree is descended beyond the
+// path.
+const GpuAddressMap::Node* GpuAddressMap::FindInnermost(
+    const Node*  pRoot,
+    Pal::gpusize gpuVirtAddr)
+{
+    const Node* pFound = nullptr;
+
+    if ((pRoot != nullptr) && (pRoot->maxEnd > gpuVirtAddr))
+    {
+        if (pRoot->range.gpuVirtAddr > gpuVirtAddr)
+        {
+            pFound = FindInnermost(pRoot->pLeft, gpuVirtAddr);
+        }
+        else
+        {
+            pFound = FindInnermost(pRoot->pRight, gpuVirtAddr);
+
+            if ((pFound == nullptr) && (gpuVirtAddr < (pRoot->range.gpuVirtAddr + pRoot->range.size)))
+            {
+                pFound = pRoot;
+            }
+
+            if (pFound == nullptr)
+            {
+                // Everything left of this node starts at or before the address
+                pFound = FindLastEndingAfter(pRoot->pLeft, gpuVirtAddr);
+            }
+        }
+    }
+
+    return pFound;
+}
+
+// =====================================================================================================================
+// Returns the last range of the subtree in tree order that ends after the address.  The caller guarantees that every
+// range of the subtree starts at or before the address, so the returned range contains it.
+const GpuAddressMap::Node* GpuAddressMap::FindLastEndingAfter(
+    const Node*  pRoot,
+    Pal::gpusize gpuVirtAddr)
+{
+    const Node* pFound = nullptr;
+    const Node* pNode  = pRoot;
+
+    while ((pFound == nullptr) && (pNode != nullptr) && (pNode->maxEnd > gpuVirtAddr))
+    {
+        if ((pNode->pRight != nullptr) && (pNode->pRight->maxEnd > gpuVirtAddr))
+        {
+            pNode = pNode->pRight;
+        }
+        else if (gpuVirtAddr < (pNode->range.gpuVirtAddr + pNode->range.size))
+        {
+            pFound = pNode;
+        }
+        else
+        {
+            pNode = pNode->pLeft;
+        }
+    }
+
+    return pFound;
+}
+
+// =====================================================================================================================
+GpuAddressMap::Node* GpuAddressMap::RotateLeft(
+    Node* pNode)
+{
+    Node* pRight = pNode->pRight;
+
+    pNode->pRight = pRight->pLeft;
+    pRight->pLeft = pNode;
+
+    UpdateMaxEnd(pNode);
+    UpdateMaxEnd(pRight);
+
+    return pRight;
+}
+
+// =====================================================================================================================
+GpuAddressMap::Node* GpuAddressMap::RotateRight(
+    Node* pNode)
+{
+    Node* pLeft = pNode->pLeft;
+
+    pNode->pLeft  = pLeft->pRight;
+    pLeft->pRight = pNode;
+
+    UpdateMaxEnd(pNode);
+    UpdateMaxEnd(pLeft);
+
+    return pLeft;
+}
+
+// =====================================================================================================================
+void GpuAddressMap::UpdateMaxEnd(
+    Node* pNode)
+{
+    Pal::gpusize maxEnd = pNode->range.gpuVirtAddr + pNode->range.size;
+
+    if (pNode->pLeft != nullptr)
+    {
+        maxEnd = Util::Max(maxEnd, pNode->pLeft->maxEnd);
+    }
+
+    if (pNode->pRight != nullptr)
+    {
+        maxEnd = Util::Max(maxEnd, pNode->pRight->maxEnd);
+    }
+
+    pNode->maxEnd = maxEnd;
+}
+
+} // namespace vk
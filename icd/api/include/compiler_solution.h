@@ -96,6 +96,7 @@ struct GraphicsPipelineCreateInfo
     Util::MetroHash::Hash                  basePipelineHash;
     PipelineCreationFeedback               pipelineFeedback;
     PipelineCreationFeedback               stageFeedback[ShaderStage::ShaderStageGfxCount];
+    bool                                   usesModuleIdentifiers; // Some stages are only given by module identifiers
 #if LLPC_CLIENT_INTERFACE_MAJOR_VERSION < 41
     Vkgc::ResourceMappingData              resourceMapping;
 #endif
@@ -115,6 +116,7 @@ struct ComputePipelineCreateInfo
     Util::MetroHash::Hash                  basePipelineHash;
     PipelineCreationFeedback               pipelineFeedback;
     PipelineCreationFeedback               stageFeedback;
+    bool                                   usesModuleIdentifiers; // The stage is only given by a module identifier
 #if LLPC_CLIENT_INTERFACE_MAJOR_VERSION < 41
     Vkgc::ResourceMappingData              resourceMapping;
 #endif
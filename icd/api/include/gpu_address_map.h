@@ -0,0 +1,168 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2021 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ ***********************************************************************************************************************
+ * @file  gpu_address_map.h
+ * @brief Reverse map from GPU virtual addresses to the Vulkan objects that own them.
+ ***********************************************************************************************************************
+ */
+
+#ifndef __GPU_ADDRESS_MAP_H__
+#define __GPU_ADDRESS_MAP_H__
+
+#pragma once
+
+#include "include/khronos/vulkan.h"
+#include "include/vk_defines.h"
+
+#include "pal.h"
+#include "palMutex.h"
+
+namespace vk
+{
+
+// Forward declare Vulkan classes used in this file
+class Instance;
+
+// =====================================================================================================================
+// The GPU address map resolves a GPU virtual address back to the memory object or buffer it belongs to, e.g. to name
+// the resource behind an address when reporting a lost device.  Memory objects register their whole allocation and
+// buffers register the range they are bound to, so an address is usually covered by a memory object and some buffers;
+// lookups return the innermost of them.
+//
+// Every PAL device keeps memory objects and buffers in two separate interval trees (treaps keyed by start address whose
+// nodes also track the highest end address of their subtree).  Memory objects of a device never overlap, and buffers
+// bound within a memory object are either disjoint or nested in practice, so the innermost range containing an address
+// is the containing one that starts last.  Each tree finds that range by walking one search path plus at most one
+// descent guided by the subtree end addresses, so inserts, removals and lookups are all expected O(log n) in the number
+// of live ranges.  If buffers overlap partially, the one starting last wins even if an earlier one is narrower.
+// Lookups only take the trees' locks for reading and never allocate.
+//
+// This object is owned by the Vulkan Device and only exists when the EnableGpuAddressMap setting is set.
+class GpuAddressMap
+{
+public:
+    enum class ObjectType : uint32_t
+    {
+        Memory = 0,  // pObject is a Memory
+        Buffer,      // pObject is a Buffer
+        Count
+    };
+
+    struct Range
+    {
+        Pal::gpusize gpuVirtAddr;
+        Pal::gpusize size;
+        ObjectType   type;
+        const void*  pObject;
+    };
+
+    GpuAddressMap(Instance* pInstance);
+    ~GpuAddressMap();
+
+    void Insert(
+        uint32_t     deviceIdx,
+        const Range& range);
+
+    void Remove(
+        uint32_t     deviceIdx,
+        const Range& range);
+
+    bool Find(
+        uint32_t     deviceIdx,
+        Pal::gpusize gpuVirtAddr,
+        Range*       pRange);
+
+    bool ReadDword(
+        uint32_t     deviceIdx,
+        Pal::gpusize gpuVirtAddr,
+        uint32_t*    pValue);
+
+    uint32_t GetRangeCount(uint32_t deviceIdx) const
+        { return m_trees[deviceIdx][0].count + m_trees[deviceIdx][1].count; }
+
+private:
+    PAL_DISALLOW_COPY_AND_ASSIGN(GpuAddressMap);
+
+    struct Node
+    {
+        Range        range;
+        Pal::gpusize maxEnd;    // Highest end address of any range in the subtree rooted at this node
+        uint32_t     priority;  // Random heap priority that keeps the tree balanced
+        Node*        pLeft;
+        Node*        pRight;
+    };
+
+    static constexpr uint32_t NodesPerChunk = 1024;
+
+    // Nodes are allocated in chunks that are only returned to the instance when the map is destroyed
+    struct NodeChunk
+    {
+        NodeChunk* pNext;
+        Node       nodes[NodesPerChunk];
+    };
+
+    struct Tree
+    {
+        Node*        pRoot;
+        Node*        pFreeNodes;   // Nodes released by Remove(), linked through pRight
+        NodeChunk*   pChunks;
+        uint32_t     chunkUsed;    // Number of nodes of the newest chunk handed out so far
+        uint32_t     count;        // Number of ranges in the tree
+        uint32_t     seed;         // State of the priority generator
+        Util::RWLock lock;
+    };
+
+    Node* AllocNode(Tree* pTree);
+
+    Tree* GetTree(uint32_t deviceIdx, ObjectType type)
+        { return &m_trees[deviceIdx][static_cast<uint32_t>(type)]; }
+
+    static Node*       InsertNode(Node* pRoot, Node* pNode);
+    static Node*       RemoveNode(Node* pRoot, const Range& range, Node** ppRemoved);
+    static const Node* FindInnermost(const Node* pRoot, Pal::gpusize gpuVirtAddr);
+    static const Node* FindLastEndingAfter(const Node* pRoot, Pal::gpusize gpuVirtAddr);
+    static Node*       RotateLeft(Node* pNode);
+    static Node*       RotateRight(Node* pNode);
+    static void        UpdateMaxEnd(Node* pNode);
+
+    // Ranges are ordered by start address, wider ranges first among ranges of the same start.  This way the innermost
+    // range containing an address is always the last containing one in tree order.
+    static bool IsBefore(const Range& lhs, const Range& rhs)
+    {
+        return (lhs.gpuVirtAddr < rhs.gpuVirtAddr) ||
+               ((lhs.gpuVirtAddr == rhs.gpuVirtAddr) &&
+                ((lhs.size > rhs.size) ||
+                 ((lhs.size == rhs.size) &&
+                  (reinterpret_cast<uintptr_t>(lhs.pObject) < reinterpret_cast<uintptr_t>(rhs.pObject)))));
+    }
+
+    Instance* m_pInstance;
+    Tree      m_trees[MaxPalDevices][static_cast<uint32_t>(ObjectType::Count)];
+};
+
+} // namespace vk
+
+#endif /* __GPU_ADDRESS_MAP_H__ */
@@ -0,0 +1,94 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020-2021 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ **********************************************************************************************************************
+ * @file  vk_ext_graphics_pipeline_library.h
+ * @brief Header for VK_EXT_graphics_pipeline_library extension.  Only used until the bundled Khronos headers provide
+ *        it.
+ **********************************************************************************************************************
+ */
+#ifndef VK_EXT_GRAPHICS_PIPELINE_LIBRARY_H_
+#define VK_EXT_GRAPHICS_PIPELINE_LIBRARY_H_
+
+#include "vk_internal_ext_helper.h"
+
+#ifndef VK_EXT_graphics_pipeline_library
+
+#define VK_EXT_graphics_pipeline_library                    1
+#define VK_EXT_GRAPHICS_PIPELINE_LIBRARY_SPEC_VERSION       1
+#define VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME     "VK_EXT_graphics_pipeline_library"
+
+#define VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NUMBER   321
+
+#define VK_EXT_GRAPHICS_PIPELINE_LIBRARY_ENUM(type, offset) \
+    VK_EXTENSION_ENUM(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NUMBER, type, offset)
+
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT \
+    VK_EXT_GRAPHICS_PIPELINE_LIBRARY_ENUM(VkStructureType, 0)
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT \
+    VK_EXT_GRAPHICS_PIPELINE_LIBRARY_ENUM(VkStructureType, 1)
+#define VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT \
+    VK_EXT_GRAPHICS_PIPELINE_LIBRARY_ENUM(VkStructureType, 2)
+
+#define VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT               VK_EXTENSION_BIT(VkPipelineCreateFlagBits, 10)
+#define VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT   VK_EXTENSION_BIT(VkPipelineCreateFlagBits, 23)
+
+#define VK_PIPELINE_LAYOUT_CREATE_INDEPENDENT_SETS_BIT_EXT              VK_EXTENSION_BIT(VkPipelineLayoutCreateFlags, 1)
+
+typedef enum VkGraphicsPipelineLibraryFlagBitsEXT
+{
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT    = 0x00000001,
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT = 0x00000002,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT           = 0x00000004,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT = 0x00000008,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FLAG_BITS_MAX_ENUM_EXT            = 0x7FFFFFFF
+} VkGraphicsPipelineLibraryFlagBitsEXT;
+typedef VkFlags VkGraphicsPipelineLibraryFlagsEXT;
+
+typedef struct VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT
+{
+    VkStructureType    sType;
+    void*              pNext;
+    VkBool32           graphicsPipelineLibrary;
+} VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT;
+
+typedef struct VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT
+{
+    VkStructureType    sType;
+    void*              pNext;
+    VkBool32           graphicsPipelineLibraryFastLinking;
+    VkBool32           graphicsPipelineLibraryIndependentInterpolationDecoration;
+} VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT;
+
+typedef struct VkGraphicsPipelineLibraryCreateInfoEXT
+{
+    VkStructureType                      sType;
+    void*                                pNext;
+    VkGraphicsPipelineLibraryFlagsEXT    flags;
+} VkGraphicsPipelineLibraryCreateInfoEXT;
+
+#endif /* VK_EXT_graphics_pipeline_library */
+
+#endif /* VK_EXT_GRAPHICS_PIPELINE_LIBRARY_H_ */
@@ -0,0 +1,100 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2014-2021 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ **********************************************************************************************************************
+ * @file  vk_ext_shader_module_identifier.h
+ * @brief Header for VK_EXT_shader_module_identifier extension.  Only used until the bundled Khronos headers provide it.
+ **********************************************************************************************************************
+ */
+#ifndef VK_EXT_SHADER_MODULE_IDENTIFIER_H_
+#define VK_EXT_SHADER_MODULE_IDENTIFIER_H_
+
+#include "vk_internal_ext_helper.h"
+
+#ifndef VK_EXT_shader_module_identifier
+
+#define VK_EXT_shader_module_identifier                     1
+#define VK_EXT_SHADER_MODULE_IDENTIFIER_SPEC_VERSION        1
+#define VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME      "VK_EXT_shader_module_identifier"
+
+#define VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NUMBER    463
+
+#define VK_MAX_SHADER_MODULE_IDENTIFIER_SIZE_EXT            32U
+
+#define VK_EXT_SHADER_MODULE_IDENTIFIER_ENUM(type, offset) \
+    VK_EXTENSION_ENUM(VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NUMBER, type, offset)
+
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MODULE_IDENTIFIER_FEATURES_EXT \
+    VK_EXT_SHADER_MODULE_IDENTIFIER_ENUM(VkStructureType, 0)
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MODULE_IDENTIFIER_PROPERTIES_EXT \
+    VK_EXT_SHADER_MODULE_IDENTIFIER_ENUM(VkStructureType, 1)
+#define VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_MODULE_IDENTIFIER_CREATE_INFO_EXT \
+    VK_EXT_SHADER_MODULE_IDENTIFIER_ENUM(VkStructureType, 2)
+#define VK_STRUCTURE_TYPE_SHADER_MODULE_IDENTIFIER_EXT \
+    VK_EXT_SHADER_MODULE_IDENTIFIER_ENUM(VkStructureType, 3)
+
+typedef struct VkPhysicalDeviceShaderModuleIdentifierFeaturesEXT
+{
+    VkStructureType    sType;
+    void*              pNext;
+    VkBool32           shaderModuleIdentifier;
+} VkPhysicalDeviceShaderModuleIdentifierFeaturesEXT;
+
+typedef struct VkPhysicalDeviceShaderModuleIdentifierPropertiesEXT
+{
+    VkStructureType    sType;
+    void*              pNext;
+    uint8_t            shaderModuleIdentifierAlgorithmUUID[VK_UUID_SIZE];
+} VkPhysicalDeviceShaderModuleIdentifierPropertiesEXT;
+
+typedef struct VkPipelineShaderStageModuleIdentifierCreateInfoEXT
+{
+    VkStructureType    sType;
+    const void*        pNext;
+    uint32_t           identifierSize;
+    const uint8_t*     pIdentifier;
+} VkPipelineShaderStageModuleIdentifierCreateInfoEXT;
+
+typedef struct VkShaderModuleIdentifierEXT
+{
+    VkStructureType    sType;
+    void*              pNext;
+    uint32_t           identifierSize;
+    uint8_t            identifier[VK_MAX_SHADER_MODULE_IDENTIFIER_SIZE_EXT];
+} VkShaderModuleIdentifierEXT;
+
+typedef void (VKAPI_PTR *PFN_vkGetShaderModuleIdentifierEXT)(
+    VkDevice                                    device,
+    VkShaderModule                              shaderModule,
+    VkShaderModuleIdentifierEXT*                pIdentifier);
+
+typedef void (VKAPI_PTR *PFN_vkGetShaderModuleCreateInfoIdentifierEXT)(
+    VkDevice                                    device,
+    const VkShaderModuleCreateInfo*             pCreateInfo,
+    VkShaderModuleIdentifierEXT*                pIdentifier);
+
+#endif /* VK_EXT_shader_module_identifier */
+
+#endif /* VK_EXT_SHADER_MODULE_IDENTIFIER_H_ */
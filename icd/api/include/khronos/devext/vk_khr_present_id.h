@@ -0,0 +1,96 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2021 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ **********************************************************************************************************************
+ * @file  vk_khr_present_id.h
+ * @brief Header for VK_KHR_present_id and VK_KHR_present_wait extensions.  Only used until the bundled Khronos
+ *        headers provide them.
+ **********************************************************************************************************************
+ */
+#ifndef VK_KHR_PRESENT_ID_H_
+#define VK_KHR_PRESENT_ID_H_
+
+#include "vk_internal_ext_helper.h"
+
+#ifndef VK_KHR_present_id
+
+#define VK_KHR_present_id                               1
+#define VK_KHR_PRESENT_ID_SPEC_VERSION                  1
+#define VK_KHR_PRESENT_ID_EXTENSION_NAME                "VK_KHR_present_id"
+
+#define VK_KHR_PRESENT_ID_EXTENSION_NUMBER              295
+
+#define VK_KHR_PRESENT_ID_ENUM(type, offset) \
+    VK_EXTENSION_ENUM(VK_KHR_PRESENT_ID_EXTENSION_NUMBER, type, offset)
+
+#define VK_STRUCTURE_TYPE_PRESENT_ID_KHR                            VK_KHR_PRESENT_ID_ENUM(VkStructureType, 0)
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR   VK_KHR_PRESENT_ID_ENUM(VkStructureType, 1)
+
+typedef struct VkPhysicalDevicePresentIdFeaturesKHR
+{
+    VkStructureType    sType;
+    void*              pNext;
+    VkBool32           presentId;
+} VkPhysicalDevicePresentIdFeaturesKHR;
+
+typedef struct VkPresentIdKHR
+{
+    VkStructureType    sType;
+    const void*        pNext;
+    uint32_t           swapchainCount;
+    const uint64_t*    pPresentIds;
+} VkPresentIdKHR;
+
+#endif /* VK_KHR_present_id */
+
+#ifndef VK_KHR_present_wait
+
+#define VK_KHR_present_wait                             1
+#define VK_KHR_PRESENT_WAIT_SPEC_VERSION                1
+#define VK_KHR_PRESENT_WAIT_EXTENSION_NAME              "VK_KHR_present_wait"
+
+#define VK_KHR_PRESENT_WAIT_EXTENSION_NUMBER            249
+
+#define VK_KHR_PRESENT_WAIT_ENUM(type, offset) \
+    VK_EXTENSION_ENUM(VK_KHR_PRESENT_WAIT_EXTENSION_NUMBER, type, offset)
+
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR VK_KHR_PRESENT_WAIT_ENUM(VkStructureType, 0)
+
+typedef struct VkPhysicalDevicePresentWaitFeaturesKHR
+{
+    VkStructureType    sType;
+    void*              pNext;
+    VkBool32           presentWait;
+} VkPhysicalDevicePresentWaitFeaturesKHR;
+
+typedef VkResult (VKAPI_PTR *PFN_vkWaitForPresentKHR)(
+    VkDevice                                    device,
+    VkSwapchainKHR                              swapchain,
+    uint64_t                                    presentId,
+    uint64_t                                    timeout);
+
+#endif /* VK_KHR_present_wait */
+
+#endif /* VK_KHR_PRESENT_ID_H_ */
@@ -58,6 +58,12 @@
 // Internal (under development) extension definitions
 
 #include "devext/vk_amd_gpa_interface.h"
+#include "devext/vk_ext_multi_draw.h"
+#include "devext/vk_khr_dynamic_rendering.h"
+#include "devext/vk_ext_graphics_pipeline_library.h"
+#include "devext/vk_ext_shader_module_identifier.h"
+#include "devext/vk_khr_maintenance4.h"
+#include "devext/vk_khr_present_id.h"
 
 #define VK_FORMAT_BEGIN_RANGE VK_FORMAT_UNDEFINED
 #define VK_FORMAT_END_RANGE VK_FORMAT_ASTC_12x12_SRGB_BLOCK
@@ -35,6 +35,7 @@
 #include "palMetroHash.h"
 #include "palVector.h"
 #include "palCacheLayer.h"
+#include "palThread.h"
 #include "cache_adapter.h"
 
 namespace Util
@@ -196,6 +197,41 @@ private:
 
     Util::Result InjectBinariesFromDirectory(
         const RuntimeSettings& settings);
+
+    // States of a replacement ELF
+    enum ReinjectionElfState : uint32_t
+    {
+        ReinjectionElfPending = 0,  // Not loaded yet
+        ReinjectionElfLoading,      // Being loaded by some thread
+        ReinjectionElfDone          // Loaded into the reinjection layer (or failed to load)
+    };
+
+    // A file of the ELF replacement directory.  It is loaded into the reinjection layer by a loader thread or when its
+    // pipeline is first looked up, whichever comes first.
+    struct ReinjectionElf
+    {
+        CacheId           hash;       // Internal hash of the pipeline the file replaces
+        const char*       pFileName;  // Name of the file within m_pReinjectionDir
+        volatile uint32_t state;      // ReinjectionElfState
+    };
+
+    using ReinjectionElfIndex = Util::HashMap<CacheId, ReinjectionElf*, PalAllocator, Util::JenkinsHashFunc>;
+
+    static constexpr uint32_t MaxReinjectionLoaderThreads = 8;
+
+    void LoadReinjectionElf(
+        ReinjectionElf* pElf);
+
+    Util::Result StoreReinjectionElfFile(
+        const ReinjectionElf* pElf);
+
+    void StartReinjectionLoaders(
+        uint32_t threadCount);
+
+    void StopReinjectionLoaders();
+
+    static void ReinjectionLoaderThreadFunc(
+        void* pParam);
 #endif
 
     VkResult InitMemoryCacheLayer(
@@ -210,6 +246,33 @@ private:
     Util::IArchiveFile* OpenWritableArchive(const char* path, const char* fileName, size_t bufferSize);
     Util::ICacheLayer*  CreateFileLayer(Util::IArchiveFile* pFile);
 
+    // An archive of the cache directory as seen by the garbage collector
+    struct CacheDirEntry
+    {
+        uint64_t lastUse;   // Modification time in seconds since the epoch
+        uint64_t size;      // File size in bytes
+        char     name[64];
+    };
+
+    void StartCacheDirGc(
+        const char*            pCachePath,
+        const char*            pArchiveBaseName,
+        size_t                 archiveBaseNameLength,
+        const RuntimeSettings& settings);
+
+    void StopCacheDirGc();
+
+    void CollectCacheDir();
+
+#if defined(__unix__)
+    bool IsOwnArchive(const char* pName) const;
+
+    void MarkOwnArchivesUsed(int dirFd) const;
+#endif
+
+    static void CacheDirGcThreadFunc(
+        void* pParam);
+
     // Override the driver's default location
     static constexpr char     EnvVarPath[] = "AMD_VK_PIPELINE_CACHE_PATH";
 
@@ -219,6 +282,9 @@ private:
     // Filename of an additional, read-only archive
     static constexpr char     EnvVarReadOnlyFileName[] = "AMD_VK_PIPELINE_CACHE_READ_ONLY_FILENAME";
 
+    // Name of the file in the cache directory whose lock serializes garbage collection between processes
+    static constexpr char     CacheDirLockFileName[] = "cache_gc.lock";
+
     static const uint32_t     ArchiveType;                // TypeId created by hashed string VK_SHADER_PIPELINE_CACHE
     static const uint32_t     ElfType;                    // TypeId created by hashed string VK_PIPELINE_ELF
 
@@ -238,6 +304,17 @@ private:
 
     HashMapping               m_hashMapping;              // Maps the internalPipelineHash to the appropriate CacheId
     Util::RWLock              m_hashMappingLock;          // Prevents collisions during writes to the map
+
+    // Files of the ELF replacement directory.  The index is built during initialization and only read afterwards.
+    ReinjectionElf*           m_pReinjectionElfs;         // Start of one allocation also holding the directory and
+                                                          // file names
+    uint32_t                  m_reinjectionElfCount;
+    const char*               m_pReinjectionDir;
+    ReinjectionElfIndex       m_reinjectionElfIndex;      // Maps pipeline hashes to their replacement ELF
+
+    Util::Thread              m_reinjectionLoaders[MaxReinjectionLoaderThreads]; // Background ELF loader threads
+    volatile uint32_t         m_nextReinjectionElf;       // Index of the next ELF for a loader thread to claim
+    volatile bool             m_stopReinjectionLoaders;
 #endif
 
     Util::ICacheLayer*        m_pMemoryLayer;
@@ -252,6 +329,15 @@ private:
     CacheAdapter*       m_pCacheAdapter;
 
     Util::Mutex         m_entriesMutex;      // Mutex that will be used to get cache state by Query
+
+    // Background garbage collection of the default cache directory
+    Util::Thread        m_cacheDirGc;
+    volatile bool       m_stopCacheDirGc;
+    char*               m_pCacheDirPath;         // Start of one allocation also holding m_pArchiveBaseName
+    const char*         m_pArchiveBaseName;      // Name prefix of the archives of this application, never evicted
+    uint64_t            m_cacheDirSizeLimit;     // Collection starts once the directory grows past this size...
+    uint64_t            m_cacheDirLowWaterMark;  // ...and evicts least recently used archives down to this size
+    uint64_t            m_cacheDirMinAge;        // Archives used more recently than this (in seconds) are kept
 };
 
 } // namespace vk
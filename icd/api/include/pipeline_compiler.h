@@ -105,6 +105,12 @@ public:
         uint32_t                            rasterizationStream,
         Util::MetroHash::Hash*              pCacheId);
 
+    VkResult BuildGraphicsPipelinePart(
+        Device*                             pDevice,
+        uint32_t                            deviceIndex,
+        PipelineCache*                      pPipelineCache,
+        GraphicsPipelineCreateInfo*         pCreateInfo);
+
     VkResult CreateComputePipelineBinary(
         Device*                             pDevice,
         uint32_t                            deviceIndex,
@@ -179,17 +185,20 @@ public:
 
     void DestroyPipelineBinaryCache();
 
+    static VkPipelineCreateFlags GetCacheIdControlFlags(
+        VkPipelineCreateFlags in);
+
 private:
     PAL_DISALLOW_COPY_AND_ASSIGN(PipelineCompiler);
 
     void ApplyProfileOptions(
-        Device*                      pDevice,
-        ShaderStage                  stage,
-        ShaderModule*                pShaderModule,
-        Vkgc::PipelineOptions*       pPipelineOptions,
-        Vkgc::PipelineShaderInfo*    pShaderInfo,
-        PipelineOptimizerKey*        pProfileKey,
-        Vkgc::NggState*              pNggState
+        Device*                       pDevice,
+        ShaderStage                   stage,
+        const ShaderModuleIdentifier& moduleIdentifier,
+        Vkgc::PipelineOptions*        pPipelineOptions,
+        Vkgc::PipelineShaderInfo*     pShaderInfo,
+        PipelineOptimizerKey*         pProfileKey,
+        Vkgc::NggState*               pNggState
     );
 
     template<class PipelineBuildInfo>
@@ -233,6 +242,40 @@ private:
         FreeCompilerBinary*          pFreeCompilerBinary,
         PipelineCreationFeedback*    pPipelineFeedback);
 
+    VkResult LoadPipelineBinaryFromIdentifiers(
+        PipelineBinaryCache*         pPipelineBinaryCache,
+        const Util::MetroHash::Hash* pIdentifierCacheId,
+        Util::MetroHash::Hash*       pCacheId,
+        size_t*                      pPipelineBinarySize,
+        const void**                 ppPipelineBinary,
+        FreeCompilerBinary*          pFreeCompilerBinary,
+        PipelineCreationFeedback*    pPipelineFeedback);
+
+    void StoreIdentifierCacheId(
+        PipelineBinaryCache*         pPipelineBinaryCache,
+        const Util::MetroHash::Hash* pIdentifierCacheId,
+        const Util::MetroHash::Hash* pCacheId);
+
+    void UpdateGraphicsCacheIdOptions(
+        Util::MetroHash128*               pHasher,
+        const GraphicsPipelineCreateInfo* pCreateInfo,
+        uint32_t                          deviceIdx) const;
+
+    void GetGraphicsIdentifierCacheId(
+        const GraphicsPipelineCreateInfo* pCreateInfo,
+        uint32_t                          deviceIdx,
+        Util::MetroHash::Hash*            pIdentifierCacheId) const;
+
+    void UpdateComputeCacheIdOptions(
+        Util::MetroHash128*               pHasher,
+        const ComputePipelineCreateInfo*  pCreateInfo,
+        uint32_t                          deviceIdx) const;
+
+    void GetComputeIdentifierCacheId(
+        const ComputePipelineCreateInfo*  pCreateInfo,
+        uint32_t                          deviceIdx,
+        Util::MetroHash::Hash*            pIdentifierCacheId) const;
+
     // -----------------------------------------------------------------------------------------------------------------
 
     PhysicalDevice*    m_pPhysicalDevice;      // Vulkan physical device object
@@ -252,9 +295,6 @@ private:
     void GetPipelineCreationInfoNext(
         const VkStructHeader*                             pHeader,
         const VkPipelineCreationFeedbackCreateInfoEXT**   ppPipelineCreationFeadbackCreateInfo);
-
-    static VkPipelineCreateFlags GetCacheIdControlFlags(
-        VkPipelineCreateFlags in);
 }; // class PipelineCompiler
 
 } // namespce vk
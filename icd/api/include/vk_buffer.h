@@ -82,6 +82,11 @@ public:
         const Device*         pDevice,
         VkMemoryRequirements* pMemoryRequirements);
 
+    static void CalculateMemoryRequirements(
+        const Device*             pDevice,
+        const VkBufferCreateInfo* pCreateInfo,
+        VkMemoryRequirements2*    pMemoryRequirements);
+
     VkDeviceSize GetSize() const
         { return m_size; }
 
@@ -130,7 +135,6 @@ private:
 
     Buffer(Device*                      pDevice,
            const VkAllocationCallbacks* pAllocator,
-           VkBufferCreateFlags          flags,
            VkBufferUsageFlags           usage,
            Pal::IGpuMemory**            pGpuMemory,
            VkSharingMode                sharingMode,
@@ -146,6 +150,16 @@ private:
         return sizeof(Buffer) + ((pDevice->NumPalDevices() - 1) * sizeof(PerGpuInfo));
     }
 
+    static BufferFlags ConvertBufferCreateInfo(
+        const Device*             pDevice,
+        const VkBufferCreateInfo* pCreateInfo);
+
+    static void CalculateMemoryRequirementsInternal(
+        const Device*         pDevice,
+        VkDeviceSize          size,
+        BufferFlags           internalFlags,
+        VkMemoryRequirements* pMemoryRequirements);
+
     static void LogBufferCreate(
         VkDeviceSize              size,
         const VkBufferCreateInfo* pCreateInfo,
@@ -154,6 +168,8 @@ private:
 
     void LogGpuMemoryBind(const Device* pDevice, const Pal::IGpuMemory* pPalMemory, VkDeviceSize memOffset) const;
 
+    void AddToGpuAddressMap(const Device* pDevice) const;
+
     const VkDeviceSize      m_size;
     VkDeviceSize            m_memOffset;
     BufferBarrierPolicy     m_barrierPolicy;     // Barrier policy to use for this buffer
@@ -219,6 +235,11 @@ VKAPI_ATTR void VKAPI_CALL vkGetBufferMemoryRequirements2(
     const VkBufferMemoryRequirementsInfo2*      pInfo,
     VkMemoryRequirements2*                      pMemoryRequirements);
 
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceBufferMemoryRequirementsKHR(
+    VkDevice                                    device,
+    const VkDeviceBufferMemoryRequirementsKHR*  pInfo,
+    VkMemoryRequirements2*                      pMemoryRequirements);
+
 VKAPI_ATTR VkDeviceAddress VKAPI_CALL vkGetBufferDeviceAddress(
     VkDevice                                    device,
     const VkBufferDeviceAddressInfo*            pInfo);
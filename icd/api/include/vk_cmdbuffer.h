@@ -70,20 +70,30 @@ struct ImageLayout;
 
 };
 
+namespace Util
+{
+
+class File;
+
+};
+
 namespace vk
 {
 
 // Forward declare Vulkan classes used in this file
+class CmdBuffer;
 class ComputePipeline;
 class Device;
 class DispatchableCmdBuffer;
 class Framebuffer;
 class GraphicsPipeline;
 class Image;
+class ImageView;
 class Queue;
 class RenderPass;
 class TimestampQueryPool;
 class SqttCmdBufferState;
+struct DynamicRenderingResolveInfo;
 
 constexpr uint8_t DefaultStencilOpValue = 1;
 
@@ -115,6 +125,8 @@ struct PipelineBindState
     uint32_t pushConstData[MaxPushConstRegCount];
     // Dynamic info (wave limits, etc.)
     PipelineDynamicBindInfo dynamicBindInfo;
+    // Set index of the most recently pushed descriptor table (VK_KHR_push_descriptor)
+    uint32_t pushDescSetIdx;
 };
 
 union DirtyState
@@ -160,6 +172,45 @@ struct PerGpuRenderState
     uint32_t maxPipelineStackSize;
 };
 
+// CPU copy of the most recently pushed descriptor table of one bind point on one device.  Push descriptor tables are
+// written here and then copied to embedded data, so descriptors inherited by the next push to the same set never have
+// to be read back from GPU-visible memory.  The storage only grows and is kept until the resources are released.
+struct PushDescriptorShadow
+{
+    uint32_t* pTable;      // Table storage, nullptr until the first push
+    uint32_t  dwCapacity;  // Size of the storage in dwords
+    uint32_t  dwSize;      // Size of the table last pushed, or 0 if there is nothing to inherit
+};
+
+// Per-attachment state of a dynamic rendering instance (VK_KHR_dynamic_rendering)
+struct DynamicRenderingAttachment
+{
+    const ImageView*        pImageView;             // Attachment view (nullptr if unused or if inherited)
+    VkImageLayout           imageLayout;            // Layout of the attachment during rendering
+    VkResolveModeFlagBits   resolveMode;            // Resolve mode applied at the end of the rendering instance
+    const ImageView*        pResolveImageView;      // Resolve destination view
+    VkImageLayout           resolveImageLayout;     // Layout of the resolve destination
+    VkFormat                attachmentFormat;       // Format of the attachment (also known for secondaries)
+    Pal::SwizzledFormat     palFormat;              // PAL format of the attachment
+    uint32_t                rasterizationSamples;   // Sample count of the attachment
+};
+
+// State tracked during a dynamic rendering instance when building a command buffer.  Unlike a render pass instance this
+// has no RenderPass or Framebuffer object behind it: targets are bound directly at vkCmdBeginRenderingKHR and load-op
+// clears and resolves are executed at the boundaries of the instance.
+struct DynamicRenderingInstanceState
+{
+    bool                        active;
+    VkRenderingFlagsKHR         flags;
+    uint32_t                    viewMask;
+    uint32_t                    layerCount;             // Layers rendered to when viewMask is zero
+    uint32_t                    colorAttachmentCount;
+    DynamicRenderingAttachment  colorAttachments[Pal::MaxColorTargets];
+    DynamicRenderingAttachment  depthAttachment;
+    DynamicRenderingAttachment  stencilAttachment;
+    SamplePattern               samplePattern;          // Sample pattern used for rendering and depth resolves
+};
+
 // Members of CmdBufferRenderState that are the same for each GPU
 struct AllGpuRenderState
 {
@@ -193,6 +244,9 @@ struct AllGpuRenderState
     // The Imageless Frambuffer extension allows setting this at RenderPassBind
     Framebuffer*             pFramebuffer;
 
+    // Attachments of the current dynamic rendering instance, used instead of pRenderPass and pFramebuffer
+    DynamicRenderingInstanceState dynamicRendering;
+
     // Dirty bits indicate which state should be validated. It assumed viewport/scissor in perGpuStates will likely be
     // changed for all GPUs if it is changed for any GPU. Put DirtyState management here will be easier to manage.
     DirtyState dirty;
@@ -205,6 +259,10 @@ struct AllGpuRenderState
     // is used at pipeline bind time to determine if CB_TARGET_MASK needs to be updated as part of the bind operation.
     bool lastColorWriteEnableDynamic;
 
+    // Set by VK_EXT_extended_dynamic_state2 when rasterizer discard is enabled for a pipeline built with rasterization
+    // enabled.  The discard is applied by programming empty scissor rects at draw time.
+    bool rasterizerDiscardEnable;
+
 // =====================================================================================================================
 // The first part of the structure will be cleared with a memset in CmdBuffer::ResetState().
 // The second part of the structure contains the larger members that are selectively reset in CmdBuffer::ResetState().
@@ -252,6 +310,7 @@ struct RenderPassInstanceState
     RenderPassInstanceState(PalAllocator* pAllocator);
 
     const RenderPassExecuteInfo*                pExecuteInfo;
+    const RPInstanceProgram*                    pProgram;       // Precompiled sync points, if any
     uint32_t                                    subpass;
     uint32_t                                    renderAreaCount;
     Pal::Rect                                   renderArea[MaxPalDevices];
@@ -261,6 +320,53 @@ struct RenderPassInstanceState
     SamplePattern*                              pSamplePatterns;
 };
 
+// Image regions known to hold the value of a render pass load-op clear recorded earlier in the command buffer.  Any
+// command that may write an image or memory bound to one drops all entries, so a load-op clear matching an entry writes
+// nothing new.  Barriers changing the layout of an image drop its entries, so the layouts recorded here stay accurate.
+struct ClearStateTracker
+{
+    struct Entry
+    {
+        const Image*        pImage;
+        Pal::SubresRange    subresRange;            // Framebuffer subresource range of the attachment view
+        VkImageAspectFlags  aspectMask;             // Aspects holding the clear value
+        uint32_t            viewMask;               // Active views of the render pass that did the clear
+        uint32_t            deviceMask;             // Devices the clear was executed on
+        Pal::Box            box[MaxPalDevices];     // Cleared region on each device
+        Pal::SwizzledFormat viewFormat;             // Format the clear value was converted with
+        VkClearValue        clearValue;
+        Pal::ImageLayout    layouts[Pal::MaxNumPlanes]; // Current layout of each plane, replacing an uninitialized one
+    };
+
+    static constexpr uint32_t MaxEntries = Pal::MaxColorTargets + 1;
+
+    Entry       entries[MaxEntries];
+    uint32_t    entryCount;
+    uint32_t    nextEntry;          // Entry replaced once all of them are in use
+};
+
+// Driver-side breadcrumb recorded for each vkCmdWriteBufferMarker*AMD call
+struct Breadcrumb
+{
+    uint32_t         marker;                  // Marker value written by the application
+    Pal::HwPipePoint pipePoint;               // Pipe point the marker was written at
+    Pal::gpusize     dstAddr[MaxPalDevices];  // Address the marker was written to on each device
+};
+
+// Per-command buffer breadcrumb ring (see the BreadcrumbRingEntries setting).  No GPU commands are added for it and
+// markers are not coalesced: the application's own marker writes are the progress, and whether a marker was reached is
+// decided by reading its destination back when the ring is reported.
+struct BreadcrumbRing
+{
+    uint32_t         entryCount;                  // Capacity of pEntries
+    uint32_t         markerCount;                 // Markers recorded since Begin (may exceed entryCount)
+    uint64_t         submitId;                    // Device-wide ID of the last submission including this command buffer
+    const Queue*     pSubmitQueue;                // Queue of that submission
+    Breadcrumb*      pEntries;                    // Most recent markers, indexed by marker number modulo entryCount
+    CmdBuffer*       pPrev;                       // Links in the device's list of command buffers with breadcrumbs
+    CmdBuffer*       pNext;
+};
+
 struct TransformFeedbackState
 {
     Pal::BindStreamOutTargetParams  params;
@@ -335,6 +441,21 @@ public:
         uint32_t                                    firstInstance,
         uint32_t                                    instanceCount);
 
+    void DrawMulti(
+        uint32_t                                    drawCount,
+        const VkMultiDrawInfoEXT*                   pVertexInfo,
+        uint32_t                                    instanceCount,
+        uint32_t                                    firstInstance,
+        uint32_t                                    stride);
+
+    void DrawMultiIndexed(
+        uint32_t                                    drawCount,
+        const VkMultiDrawIndexedInfoEXT*            pIndexInfo,
+        uint32_t                                    instanceCount,
+        uint32_t                                    firstInstance,
+        uint32_t                                    stride,
+        const int32_t*                              pVertexOffset);
+
     template< bool indexed, bool useBufferCount>
     void DrawIndirect(
         VkBuffer                                    buffer,
@@ -516,6 +637,15 @@ public:
         uint32_t                                    attachmentCount,
         const VkBool32*                             pColorWriteEnables);
 
+    void SetRasterizerDiscardEnableEXT(
+        VkBool32                                    rasterizerDiscardEnable);
+
+    void SetDepthBiasEnableEXT(
+        VkBool32                                    depthBiasEnable);
+
+    void SetPrimitiveRestartEnableEXT(
+        VkBool32                                    primitiveRestartEnable);
+
     void SetLineWidth(
         float                                       lineWidth);
 
@@ -648,6 +778,11 @@ public:
 
     void EndRenderPass();
 
+    void BeginRendering(
+        const VkRenderingInfoKHR*    pRenderingInfo);
+
+    void EndRendering();
+
     void PushConstants(
         VkPipelineLayout                            layout,
         VkShaderStageFlags                          stageFlags,
@@ -655,12 +790,29 @@ public:
         uint32_t                                    length,
         const void*                                 values);
 
+    void PushDescriptorSetWithTemplateKHR(
+        VkDescriptorUpdateTemplate                  descriptorUpdateTemplate,
+        VkPipelineLayout                            layout,
+        uint32_t                                    set,
+        const void*                                 pData);
+
     void WriteBufferMarker(
         PipelineStageFlags      pipelineStage,
         VkBuffer                dstBuffer,
         VkDeviceSize            dstOffset,
         uint32_t                marker);
 
+    BreadcrumbRing* GetBreadcrumbRing()
+        { return m_pBreadcrumbs; }
+
+    void MarkBreadcrumbSubmit(
+        const Queue* pQueue,
+        uint64_t     submitId) const;
+
+    void ReportBreadcrumbs(
+        Util::File* pFile,
+        bool        incompleteOnly) const;
+
     void BindTransformFeedbackBuffers(
         uint32_t            firstBinding,
         uint32_t            bindingCount,
@@ -708,7 +860,7 @@ public:
         VK_ASSERT(((m_cbBeginDeviceMask ^ deviceMask) & deviceMask) == 0);
 
         // If called inside a render pass, ensure devices outside of render pass device mask are not enabled
-        VK_ASSERT((m_allGpuState.pRenderPass == nullptr) ||
+        VK_ASSERT(((m_allGpuState.pRenderPass == nullptr) && (m_allGpuState.dynamicRendering.active == false)) ||
                   (((m_rpDeviceMask ^ deviceMask) & deviceMask) == 0));
 
         m_curDeviceMask = deviceMask;
@@ -980,12 +1132,18 @@ public:
     SqttCmdBufferState* GetSqttState()
         { return m_pSqttState; }
 
+    // Returns the SQTT command buffer ID of the last recording, cached at End() for timed submits
+    uint32_t GetSqttCmdBufId() const
+        { return m_sqttCmdBufId; }
+
     VK_INLINE static bool IsStaticStateDifferent(
         uint32_t oldToken,
         uint32_t newToken);
 
     static PFN_vkCmdBindDescriptorSets GetCmdBindDescriptorSetsFunc(const Device* pDevice);
 
+    static PFN_vkCmdPushDescriptorSetKHR GetCmdPushDescriptorSetKHRFunc(const Device* pDevice);
+
     CmdPool* GetCmdPool() const { return m_pCmdPool; }
 
     PerGpuRenderState* PerGpuState(uint32 deviceIdx)
@@ -1073,7 +1231,8 @@ private:
     VK_INLINE void RPBeginSubpass();
     VK_INLINE void RPEndSubpass();
     void RPResolveAttachments(uint32_t count, const RPResolveInfo* pResolves);
-    void RPSyncPoint(const RPSyncPointInfo& syncPoint, VirtualStackFrame* pVirtStack);
+    void RPSyncPoint(const RPSyncPointInfo& syncPoint, uint32_t syncPointIndex, VirtualStackFrame* pVirtStack);
+    void RPReplaySyncPoint(const RPSyncPointProgram& program, VirtualStackFrame* pVirtStack);
     void RPLoadOpClearColor(uint32_t count, const RPLoadOpClearInfo* pClears);
     void RPLoadOpClearDepthStencil(uint32_t count, const RPLoadOpClearInfo* pClears);
     void RPBindTargets(const RPBindTargetsInfo& targets);
@@ -1081,15 +1240,75 @@ private:
 
     void RPInitSamplePattern();
 
+    void RPSetRenderArea(
+        const VkRect2D&                         renderArea,
+        const VkDeviceGroupRenderPassBeginInfo* pDeviceGroupRenderPassBeginInfo);
+
+    void LoadOpClearDynamicRenderingAttachments(const VkRenderingInfoKHR* pRenderingInfo);
+    void BindDynamicRenderingTargets();
+    void ResolveDynamicRenderingAttachments();
+    void DynamicRenderingResolveBarrier(
+        uint32_t                           resolveCount,
+        const DynamicRenderingResolveInfo* pResolves,
+        bool                               preResolve);
+
+    VK_INLINE uint32_t GetRenderingViewMask() const;
+
     VK_INLINE Pal::ImageLayout RPGetAttachmentLayout(uint32_t attachment, uint32_t plane);
     VK_INLINE void RPSetAttachmentLayout(uint32_t attachment, uint32_t plane, Pal::ImageLayout layout);
 
+    bool RPIsAttachmentCleared(
+        uint32_t            attachment,
+        VkImageAspectFlags  aspectMask,
+        const Pal::Box*     pBoxes) const;
+    void RPSetAttachmentCleared(
+        uint32_t            attachment,
+        VkImageAspectFlags  aspectMask,
+        const Pal::Box*     pBoxes);
+    void RPDropAttachmentClearState(uint32_t attachment);
+    uint32_t RPFindAttachmentClearState(uint32_t attachment) const;
+    void RPUpdateAttachmentClearLayouts(uint32_t attachment);
+    Pal::ImageLayout RPResolveUninitializedLayout(uint32_t attachment, uint32_t plane, Pal::ImageLayout layout);
+    void DropImageClearState(const Image* pImage);
+
+    VK_INLINE void InvalidateClearStates()
+        { m_clearStates.entryCount = 0; }
+
+    template <typename ImageBarrierType>
+    void InvalidateClearStates(uint32_t imageBarrierCount, const ImageBarrierType* pImageBarriers);
+
     void FillTimestampQueryPool(
         const TimestampQueryPool& timestampQueryPool,
         const uint32_t            firstQuery,
         const uint32_t            queryCount,
         const uint32_t            timestampChunk);
 
+    // Upper bound on the number of timestamp query results copied without a dispatch (see CopyQueryPoolResults)
+    static constexpr uint32_t MaxDirectTimestampCopies = 32;
+
+    VkResult InitBreadcrumbRing();
+
+    void ResetBreadcrumbRing();
+
+    void RecordBreadcrumb(
+        Pal::HwPipePoint        pipePoint,
+        uint32_t                marker,
+        const Pal::gpusize*     pDstAddr);
+
+    void WaitTimestampQueries(
+        const TimestampQueryPool& timestampQueryPool,
+        uint32_t                  firstQuery,
+        uint32_t                  queryCount);
+
+    void CopyTimestampQueriesDirect(
+        const TimestampQueryPool& timestampQueryPool,
+        uint32_t                  firstQuery,
+        uint32_t                  queryCount,
+        const Buffer*             pDestBuffer,
+        VkDeviceSize              destOffset,
+        VkDeviceSize              destStride,
+        VkQueryResultFlags        flags);
+
     VK_INLINE uint32_t EstimateMaxObjectsOnVirtualStack(size_t objectSize) const;
 
     void ReleaseResources();
@@ -1122,6 +1341,42 @@ private:
     template <uint32_t numPalDevices>
     static PFN_vkCmdBindDescriptorSets GetCmdBindDescriptorSetsFunc(const Device* pDevice);
 
+    uint32_t* GetPushDescriptorShadow(
+        uint32_t                                    deviceIdx,
+        PipelineBindPoint                           apiBindPoint,
+        uint32_t                                    setIdx,
+        uint32_t                                    dwSize);
+
+    void UploadPushDescriptorTable(
+        uint32_t                                    deviceIdx,
+        PipelineBindPoint                           apiBindPoint,
+        const PipelineLayout*                       pLayout,
+        uint32_t                                    setIdx,
+        uint32_t                                    dwSize);
+
+    void BindPushDescriptorSet(
+        Pal::PipelineBindPoint                      palBindPoint,
+        PipelineBindPoint                           apiBindPoint,
+        const PipelineLayout*                       pLayout,
+        uint32_t                                    setIdx);
+
+    template <size_t imageDescSize, size_t samplerDescSize, size_t bufferDescSize>
+    void PushDescriptorSetKHR(
+        VkPipelineBindPoint                         pipelineBindPoint,
+        VkPipelineLayout                            layout,
+        uint32_t                                    set,
+        uint32_t                                    descriptorWriteCount,
+        const VkWriteDescriptorSet*                 pDescriptorWrites);
+
+    template <size_t imageDescSize, size_t samplerDescSize, size_t bufferDescSize>
+    static VKAPI_ATTR void VKAPI_CALL CmdPushDescriptorSetKHR(
+        VkCommandBuffer                             commandBuffer,
+        VkPipelineBindPoint                         pipelineBindPoint,
+        VkPipelineLayout                            layout,
+        uint32_t                                    set,
+        uint32_t                                    descriptorWriteCount,
+        const VkWriteDescriptorSet*                 pDescriptorWrites);
+
     VK_INLINE bool PalPipelineBindingOwnedBy(
         Pal::PipelineBindPoint palBind,
         PipelineBindPoint apiBind
@@ -1186,6 +1441,8 @@ private:
 
     AllGpuRenderState             m_allGpuState; // Render state tracked during command buffer building
 
+    PushDescriptorShadow          m_pushDescShadow[MaxPalDevices][PipelineBindCount];
+
     CmdBufferFlags                m_flags;
     OptimizeCmdbufMode            m_optimizeCmdbufMode;
     uint32_t                      m_asyncComputeQueueMaxWavesPerCu;
@@ -1193,9 +1450,12 @@ private:
     VkResult                      m_recordingResult; // Tracks the result of recording commands to capture OOM errors
 
     SqttCmdBufferState*           m_pSqttState; // Per-cmdbuf state for handling SQ thread-tracing annotations
+    uint32_t                      m_sqttCmdBufId; // SQTT command buffer ID of the last recording
 
     RenderPassInstanceState       m_renderPassInstance;
+    ClearStateTracker             m_clearStates;
     TransformFeedbackState*       m_pTransformFeedbackState;
+    BreadcrumbRing*               m_pBreadcrumbs;
 
 #if VK_ENABLE_DEBUG_BARRIERS
     uint32_t                      m_dbgBarrierPreCmdMask;
@@ -1320,6 +1580,24 @@ void CmdBuffer::RPSetAttachmentLayout(
     m_renderPassInstance.pAttachments[attachment].planeLayout[plane] = layout;
 }
 
+// =====================================================================================================================
+// Returns the view mask of the current subpass or dynamic rendering instance.  A zero mask means multiview is disabled.
+uint32_t CmdBuffer::GetRenderingViewMask() const
+{
+    uint32_t viewMask = 0;
+
+    if (m_allGpuState.pRenderPass != nullptr)
+    {
+        viewMask = m_allGpuState.pRenderPass->GetViewMask(m_renderPassInstance.subpass);
+    }
+    else if (m_allGpuState.dynamicRendering.active)
+    {
+        viewMask = m_allGpuState.dynamicRendering.viewMask;
+    }
+
+    return viewMask;
+}
+
 VK_DEFINE_DISPATCHABLE(CmdBuffer);
 
 namespace entry
@@ -1402,6 +1680,38 @@ VKAPI_ATTR void VKAPI_CALL vkCmdBindDescriptorSets(
     uint32_t                                    dynamicOffsetCount,
     const uint32_t*                             pDynamicOffsets);
 
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawMultiEXT(
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    drawCount,
+    const VkMultiDrawInfoEXT*                   pVertexInfo,
+    uint32_t                                    instanceCount,
+    uint32_t                                    firstInstance,
+    uint32_t                                    stride);
+
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawMultiIndexedEXT(
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    drawCount,
+    const VkMultiDrawIndexedInfoEXT*            pIndexInfo,
+    uint32_t                                    instanceCount,
+    uint32_t                                    firstInstance,
+    uint32_t                                    stride,
+    const int32_t*                              pVertexOffset);
+
+VKAPI_ATTR void VKAPI_CALL vkCmdPushDescriptorSetKHR(
+    VkCommandBuffer                             commandBuffer,
+    VkPipelineBindPoint                         pipelineBindPoint,
+    VkPipelineLayout                            layout,
+    uint32_t                                    set,
+    uint32_t                                    descriptorWriteCount,
+    const VkWriteDescriptorSet*                 pDescriptorWrites);
+
+VKAPI_ATTR void VKAPI_CALL vkCmdPushDescriptorSetWithTemplateKHR(
+    VkCommandBuffer                             commandBuffer,
+    VkDescriptorUpdateTemplate                  descriptorUpdateTemplate,
+    VkPipelineLayout                            layout,
+    uint32_t                                    set,
+    const void*                                 pData);
+
 VKAPI_ATTR void VKAPI_CALL vkCmdBindIndexBuffer(
     VkCommandBuffer                             commandBuffer,
     VkBuffer                                    buffer,
@@ -1676,6 +1986,13 @@ VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderPass2(
     VkCommandBuffer                             commandBuffer,
     const VkSubpassEndInfo*                     pSubpassEndInfo);
 
+VKAPI_ATTR void VKAPI_CALL vkCmdBeginRenderingKHR(
+    VkCommandBuffer                             commandBuffer,
+    const VkRenderingInfoKHR*                   pRenderingInfo);
+
+VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderingKHR(
+    VkCommandBuffer                             commandBuffer);
+
 VKAPI_ATTR void VKAPI_CALL vkCmdExecuteCommands(
     VkCommandBuffer                             commandBuffer,
     uint32_t                                    commandBufferCount,
@@ -1867,6 +2184,26 @@ VKAPI_ATTR void VKAPI_CALL vkCmdSetColorWriteEnableEXT(
     uint32_t                                    attachmentCount,
     const VkBool32*                             pColorWriteEnables);
 
+VKAPI_ATTR void VKAPI_CALL vkCmdSetPatchControlPointsEXT(
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    patchControlPoints);
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetRasterizerDiscardEnableEXT(
+    VkCommandBuffer                             commandBuffer,
+    VkBool32                                    rasterizerDiscardEnable);
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetDepthBiasEnableEXT(
+    VkCommandBuffer                             commandBuffer,
+    VkBool32                                    depthBiasEnable);
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetLogicOpEXT(
+    VkCommandBuffer                             commandBuffer,
+    VkLogicOp                                   logicOp);
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetPrimitiveRestartEnableEXT(
+    VkCommandBuffer                             commandBuffer,
+    VkBool32                                    primitiveRestartEnable);
+
 } // namespace entry
 
 } // namespace vk
@@ -0,0 +1,168 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020-2021 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ ***********************************************************************************************************************
+ * @file  vk_deferred_operation.h
+ * @brief Deferred host operation object related functionality for Vulkan.
+ ***********************************************************************************************************************
+ */
+
+#ifndef __VK_DEFERRED_OPERATION_H__
+#define __VK_DEFERRED_OPERATION_H__
+
+#pragma once
+
+#include "include/khronos/vulkan.h"
+#include "include/vk_dispatch.h"
+#include "include/vk_utils.h"
+
+#include "palEvent.h"
+#include "palMutex.h"
+#include "palThread.h"
+#include "palUtil.h"
+
+namespace vk
+{
+
+class Device;
+
+// =====================================================================================================================
+// Implementation of VkDeferredOperationKHR.  A deferred operation owns a workload which is split into a number of
+// independent work units.  Any thread that joins the operation pulls units off a shared counter until none remain, so
+// the work is spread across however many threads the application (or the driver) chooses to lend it.
+//
+// No command exposed by this driver accepts a VkDeferredOperationKHR (those are the ray tracing pipeline and host
+// acceleration structure commands), so operations created by the application never receive a workload: they are
+// always complete, report a maximum concurrency of zero and a result of VK_SUCCESS.  The driver itself uses the class
+// to spread pipeline batches over the device's DeferredWorkerPool.
+class DeferredHostOperation : public NonDispatchable<VkDeferredOperationKHR, DeferredHostOperation>
+{
+public:
+    // Executes a single work unit of the workload.  Must be safe to call concurrently for distinct unit indices.
+    typedef VkResult (*PfnWorkUnit)(Device* pDevice, void* pPayload, uint32_t unitIdx);
+
+    static VkResult Create(
+        Device*                         pDevice,
+        const VkAllocationCallbacks*    pAllocator,
+        VkDeferredOperationKHR*         pDeferredOperation);
+
+    explicit DeferredHostOperation(Device* pDevice);
+
+    void Destroy(
+        Device*                         pDevice,
+        const VkAllocationCallbacks*    pAllocator);
+
+    void SetWorkload(
+        PfnWorkUnit                     pfnWorkUnit,
+        void*                           pPayload,
+        uint32_t                        unitCount);
+
+    VkResult Join();
+
+    VkResult GetResult() const;
+
+    uint32_t GetMaxConcurrency() const;
+
+    bool IsComplete() const { return (m_completedUnits == m_unitCount); }
+
+private:
+    PAL_DISALLOW_COPY_AND_ASSIGN(DeferredHostOperation);
+
+    Device*             m_pDevice;
+    PfnWorkUnit         m_pfnWorkUnit;      // Work unit callback, or nullptr if nothing has been deferred
+    void*               m_pPayload;         // Opaque workload data passed to every work unit
+    uint32_t            m_unitCount;        // Total number of work units in the workload
+    volatile uint32_t   m_nextUnit;         // Index of the next work unit to hand out to a joining thread
+    volatile uint32_t   m_completedUnits;   // Number of work units which have finished executing
+    volatile int32_t    m_result;           // First failure reported by a work unit, or VK_SUCCESS
+    uint32_t            m_cpuCoreCount;     // Number of logical CPU cores in the system
+};
+
+// =====================================================================================================================
+// A set of driver threads which are kept for the lifetime of a device and lent to the deferred operations the device
+// runs internally, so that spreading a workload over several threads does not cost a thread creation per call.  The
+// pool serves one operation at a time; a caller that finds it busy executes its operation alone.
+class DeferredWorkerPool
+{
+public:
+    // Maximum number of helper threads in a pool
+    static const uint32_t MaxWorkerThreads = 16;
+
+    DeferredWorkerPool();
+    ~DeferredWorkerPool();
+
+    VkResult Init(uint32_t threadCount);
+
+    VkResult Execute(DeferredHostOperation* pOperation);
+
+    uint32_t GetThreadCount() const { return m_threadCount; }
+
+private:
+    PAL_DISALLOW_COPY_AND_ASSIGN(DeferredWorkerPool);
+
+    static void WorkerThreadFunc(void* pParam);
+
+    void WorkerLoop();
+
+    Util::Thread                    m_threads[MaxWorkerThreads];
+    uint32_t                        m_threadCount;
+    Util::Mutex                     m_executeLock;      // Held by the thread whose operation is being served
+    Util::Event                     m_workEvent;        // Manual reset event which is set while an operation is served
+    DeferredHostOperation* volatile m_pOperation;       // Operation being served, or nullptr
+    volatile uint32_t               m_generation;       // Incremented for every served operation
+    volatile uint32_t               m_activeWorkers;    // Number of helpers which may still be inside m_pOperation
+    volatile bool                   m_stop;
+};
+
+namespace entry
+{
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateDeferredOperationKHR(
+    VkDevice                                    device,
+    const VkAllocationCallbacks*                pAllocator,
+    VkDeferredOperationKHR*                     pDeferredOperation);
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyDeferredOperationKHR(
+    VkDevice                                    device,
+    VkDeferredOperationKHR                      operation,
+    const VkAllocationCallbacks*                pAllocator);
+
+VKAPI_ATTR uint32_t VKAPI_CALL vkGetDeferredOperationMaxConcurrencyKHR(
+    VkDevice                                    device,
+    VkDeferredOperationKHR                      operation);
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetDeferredOperationResultKHR(
+    VkDevice                                    device,
+    VkDeferredOperationKHR                      operation);
+
+VKAPI_ATTR VkResult VKAPI_CALL vkDeferredOperationJoinKHR(
+    VkDevice                                    device,
+    VkDeferredOperationKHR                      operation);
+
+} // namespace entry
+
+} // namespace vk
+
+#endif /* __VK_DEFERRED_OPERATION_H__ */
@@ -190,6 +190,9 @@ namespace vk
     // The maximum size of push constants in bytes
     static const uint32_t MaxPushConstants = 128;
 
+    // The maximum number of descriptors that can be written to a push descriptor set (VK_KHR_push_descriptor)
+    static const uint32_t MaxPushDescriptors = 32;
+
     // The default, full stencil write mask
     static const uint8_t StencilWriteMaskFull = 0xFF;
 
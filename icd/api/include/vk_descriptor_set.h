@@ -299,6 +299,15 @@ public:
         uint32_t                        count,
         uint32_t                        dwStride);
 
+    template <size_t imageDescSize, size_t samplerDescSize, size_t bufferDescSize>
+    static void WritePushDescriptors(
+        const Device*                   pDevice,
+        uint32_t                        deviceIdx,
+        const DescriptorSetLayout*      pLayout,
+        uint32_t*                       pDestTable,
+        uint32_t                        descriptorWriteCount,
+        const VkWriteDescriptorSet*     pDescriptorWrites);
+
     static PFN_vkUpdateDescriptorSets GetUpdateDescriptorSetsFunc(const Device* pDevice);
 
 private:
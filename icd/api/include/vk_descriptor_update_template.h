@@ -64,10 +64,20 @@ public:
         VkDescriptorSet descriptorSet,
         const void*     pData);
 
+    void PushUpdate(
+        const Device*   pDevice,
+        uint32_t        deviceIdx,
+        uint32_t*       pDestTable,
+        const void*     pData) const;
+
+    VkPipelineBindPoint GetPipelineBindPoint() const
+        { return m_pipelineBindPoint; }
+
 private:
     PAL_DISALLOW_COPY_AND_ASSIGN(DescriptorUpdateTemplate);
 
     DescriptorUpdateTemplate(
+        VkPipelineBindPoint         pipelineBindPoint,
         uint32_t                    numEntries);
 
     ~DescriptorUpdateTemplate();
@@ -80,9 +90,18 @@ private:
         const void*                 pDescriptorInfo,
         const TemplateUpdateInfo&   entry);
 
+    // Writes a template entry straight into a push descriptor table (VK_KHR_push_descriptor)
+    typedef void(*PfnPushEntry)(
+        const Device*               pDevice,
+        uint32_t                    deviceIdx,
+        uint32_t*                   pDestTable,
+        const void*                 pDescriptorInfo,
+        const TemplateUpdateInfo&   entry);
+
     struct TemplateUpdateInfo
     {
         PfnUpdateEntry  pFunc;
+        PfnPushEntry    pPushFunc;
         size_t          srcOffset;
         size_t          srcStride;
         size_t          dstStaOffset;
@@ -118,6 +137,16 @@ private:
         VkDescriptorType                        descriptorType,
         const DescriptorSetLayout::BindingInfo& dstBinding);
 
+    template <size_t imageDescSize, size_t samplerDescSize, size_t bufferDescSize>
+    static PfnPushEntry GetPushEntryFunc(
+        VkDescriptorType                        descriptorType,
+        const DescriptorSetLayout::BindingInfo& dstBinding);
+
+    static PfnPushEntry GetPushEntryFunc(
+        const Device*                           pDevice,
+        VkDescriptorType                        descriptorType,
+        const DescriptorSetLayout::BindingInfo& dstBinding);
+
     template <size_t imageDescSize, size_t fmaskDescSize,  bool updateFmask, bool isShaderStorageDesc,
         uint32_t numPalDevices>
     static void UpdateEntrySampledImage(
@@ -162,6 +191,47 @@ private:
             const void*                 pDescriptorInfo,
             const TemplateUpdateInfo&   entry);
 
+    template <size_t imageDescSize, bool isShaderStorageDesc>
+    static void PushEntrySampledImage(
+            const Device*               pDevice,
+            uint32_t                    deviceIdx,
+            uint32_t*                   pDestTable,
+            const void*                 pDescriptorInfo,
+            const TemplateUpdateInfo&   entry);
+
+    template <size_t samplerDescSize>
+    static void PushEntrySampler(
+            const Device*               pDevice,
+            uint32_t                    deviceIdx,
+            uint32_t*                   pDestTable,
+            const void*                 pDescriptorInfo,
+            const TemplateUpdateInfo&   entry);
+
+    template <size_t bufferDescSize, VkDescriptorType descriptorType>
+    static void PushEntryBuffer(
+            const Device*               pDevice,
+            uint32_t                    deviceIdx,
+            uint32_t*                   pDestTable,
+            const void*                 pDescriptorInfo,
+            const TemplateUpdateInfo&   entry);
+
+    template <size_t bufferDescSize, VkDescriptorType descriptorType>
+    static void PushEntryTexelBuffer(
+            const Device*               pDevice,
+            uint32_t                    deviceIdx,
+            uint32_t*                   pDestTable,
+            const void*                 pDescriptorInfo,
+            const TemplateUpdateInfo&   entry);
+
+    template <size_t imageDescSize, size_t samplerDescSize, bool immutable, bool ycbcrUsage>
+    static void PushEntryCombinedImageSampler(
+            const Device*               pDevice,
+            uint32_t                    deviceIdx,
+            uint32_t*                   pDestTable,
+            const void*                 pDescriptorInfo,
+            const TemplateUpdateInfo&   entry);
+
+    VkPipelineBindPoint         m_pipelineBindPoint;
     uint32_t                    m_numEntries;
 };
 
@@ -83,9 +83,12 @@ namespace vk
 // Forward declarations of Vulkan classes used in this file.
 class BarrierFilterLayer;
 class Buffer;
+class CmdBuffer;
+class DeferredWorkerPool;
 class Device;
 class DispatchableDevice;
 class DispatchableQueue;
+class GpuAddressMap;
 class Instance;
 class OptLayer;
 class PhysicalDevice;
@@ -105,6 +108,15 @@ struct ImportSemaphoreInfo
     VkSemaphoreImportFlags                importFlags;
 };
 
+// =====================================================================================================================
+// Semaphores chaining the software compositing copy of one frame from a non-presenting device.  Each intermediate image
+// of the compositing ring has its own set, so consecutive frames never share a semaphore.
+struct SwCompositingSync
+{
+    Pal::IQueueSemaphore* pRenderDone; // Orders the copy on the transfer queue after rendering of the source image
+    Pal::IQueueSemaphore* pCopyDone;   // Orders the present after the copy into the intermediate image
+};
+
 // =====================================================================================================================
 class Device
 {
@@ -565,6 +577,12 @@ public:
     VK_INLINE AsyncLayer* GetAsyncLayer()
         { return m_pAsyncLayer; }
 
+    VK_INLINE GpuAddressMap* GetGpuAddressMap() const
+        { return m_pGpuAddressMap; }
+
+    VK_INLINE DeferredWorkerPool* GetPipelineBatchPool() const
+        { return m_pPipelineBatchPool; }
+
     VK_INLINE Util::Mutex* GetMemoryMutex()
         { return &m_memoryMutex; }
 
@@ -579,6 +597,44 @@ public:
     VK_INLINE RenderStateCache* GetRenderStateCache()
         { return &m_renderStateCache; }
 
+    // Memory requirements of an image described only by its create info (VK_KHR_maintenance4)
+    struct ImageMemoryRequirements
+    {
+        VkMemoryRequirements memoryRequirements;
+        bool                 dedicatedRequired;
+    };
+
+    // Every part of an image create info that can affect the image's memory requirements.  Keys are zero-initialized
+    // before being filled so that they can be hashed and compared as raw memory.
+    struct ImageMemoryRequirementsKey
+    {
+        static constexpr uint32_t MaxViewFormats = 8;
+
+        VkImageCreateFlags                 flags;
+        VkImageType                        imageType;
+        VkFormat                           format;
+        VkExtent3D                         extent;
+        uint32_t                           mipLevels;
+        uint32_t                           arrayLayers;
+        VkSampleCountFlagBits              samples;
+        VkImageTiling                      tiling;
+        VkImageUsageFlags                  usage;
+        VkImageAspectFlagBits              planeAspect;
+        VkExternalMemoryHandleTypeFlags    externalHandleTypes;
+        VkImageUsageFlags                  stencilUsage;
+        uint32_t                           chainedStructMask;   // Which of the optional structures were chained
+        uint32_t                           viewFormatCount;
+        VkFormat                           viewFormats[MaxViewFormats];
+    };
+
+    bool FindImageMemoryRequirements(
+        const ImageMemoryRequirementsKey& key,
+        ImageMemoryRequirements*          pRequirements);
+
+    void CacheImageMemoryRequirements(
+        const ImageMemoryRequirementsKey& key,
+        const ImageMemoryRequirements&    requirements);
+
     uint32_t GetPinnedSystemMemoryTypes() const;
 
     uint32_t GetPinnedHostMappedForeignMemoryTypes() const;
@@ -619,11 +675,12 @@ public:
     }
 
     Pal::IQueue* PerformSwCompositing(
-        uint32_t         deviceIdx,
-        uint32_t         presentationDeviceIdx,
-        Pal::ICmdBuffer* pCommandBuffer,
-        Pal::QueueType   cmdBufferQueueType,
-        const Queue*     pQueue);
+        uint32_t                 deviceIdx,
+        uint32_t                 presentationDeviceIdx,
+        Pal::ICmdBuffer*         pCommandBuffer,
+        Pal::QueueType           cmdBufferQueueType,
+        const Queue*             pQueue,
+        const SwCompositingSync* pSync);
 
     VkResult SwCompositingNotifyFlipMetadata(
         Pal::IQueue*            pPresentQueue,
@@ -670,6 +727,11 @@ public:
     void ReleaseBorderColorIndex(
         uint32_t                 pBorderColor);
 
+    void RegisterBreadcrumbs(CmdBuffer* pCmdBuffer);
+    void UnregisterBreadcrumbs(CmdBuffer* pCmdBuffer);
+    void ReportBreadcrumbs();
+    uint64 NextBreadcrumbSubmitId();
+
     VK_INLINE Pal::IBorderColorPalette* GetPalBorderColorPalette(uint32_t deviceIdx) const
     {
         return m_perGpu[deviceIdx].pPalBorderColorPalette;
@@ -759,6 +821,9 @@ protected:
     DispatchTable                       m_dispatchTable;           // Device dispatch table
     SqttMgr*                            m_pSqttMgr;                // Manager for developer mode SQ thread tracing
     AsyncLayer*                         m_pAsyncLayer;             // State for async compiler layer, otherwise null
+    GpuAddressMap*                      m_pGpuAddressMap;          // GPU address to object map, otherwise null
+    DeferredWorkerPool*                 m_pPipelineBatchPool;      // Helper threads for pipeline batches, otherwise
+                                                                   // null
     OptLayer*                           m_pAppOptLayer;            // State for an app-specific layer, otherwise null
     BarrierFilterLayer*                 m_pBarrierFilterLayer;     // State for enabling barrier filtering, otherwise
                                                                    // null
@@ -821,6 +886,27 @@ protected:
     bool*                               m_pBorderColorUsedIndexes;
     Util::Mutex                         m_borderColorMutex;
 
+    // Command buffers that own a breadcrumb ring, so their progress can be reported after a device loss
+    CmdBuffer*                          m_pBreadcrumbCmdBuffers;
+    Util::Mutex                         m_breadcrumbLock;
+    volatile uint64                     m_nextBreadcrumbSubmitId;
+
+    // Image memory requirements queried without an image object.  Entries are looked up by a hash of the key and keep
+    // the key itself, which is compared on every hit so that a hash collision can't return another image's
+    // requirements.
+    struct ImageMemoryRequirementsEntry
+    {
+        ImageMemoryRequirementsKey key;
+        ImageMemoryRequirements    requirements;
+    };
+
+    typedef Util::HashMap<uint64_t, ImageMemoryRequirementsEntry, PalAllocator> ImageMemoryRequirementsMap;
+
+    static constexpr uint32_t           MaxCachedImageMemoryRequirements = 4096;
+
+    ImageMemoryRequirementsMap          m_imageMemReqsCache;
+    Util::RWLock                        m_imageMemReqsLock;
+
     // This goes last.  The memory for the rest of the array is calculated dynamically based on the number of GPUs in
     // use.
     PerGpuInfo              m_perGpu[1];
@@ -212,6 +212,7 @@ public:
         EXT_DEBUG_UTILS,
         EXT_DIRECT_MODE_DISPLAY,
         EXT_DISPLAY_SURFACE_COUNTER,
+        EXT_HEADLESS_SURFACE,
         EXT_SWAPCHAIN_COLORSPACE,
         Count
     };
@@ -236,9 +237,11 @@ public:
         KHR_BUFFER_DEVICE_ADDRESS,
         KHR_CREATE_RENDERPASS2,
         KHR_DEDICATED_ALLOCATION,
+        KHR_DEFERRED_HOST_OPERATIONS,
         KHR_DEPTH_STENCIL_RESOLVE,
         KHR_DESCRIPTOR_UPDATE_TEMPLATE,
         KHR_DEVICE_GROUP,
+        KHR_DYNAMIC_RENDERING,
         KHR_DRAW_INDIRECT_COUNT,
         KHR_DRIVER_PROPERTIES,
         KHR_EXTERNAL_FENCE,
@@ -258,8 +261,13 @@ public:
         KHR_MAINTENANCE1,
         KHR_MAINTENANCE2,
         KHR_MAINTENANCE3,
+        KHR_MAINTENANCE4,
         KHR_MULTIVIEW,
         KHR_PIPELINE_EXECUTABLE_PROPERTIES,
+        KHR_PIPELINE_LIBRARY,
+        KHR_PRESENT_ID,
+        KHR_PRESENT_WAIT,
+        KHR_PUSH_DESCRIPTOR,
         KHR_RELAXED_BLOCK_LAYOUT,
         KHR_SAMPLER_MIRROR_CLAMP_TO_EDGE,
         KHR_SAMPLER_YCBCR_CONVERSION,
@@ -295,9 +303,11 @@ public:
         EXT_DEPTH_RANGE_UNRESTRICTED,
         EXT_DESCRIPTOR_INDEXING,
         EXT_EXTENDED_DYNAMIC_STATE,
+        EXT_EXTENDED_DYNAMIC_STATE2,
         EXT_EXTERNAL_MEMORY_DMA_BUF,
         EXT_EXTERNAL_MEMORY_HOST,
         EXT_GLOBAL_PRIORITY,
+        EXT_GRAPHICS_PIPELINE_LIBRARY,
         EXT_HDR_METADATA,
         EXT_HOST_QUERY_RESET,
         EXT_IMAGE_ROBUSTNESS,
@@ -305,6 +315,7 @@ public:
         EXT_LINE_RASTERIZATION,
         EXT_MEMORY_BUDGET,
         EXT_MEMORY_PRIORITY,
+        EXT_MULTI_DRAW,
         EXT_PCI_BUS_INFO,
         EXT_PIPELINE_CREATION_CACHE_CONTROL,
         EXT_PIPELINE_CREATION_FEEDBACK,
@@ -318,6 +329,7 @@ public:
         EXT_SEPARATE_STENCIL_USAGE,
         EXT_SHADER_DEMOTE_TO_HELPER_INVOCATION,
         EXT_SHADER_IMAGE_ATOMIC_INT64,
+        EXT_SHADER_MODULE_IDENTIFIER,
         EXT_SHADER_STENCIL_EXPORT,
         EXT_SHADER_SUBGROUP_BALLOT,
         EXT_SHADER_SUBGROUP_VOTE,
@@ -31,13 +31,17 @@
 #include "include/khronos/vulkan.h"
 #include "include/vk_dispatch.h"
 
+#include "palMutex.h"
 #include "palVector.h"
 
 namespace vk
 {
 
+class Device;
 class Image;
 class ImageView;
+class RenderPass;
+struct RPInstanceProgram;
 
 // =====================================================================================================================
 // Implementation of a Vulkan framebuffer (VkFramebuffer)
@@ -95,20 +99,37 @@ public:
         return m_globalScissorParams;
     }
 
+    static void InitAttachment(
+        const ImageView*       pView,
+        const RuntimeSettings& settings,
+        Attachment*            pAttachment);
+
+    const RPInstanceProgram* GetRenderPassProgram(
+        const Device*     pDevice,
+        const RenderPass* pRenderPass,
+        uint32_t          queueFamilyIndex);
+
+    void ReleaseRenderPassProgram(
+        const Device*            pDevice,
+        const RPInstanceProgram* pProgram);
+
 protected:
     Framebuffer(const VkFramebufferCreateInfo& info, Attachment* pAttachments, const RuntimeSettings& runTimeSettings);
 
 private:
     PAL_DISALLOW_COPY_AND_ASSIGN(Framebuffer);
 
-    VK_INLINE void SetImageViews(
-        const VkImageView& imageView,
-        Attachment*        pAttachments);
-
-    VK_INLINE void SetSubresRanges(
+    VK_INLINE static void SetSubresRanges(
         const Image* pImage,
         Attachment*  pAttachment);
 
+    RPInstanceProgram* BuildRenderPassProgram(
+        const Device*     pDevice,
+        const RenderPass* pRenderPass,
+        uint32_t          queueFamilyIndex) const;
+
+    void EvictRenderPassProgram(const Device* pDevice);
+
     // Get the start address of the first Attachment object relative to the start of a Framebuffer object.
     VK_INLINE static size_t GetAttachmentsOffset()
     {
@@ -117,9 +138,18 @@ private:
         return Util::Pow2Align(sizeof(Framebuffer), alignof(Attachment));
     }
 
+    // Limits the number of render passes whose sync points are precompiled for one framebuffer
+    static constexpr uint32_t MaxRenderPassPrograms = 4;
+
     const uint32_t            m_attachmentCount;
     Pal::GlobalScissorParams  m_globalScissorParams;
     const RuntimeSettings&    m_settings;
+    const bool                m_imageless;          // Attachments are given at each render pass begin
+
+    Util::Mutex               m_programLock;        // Serializes access to the precompiled programs below
+    RPInstanceProgram*        m_pPrograms;          // Precompiled render pass sync points, most recently used first
+    uint32_t                  m_programCount;
+    RPInstanceProgram*        m_pRetiredPrograms;   // Evicted programs still referenced by a render pass instance
 };
 
 namespace entry
@@ -0,0 +1,122 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2014-2021 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ ***********************************************************************************************************************
+ * @file  vk_graphics_pipeline_library.h
+ * @brief Graphics pipeline library objects (VK_KHR_pipeline_library and VK_EXT_graphics_pipeline_library).
+ ***********************************************************************************************************************
+ */
+
+#ifndef __VK_GRAPHICS_PIPELINE_LIBRARY_H__
+#define __VK_GRAPHICS_PIPELINE_LIBRARY_H__
+
+#pragma once
+
+#include "include/vk_pipeline.h"
+#include "include/vk_shader_code.h"
+
+namespace vk
+{
+
+class Device;
+class PipelineCache;
+
+// Mask of all graphics pipeline library parts, i.e. a complete graphics pipeline
+constexpr VkGraphicsPipelineLibraryFlagsEXT GraphicsPipelineLibraryAll =
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT    |
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT |
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT           |
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+// =====================================================================================================================
+// Graphics pipeline create info assembled from the parts provided by a set of pipeline libraries and the create info
+// that references them.  All pointers refer either to this structure, to the libraries or to the application's create
+// info, so it is only valid while those are alive.
+struct GraphicsPipelineLinkInfo
+{
+    VkGraphicsPipelineCreateInfo            createInfo;
+    VkGraphicsPipelineLibraryFlagsEXT       libraryFlags;     // Parts present in createInfo
+
+    VkPipelineShaderStageCreateInfo         stages[ShaderStage::ShaderStageGfxCount];
+    VkPipelineDynamicStateCreateInfo        dynamicState;
+    VkDynamicState                          dynamicStates[static_cast<uint32_t>(
+                                                DynamicStatesInternal::DynamicStatesInternalCount) + 8];
+    VkPipelineRenderingCreateInfoKHR        renderingInfo;
+    VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo;
+    VkPipelineCreationFeedbackEXT           stageFeedback[ShaderStage::ShaderStageGfxCount];
+};
+
+// =====================================================================================================================
+// A graphics pipeline library holds a subset of graphics pipeline state.  Libraries are never bound; a complete
+// pipeline is linked from them by vkCreateGraphicsPipelines with VkPipelineLibraryCreateInfoKHR.
+//
+// The library keeps a deep copy of the create info for the parts it contains, along with its own shader modules and its
+// own copies of the pipeline layout and render pass, so that the application is free to destroy any of those objects
+// once the library has been created.  The shader parts are compiled at library creation, leaving the link to combine
+// them with the state of the other parts.
+class GraphicsPipelineLibrary final : public Pipeline, public NonDispatchable<VkPipeline, GraphicsPipelineLibrary>
+{
+public:
+    static VkResult Create(
+        Device*                                 pDevice,
+        PipelineCache*                          pPipelineCache,
+        const VkGraphicsPipelineCreateInfo*     pCreateInfo,
+        const VkAllocationCallbacks*            pAllocator,
+        VkPipeline*                             pPipeline);
+
+    static bool BuildLinkInfo(
+        const VkGraphicsPipelineCreateInfo*     pCreateInfo,
+        GraphicsPipelineLinkInfo*               pLinkInfo);
+
+    VkResult Destroy(
+        Device*                                 pDevice,
+        const VkAllocationCallbacks*            pAllocator) override;
+
+    VkGraphicsPipelineLibraryFlagsEXT GetLibraryFlags() const
+        { return m_libraryFlags; }
+
+    const VkGraphicsPipelineCreateInfo& GetCreateInfo() const
+        { return m_createInfo; }
+
+protected:
+    GraphicsPipelineLibrary(
+        Device*                                 pDevice,
+        VkGraphicsPipelineLibraryFlagsEXT       libraryFlags);
+
+    virtual ~GraphicsPipelineLibrary() { }
+
+private:
+    PAL_DISALLOW_COPY_AND_ASSIGN(GraphicsPipelineLibrary);
+
+    VkGraphicsPipelineLibraryFlagsEXT   m_libraryFlags;                                  // Parts held by this library
+    VkGraphicsPipelineCreateInfo        m_createInfo;                                    // Deep copy of those parts
+    VkShaderModule                      m_shaderModules[ShaderStage::ShaderStageGfxCount]; // Modules owned by the library
+    VkPipelineLayout                    m_layout;                                        // Copy of the layout
+    VkRenderPass                        m_renderPass;                                    // Copy of the render pass
+};
+
+} // namespace vk
+
+#endif /* __VK_GRAPHICS_PIPELINE_LIBRARY_H__ */
@@ -97,6 +97,13 @@ public:
         const uint32_t*                         pQueueFamilyIndices,
         VkDeviceMemory*                         pDeviceMemory);
 
+    static VkResult CreateHeadlessPresentableImage(
+        Device*                                 pDevice,
+        const VkImageCreateInfo*                pCreateInfo,
+        const VkAllocationCallbacks*            pAllocator,
+        VkImage*                                pImage,
+        VkDeviceMemory*                         pDeviceMemory);
+
     VkResult Destroy(
         Device*                         pDevice,
         const VkAllocationCallbacks*    pAllocator);
@@ -133,6 +140,17 @@ public:
         uint32_t*                                           pNumRequirements,
         utils::ArrayView<VkSparseImageMemoryRequirements>   sparseMemoryRequirements);
 
+    static void CalculateMemoryRequirements(
+        Device*                                   pDevice,
+        const VkDeviceImageMemoryRequirementsKHR* pInfo,
+        VkMemoryRequirements2*                    pMemoryRequirements);
+
+    static void CalculateSparseMemoryRequirements(
+        Device*                                   pDevice,
+        const VkDeviceImageMemoryRequirementsKHR* pInfo,
+        uint32_t*                                 pSparseMemoryRequirementCount,
+        VkSparseImageMemoryRequirements2*         pSparseMemoryRequirements);
+
     VK_FORCEINLINE Pal::IImage* PalImage(int32_t idx) const
        { return m_perGpu[idx].pPalImage; }
 
@@ -197,6 +215,12 @@ public:
         const CmdBuffer*     pCmdBuffer
         ) const;
 
+    Pal::ImageLayout GetAttachmentLayout(
+        const RPImageLayout& layout,
+        uint32_t             plane,
+        uint32_t             queueFamilyIndex
+        ) const;
+
     bool DedicatedMemoryRequired() const { return m_internalFlags.dedicatedRequired; }
 
     VK_FORCEINLINE const ImageBarrierPolicy& GetBarrierPolicy() const
@@ -407,6 +431,17 @@ VKAPI_ATTR void VKAPI_CALL vkGetImageSparseMemoryRequirements2(
     uint32_t*                                   pSparseMemoryRequirementCount,
     VkSparseImageMemoryRequirements2*           pSparseMemoryRequirements);
 
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceImageMemoryRequirementsKHR(
+    VkDevice                                    device,
+    const VkDeviceImageMemoryRequirementsKHR*   pInfo,
+    VkMemoryRequirements2*                      pMemoryRequirements);
+
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceImageSparseMemoryRequirementsKHR(
+    VkDevice                                    device,
+    const VkDeviceImageMemoryRequirementsKHR*   pInfo,
+    uint32_t*                                   pSparseMemoryRequirementCount,
+    VkSparseImageMemoryRequirements2*           pSparseMemoryRequirements);
+
 } // namespace entry
 
 } // namespace vk
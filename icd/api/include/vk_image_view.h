@@ -32,6 +32,7 @@
 #include "include/vk_defines.h"
 #include "include/vk_dispatch.h"
 #include "include/vk_utils.h"
+#include "include/vk_framebuffer.h"
 #include "include/vk_image.h"
 
 namespace vk
@@ -95,6 +96,9 @@ public:
     VK_INLINE bool NeedsFmaskViewSrds() const
         { return m_needsFmaskViewSrds; }
 
+    VK_INLINE const Framebuffer::Attachment& GetFramebufferAttachment() const
+        { return m_fbAttachment; }
+
 protected:
     static VK_INLINE void BuildImageSrds(
         const Device*                pDevice,
@@ -165,6 +169,9 @@ protected:
     Pal::IColorTargetView*  m_pColorTargetViews[MaxPalDevices];
     Pal::IDepthStencilView* m_pDepthStencilViews[MaxPalDevices];
 
+    Framebuffer::Attachment m_fbAttachment; // Attachment info for this view, built once at creation so that
+                                            // imageless framebuffers and dynamic rendering only need to copy it
+
 private:
     PAL_DISALLOW_COPY_AND_ASSIGN(ImageView);
 };
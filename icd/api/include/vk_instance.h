@@ -291,6 +291,47 @@ private:
 
     void UpdateSettingsWithAppProfile(RuntimeSettings* pSettings);
 
+    // Copy of the callback information of one registered debug report callback
+    struct DebugReportEntry
+    {
+        VkDebugReportFlagsEXT                flags;
+        PFN_vkDebugReportCallbackEXT         pfnCallback;
+        void*                                pUserData;
+    };
+
+    // Copy of the callback information of one registered debug utils messenger
+    struct DebugMessengerEntry
+    {
+        VkDebugUtilsMessageSeverityFlagsEXT  severityFlags;
+        VkDebugUtilsMessageTypeFlagsEXT      typeFlags;
+        PFN_vkDebugUtilsMessengerCallbackEXT pfnCallback;
+        void*                                pUserData;
+    };
+
+    // Immutable snapshot of all registered debug callbacks.  Messages are dispatched from the current snapshot without
+    // taking any lock; registration publishes a new snapshot and retires the previous one, which is only reused once no
+    // thread reads it anymore.  Snapshots are only freed with the instance, so a thread may briefly count itself as a
+    // reader of a snapshot that has just been replaced.
+    struct DebugCallbackSnapshot
+    {
+        volatile uint32_t       readerCount;     // Number of threads currently dispatching from this snapshot
+        uint32_t                capacity;        // Number of entries of either kind the snapshot has room for
+        uint32_t                reportCount;
+        uint32_t                messengerCount;
+        DebugReportEntry*       pReports;
+        DebugMessengerEntry*    pMessengers;
+        DebugCallbackSnapshot*  pNextRetired;    // Next snapshot in the list of replaced snapshots
+    };
+
+    DebugCallbackSnapshot* AcquireDebugCallbacks();
+    void ReleaseDebugCallbacks(DebugCallbackSnapshot* pSnapshot);
+    VkResult PublishDebugCallbacks();
+    void ReplaceDebugCallbacks(
+        DebugCallbackSnapshot*              pSnapshot,
+        VkDebugReportFlagsEXT               reportFlags,
+        VkDebugUtilsMessageSeverityFlagsEXT severityFlags,
+        VkDebugUtilsMessageTypeFlagsEXT     typeFlags);
+
     Pal::IPlatform*                     m_pPalPlatform;             // Pal Platform object.
     VkAllocationCallbacks               m_allocCallbacks;
 
@@ -345,12 +386,17 @@ private:
                                                                                         // Report Callbacks
     Util::List<DebugUtilsMessenger*, PalAllocator>  m_debugUtilsMessengers;             // List of registered Debug
                                                                                         // Utils Messengers
-    Util::Mutex                                     m_logCallbackInternalOnlyMutex;     // Serialize internal log
-                                                                                        // message translation prior
-                                                                                        // to calling external callbacks
-    Util::Mutex                                     m_logCallbackInternalExternalMutex; // Serialize all calls to
-                                                                                        // external callbacks from
-                                                                                        // internal and external sources
+    Util::Mutex                                     m_debugCallbackMutex;               // Serializes registration
+                                                                                        // changes
+    DebugCallbackSnapshot* volatile                 m_pDebugCallbacks;                  // Current snapshot of the
+                                                                                        // above lists, if not empty
+    DebugCallbackSnapshot*                          m_pRetiredDebugCallbacks;           // Replaced snapshots
+
+    // Union of the flags all registered callbacks subscribed to, so that unwanted messages are dropped before they
+    // are formatted or dispatched
+    volatile VkDebugReportFlagsEXT                  m_debugReportFlags;
+    volatile VkDebugUtilsMessageSeverityFlagsEXT    m_debugMessengerSeverityFlags;
+    volatile VkDebugUtilsMessageTypeFlagsEXT        m_debugMessengerTypeFlags;
 
     // The ratified extensions (including instance and device) under developing could be enabled by environmental
     // variable, AMDVLK_ENABLE_DEVELOPING_EXT.
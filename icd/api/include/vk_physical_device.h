@@ -702,6 +702,8 @@ protected:
 
     void InitializePlatformKey(const RuntimeSettings& settings);
 
+    void GetHeadlessSwapChainProperties(Pal::SwapChainProperties* pSwapChainProperties) const;
+
     VK_FORCEINLINE bool IsPerChannelMinMaxFilteringSupported() const
     {
         return m_properties.gfxipProperties.flags.supportPerChannelMinMaxFilter;
@@ -122,6 +122,9 @@ enum class DynamicStatesInternal : uint32_t
     StencilTestEnableExt,
     StencilOpExt,
     ColorWriteEnableExt,
+    RasterizerDiscardEnableExt,
+    DepthBiasEnableExt,
+    PrimitiveRestartEnableExt,
     DynamicStatesInternalCount
 };
 
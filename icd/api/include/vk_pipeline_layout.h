@@ -127,6 +127,11 @@ public:
         const VkAllocationCallbacks*        pAllocator,
         VkPipelineLayout*                   pPipelineLayout);
 
+    VkResult Clone(
+        Device*                             pDevice,
+        const VkAllocationCallbacks*        pAllocator,
+        VkPipelineLayout*                   pPipelineLayout) const;
+
     VkResult Destroy(
         Device*                             pDevice,
         const VkAllocationCallbacks*        pAllocator);
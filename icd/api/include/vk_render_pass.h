@@ -91,6 +91,8 @@ struct AttachmentDescription
     VkImageLayout                   finalLayout;
     VkImageLayout                   stencilInitialLayout;
     VkImageLayout                   stencilFinalLayout;
+    Pal::SwizzledFormat             palFormat;          // PAL format of the attachment, resolved at render pass
+                                                        // creation so bound target clears don't convert it again
 };
 
 struct SubpassSampleCount
@@ -219,6 +221,11 @@ public:
         const VkAllocationCallbacks*        pAllocator,
         VkRenderPass*                       pRenderPass);
 
+    VkResult Clone(
+        Device*                             pDevice,
+        const VkAllocationCallbacks*        pAllocator,
+        VkRenderPass*                       pRenderPass) const;
+
     RenderPass(
         const RenderPassCreateInfo*     pCreateInfo,
         const RenderPassExecuteInfo*    pExecuteInfo);
@@ -230,6 +237,8 @@ public:
     VkFormat GetColorAttachmentFormat(uint32_t subPassIndex, uint32_t colorTarget) const;
     VkFormat GetDepthStencilAttachmentFormat(uint32_t subPassIndex) const;
 
+    Pal::SwizzledFormat GetColorAttachmentPalFormat(uint32_t subPassIndex, uint32_t colorTarget) const;
+
     uint32_t GetColorAttachmentSamples(uint32_t subPassIndex, uint32_t colorTarget) const;
     uint32_t GetDepthStencilAttachmentSamples(uint32_t subPassIndex) const;
     VK_INLINE VkResolveModeFlagBits GetDepthResolveMode(uint32_t subpass) const
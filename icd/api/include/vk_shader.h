@@ -67,7 +67,16 @@ public:
     const void* GetCode() const { return m_pCode; }
     const ShaderModuleHandle* GetShaderModuleHandle() const { return &m_handle; }
 
-    Pal::ShaderHash GetCodeHash(const char* pEntryPoint) const;
+    Pal::ShaderHash GetCodeHash(const char* pEntryPoint) const
+        { return GetCodeHash(m_codeHash, pEntryPoint); }
+
+    void GetIdentifier(ShaderModuleIdentifier* pIdentifier) const;
+
+    static Pal::ShaderHash GetCodeHash(Pal::ShaderHash codeHash, const char* pEntryPoint);
+
+    static void BuildIdentifier(size_t codeSize, const void* pCode, ShaderModuleIdentifier* pIdentifier);
+
+    static bool GetStageIdentifier(const VkPipelineShaderStageCreateInfo& stage, ShaderModuleIdentifier* pIdentifier);
 
     void* GetShaderData(PipelineCompilerType compilerType) const
     {
@@ -99,6 +108,16 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyShaderModule(
     VkShaderModule                              shaderModule,
     const VkAllocationCallbacks*                pAllocator);
 
+VKAPI_ATTR void VKAPI_CALL vkGetShaderModuleIdentifierEXT(
+    VkDevice                                    device,
+    VkShaderModule                              shaderModule,
+    VkShaderModuleIdentifierEXT*                pIdentifier);
+
+VKAPI_ATTR void VKAPI_CALL vkGetShaderModuleCreateInfoIdentifierEXT(
+    VkDevice                                    device,
+    const VkShaderModuleCreateInfo*             pCreateInfo,
+    VkShaderModuleIdentifierEXT*                pIdentifier);
+
 } // namespace entry
 
 } // namespace vk
@@ -29,6 +29,8 @@
 #include "vk_instance.h"
 #include "vkgcDefs.h"
 
+#include "palPipeline.h"
+
 namespace vk
 {
 
@@ -36,6 +38,14 @@ typedef Vkgc::ShaderStage ShaderStage;
 #define ShaderStageTessEvaluation ShaderStageTessEval
 constexpr uint32_t ShaderStageCount = ShaderStage::ShaderStageCount;
 
+// Identifies the SPIR-V of a shader module without the code itself (VK_EXT_shader_module_identifier).  It carries what
+// pipeline hashing and the pipeline profile key need to know about the module.
+struct ShaderModuleIdentifier
+{
+    Pal::ShaderHash codeHash;   // Hash of the SPIR-V code, excluding any entry point
+    uint64_t        codeSize;   // Size of the SPIR-V code in bytes
+};
+
 /// Translate shader stage flag bits to corresponding shader stage.
 VK_INLINE ShaderStage ShaderFlagBitToStage(const VkShaderStageFlagBits& shaderBits)
 {
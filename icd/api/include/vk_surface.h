@@ -55,6 +55,7 @@ public:
         VkIcdSurfaceXlib*    GetXlibSurface() { return &m_xlibSurface; }
 #endif
         VkIcdSurfaceDisplay* GetDisplaySurface() { return &m_displaySurface; }
+        VkIcdSurfaceHeadless* GetHeadlessSurface() { return &m_headlessSurface; }
 #ifdef VK_USE_PLATFORM_WAYLAND_KHR
         VkIcdSurfaceWayland*  GetWaylandSurface() { return &m_waylandSurface; }
 #endif
@@ -76,6 +77,14 @@ protected:
     {
     }
 
+    Surface(Instance*               pInstance,
+        const VkIcdSurfaceHeadless& headlessSurface)
+        :
+        m_headlessSurface(headlessSurface),
+        m_pInstance(pInstance)
+    {
+    }
+
 #ifdef VK_USE_PLATFORM_XCB_KHR
     Surface(Instance*           pInstance,
         const VkIcdSurfaceXcb&  xcbSurface)
@@ -115,6 +124,7 @@ protected:
         VkIcdSurfaceXlib    m_xlibSurface;
 #endif
         VkIcdSurfaceDisplay m_displaySurface;
+        VkIcdSurfaceHeadless m_headlessSurface;
 #ifdef VK_USE_PLATFORM_WAYLAND_KHR
         VkIcdSurfaceWayland m_waylandSurface;
 #endif
@@ -162,6 +172,12 @@ namespace entry
         const VkAllocationCallbacks*                pAllocator,
         VkSurfaceKHR*                               pSurface);
 
+    VKAPI_ATTR VkResult VKAPI_CALL vkCreateHeadlessSurfaceEXT(
+        VkInstance                                  instance,
+        const VkHeadlessSurfaceCreateInfoEXT*       pCreateInfo,
+        const VkAllocationCallbacks*                pAllocator,
+        VkSurfaceKHR*                               pSurface);
+
 VKAPI_ATTR void VKAPI_CALL vkDestroySurfaceKHR(
     VkInstance                                  instance,
     VkSurfaceKHR                                surface,
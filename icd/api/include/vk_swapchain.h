@@ -40,6 +40,8 @@
 #include "include/vk_image.h"
 #include "include/vk_utils.h"
 
+#include "palEvent.h"
+#include "palMutex.h"
 #include "palQueue.h"
 #include "palSwapChain.h"
 
@@ -49,7 +51,12 @@ namespace vk
 // Forward declare Vulkan classes used in this file.
 class FullscreenMgr;
 class Fence;
+class HeadlessPresenter;
 class Image;
+class PresentTimeline;
+#if ICD_PRESENT_TIMING
+class PresentTimingLog;
+#endif
 class Semaphore;
 class SwCompositor;
 
@@ -131,6 +138,24 @@ public:
     VK_INLINE FullscreenMgr* GetFullscreenMgr()
         { return m_pFullscreenMgr; }
 
+    VK_INLINE HeadlessPresenter* GetHeadlessPresenter() const
+        { return m_pHeadlessPresenter; }
+
+    VK_INLINE bool IsHeadless() const
+        { return (m_pHeadlessPresenter != nullptr); }
+
+    VK_INLINE PresentTimeline* GetPresentTimeline() const
+        { return m_pPresentTimeline; }
+
+#if ICD_PRESENT_TIMING
+    VK_INLINE PresentTimingLog* GetPresentTimingLog() const
+        { return m_pPresentTimingLog; }
+
+    Pal::Result DumpPresentTimings(
+        const char*                  pFileName,
+        const VkAllocationCallbacks* pAllocator);
+#endif
+
     VK_INLINE uint32_t GetPresentCount() const
         { return m_presentCount; }
 
@@ -172,6 +197,12 @@ public:
 
     void MarkAsDeprecated();
 
+    void MarkPresentsOutOfDate();
+
+    VkResult WaitForPresent(
+        uint64_t presentId,
+        uint64_t timeout);
+
     bool IsSuboptimal(uint32_t  deviceIdx);
 
 protected:
@@ -180,6 +211,8 @@ protected:
         const Properties&   properties,
         VkPresentModeKHR    presentMode,
         FullscreenMgr*      pFullscreenMgr,
+        HeadlessPresenter*  pHeadlessPresenter,
+        PresentTimeline*    pPresentTimeline,
         Pal::ISwapChain*    pPalSwapChain);
 
     void InitSwCompositor(Pal::QueueType presentQueueType);
@@ -192,6 +225,11 @@ protected:
     Pal::ScreenColorConfig  m_colorParams;
     FullscreenMgr*          m_pFullscreenMgr;
     SwCompositor*           m_pSwCompositor;
+    HeadlessPresenter*      m_pHeadlessPresenter;  // Emulated presentation engine of headless swap chains
+    PresentTimeline*        m_pPresentTimeline;    // Present completion tracking for VK_KHR_present_wait
+#if ICD_PRESENT_TIMING
+    PresentTimingLog*       m_pPresentTimingLog;   // Acquire and present latency records
+#endif
     int32_t                 m_appOwnedImageCount;
     uint32_t                m_presentCount;
     VkPresentModeKHR        m_presentMode;
@@ -319,28 +357,297 @@ public:
         const Queue*               pPresentQueue);
 
 protected:
+    // Synchronization state of one intermediate image of the ring
+    struct RingSlot
+    {
+        Pal::IFence*          pReleased;                  // Signaled by the present queue once a later present has
+                                                          // replaced the slot on screen
+        bool                  releasePending;             // pReleased was submitted and has not been waited on yet
+        Pal::IQueueSemaphore* pRenderDone[MaxPalDevices]; // Source image rendered (non-presenting devices only)
+        Pal::IQueueSemaphore* pCopyDone[MaxPalDevices];   // Copy into the slot done (non-presenting devices only)
+    };
+
+    static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
     SwCompositor(
         const Device*     pDevice,
         uint32_t          presentationDeviceIdx,
         uint32_t          imageCount,
+        uint32_t          ringSize,
         Pal::QueueType    queueType,
+        size_t            palCmdBufferSize,
         Pal::IImage**     ppBltImages[],
         Pal::IGpuMemory** ppBltMemory[],
-        Pal::ICmdBuffer** ppBltCmdBuffers[]);
+        Pal::ICmdBuffer** ppBltCmdBuffers[],
+        void*             pCmdBufferMemory[],
+        RingSlot*         pSlots,
+        const VkImage*    pSrcImages);
 
     ~SwCompositor() {}
 
+    Pal::Result ReleaseReplacedSlot(
+        const Device* pDevice);
+
+    Pal::Result AcquireSlot(
+        const Device* pDevice,
+        uint32_t      slot);
+
+    Pal::ICmdBuffer* GetBltCmdBuffer(
+        const Device* pDevice,
+        uint32_t      deviceIdx,
+        uint32_t      imageIndex,
+        uint32_t      slot);
+
     uint32_t          m_presentationDeviceIdx;          // The physical device that performs the actual present
     uint32_t          m_imageCount;                     // The number of images in the swapchain
+    const VkImage*    m_pSrcImages;                     // The swap chain images (owned by the swap chain)
+    uint32_t          m_ringSize;                       // The number of intermediate images presents rotate through
+    uint32_t          m_nextSlot;                       // Ring slot the next non-presenting device frame is copied to
+    uint32_t          m_lastSlot;                       // Slot presented by the last compositing call, if any
+    uint32_t          m_shownSlot;                      // Slot presented before that, which the last present replaces
+    Pal::IQueue*      m_pLastPresentQueue;              // Present queue returned by the last compositing call
     Pal::QueueType    m_queueType;                      // The queue type that the command buffers are compatible with
-    Pal::IImage**     m_ppBltImages[MaxPalDevices];     // Array of intermediate images (master) or peer images (slave)
-    Pal::IGpuMemory** m_ppBltMemory[MaxPalDevices];     // Array of intermediate memory (master) or peer memory (slave)
-    Pal::ICmdBuffer** m_ppBltCmdBuffers[MaxPalDevices]; // Array of copy to peer image command buffers (slave-only)
+    size_t            m_palCmdBufferSize;               // Size of one BLT command buffer object
+    Pal::IImage**     m_ppBltImages[MaxPalDevices];     // Ring of intermediate images (master) or peer images (slave)
+    Pal::IGpuMemory** m_ppBltMemory[MaxPalDevices];     // Ring of intermediate memory (master) or peer memory (slave)
+    Pal::ICmdBuffer** m_ppBltCmdBuffers[MaxPalDevices]; // Copy to peer image command buffers for each swap chain image
+                                                        // and ring slot pair, recorded on first use (slave-only)
+    void*             m_pCmdBufferMemory[MaxPalDevices]; // Storage for the above command buffers (slave-only)
+    RingSlot*         m_pSlots;                         // Synchronization state of each ring slot
 
 private:
     PAL_DISALLOW_COPY_AND_ASSIGN(SwCompositor);
 };
 
+// =====================================================================================================================
+// This is a helper class that emulates the presentation engine behind VK_EXT_headless_surface swap chains.  Presented
+// images are latched by a simulated display whose refresh clock comes from the HeadlessSurfaceRefreshRate setting, so
+// that FIFO, MAILBOX and IMMEDIATE pacing behave like they would on a real display.
+class HeadlessPresenter
+{
+public:
+    // Image count limits reported by headless surfaces
+    static constexpr uint32_t MinImageCount = 2;
+    static constexpr uint32_t MaxImageCount = 16;
+
+    static VkResult Create(
+        Device*                      pDevice,
+        const VkAllocationCallbacks* pAllocator,
+        uint32_t                     imageCount,
+        VkPresentModeKHR             presentMode,
+        HeadlessPresenter**          ppPresenter);
+
+    void Destroy(const VkAllocationCallbacks* pAllocator);
+
+    VkResult AcquireNextImage(
+        uint64_t    timeout,
+        Semaphore*  pSemaphore,
+        Fence*      pFence,
+        uint32_t*   pImageIndex);
+
+    Pal::Result Present(
+        Pal::IQueue* pPalQueue,
+        uint32_t     imageIndex,
+        uint64_t     presentId);
+
+    VkResult WaitForPresent(
+        uint64_t presentId,
+        uint64_t timeout);
+
+    void MarkOutOfDate();
+
+    void WaitIdle();
+
+protected:
+    enum class ImageState : uint32_t
+    {
+        Available = 0,  // Can be returned by the next acquire
+        Acquired,       // Owned by the application
+        Queued,         // Presented but not yet latched by the simulated display
+        Dropped,        // Replaced in the mailbox before being latched; available once its rendering is done
+        Displayed       // Currently scanned out by the simulated display
+    };
+
+    struct ImageInfo
+    {
+        ImageState   state;
+        Pal::IFence* pPresentFence;  // Signaled once the rendering of the presented image is done
+        uint64_t     presentId;      // VK_KHR_present_id identifier of the last present of the image, 0 if untagged
+    };
+
+    HeadlessPresenter(
+        Device*          pDevice,
+        VkPresentModeKHR presentMode,
+        uint32_t         imageCount,
+        ImageInfo*       pImages,
+        uint32_t*        pQueuedImages,
+        Pal::IQueue*     pPalQueue);
+
+    ~HeadlessPresenter() {}
+
+    bool IsRenderingDone(uint32_t imageIndex) const;
+    void LatchQueuedImage();
+    void AdvanceClock(uint64_t now);
+    void ReleaseDroppedImages();
+    void WaitForProgress(uint64_t* pNow, uint64_t deadline);
+
+    static constexpr uint32_t InvalidImageIndex = UINT32_MAX;
+
+    Device*          m_pDevice;
+    VkPresentModeKHR m_presentMode;
+    uint32_t         m_imageCount;
+    ImageInfo*       m_pImages;          // Per image state
+    uint32_t*        m_pQueuedImages;    // Ring of presented images waiting to be latched, oldest first
+    uint32_t         m_queueHead;
+    uint32_t         m_queueCount;
+    uint32_t         m_displayedImage;   // Image currently scanned out or InvalidImageIndex
+    uint64_t         m_refreshPeriod;    // Simulated refresh interval in nanoseconds, 0 when unthrottled
+    uint64_t         m_nextRefresh;      // Time of the next simulated vertical blank in nanoseconds
+    Pal::IQueue*     m_pPalQueue;        // Internal queue used to signal acquire semaphores and fences
+    Util::Mutex      m_lock;             // Serializes acquires and presents
+    Util::Event      m_releaseEvent;     // Signaled whenever an image may have become available
+    uint64_t         m_lastPresentId;    // Highest present identifier handed to Present
+    uint64_t         m_latchedPresentId; // Highest present identifier latched by the simulated display
+    bool             m_outOfDate;        // No further presents will be queued
+
+private:
+    PAL_DISALLOW_COPY_AND_ASSIGN(HeadlessPresenter);
+};
+
+// =====================================================================================================================
+// This is a helper class that tracks the completion of presents tagged with a VK_KHR_present_id identifier on PAL swap
+// chains.  Each tagged present signals a fence on the queue it was presented on once PAL has handed the image to the
+// window system, and waiters block on the fence of the oldest present whose identifier satisfies their request.
+// Headless swap chains track completion in their HeadlessPresenter instead, which knows when an image is displayed.
+class PresentTimeline
+{
+public:
+    static PresentTimeline* Create(
+        Device*                      pDevice,
+        uint32_t                     deviceIdx,
+        const VkAllocationCallbacks* pAllocator,
+        uint32_t                     slotCount);
+
+    void Destroy(const VkAllocationCallbacks* pAllocator);
+
+    Pal::Result MarkPresent(
+        Pal::IQueue* pPalQueue,
+        uint64_t     presentId);
+
+    void MarkOutOfDate();
+
+    VkResult WaitForPresent(
+        uint64_t presentId,
+        uint64_t timeout);
+
+protected:
+    struct Slot
+    {
+        uint64_t     presentId;  // Identifier of the present the fence was submitted after
+        Pal::IFence* pFence;
+    };
+
+    PresentTimeline(
+        Device*  pDevice,
+        uint32_t deviceIdx,
+        uint32_t slotCount,
+        Slot*    pSlots);
+
+    ~PresentTimeline() {}
+
+    void RetireCompleted();
+
+    Device*             m_pDevice;
+    const uint32_t      m_deviceIdx;
+    const uint32_t      m_slotCount;
+    Slot*               m_pSlots;               // Ring of in-flight presents, oldest at m_head
+    uint32_t            m_head;
+    uint32_t            m_count;
+    uint64_t            m_completedPresentId;   // Highest identifier known to have completed
+    uint64_t            m_lastPresentId;        // Highest identifier recorded by MarkPresent
+    bool                m_outOfDate;            // No further presents will be recorded
+    Util::Mutex         m_lock;
+    Util::Event         m_presentEvent;         // Signaled on every tagged present to wake up waiters
+
+private:
+    PAL_DISALLOW_COPY_AND_ASSIGN(PresentTimeline);
+};
+
+#if ICD_PRESENT_TIMING
+// =====================================================================================================================
+// This is a helper class that records where the CPU time of each frame presented through a swap chain went.  It is only
+// built with ICD_PRESENT_TIMING, so none of the instrumentation exists in regular builds.  Records are kept in a ring
+// that overwrites the oldest frame.  GetRecords() copies them out, which the swap chain uses to write them as CSV when
+// it is destroyed (see the PresentTimingLogDirectory setting).
+class PresentTimingLog
+{
+public:
+    enum Stage : uint32_t
+    {
+        StageAcquireWait = 0,  // Blocked in vkAcquireNextImageKHR for the presented image
+        StageCompositing,      // Software compositing and post processing submission before the present
+        StagePresentSubmit,    // Handing the present to the PAL queue or the headless presentation engine
+        StageFlipModeChange,   // Fullscreen exclusive mode transitions of the fullscreen manager
+        StageCount
+    };
+
+    struct Record
+    {
+        uint64_t         frameIndex;              // Index of the present within the swap chain
+        uint64_t         presentTime;             // CPU time at which the present returned in nanoseconds
+        uint32_t         imageIndex;
+        Pal::PresentMode presentMode;
+        uint64_t         stageTime[StageCount];   // Time spent in each stage in nanoseconds
+    };
+
+    static PresentTimingLog* Create(
+        const VkAllocationCallbacks* pAllocator,
+        uint32_t                     imageCount,
+        uint32_t                     recordCount);
+
+    void Destroy(const VkAllocationCallbacks* pAllocator);
+
+    void AddAcquireWait(
+        uint32_t imageIndex,
+        uint64_t time);
+
+    VK_INLINE void AddStageTime(
+        Stage    stage,
+        uint64_t time)
+        { m_current.stageTime[stage] += time; }
+
+    void EndFrame(
+        uint32_t         imageIndex,
+        Pal::PresentMode presentMode);
+
+    VkResult GetRecords(
+        uint32_t* pRecordCount,
+        Record*   pRecords);
+
+protected:
+    PresentTimingLog(
+        uint32_t  imageCount,
+        uint32_t  recordCount,
+        uint64_t* pAcquireWaits,
+        Record*   pRecords);
+
+    ~PresentTimingLog() {}
+
+    const uint32_t m_imageCount;
+    const uint32_t m_recordCount;
+    uint64_t*      m_pAcquireWaits;  // Acquire wait of each image not yet presented since it was acquired
+    Record*        m_pRecords;       // Ring of finished frames, oldest at m_head
+    uint32_t       m_head;
+    uint32_t       m_count;
+    uint64_t       m_frameIndex;
+    Record         m_current;        // Frame currently being presented
+    Util::Mutex    m_lock;           // Serializes finishing frames against readers on other threads
+
+private:
+    PAL_DISALLOW_COPY_AND_ASSIGN(PresentTimingLog);
+};
+#endif
+
 namespace entry
 {
 VKAPI_ATTR void VKAPI_CALL vkDestroySwapchainKHR(
@@ -373,6 +680,12 @@ VKAPI_ATTR void VKAPI_CALL vkSetHdrMetadataEXT(
     const VkSwapchainKHR*                       pSwapchains,
     const VkHdrMetadataEXT*                     pMetadata);
 
+VKAPI_ATTR VkResult VKAPI_CALL vkWaitForPresentKHR(
+    VkDevice                                    device,
+    VkSwapchainKHR                              swapchain,
+    uint64_t                                    presentId,
+    uint64_t                                    timeout);
+
 }// entry
 }// vk
 
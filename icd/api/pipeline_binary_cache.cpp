@@ -41,15 +41,28 @@
 
 #if ICD_GPUOPEN_DEVMODE_BUILD
 #include "palPipelineAbiReader.h"
+#include "palSysUtil.h"
 #include "devmode/devmode_mgr.h"
 #endif
+
+#if defined(__unix__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
 #include <string.h>
+#include <time.h>
 
 namespace vk
 {
 constexpr char   PipelineBinaryCache::EnvVarPath[];
 constexpr char   PipelineBinaryCache::EnvVarFileName[];
 constexpr char   PipelineBinaryCache::EnvVarReadOnlyFileName[];
+constexpr char   PipelineBinaryCache::CacheDirLockFileName[];
 
 static constexpr char   ArchiveTypeString[]  = "VK_SHADER_PIPELINE_CACHE";
 static constexpr size_t ArchiveTypeStringLen = sizeof(ArchiveTypeString);
@@ -182,12 +195,24 @@ PipelineBinaryCache::PipelineBinaryCache(
     m_pDevModeMgr          { nullptr },
     m_pReinjectionLayer    { nullptr },
     m_hashMapping          { 32, &m_palAllocator },
+    m_pReinjectionElfs     { nullptr },
+    m_reinjectionElfCount  { 0 },
+    m_pReinjectionDir      { nullptr },
+    m_reinjectionElfIndex  { 1024, &m_palAllocator },
+    m_nextReinjectionElf   { 0 },
+    m_stopReinjectionLoaders { false },
 #endif
     m_pMemoryLayer         { nullptr },
     m_pArchiveLayer        { nullptr },
     m_openFiles            { &m_palAllocator },
     m_archiveLayers        { &m_palAllocator },
-    m_pCacheAdapter        { nullptr }
+    m_pCacheAdapter        { nullptr },
+    m_stopCacheDirGc       { false },
+    m_pCacheDirPath        { nullptr },
+    m_pArchiveBaseName     { nullptr },
+    m_cacheDirSizeLimit    { 0 },
+    m_cacheDirLowWaterMark { 0 },
+    m_cacheDirMinAge       { 0 }
 {
     // Without copy constructor, a class type variable can't be initialized in initialization list with gcc 4.8.5.
     // Initialize m_gfxIp here instead to make gcc 4.8.5 work.
@@ -197,6 +222,12 @@ PipelineBinaryCache::PipelineBinaryCache(
 // =====================================================================================================================
 PipelineBinaryCache::~PipelineBinaryCache()
 {
+    StopCacheDirGc();
+
+#if ICD_GPUOPEN_DEVMODE_BUILD
+    StopReinjectionLoaders();
+#endif
+
     if (m_pCacheAdapter != nullptr)
     {
         m_pCacheAdapter->Destroy();
@@ -230,7 +261,11 @@ PipelineBinaryCache::~PipelineBinaryCache()
     {
         m_pReinjectionLayer->Destroy();
     }
+
+    FreeMem(m_pReinjectionElfs);
 #endif
+
+    FreeMem(m_pCacheDirPath);
 }
 
 // =====================================================================================================================
@@ -430,6 +465,19 @@ Util::Result PipelineBinaryCache::LoadReinjectionBinary(
         Util::QueryResult query = {};
         result = m_pReinjectionLayer->Query(pInternalPipelineHash, 0, 0, &query);
 
+        // Load the replacement ELF of this pipeline if no loader thread got to it yet
+        if ((result != Util::Result::Success) && (m_reinjectionElfCount > 0))
+        {
+            ReinjectionElf** ppElf = m_reinjectionElfIndex.FindKey(*pInternalPipelineHash);
+
+            if (ppElf != nullptr)
+            {
+                LoadReinjectionElf(*ppElf);
+
+                result = m_pReinjectionLayer->Query(pInternalPipelineHash, 0, 0, &query);
+            }
+        }
+
         if (result == Util::Result::Success)
         {
             void* pOutputMem = AllocMem(query.dataSize);
@@ -564,6 +612,13 @@ VkResult PipelineBinaryCache::Initialize(
             PAL_ASSERT_ALWAYS();
         }
     }
+
+    if ((result == VK_SUCCESS) &&
+        (m_pReinjectionLayer != nullptr) &&
+        (m_reinjectionElfCount > 0))
+    {
+        StartReinjectionLoaders(settings.devModeElfReplacementLoaderThreadCount);
+    }
 #endif
 
     if (result == VK_SUCCESS)
@@ -651,7 +706,9 @@ Util::Hash128 ParseHash128(const char* str)
 }
 
 // =====================================================================================================================
-// Adds binaries to reinjection cache layer from a directory source
+// Indexes the ELF files of the replacement directory by the pipeline hash in their names.  The files themselves are
+// only loaded into the reinjection layer later, by the loader threads or when their pipeline is first looked up, so the
+// cost of initializing the cache doesn't grow with the number of replacement ELFs.
 Util::Result PipelineBinaryCache::InjectBinariesFromDirectory(
     const RuntimeSettings& settings)
 {
@@ -659,114 +716,221 @@ Util::Result PipelineBinaryCache::InjectBinariesFromDirectory(
 
     if (settings.devModeElfReplacementDirectoryEnable)
     {
-        Util::File      file;
-        char            filePath[Util::PathBufferLen] = {};
-        uint32_t        fileCount                     = 0u;
-        const char**    ppFileNames                   = nullptr;
-        size_t          fileNameBufferSize            = 0u;
-        void*           pFileNameBuffer               = nullptr;
-        size_t          dirLength                     = strlen(settings.devModeElfReplacementDirectory) + 1u;
-
-        Util::Hash128   pipelineHash                  = {};
-        size_t          pipelineBinarySize            = 0u;
-        void*           pPipelineBinary               = nullptr;
+        const char*  pDir               = settings.devModeElfReplacementDirectory;
+        const size_t dirSize            = strlen(pDir) + 1u;
+        uint32_t     fileCount          = 0u;
+        const char** ppFileNames        = nullptr;
+        size_t       fileNameBufferSize = 0u;
 
         // Get the number of files in dir and the size of the buffer to hold their names
-        result = Util::ListDir(
-            settings.devModeElfReplacementDirectory,
-            &fileCount,
-            nullptr,
-            &fileNameBufferSize,
-            nullptr);
-
-        if (fileCount == 0u)
-        {
-            return result;
-        }
+        result = Util::ListDir(pDir, &fileCount, nullptr, &fileNameBufferSize, nullptr);
 
-        if (result == Util::Result::Success)
+        if ((result == Util::Result::Success) && (fileCount > 0u))
         {
-            // Allocate space for ppFileNames and pFileNameBuffer
-            ppFileNames = (const char**)AllocMem(sizeof(const char*) * fileCount);
-            pFileNameBuffer = AllocMem(fileNameBufferSize);
-
-            // Populate ppFileNames and pFileNameBuffer
-            result = Util::ListDir(
-                settings.devModeElfReplacementDirectory,
-                &fileCount,
-                ppFileNames,
-                &fileNameBufferSize,
-                pFileNameBuffer);
+            // The index entries share one allocation with the directory and the file names they point to
+            ppFileNames        = static_cast<const char**>(AllocMem(sizeof(const char*) * fileCount));
+            m_pReinjectionElfs = static_cast<ReinjectionElf*>(
+                AllocMem((sizeof(ReinjectionElf) * fileCount) + dirSize + fileNameBufferSize));
 
-            if (result != Util::Result::Success)
+            if ((ppFileNames != nullptr) && (m_pReinjectionElfs != nullptr))
             {
-                FreeMem(pFileNameBuffer);
-                FreeMem(ppFileNames);
+                char* pDirCopy = reinterpret_cast<char*>(m_pReinjectionElfs + fileCount);
+
+                memcpy(pDirCopy, pDir, dirSize);
+                m_pReinjectionDir = pDirCopy;
+
+                // Populate ppFileNames and the file name buffer
+                result = Util::ListDir(pDir, &fileCount, ppFileNames, &fileNameBufferSize, pDirCopy + dirSize);
+            }
+            else
+            {
+                result = Util::Result::ErrorOutOfMemory;
             }
-        }
 
-        if (result == Util::Result::Success)
-        {
-            // Store each file into cache
-            Util::Strncpy(filePath, settings.devModeElfReplacementDirectory, sizeof(filePath));
-            Util::Strncat(filePath, sizeof(filePath), "\\");
-            for (uint32_t fileIndex = 0; fileIndex < fileCount; fileIndex++)
+            if (result == Util::Result::Success)
             {
-                filePath[dirLength] = '\0';
-                Util::Strncat(filePath, sizeof(filePath), ppFileNames[fileIndex]);
+                result = m_reinjectionElfIndex.Init();
+            }
 
-                ppFileNames[fileIndex] = strstr(ppFileNames[fileIndex], "_0x");
+            for (uint32_t fileIndex = 0; (fileIndex < fileCount) && (result == Util::Result::Success); fileIndex++)
+            {
+                const char* pHashString = strstr(ppFileNames[fileIndex], "_0x");
 
-                if ((ppFileNames[fileIndex] != nullptr) &&
-                    (strlen(ppFileNames[fileIndex]) >= 32))
+                if ((pHashString != nullptr) && (strlen(pHashString) >= 35u))
                 {
-                    ppFileNames[fileIndex] += 3u;
-                    pipelineHash = ParseHash128(ppFileNames[fileIndex]);
+                    const CacheId    pipelineHash = ParseHash128(pHashString + 3u);
+                    bool             existed      = false;
+                    ReinjectionElf** ppElf        = nullptr;
 
-                    if (Util::File::Exists(filePath))
-                    {
-                        pipelineBinarySize = Util::File::GetFileSize(filePath);
-                        pPipelineBinary = AllocMem(pipelineBinarySize);
+                    result = m_reinjectionElfIndex.FindAllocate(pipelineHash, &existed, &ppElf);
 
-                        if (pPipelineBinary != nullptr)
+                    if (result == Util::Result::Success)
+                    {
+                        // When several files replace the same pipeline, the last one listed is used
+                        if (existed == false)
                         {
-                            if (file.Open(
-                                filePath,
-                                Util::FileAccessRead | Util::FileAccessBinary) == Util::Result::Success)
-                            {
-                                if (file.Read(pPipelineBinary, pipelineBinarySize, nullptr) == Util::Result::Success)
-                                {
-                                    StoreReinjectionBinary(&pipelineHash, pipelineBinarySize, pPipelineBinary);
-                                }
-                                else
-                                {
-                                    VK_NEVER_CALLED();
-                                }
-
-                                file.Close();
-                            }
-                            else
-                            {
-                                VK_NEVER_CALLED();
-                            }
+                            *ppElf = &m_pReinjectionElfs[m_reinjectionElfCount++];
+
+                            (*ppElf)->hash  = pipelineHash;
+                            (*ppElf)->state = ReinjectionElfPending;
                         }
 
-                        FreeMem(pPipelineBinary);
-                    }
-                    else
-                    {
-                        VK_NEVER_CALLED();
+                        (*ppElf)->pFileName = ppFileNames[fileIndex];
                     }
                 }
             }
 
-            FreeMem(pFileNameBuffer);
+            if (result != Util::Result::Success)
+            {
+                FreeMem(m_pReinjectionElfs);
+
+                m_pReinjectionElfs    = nullptr;
+                m_pReinjectionDir     = nullptr;
+                m_reinjectionElfCount = 0;
+            }
+
             FreeMem(ppFileNames);
         }
     }
 
     return result;
 }
+
+// =====================================================================================================================
+// Loads a replacement ELF into the reinjection layer unless another thread already did.  If another thread is loading
+// it right now, waits for that thread to finish.
+void PipelineBinaryCache::LoadReinjectionElf(
+    ReinjectionElf* pElf)
+{
+    if (Util::AtomicCompareAndSwap(&pElf->state, ReinjectionElfPending, ReinjectionElfLoading) == ReinjectionElfPending)
+    {
+        // Don't replace a binary that was reinjected through the developer mode service in the meantime
+        Util::QueryResult query = {};
+
+        if (m_pReinjectionLayer->Query(&pElf->hash, 0, 0, &query) != Util::Result::Success)
+        {
+            const Util::Result result = StoreReinjectionElfFile(pElf);
+
+            VK_ASSERT((result == Util::Result::Success) || (result == Util::Result::ErrorIncompatibleDevice));
+        }
+
+        Util::AtomicExchange(&pElf->state, ReinjectionElfDone);
+    }
+    else
+    {
+        while (pElf->state != ReinjectionElfDone)
+        {
+            Util::YieldThread();
+        }
+    }
+}
+
+// =====================================================================================================================
+// Stores the contents of a replacement ELF file into the reinjection layer.  Where possible the file is mapped instead
+// of read, so that its contents are only copied once, into the layer.
+Util::Result PipelineBinaryCache::StoreReinjectionElfFile(
+    const ReinjectionElf* pElf)
+{
+    Util::Result result = Util::Result::ErrorUnavailable;
+    char         filePath[Util::PathBufferLen];
+
+    Util::Snprintf(filePath, sizeof(filePath), "%s/%s", m_pReinjectionDir, pElf->pFileName);
+
+#if defined(__unix__)
+    const int fd = open(filePath, O_RDONLY);
+
+    if (fd >= 0)
+    {
+        struct stat fileStat = {};
+
+        if ((fstat(fd, &fileStat) == 0) && (fileStat.st_size > 0))
+        {
+            const size_t fileSize = static_cast<size_t>(fileStat.st_size);
+            void*        pData    = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (pData != MAP_FAILED)
+            {
+                result = StoreReinjectionBinary(&pElf->hash, fileSize, pData);
+
+                munmap(pData, fileSize);
+            }
+        }
+
+        close(fd);
+    }
+#else
+    Util::File file;
+
+    if (file.Open(filePath, Util::FileAccessRead | Util::FileAccessBinary) == Util::Result::Success)
+    {
+        const size_t fileSize = Util::File::GetFileSize(filePath);
+        void*        pData    = (fileSize > 0) ? AllocMem(fileSize) : nullptr;
+
+        if (pData != nullptr)
+        {
+            if (file.Read(pData, fileSize, nullptr) == Util::Result::Success)
+            {
+                result = StoreReinjectionBinary(&pElf->hash, fileSize, pData);
+            }
+
+            FreeMem(pData);
+        }
+
+        file.Close();
+    }
+#endif
+
+    return result;
+}
+
+// =====================================================================================================================
+// Starts the threads that load the replacement ELFs in the background.  With no threads, every ELF is only loaded when
+// its pipeline is first looked up.
+void PipelineBinaryCache::StartReinjectionLoaders(
+    uint32_t threadCount)
+{
+    threadCount = Util::Min(threadCount, Util::Min(m_reinjectionElfCount, MaxReinjectionLoaderThreads));
+
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        m_reinjectionLoaders[i].Begin(ReinjectionLoaderThreadFunc, this);
+    }
+}
+
+// =====================================================================================================================
+// Makes the loader threads stop after the ELF they are currently loading and waits for them to exit.
+void PipelineBinaryCache::StopReinjectionLoaders()
+{
+    m_stopReinjectionLoaders = true;
+
+    for (uint32_t i = 0; i < MaxReinjectionLoaderThreads; ++i)
+    {
+        if (m_reinjectionLoaders[i].IsCreated())
+        {
+            m_reinjectionLoaders[i].Join();
+        }
+    }
+}
+
+// =====================================================================================================================
+// Loader threads claim the replacement ELFs in directory order until all are claimed or the cache is destroyed.
+void PipelineBinaryCache::ReinjectionLoaderThreadFunc(
+    void* pParam)
+{
+    PipelineBinaryCache* pCache = static_cast<PipelineBinaryCache*>(pParam);
+
+    while (pCache->m_stopReinjectionLoaders == false)
+    {
+        const uint32_t elfIndex = Util::AtomicIncrement(&pCache->m_nextReinjectionElf) - 1;
+
+        if (elfIndex >= pCache->m_reinjectionElfCount)
+        {
+            break;
+        }
+
+        pCache->LoadReinjectionElf(&pCache->m_pReinjectionElfs[elfIndex]);
+    }
+}
 #endif
 
 // =====================================================================================================================
@@ -974,6 +1138,8 @@ VkResult PipelineBinaryCache::InitArchiveLayers(
 
     // Buffer to hold constructed path
     char pathBuffer[Util::PathBufferLen] = {};
+    // Only the driver's default location is garbage collected
+    bool cleanUpCacheDirectory = false;
     // If the environment variable AMD_VK_PIPELINE_CACHE_PATH is set, obey it first
     const char* pCachePath = getenv(EnvVarPath);
 
@@ -994,19 +1160,9 @@ VkResult PipelineBinaryCache::InitArchiveLayers(
                 // Construct the path in the local buffer. Consider it valid if not empty
                 if (Util::Snprintf(pathBuffer, sizeof(pathBuffer), "%s%s", pUserDataPath, pCacheSubPath) > 0)
                 {
-                    pCachePath = pathBuffer;
+                    pCachePath            = pathBuffer;
+                    cleanUpCacheDirectory = settings.allowCleanUpCacheDirectory;
 
-                    if (settings.allowCleanUpCacheDirectory)
-                    {
-                        uint64 totalSize = 0, oldestTime = 0;
-                        if (Util::GetStatusOfDir(pCachePath, &totalSize, &oldestTime) == Util::Result::Success)
-                        {
-                            if (totalSize >= settings.pipelineCacheDefaultLocationLimitation)
-                            {
-                                Util::RemoveFilesOfDir(pCachePath, oldestTime + settings.thresholdOfCleanUpCache);
-                            }
-                        }
-                    }
                     result = VK_SUCCESS;
                 }
             }
@@ -1157,11 +1313,260 @@ VkResult PipelineBinaryCache::InitArchiveLayers(
         }
 
         PAL_ALERT_MSG(pWriteLayer == nullptr, "No valid write layer for cache. No data will be written out.");
+
+        // Collect the directory only once our archives exist, so that they are recognized as in use
+        if (cleanUpCacheDirectory)
+        {
+            StartCacheDirGc(pCachePath, nameBuffer, nameEnd - nameBuffer, settings);
+        }
     }
 
     return result;
 }
 
+// =====================================================================================================================
+// Starts collecting the cache directory on a background thread, so that device creation never waits for it.
+void PipelineBinaryCache::StartCacheDirGc(
+    const char*            pCachePath,
+    const char*            pArchiveBaseName,
+    size_t                 archiveBaseNameLength,
+    const RuntimeSettings& settings)
+{
+    VK_ASSERT(m_pCacheDirPath == nullptr);
+
+    const size_t pathSize = strlen(pCachePath) + 1;
+
+    m_pCacheDirPath = static_cast<char*>(AllocMem(pathSize + archiveBaseNameLength + 1));
+
+    if (m_pCacheDirPath != nullptr)
+    {
+        char* pBaseName = m_pCacheDirPath + pathSize;
+
+        memcpy(m_pCacheDirPath, pCachePath, pathSize);
+        memcpy(pBaseName, pArchiveBaseName, archiveBaseNameLength);
+        pBaseName[archiveBaseNameLength] = '\0';
+
+        m_pArchiveBaseName     = pBaseName;
+        m_cacheDirSizeLimit    = settings.pipelineCacheDefaultLocationLimitation;
+        m_cacheDirLowWaterMark = (m_cacheDirSizeLimit / 100) *
+                                 Util::Min(settings.pipelineCacheDefaultLocationLowWaterMark, 100u);
+        m_cacheDirMinAge       = settings.thresholdOfCleanUpCache;
+
+        if (m_cacheDirGc.Begin(CacheDirGcThreadFunc, this) != Util::Result::Success)
+        {
+            // Skip the collection rather than block on it; the next device will try again
+            PAL_ALERT_ALWAYS_MSG("Failed to start the pipeline cache directory garbage collector.");
+        }
+    }
+}
+
+// =====================================================================================================================
+// Makes the garbage collector stop before its next file and waits for it to exit.
+void PipelineBinaryCache::StopCacheDirGc()
+{
+    m_stopCacheDirGc = true;
+
+    if (m_cacheDirGc.IsCreated())
+    {
+        m_cacheDirGc.Join();
+    }
+}
+
+// =====================================================================================================================
+void PipelineBinaryCache::CacheDirGcThreadFunc(
+    void* pParam)
+{
+    static_cast<PipelineBinaryCache*>(pParam)->CollectCacheDir();
+}
+
+#if defined(__unix__)
+// =====================================================================================================================
+// Returns whether the archive is one of this application's archives, which the collection never evicts.
+bool PipelineBinaryCache::IsOwnArchive(
+    const char* pName) const
+{
+    const char* pReadOnlyFileName = getenv(EnvVarReadOnlyFileName);
+
+    return (strncmp(pName, m_pArchiveBaseName, strlen(m_pArchiveBaseName)) == 0) ||
+           ((pReadOnlyFileName != nullptr) && (strcmp(pName, pReadOnlyFileName) == 0));
+}
+
+// =====================================================================================================================
+// Sets the access and modification times of this application's archives to the current time, marking them as used.
+// UTIME_NOW is used rather than an explicit time since it only needs write access to the archive, while setting an
+// explicit time is limited to its owner; archives shared between users of the directory would fail with EPERM.
+void PipelineBinaryCache::MarkOwnArchivesUsed(
+    int dirFd) const
+{
+    // Open the directory afresh rather than duplicating dirFd, which would share its read position with the scan
+    const int scanFd = openat(dirFd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR*      pDir   = (scanFd >= 0) ? fdopendir(scanFd) : nullptr;
+
+    if ((pDir == nullptr) && (scanFd >= 0))
+    {
+        close(scanFd);
+    }
+
+    if (pDir != nullptr)
+    {
+        struct timespec times[2] = {};
+
+        times[0].tv_nsec = UTIME_NOW;
+        times[1].tv_nsec = UTIME_NOW;
+
+        const struct dirent* pDirEntry = nullptr;
+
+        while ((m_stopCacheDirGc == false) && ((pDirEntry = readdir(pDir)) != nullptr))
+        {
+            const char*  pName   = pDirEntry->d_name;
+            const size_t nameLen = strlen(pName);
+
+            if ((nameLen > 5) && (strcmp(pName + nameLen - 5, ".parc") == 0) && IsOwnArchive(pName))
+            {
+                utimensat(dirFd, pName, times, AT_SYMLINK_NOFOLLOW);
+            }
+        }
+
+        closedir(pDir);
+    }
+}
+#endif
+
+// =====================================================================================================================
+// Evicts the least recently used archives of the cache directory once it has grown past its size limit, until it is
+// back under the low water mark.
+//
+// The file system itself is the persistent size and recency index: the size of an archive is its file size and its
+// last use is its modification time.  Every collection first sets the times of this application's archives, which are
+// never evicted, to the current time, so an archive ages from the last time any application that uses it created a
+// device.  Access times are not used since they are often not maintained (noatime and relatime mounts).
+// Keeping the index in the file system means processes sharing the directory always see the same state without having
+// to keep a separate index file consistent.
+//
+// Processes sharing the directory take turns through an advisory lock on CacheDirLockFileName; a process that finds it
+// taken leaves the collection to its holder.  Its own archives are refreshed before it tries the lock, so the holder
+// doesn't evict them.  Only archives are evicted, and an archive that was used after the scan is kept.  Removing an
+// archive that another process still has open is safe, as its open handle stays valid.
+void PipelineBinaryCache::CollectCacheDir()
+{
+#if defined(__unix__)
+    const int dirFd = open(m_pCacheDirPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (dirFd >= 0)
+    {
+        const uint64_t currentTime = static_cast<uint64_t>(time(nullptr));
+
+        MarkOwnArchivesUsed(dirFd);
+
+        const int lockFd = openat(dirFd, CacheDirLockFileName, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+        if ((lockFd >= 0) && (flock(lockFd, LOCK_EX | LOCK_NB) == 0))
+        {
+            Util::Vector<CacheDirEntry, 64, PalAllocator> entries(&m_palAllocator);
+
+            uint64_t  totalSize = 0;
+            const int scanFd    = dup(dirFd);
+            DIR*      pDir      = (scanFd >= 0) ? fdopendir(scanFd) : nullptr;
+
+            if ((pDir == nullptr) && (scanFd >= 0))
+            {
+                close(scanFd);
+            }
+
+            if (pDir != nullptr)
+            {
+                const struct dirent* pDirEntry = nullptr;
+
+                while ((m_stopCacheDirGc == false) && ((pDirEntry = readdir(pDir)) != nullptr))
+                {
+                    const char*  pName   = pDirEntry->d_name;
+                    const size_t nameLen = strlen(pName);
+                    struct stat  fileStat;
+
+                    if ((fstatat(dirFd, pName, &fileStat, AT_SYMLINK_NOFOLLOW) != 0) ||
+                        (S_ISREG(fileStat.st_mode) == 0))
+                    {
+                        continue;
+                    }
+
+                    // Everything in the directory counts towards its size, but only archives are ever evicted
+                    totalSize += fileStat.st_size;
+
+                    if ((nameLen <= 5) || (strcmp(pName + nameLen - 5, ".parc") != 0))
+                    {
+                        continue;
+                    }
+
+                    if ((IsOwnArchive(pName) == false) && (nameLen < sizeof(CacheDirEntry::name)))
+                    {
+                        CacheDirEntry entry = {};
+
+                        entry.lastUse = static_cast<uint64_t>(fileStat.st_mtime);
+                        entry.size    = fileStat.st_size;
+                        memcpy(entry.name, pName, nameLen + 1);
+
+                        if (entries.PushBack(entry) != Util::Result::Success)
+                        {
+                            break;
+                        }
+                    }
+                }
+
+                closedir(pDir);
+            }
+
+            if ((totalSize > m_cacheDirSizeLimit) && (entries.NumElements() > 0))
+            {
+                CacheDirEntry* const pEntries = entries.Data();
+                const uint32_t       count    = entries.NumElements();
+
+                std::sort(pEntries, pEntries + count,
+                    [](const CacheDirEntry& lhs, const CacheDirEntry& rhs) { return lhs.lastUse < rhs.lastUse; });
+
+                for (uint32_t i = 0; (i < count) && (totalSize > m_cacheDirLowWaterMark); ++i)
+                {
+                    const CacheDirEntry& entry = pEntries[i];
+
+                    // Entries are in LRU order, so all remaining archives are recent enough to keep as well
+                    if ((m_stopCacheDirGc) || ((entry.lastUse + m_cacheDirMinAge) > currentTime))
+                    {
+                        break;
+                    }
+
+                    struct stat fileStat;
+
+                    // Keep archives that were used or replaced since the scan
+                    if ((fstatat(dirFd, entry.name, &fileStat, AT_SYMLINK_NOFOLLOW) == 0) &&
+                        (static_cast<uint64_t>(fileStat.st_mtime) == entry.lastUse) &&
+                        (unlinkat(dirFd, entry.name, 0) == 0))
+                    {
+                        totalSize -= Util::Min(totalSize, entry.size);
+                    }
+                }
+            }
+        }
+
+        if (lockFd >= 0)
+        {
+            // Also releases the lock
+            close(lockFd);
+        }
+
+        close(dirFd);
+    }
+#else
+    uint64 totalSize  = 0;
+    uint64 oldestTime = 0;
+
+    // Elsewhere keep the old policy of removing every file within the threshold of the oldest one
+    if ((Util::GetStatusOfDir(m_pCacheDirPath, &totalSize, &oldestTime) == Util::Result::Success) &&
+        (totalSize >= m_cacheDirSizeLimit))
+    {
+        Util::RemoveFilesOfDir(m_pCacheDirPath, oldestTime + m_cacheDirMinAge);
+    }
+#endif
+}
+
 // =====================================================================================================================
 // Initialize layers (a single layer that supports storage for binaries needs to succeed)
 VkResult PipelineBinaryCache::InitLayers(
@@ -592,6 +592,153 @@ Util::Result PipelineCompiler::GetCachedPipelineBinary(
     return cacheResult;
 }
 
+// =====================================================================================================================
+// Loads the binary of a pipeline whose shader stages are given by module identifiers.  Without module data such a
+// pipeline can't be compiled, so it is only found if it was created from the modules themselves before and the cache id
+// was recorded under its identifier cache id.
+VkResult PipelineCompiler::LoadPipelineBinaryFromIdentifiers(
+    PipelineBinaryCache*         pPipelineBinaryCache,
+    const Util::MetroHash::Hash* pIdentifierCacheId,
+    Util::MetroHash::Hash*       pCacheId,
+    size_t*                      pPipelineBinarySize,
+    const void**                 ppPipelineBinary,
+    FreeCompilerBinary*          pFreeCompilerBinary,
+    PipelineCreationFeedback*    pPipelineFeedback)
+{
+    PipelineBinaryCache* pCaches[] = { pPipelineBinaryCache, m_pBinaryCache };
+
+    Util::Result cacheResult = Util::Result::NotFound;
+
+    for (uint32_t i = 0; (i < VK_ARRAY_SIZE(pCaches)) && (cacheResult != Util::Result::Success); ++i)
+    {
+        size_t      dataSize = 0;
+        const void* pData    = nullptr;
+
+        if ((pCaches[i] != nullptr) &&
+            (pCaches[i]->LoadPipelineBinary(pIdentifierCacheId, &dataSize, &pData) == Util::Result::Success))
+        {
+            if (dataSize == sizeof(*pCacheId))
+            {
+                memcpy(pCacheId, pData, sizeof(*pCacheId));
+                cacheResult = Util::Result::Success;
+            }
+
+            pCaches[i]->FreePipelineBinary(pData);
+        }
+    }
+
+    if (cacheResult == Util::Result::Success)
+    {
+        bool isUserCacheHit     = false;
+        bool isInternalCacheHit = false;
+
+        cacheResult = GetCachedPipelineBinary(pCacheId, pPipelineBinaryCache, pPipelineBinarySize, ppPipelineBinary,
+            &isUserCacheHit, &isInternalCacheHit, pFreeCompilerBinary, pPipelineFeedback);
+    }
+
+    m_totalBinaries++;
+
+    return (cacheResult == Util::Result::Success) ? VK_SUCCESS : VK_PIPELINE_COMPILE_REQUIRED_EXT;
+}
+
+// =====================================================================================================================
+// Records the cache id of a pipeline under its identifier cache id.  The entry only holds the cache id, so it costs a
+// few bytes per pipeline.
+void PipelineCompiler::StoreIdentifierCacheId(
+    PipelineBinaryCache*         pPipelineBinaryCache,
+    const Util::MetroHash::Hash* pIdentifierCacheId,
+    const Util::MetroHash::Hash* pCacheId)
+{
+    Util::Result cacheResult = pPipelineBinaryCache->StorePipelineBinary(
+        pIdentifierCacheId,
+        sizeof(*pCacheId),
+        pCacheId);
+
+    VK_ASSERT(Util::IsErrorResult(cacheResult) == false);
+}
+
+// =====================================================================================================================
+// Adds the graphics pipeline compile options that aren't part of the LLPC pipeline hash to a cache id.
+void PipelineCompiler::UpdateGraphicsCacheIdOptions(
+    Util::MetroHash128*               pHasher,
+    const GraphicsPipelineCreateInfo* pCreateInfo,
+    uint32_t                          deviceIdx) const
+{
+    const RuntimeSettings& settings = m_pPhysicalDevice->GetRuntimeSettings();
+
+    pHasher->Update(pCreateInfo->pipelineInfo.vs.options);
+    pHasher->Update(pCreateInfo->pipelineInfo.tes.options);
+    pHasher->Update(pCreateInfo->pipelineInfo.tcs.options);
+    pHasher->Update(pCreateInfo->pipelineInfo.gs.options);
+    pHasher->Update(pCreateInfo->pipelineInfo.fs.options);
+    pHasher->Update(pCreateInfo->pipelineInfo.options);
+    pHasher->Update(pCreateInfo->pipelineInfo.nggState);
+    pHasher->Update(GetCacheIdControlFlags(pCreateInfo->flags));
+    pHasher->Update(pCreateInfo->dbFormat);
+    pHasher->Update(pCreateInfo->pipelineProfileKey);
+    pHasher->Update(deviceIdx);
+    pHasher->Update(pCreateInfo->compilerType);
+    pHasher->Update(pCreateInfo->pipelineInfo.dynamicVertexStride);
+    if (pCreateInfo->compilerType == PipelineCompilerTypeLlpc)
+    {
+        pHasher->Update(reinterpret_cast<const uint8_t*>(settings.llpcOptions), sizeof(settings.llpcOptions));
+    }
+}
+
+// =====================================================================================================================
+// Builds the key under which a graphics pipeline's cache id is recorded for creation from shader module identifiers.
+// The LLPC pipeline hash needs the module data, so the key is built from the API state hash instead, along with the
+// fixed function state derived from it.
+void PipelineCompiler::GetGraphicsIdentifierCacheId(
+    const GraphicsPipelineCreateInfo* pCreateInfo,
+    uint32_t                          deviceIdx,
+    Util::MetroHash::Hash*            pIdentifierCacheId) const
+{
+    Util::MetroHash128 hash = {};
+    hash.Update(pCreateInfo->basePipelineHash);
+    hash.Update(pCreateInfo->pipelineInfo.iaState);
+    hash.Update(pCreateInfo->pipelineInfo.vpState);
+    hash.Update(pCreateInfo->pipelineInfo.rsState);
+    hash.Update(pCreateInfo->pipelineInfo.cbState);
+    UpdateGraphicsCacheIdOptions(&hash, pCreateInfo, deviceIdx);
+    hash.Finalize(pIdentifierCacheId->bytes);
+}
+
+// =====================================================================================================================
+// Adds the compute pipeline compile options that aren't part of the LLPC pipeline hash to a cache id.
+void PipelineCompiler::UpdateComputeCacheIdOptions(
+    Util::MetroHash128*               pHasher,
+    const ComputePipelineCreateInfo*  pCreateInfo,
+    uint32_t                          deviceIdx) const
+{
+    const RuntimeSettings& settings = m_pPhysicalDevice->GetRuntimeSettings();
+
+    pHasher->Update(pCreateInfo->pipelineInfo.cs.options);
+    pHasher->Update(pCreateInfo->pipelineInfo.options);
+    pHasher->Update(GetCacheIdControlFlags(pCreateInfo->flags));
+    pHasher->Update(pCreateInfo->pipelineProfileKey);
+    pHasher->Update(deviceIdx);
+    pHasher->Update(pCreateInfo->compilerType);
+    pHasher->Update(settings.forceCsThreadGroupSwizzleMode);
+    if (pCreateInfo->compilerType == PipelineCompilerTypeLlpc)
+    {
+        pHasher->Update(reinterpret_cast<const uint8_t*>(settings.llpcOptions), sizeof(settings.llpcOptions));
+    }
+}
+
+// =====================================================================================================================
+// Builds the key under which a compute pipeline's cache id is recorded for creation from a shader module identifier.
+void PipelineCompiler::GetComputeIdentifierCacheId(
+    const ComputePipelineCreateInfo*  pCreateInfo,
+    uint32_t                          deviceIdx,
+    Util::MetroHash::Hash*            pIdentifierCacheId) const
+{
+    Util::MetroHash128 hash = {};
+    hash.Update(pCreateInfo->basePipelineHash);
+    UpdateComputeCacheIdOptions(&hash, pCreateInfo, deviceIdx);
+    hash.Finalize(pIdentifierCacheId->bytes);
+}
+
 // =====================================================================================================================
 // Creates partial pipeline binary.
 VkResult PipelineCompiler::CreatePartialPipelineBinary(
@@ -629,6 +776,21 @@ VkResult PipelineCompiler::CreateGraphicsPipelineBinary(
     bool                   shouldCompile = true;
     const RuntimeSettings& settings      = m_pPhysicalDevice->GetRuntimeSettings();
 
+    if (pCreateInfo->usesModuleIdentifiers)
+    {
+        Util::MetroHash::Hash identifierCacheId = {};
+        GetGraphicsIdentifierCacheId(pCreateInfo, deviceIdx, &identifierCacheId);
+
+        return LoadPipelineBinaryFromIdentifiers(
+            (pPipelineCache != nullptr) ? pPipelineCache->GetPipelineCache() : nullptr,
+            &identifierCacheId,
+            pCacheId,
+            pPipelineBinarySize,
+            ppPipelineBinary,
+            &pCreateInfo->freeCompilerBinary,
+            &pCreateInfo->pipelineFeedback);
+    }
+
     int64_t compileTime = 0;
     uint64_t pipelineHash = Vkgc::IPipelineDumper::GetPipelineHash(&pCreateInfo->pipelineInfo);
 
@@ -696,6 +858,9 @@ VkResult PipelineCompiler::CreateGraphicsPipelineBinary(
     bool isUserCacheHit     = false;
     bool isInternalCacheHit = false;
 
+    bool                  storeIdentifierCacheId = false;
+    Util::MetroHash::Hash identifierCacheId      = {};
+
     PipelineBinaryCache* pPipelineBinaryCache = nullptr;
 
     if ((pPipelineCache != nullptr) && (pPipelineCache->GetPipelineCache() != nullptr))
@@ -708,25 +873,13 @@ VkResult PipelineCompiler::CreateGraphicsPipelineBinary(
         int64_t startTime = Util::GetPerfCpuTime();
         Util::MetroHash128 hash = {};
         hash.Update(pipelineHash);
-        hash.Update(pCreateInfo->pipelineInfo.vs.options);
-        hash.Update(pCreateInfo->pipelineInfo.tes.options);
-        hash.Update(pCreateInfo->pipelineInfo.tcs.options);
-        hash.Update(pCreateInfo->pipelineInfo.gs.options);
-        hash.Update(pCreateInfo->pipelineInfo.fs.options);
-        hash.Update(pCreateInfo->pipelineInfo.options);
-        hash.Update(pCreateInfo->pipelineInfo.nggState);
-        hash.Update(GetCacheIdControlFlags(pCreateInfo->flags));
-        hash.Update(pCreateInfo->dbFormat);
-        hash.Update(pCreateInfo->pipelineProfileKey);
-        hash.Update(deviceIdx);
-        hash.Update(pCreateInfo->compilerType);
-        hash.Update(pCreateInfo->pipelineInfo.dynamicVertexStride);
-        if (pCreateInfo->compilerType == PipelineCompilerTypeLlpc)
-        {
-            hash.Update(reinterpret_cast<const uint8_t*>(settings.llpcOptions), sizeof(settings.llpcOptions));
-        }
+        UpdateGraphicsCacheIdOptions(&hash, pCreateInfo, deviceIdx);
         hash.Finalize(pCacheId->bytes);
 
+        // Shader replacement changes the pipeline without changing its API state
+        storeIdentifierCacheId = (shaderModuleReplaced == false);
+        GetGraphicsIdentifierCacheId(pCreateInfo, deviceIdx, &identifierCacheId);
+
         cacheResult = GetCachedPipelineBinary(pCacheId, pPipelineBinaryCache, pPipelineBinarySize, ppPipelineBinary,
             &isUserCacheHit, &isInternalCacheHit, &pCreateInfo->freeCompilerBinary, &pCreateInfo->pipelineFeedback);
         if (cacheResult == Util::Result::Success)
@@ -779,6 +932,11 @@ VkResult PipelineCompiler::CreateGraphicsPipelineBinary(
             *ppPipelineBinary);
 
         VK_ASSERT(Util::IsErrorResult(cacheResult) == false);
+
+        if (storeIdentifierCacheId)
+        {
+            StoreIdentifierCacheId(pPipelineBinaryCache, &identifierCacheId, pCacheId);
+        }
     }
 
     if ((m_pBinaryCache != nullptr) &&
@@ -791,6 +949,11 @@ VkResult PipelineCompiler::CreateGraphicsPipelineBinary(
             *ppPipelineBinary);
 
         VK_ASSERT(Util::IsErrorResult(cacheResult) == false);
+
+        if (storeIdentifierCacheId)
+        {
+            StoreIdentifierCacheId(m_pBinaryCache, &identifierCacheId, pCacheId);
+        }
     }
 
     m_totalTimeSpent += shouldCompile ? compileTime : cacheTime;
@@ -827,6 +990,59 @@ VkResult PipelineCompiler::CreateGraphicsPipelineBinary(
     return result;
 }
 
+// =====================================================================================================================
+// Compiles a graphics pipeline made of a subset of the shader stages of a complete pipeline (e.g. the shaders held by a
+// graphics pipeline library) so that the compiler's shader cache holds them when the complete pipeline is built.  The
+// binary itself is discarded and is not stored in the pipeline binary caches.
+VkResult PipelineCompiler::BuildGraphicsPipelinePart(
+    Device*                             pDevice,
+    uint32_t                            deviceIdx,
+    PipelineCache*                      pPipelineCache,
+    GraphicsPipelineCreateInfo*         pCreateInfo)
+{
+    VkResult result = VK_SUCCESS;
+
+    if ((pCreateInfo->compilerType == PipelineCompilerTypeLlpc) && (pCreateInfo->usesModuleIdentifiers == false))
+    {
+        Vkgc::PipelineShaderInfo* shaderInfos[ShaderStage::ShaderStageGfxCount] =
+        {
+            &pCreateInfo->pipelineInfo.vs,
+            &pCreateInfo->pipelineInfo.tcs,
+            &pCreateInfo->pipelineInfo.tes,
+            &pCreateInfo->pipelineInfo.gs,
+            &pCreateInfo->pipelineInfo.fs,
+        };
+
+        size_t      pipelineBinarySize = 0;
+        const void* pPipelineBinary    = nullptr;
+        int64_t     compileTime        = 0;
+
+        result = m_compilerSolutionLlpc.CreateGraphicsPipelineBinary(
+            pDevice,
+            deviceIdx,
+            pPipelineCache,
+            pCreateInfo,
+            &pipelineBinarySize,
+            &pPipelineBinary,
+            0,
+            shaderInfos,
+            nullptr,
+            Vkgc::IPipelineDumper::GetPipelineHash(&pCreateInfo->pipelineInfo),
+            &compileTime);
+
+        if (result == VK_SUCCESS)
+        {
+            pCreateInfo->freeCompilerBinary = FreeWithCompiler;
+
+            FreeGraphicsPipelineBinary(pCreateInfo, pPipelineBinary, pipelineBinarySize);
+        }
+
+        m_totalTimeSpent += compileTime;
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Creates compute pipeline binary.
 VkResult PipelineCompiler::CreateComputePipelineBinary(
@@ -844,6 +1060,21 @@ VkResult PipelineCompiler::CreateComputePipelineBinary(
 
     pCreateInfo->pipelineInfo.deviceIndex = deviceIdx;
 
+    if (pCreateInfo->usesModuleIdentifiers)
+    {
+        Util::MetroHash::Hash identifierCacheId = {};
+        GetComputeIdentifierCacheId(pCreateInfo, deviceIdx, &identifierCacheId);
+
+        return LoadPipelineBinaryFromIdentifiers(
+            (pPipelineCache != nullptr) ? pPipelineCache->GetPipelineCache() : nullptr,
+            &identifierCacheId,
+            pCacheId,
+            pPipelineBinarySize,
+            ppPipelineBinary,
+            &pCreateInfo->freeCompilerBinary,
+            &pCreateInfo->pipelineFeedback);
+    }
+
     int64_t compileTime = 0;
     uint64_t pipelineHash = Vkgc::IPipelineDumper::GetPipelineHash(&pCreateInfo->pipelineInfo);
 
@@ -898,6 +1129,9 @@ VkResult PipelineCompiler::CreateComputePipelineBinary(
     bool isUserCacheHit     = false;
     bool isInternalCacheHit = false;
 
+    bool                  storeIdentifierCacheId = false;
+    Util::MetroHash::Hash identifierCacheId      = {};
+
     PipelineBinaryCache* pPipelineBinaryCache = nullptr;
 
     if ((pPipelineCache != nullptr) && (pPipelineCache->GetPipelineCache() != nullptr))
@@ -910,19 +1144,13 @@ VkResult PipelineCompiler::CreateComputePipelineBinary(
         int64_t startTime = Util::GetPerfCpuTime();
         Util::MetroHash128 hash = {};
         hash.Update(pipelineHash);
-        hash.Update(pCreateInfo->pipelineInfo.cs.options);
-        hash.Update(pCreateInfo->pipelineInfo.options);
-        hash.Update(GetCacheIdControlFlags(pCreateInfo->flags));
-        hash.Update(pCreateInfo->pipelineProfileKey);
-        hash.Update(deviceIdx);
-        hash.Update(pCreateInfo->compilerType);
-        hash.Update(settings.forceCsThreadGroupSwizzleMode);
-        if (pCreateInfo->compilerType == PipelineCompilerTypeLlpc)
-        {
-            hash.Update(reinterpret_cast<const uint8_t*>(settings.llpcOptions), sizeof(settings.llpcOptions));
-        }
+        UpdateComputeCacheIdOptions(&hash, pCreateInfo, deviceIdx);
         hash.Finalize(pCacheId->bytes);
 
+        // Shader replacement changes the pipeline without changing its API state
+        storeIdentifierCacheId = (shaderModuleReplaced == false);
+        GetComputeIdentifierCacheId(pCreateInfo, deviceIdx, &identifierCacheId);
+
         cacheResult = GetCachedPipelineBinary(pCacheId, pPipelineBinaryCache, pPipelineBinarySize, ppPipelineBinary,
             &isUserCacheHit, &isInternalCacheHit, &pCreateInfo->freeCompilerBinary, &pCreateInfo->pipelineFeedback);
         if (cacheResult == Util::Result::Success)
@@ -972,6 +1200,11 @@ VkResult PipelineCompiler::CreateComputePipelineBinary(
             *ppPipelineBinary);
 
         VK_ASSERT(Util::IsErrorResult(cacheResult) == false);
+
+        if (storeIdentifierCacheId)
+        {
+            StoreIdentifierCacheId(pPipelineBinaryCache, &identifierCacheId, pCacheId);
+        }
     }
 
     if ((m_pBinaryCache != nullptr) &&
@@ -984,6 +1217,11 @@ VkResult PipelineCompiler::CreateComputePipelineBinary(
             *ppPipelineBinary);
 
         VK_ASSERT(Util::IsErrorResult(cacheResult) == false);
+
+        if (storeIdentifierCacheId)
+        {
+            StoreIdentifierCacheId(m_pBinaryCache, &identifierCacheId, pCacheId);
+        }
     }
 
     m_totalTimeSpent += shouldCompile ? compileTime : cacheTime;
@@ -1120,6 +1358,29 @@ VkResult PipelineCompiler::SetPipelineCreationFeedbackInfo(
     return VK_SUCCESS;
 }
 
+// =====================================================================================================================
+// Returns true if the given state is listed in the pipeline's dynamic state
+static bool IsDynamicStateEnabled(
+    const VkPipelineDynamicStateCreateInfo* pDynamicState,
+    VkDynamicState                          dynamicState)
+{
+    bool enabled = false;
+
+    if (pDynamicState != nullptr)
+    {
+        for (uint32_t i = 0; i < pDynamicState->dynamicStateCount; ++i)
+        {
+            if (pDynamicState->pDynamicStates[i] == dynamicState)
+            {
+                enabled = true;
+                break;
+            }
+        }
+    }
+
+    return enabled;
+}
+
 // =====================================================================================================================
 // Converts Vulkan graphics pipeline parameters to an internal structure
 VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
@@ -1151,6 +1412,7 @@ VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
 
     // Fill in necessary non-zero defaults in case some information is missing
     const RenderPass* pRenderPass = nullptr;
+    const VkPipelineRenderingCreateInfoKHR* pPipelineRenderingCreateInfo = nullptr;
     const PipelineLayout* pLayout = nullptr;
     const VkPipelineShaderStageCreateInfo* pStageInfos[ShaderStage::ShaderStageGfxCount] = {};
 
@@ -1174,6 +1436,14 @@ VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
 
         pRenderPass = RenderPass::ObjectFromHandle(pGraphicsPipelineCreateInfo->renderPass);
 
+        // Without a render pass the pipeline is used with dynamic rendering, which provides the attachment formats
+        if (pRenderPass == nullptr)
+        {
+            pPipelineRenderingCreateInfo = utils::GetExtensionStructure<VkPipelineRenderingCreateInfoKHR>(
+                pGraphicsPipelineCreateInfo,
+                VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR);
+        }
+
         if (pGraphicsPipelineCreateInfo->layout != VK_NULL_HANDLE)
         {
             pLayout = PipelineLayout::ObjectFromHandle(pGraphicsPipelineCreateInfo->layout);
@@ -1186,9 +1456,18 @@ VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
         // According to the spec this should never be null
         VK_ASSERT(pIa != nullptr);
 
-        pCreateInfo->pipelineInfo.iaState.enableMultiView    = (pRenderPass != nullptr) ?
-                                                                pRenderPass->IsMultiviewEnabled() :
-                                                                0;
+        if (pRenderPass != nullptr)
+        {
+            pCreateInfo->pipelineInfo.iaState.enableMultiView = pRenderPass->IsMultiviewEnabled();
+        }
+        else if (pPipelineRenderingCreateInfo != nullptr)
+        {
+            pCreateInfo->pipelineInfo.iaState.enableMultiView = (pPipelineRenderingCreateInfo->viewMask != 0);
+        }
+        else
+        {
+            pCreateInfo->pipelineInfo.iaState.enableMultiView = 0;
+        }
 
         pCreateInfo->pipelineInfo.iaState.topology           = pIa->topology;
         pCreateInfo->pipelineInfo.iaState.disableVertexReuse = false;
@@ -1228,8 +1507,13 @@ VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
 
         if (pRs != nullptr)
         {
+            // Dynamic rasterizer discard is applied at draw time, so the pipeline itself must keep rasterizing
+            const bool dynamicRasterizerDiscard =
+                IsDynamicStateEnabled(pIn->pDynamicState, VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT);
+
             pCreateInfo->pipelineInfo.vpState.depthClipEnable         = (pRs->depthClampEnable == VK_FALSE);
-            pCreateInfo->pipelineInfo.rsState.rasterizerDiscardEnable = (pRs->rasterizerDiscardEnable != VK_FALSE);
+            pCreateInfo->pipelineInfo.rsState.rasterizerDiscardEnable = (pRs->rasterizerDiscardEnable != VK_FALSE) &&
+                                                                        (dynamicRasterizerDiscard == false);
             pCreateInfo->pipelineInfo.rsState.polygonMode             = pRs->polygonMode;
             pCreateInfo->pipelineInfo.rsState.cullMode                = pRs->cullMode;
             pCreateInfo->pipelineInfo.rsState.frontFace               = pRs->frontFace;
@@ -1269,11 +1553,14 @@ VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
 
             if (multisampleEnable)
             {
-                VK_ASSERT(pRenderPass != nullptr);
+                VK_ASSERT((pRenderPass != nullptr) || (pPipelineRenderingCreateInfo != nullptr));
 
+                // With dynamic rendering all attachments have rasterizationSamples samples
                 uint32_t rasterizationSampleCount   = pMs->rasterizationSamples;
-                uint32_t subpassCoverageSampleCount = pRenderPass->GetSubpassMaxSampleCount(pGraphicsPipelineCreateInfo->subpass);
-                uint32_t subpassColorSampleCount    = pRenderPass->GetSubpassColorSampleCount(pGraphicsPipelineCreateInfo->subpass);
+                uint32_t subpassCoverageSampleCount = (pRenderPass != nullptr) ?
+                    pRenderPass->GetSubpassMaxSampleCount(pGraphicsPipelineCreateInfo->subpass) : rasterizationSampleCount;
+                uint32_t subpassColorSampleCount    = (pRenderPass != nullptr) ?
+                    pRenderPass->GetSubpassColorSampleCount(pGraphicsPipelineCreateInfo->subpass) : rasterizationSampleCount;
 
                 // subpassCoverageSampleCount would be equal to zero if there are zero attachments.
                 subpassCoverageSampleCount = subpassCoverageSampleCount == 0 ? rasterizationSampleCount : subpassCoverageSampleCount;
@@ -1319,13 +1606,19 @@ VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
                 {
                     cbFormat = pRenderPass->GetColorAttachmentFormat(pGraphicsPipelineCreateInfo->subpass, i);
                 }
+                else if ((pPipelineRenderingCreateInfo != nullptr) &&
+                         (i < pPipelineRenderingCreateInfo->colorAttachmentCount))
+                {
+                    cbFormat = pPipelineRenderingCreateInfo->pColorAttachmentFormats[i];
+                }
 
                 // If the sub pass attachment format is UNDEFINED, then it means that that subpass does not
                 // want to write to any attachment for that output (VK_ATTACHMENT_UNUSED).  Under such cases,
                 // disable shader writes through that target. There is one exception for alphaToCoverageEnable
-                // and attachment zero, which can be set to VK_ATTACHMENT_UNUSED.
+                // and attachment zero, which can be set to VK_ATTACHMENT_UNUSED (dynamic rendering has no
+                // render pass attachment to fall back to).
                 if ((cbFormat != VK_FORMAT_UNDEFINED) ||
-                    (pCreateInfo->pipelineInfo.cbState.alphaToCoverageEnable && (i == 0u)))
+                    (pCreateInfo->pipelineInfo.cbState.alphaToCoverageEnable && (i == 0u) && (pRenderPass != nullptr)))
                 {
                     pLlpcCbDst->format               = cbFormat != VK_FORMAT_UNDEFINED ? cbFormat  : pRenderPass->GetAttachmentDesc(i).format;
                     pLlpcCbDst->blendEnable          = (src.blendEnable == VK_TRUE);
@@ -1348,6 +1641,12 @@ VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
         {
             dbFormat = pRenderPass->GetDepthStencilAttachmentFormat(pGraphicsPipelineCreateInfo->subpass);
         }
+        else if (pPipelineRenderingCreateInfo != nullptr)
+        {
+            dbFormat = (pPipelineRenderingCreateInfo->depthAttachmentFormat != VK_FORMAT_UNDEFINED) ?
+                       pPipelineRenderingCreateInfo->depthAttachmentFormat :
+                       pPipelineRenderingCreateInfo->stencilAttachmentFormat;
+        }
 
         pCreateInfo->dbFormat = dbFormat;
     }
@@ -1457,8 +1756,20 @@ VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
 
         stageMask |= (1 << stage);
 
-        auto pShaderModule = ShaderModule::ObjectFromHandle(pStage->module);
-        pShaderInfo->pModuleData           = pShaderModule->GetFirstValidShaderData();
+        // A stage given by a module identifier has no module data; such a pipeline can only be loaded from a cache
+        ShaderModuleIdentifier moduleIdentifier = {};
+
+        if (ShaderModule::GetStageIdentifier(*pStage, &moduleIdentifier))
+        {
+            pCreateInfo->usesModuleIdentifiers = true;
+        }
+        else
+        {
+            auto pShaderModule = ShaderModule::ObjectFromHandle(pStage->module);
+            pShaderModule->GetIdentifier(&moduleIdentifier);
+            pShaderInfo->pModuleData = pShaderModule->GetFirstValidShaderData();
+        }
+
         pShaderInfo->pSpecializationInfo   = pStage->pSpecializationInfo;
         pShaderInfo->pEntryTarget          = pStage->pName;
         pShaderInfo->entryStage = static_cast<Vkgc::ShaderStage>(stage);
@@ -1474,7 +1785,7 @@ VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
 
         ApplyProfileOptions(pDevice,
                             static_cast<ShaderStage>(stage),
-                            pShaderModule,
+                            moduleIdentifier,
                             &pCreateInfo->pipelineInfo.options,
                             pShaderInfo,
                             &pCreateInfo->pipelineProfileKey,
@@ -1586,23 +1897,16 @@ VkResult PipelineCompiler::ConvertGraphicsPipelineInfo(
         auto pStage = pStageInfos[stage];
         auto pShaderInfo = shaderInfos[stage];
 
-        if (pStage == nullptr)
+        if ((pStage == nullptr) || (pStage->module == VK_NULL_HANDLE))
             continue;
 
         auto pShaderModule = ShaderModule::ObjectFromHandle(pStage->module);
         pShaderInfo->pModuleData = pShaderModule->GetShaderData(pCreateInfo->compilerType);
     }
 
-    if (pIn->pDynamicState != nullptr)
+    if (IsDynamicStateEnabled(pIn->pDynamicState, VK_DYNAMIC_STATE_VERTEX_INPUT_BINDING_STRIDE_EXT))
     {
-        for( uint32_t ndx = 0; ndx < pIn->pDynamicState->dynamicStateCount; ++ndx)
-        {
-            if(pIn->pDynamicState->pDynamicStates[ndx] == VK_DYNAMIC_STATE_VERTEX_INPUT_BINDING_STRIDE_EXT)
-            {
-                pCreateInfo->pipelineInfo.dynamicVertexStride = true;
-                break;
-            }
-        }
+        pCreateInfo->pipelineInfo.dynamicVertexStride = true;
     }
 
     pCreateInfo->freeCompilerBinary = FreeWithCompiler;
@@ -1726,9 +2030,22 @@ VkResult PipelineCompiler::ConvertComputePipelineInfo(
 
     ApplyPipelineOptions(pDevice, pIn->flags, &pCreateInfo->pipelineInfo.options);
 
-    ShaderModule* pShaderModule = ShaderModule::ObjectFromHandle(pIn->stage.module);
+    // A stage given by a module identifier has no module data; such a pipeline can only be loaded from a cache
+    ShaderModule*          pShaderModule    = nullptr;
+    ShaderModuleIdentifier moduleIdentifier = {};
+
+    if (ShaderModule::GetStageIdentifier(pIn->stage, &moduleIdentifier))
+    {
+        pCreateInfo->usesModuleIdentifiers = true;
+    }
+    else
+    {
+        pShaderModule = ShaderModule::ObjectFromHandle(pIn->stage.module);
+        pShaderModule->GetIdentifier(&moduleIdentifier);
+
+        pCreateInfo->pipelineInfo.cs.pModuleData = pShaderModule->GetFirstValidShaderData();
+    }
 
-    pCreateInfo->pipelineInfo.cs.pModuleData         = pShaderModule->GetFirstValidShaderData();
     pCreateInfo->pipelineInfo.cs.pSpecializationInfo = pIn->stage.pSpecializationInfo;
     pCreateInfo->pipelineInfo.cs.pEntryTarget        = pIn->stage.pName;
     pCreateInfo->pipelineInfo.cs.entryStage          = Vkgc::ShaderStageCompute;
@@ -1816,7 +2133,11 @@ VkResult PipelineCompiler::ConvertComputePipelineInfo(
     }
 
     pCreateInfo->compilerType = CheckCompilerType(&pCreateInfo->pipelineInfo);
-    pCreateInfo->pipelineInfo.cs.pModuleData = pShaderModule->GetShaderData(pCreateInfo->compilerType);
+
+    if (pShaderModule != nullptr)
+    {
+        pCreateInfo->pipelineInfo.cs.pModuleData = pShaderModule->GetShaderData(pCreateInfo->compilerType);
+    }
 
     ApplyDefaultShaderOptions(ShaderStage::ShaderStageCompute,
                               &pCreateInfo->pipelineInfo.cs.options
@@ -1824,7 +2145,7 @@ VkResult PipelineCompiler::ConvertComputePipelineInfo(
 
     ApplyProfileOptions(pDevice,
                         ShaderStage::ShaderStageCompute,
-                        pShaderModule,
+                        moduleIdentifier,
                         nullptr,
                         &pCreateInfo->pipelineInfo.cs,
                         &pCreateInfo->pipelineProfileKey,
@@ -1875,13 +2196,13 @@ void PipelineCompiler::ApplyDefaultShaderOptions(
 // =====================================================================================================================
 // Builds app profile key and applies profile options.
 void PipelineCompiler::ApplyProfileOptions(
-    Device*                      pDevice,
-    ShaderStage                  stage,
-    ShaderModule*                pShaderModule,
-    Vkgc::PipelineOptions*       pPipelineOptions,
-    Vkgc::PipelineShaderInfo*    pShaderInfo,
-    PipelineOptimizerKey*        pProfileKey,
-    Vkgc::NggState*              pNggState
+    Device*                       pDevice,
+    ShaderStage                   stage,
+    const ShaderModuleIdentifier& moduleIdentifier,
+    Vkgc::PipelineOptions*        pPipelineOptions,
+    Vkgc::PipelineShaderInfo*     pShaderInfo,
+    PipelineOptimizerKey*         pProfileKey,
+    Vkgc::NggState*               pNggState
     )
 {
     auto&    settings  = m_pPhysicalDevice->GetRuntimeSettings();
@@ -1891,7 +2212,7 @@ void PipelineCompiler::ApplyProfileOptions(
     options.pNggState    = pNggState;
 
     auto& shaderKey = pProfileKey->shaders[stage];
-    if (settings.pipelineUseShaderHashAsProfileHash)
+    if (settings.pipelineUseShaderHashAsProfileHash && (pShaderInfo->pModuleData != nullptr))
     {
         const void* pModuleData = pShaderInfo->pModuleData;
         shaderKey.codeHash.lower = Vkgc::IPipelineDumper::GetShaderHash(pModuleData);
@@ -1902,9 +2223,9 @@ void PipelineCompiler::ApplyProfileOptions(
         // Populate the pipeline profile key.  The hash used by the profile is different from the default
         // internal hash in that it only depends on the SPIRV code + entry point.  This is to reduce the
         // chance that internal changes to our hash calculation logic drop us off pipeline profiles.
-        shaderKey.codeHash = pShaderModule->GetCodeHash(pShaderInfo->pEntryTarget);
+        shaderKey.codeHash = ShaderModule::GetCodeHash(moduleIdentifier.codeHash, pShaderInfo->pEntryTarget);
     }
-    shaderKey.codeSize = pShaderModule->GetCodeSize();
+    shaderKey.codeSize = moduleIdentifier.codeSize;
 
     // Override the compile parameters based on any app profile
     auto* pShaderOptimizer = pDevice->GetShaderOptimizer();
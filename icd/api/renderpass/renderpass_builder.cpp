@@ -714,6 +714,10 @@ Pal::Result RenderPassBuilder::BuildResolveAttachmentReferences(
                     resolve.dst.attachment = dst.attachment;
                     resolve.dst.layout     = m_pAttachments[dst.attachment].prevReferenceLayout;
 
+                    resolve.planeCount = 1;
+                    resolve.planes[0]  = 0;
+                    resolve.modes[0]   = Pal::ResolveMode::Average;
+
                     result = pSubpass->resolves.PushBack(resolve);
 
                     VK_ASSERT(Formats::IsColorFormat(m_pAttachments[resolve.src.attachment].pDesc->format));
@@ -777,6 +781,29 @@ Pal::Result RenderPassBuilder::BuildResolveAttachmentReferences(
                 resolve.dst.layout        = m_pAttachments[dst.attachment].prevReferenceLayout;
                 resolve.dst.stencilLayout = m_pAttachments[dst.attachment].prevReferenceStencilLayout;
 
+                // Depth and stencil may have different resolve modes, so each plane is resolved independently.
+                const VkFormat              resolveFormat      = m_pAttachments[src.attachment].pDesc->format;
+                const VkResolveModeFlagBits depthResolveMode   = subpassDesc.depthResolveMode;
+                const VkResolveModeFlagBits stencilResolveMode = subpassDesc.stencilResolveMode;
+
+                if (Formats::HasDepth(resolveFormat))
+                {
+                    if (depthResolveMode != VK_RESOLVE_MODE_NONE)
+                    {
+                        resolve.modes[resolve.planeCount]    = VkToPalResolveMode(depthResolveMode);
+                        resolve.planes[resolve.planeCount++] = 0;
+                    }
+
+                    // Must be specified because the source image was created with sampleLocsAlwaysKnown set
+                    resolve.needsSampleLocations = true;
+                }
+
+                if (Formats::HasStencil(resolveFormat) && (stencilResolveMode != VK_RESOLVE_MODE_NONE))
+                {
+                    resolve.modes[resolve.planeCount]    = VkToPalResolveMode(stencilResolveMode);
+                    resolve.planes[resolve.planeCount++] = Formats::HasDepth(resolveFormat) ? 1 : 0;
+                }
+
                 result = pSubpass->resolves.PushBack(resolve);
 
                 VK_ASSERT(Formats::IsDepthStencilFormat(m_pAttachments[resolve.src.attachment].pDesc->format));
@@ -944,6 +971,21 @@ void RenderPassBuilder::PostProcessSyncPoint(
         pSyncPoint->barrier.implicitDstCacheMask != 0)
     {
         pSyncPoint->barrier.flags.needsGlobalTransition = 1;
+
+        // Resolve the cache masks of the global transition here rather than at every sync point execution
+        Pal::BarrierTransition globalTransition = { };
+
+        m_pDevice->GetBarrierPolicy().ApplyBarrierCacheFlags(
+            pSyncPoint->barrier.srcAccessMask,
+            pSyncPoint->barrier.dstAccessMask,
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_IMAGE_LAYOUT_GENERAL,
+            &globalTransition);
+
+        pSyncPoint->barrier.globalSrcCacheMask = globalTransition.srcCacheMask |
+                                                 pSyncPoint->barrier.implicitSrcCacheMask;
+        pSyncPoint->barrier.globalDstCacheMask = globalTransition.dstCacheMask |
+                                                 pSyncPoint->barrier.implicitDstCacheMask;
     }
 
     // The barrier is active if it does any waiting or global cache synchronization or attachment transitions
@@ -33,11 +33,14 @@
 #include "include/vk_alloccb.h"
 #include "include/vk_dispatch.h"
 
+#include "palCmdBuffer.h"
 #include "palVector.h"
 
 namespace vk
 {
 
+class Image;
+
 // Image layout structure to describe a render pass attachment's layout in a subpass.  It is basically the same as
 // a VkImageLayout with some additional internal flags.
 struct RPImageLayout
@@ -92,6 +95,13 @@ struct RPResolveInfo
 {
     RPAttachmentReference src; // Attachment to resolve from
     RPAttachmentReference dst; // Attachment to resolve to
+
+    // Per-plane resolve parameters, resolved when the render pass is built
+    uint32_t              planeCount;                       // Number of planes to resolve
+    uint32_t              planes[MaxRangePerAttachment];    // Plane index of each resolve
+    Pal::ResolveMode      modes[MaxRangePerAttachment];     // Resolve mode of each plane
+    bool                  needsSampleLocations;             // The source has depth, whose resolve needs the sample
+                                                            // locations of the subpass
 };
 
 // Information about which color/depth-stencil targets are bound for a subpass's contents
@@ -117,6 +127,8 @@ struct RPBarrierInfo
     Pal::HwPipePoint     pipePoints[MaxHwPipePoints];
     uint32_t             implicitSrcCacheMask;
     uint32_t             implicitDstCacheMask;
+    uint32_t             globalSrcCacheMask;    // PAL cache masks of the global transition (including the implicit
+    uint32_t             globalDstCacheMask;    // masks above), valid if needsGlobalTransition is set
 
     union
     {
@@ -249,6 +261,72 @@ struct RenderPassExecuteInfo
     RPExecuteEndRenderPassInfo end;
 };
 
+// Sync points of a subpass in execution order.  Used to index the sync points of an RPInstanceProgram; the sync point
+// at the end of the render pass follows those of the last subpass.
+enum RPSyncPointSlot : uint32_t
+{
+    RPSyncPointTop = 0,
+    RPSyncPointPreResolve,
+    RPSyncPointBottom,
+    RPSyncPointSlotCount
+};
+
+constexpr uint32_t RPSyncPointIndex(uint32_t subpass, RPSyncPointSlot slot)
+    { return (subpass * RPSyncPointSlotCount) + slot; }
+
+// Sample pattern used by a precompiled layout transition
+enum RPSamplePatternSource : uint32_t
+{
+    RPSamplePatternNone = 0,    // Single-sampled attachment
+    RPSamplePatternInitial,     // Initial sample pattern of the attachment given at render pass begin
+    RPSamplePatternSubpass      // Sample pattern of the subpass owning the sync point
+};
+
+// Attachment plane changing layout in a precompiled layout transition
+struct RPTransitionTarget
+{
+    uint32_t              attachment;
+    uint32_t              plane;
+    RPSamplePatternSource samplePatternSource;
+    uint32_t              subpass;              // Subpass owning the sync point the transition came from
+};
+
+// A sync point with its attachment layout transitions resolved against a particular framebuffer.  The barrier can be
+// replayed as-is, apart from the sample patterns of multisampled attachments which are render pass instance state.
+struct RPSyncPointProgram
+{
+    Pal::BarrierInfo        barrier;                        // pPipePoints and pTransitions point into this program
+    Pal::HwPipePoint        pipePoints[MaxHwPipePoints];
+    Pal::BarrierTransition* pTransitions;
+    const Image**           ppImages;
+    RPTransitionTarget*     pTargets;                       // One per transition
+
+    union
+    {
+        struct
+        {
+            uint32_t execute           :  1; // The barrier needs to be issued
+            uint32_t merged            :  1; // Folded into an earlier sync point with no work in between
+            uint32_t hasSamplePatterns :  1; // Some transitions need a sample pattern at replay
+            uint32_t discardsContents  :  1; // Some transitions are out of an uninitialized layout
+            uint32_t reserved          : 28;
+        };
+        uint32_t u32All;
+    } flags;
+};
+
+// All sync points of a render pass instance resolved against a framebuffer for one queue family.  Indexed by
+// RPSyncPointIndex().
+struct RPInstanceProgram
+{
+    uint64_t            renderPassHash;
+    uint32_t            queueFamilyIndex;
+    uint32_t            syncPointCount;
+    RPSyncPointProgram* pSyncPoints;
+    uint32_t            refCount;           // Render pass instances being recorded with the program
+    RPInstanceProgram*  pNext;
+};
+
 } // namespace vk
 
 #endif /* __RENDERPASS_RENDERPASS_TYPES_H__ */
@@ -1095,6 +1095,49 @@ VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndexed(
     pSqtt->EndEntryPoint();
 }
 
+// =====================================================================================================================
+// RGP has no dedicated marker types for VK_EXT_multi_draw, so each draw of the batch is reported as a regular draw.
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawMultiEXT(
+    VkCommandBuffer                             cmdBuffer,
+    uint32_t                                    drawCount,
+    const VkMultiDrawInfoEXT*                   pVertexInfo,
+    uint32_t                                    instanceCount,
+    uint32_t                                    firstInstance,
+    uint32_t                                    stride)
+{
+    SQTT_SETUP();
+
+    pSqtt->BeginEntryPoint(RgpSqttMarkerGeneralApiType::CmdDraw);
+    pSqtt->BeginEventMarkers(RgpSqttMarkerEventType::CmdDraw);
+
+    SQTT_CALL_NEXT_LAYER(vkCmdDrawMultiEXT)(cmdBuffer, drawCount, pVertexInfo, instanceCount, firstInstance, stride);
+
+    pSqtt->EndEventMarkers();
+    pSqtt->EndEntryPoint();
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawMultiIndexedEXT(
+    VkCommandBuffer                             cmdBuffer,
+    uint32_t                                    drawCount,
+    const VkMultiDrawIndexedInfoEXT*            pIndexInfo,
+    uint32_t                                    instanceCount,
+    uint32_t                                    firstInstance,
+    uint32_t                                    stride,
+    const int32_t*                              pVertexOffset)
+{
+    SQTT_SETUP();
+
+    pSqtt->BeginEntryPoint(RgpSqttMarkerGeneralApiType::CmdDrawIndexed);
+    pSqtt->BeginEventMarkers(RgpSqttMarkerEventType::CmdDrawIndexed);
+
+    SQTT_CALL_NEXT_LAYER(vkCmdDrawMultiIndexedEXT)(cmdBuffer, drawCount, pIndexInfo, instanceCount, firstInstance,
+        stride, pVertexOffset);
+
+    pSqtt->EndEventMarkers();
+    pSqtt->EndEntryPoint();
+}
+
 // =====================================================================================================================
 VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndirect(
     VkCommandBuffer                             cmdBuffer,
@@ -1681,6 +1724,34 @@ VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderPass(
     pSqtt->EndEntryPoint();
 }
 
+// =====================================================================================================================
+// RGP has no dedicated marker types for VK_KHR_dynamic_rendering, so rendering instances are reported as render passes.
+VKAPI_ATTR void VKAPI_CALL vkCmdBeginRenderingKHR(
+    VkCommandBuffer                             cmdBuffer,
+    const VkRenderingInfoKHR*                   pRenderingInfo)
+{
+    SQTT_SETUP();
+
+    pSqtt->BeginEntryPoint(RgpSqttMarkerGeneralApiType::CmdBeginRenderPass);
+
+    SQTT_CALL_NEXT_LAYER(vkCmdBeginRenderingKHR)(cmdBuffer, pRenderingInfo);
+
+    pSqtt->EndEntryPoint();
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderingKHR(
+    VkCommandBuffer                             cmdBuffer)
+{
+    SQTT_SETUP();
+
+    pSqtt->BeginEntryPoint(RgpSqttMarkerGeneralApiType::CmdEndRenderPass);
+
+    SQTT_CALL_NEXT_LAYER(vkCmdEndRenderingKHR)(cmdBuffer);
+
+    pSqtt->EndEntryPoint();
+}
+
 // =====================================================================================================================
 VKAPI_ATTR void VKAPI_CALL vkCmdExecuteCommands(
     VkCommandBuffer                             cmdBuffer,
@@ -1965,7 +2036,9 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateGraphicsPipelines(
     {
         for (uint32_t i = 0; i < createInfoCount; ++i)
         {
-            if (pPipelines[i] != VK_NULL_HANDLE)
+            // Pipeline libraries have no hardware pipeline to report
+            if ((pPipelines[i] != VK_NULL_HANDLE) &&
+                ((pCreateInfos[i].flags & VK_PIPELINE_CREATE_LIBRARY_BIT_KHR) == 0))
             {
                 GraphicsPipeline* pPipeline = NonDispatchable<VkPipeline, GraphicsPipeline>::ObjectFromHandle(
                     pPipelines[i]);
@@ -2341,6 +2414,8 @@ void SqttOverrideDispatchTable(
     SQTT_OVERRIDE_ENTRY(vkCmdBindVertexBuffers);
     SQTT_OVERRIDE_ENTRY(vkCmdDraw);
     SQTT_OVERRIDE_ENTRY(vkCmdDrawIndexed);
+    SQTT_OVERRIDE_ENTRY(vkCmdDrawMultiEXT);
+    SQTT_OVERRIDE_ENTRY(vkCmdDrawMultiIndexedEXT);
     SQTT_OVERRIDE_ENTRY(vkCmdDrawIndirect);
     SQTT_OVERRIDE_ENTRY(vkCmdDrawIndexedIndirect);
     SQTT_OVERRIDE_ENTRY(vkCmdDrawIndirectCountAMD);
@@ -2371,6 +2446,8 @@ void SqttOverrideDispatchTable(
     SQTT_OVERRIDE_ENTRY(vkCmdBeginRenderPass);
     SQTT_OVERRIDE_ENTRY(vkCmdNextSubpass);
     SQTT_OVERRIDE_ENTRY(vkCmdEndRenderPass);
+    SQTT_OVERRIDE_ENTRY(vkCmdBeginRenderingKHR);
+    SQTT_OVERRIDE_ENTRY(vkCmdEndRenderingKHR);
     SQTT_OVERRIDE_ENTRY(vkCmdExecuteCommands);
     SQTT_OVERRIDE_ENTRY(vkCmdSetViewport);
     SQTT_OVERRIDE_ENTRY(vkCmdSetScissor);
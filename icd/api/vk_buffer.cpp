@@ -23,6 +23,7 @@
  *
  **********************************************************************************************************************/
 
+#include "include/gpu_address_map.h"
 #include "include/vk_buffer.h"
 #include "include/vk_conv.h"
 #include "include/vk_device.h"
@@ -44,7 +45,6 @@ namespace vk
 Buffer::Buffer(
     Device*                      pDevice,
     const VkAllocationCallbacks* pAllocator,
-    VkBufferCreateFlags          flags,
     VkBufferUsageFlags           usage,
     Pal::IGpuMemory**            pGpuMemory,
     VkSharingMode                sharingMode,
@@ -62,12 +62,7 @@ Buffer::Buffer(
         queueFamilyIndexCount,
         pQueueFamilyIndices)
 {
-    m_internalFlags.u32All                = internalFlags.u32All;
-    m_internalFlags.usageUniformBuffer    = (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)    ? 1 : 0;
-    m_internalFlags.createSparseBinding   = (flags & VK_BUFFER_CREATE_SPARSE_BINDING_BIT)   ? 1 : 0;
-    m_internalFlags.createSparseResidency = (flags & VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT) ? 1 : 0;
-    m_internalFlags.createProtected       = (flags & VK_BUFFER_CREATE_PROTECTED_BIT)        ? 1 : 0;
-    // Note: The VK_BUFFER_CREATE_DEVICE_ADDRESS_CAPTURE_REPLAY_BIT is only used in vk_memory objects.
+    m_internalFlags.u32All = internalFlags.u32All;
 
     for (uint32_t deviceIdx = 0; deviceIdx < pDevice->NumPalDevices(); deviceIdx++)
     {
@@ -85,6 +80,55 @@ Buffer::Buffer(
 
 }
 
+// =====================================================================================================================
+// Derives the internal buffer flags from the buffer create info
+Buffer::BufferFlags Buffer::ConvertBufferCreateInfo(
+    const Device*             pDevice,
+    const VkBufferCreateInfo* pCreateInfo)
+{
+    BufferFlags bufferFlags;
+
+    bufferFlags.u32All = 0;
+
+    bufferFlags.usageUniformBuffer    = (pCreateInfo->usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)    ? 1 : 0;
+    bufferFlags.createSparseBinding   = (pCreateInfo->flags & VK_BUFFER_CREATE_SPARSE_BINDING_BIT)   ? 1 : 0;
+    bufferFlags.createSparseResidency = (pCreateInfo->flags & VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT) ? 1 : 0;
+    bufferFlags.createProtected       = (pCreateInfo->flags & VK_BUFFER_CREATE_PROTECTED_BIT)        ? 1 : 0;
+    // Note: The VK_BUFFER_CREATE_DEVICE_ADDRESS_CAPTURE_REPLAY_BIT is only used in vk_memory objects.
+
+    const VkExternalMemoryBufferCreateInfo* pExternalInfo =
+        static_cast<const VkExternalMemoryBufferCreateInfo*>(pCreateInfo->pNext);
+    if ((pExternalInfo != nullptr) &&
+        (pExternalInfo->sType == VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO))
+    {
+        VkExternalMemoryProperties externalMemoryProperties = {};
+
+        pDevice->VkPhysicalDevice(DefaultDeviceIndex)->GetExternalMemoryProperties(
+            (pCreateInfo->flags & SparseEnablingFlags) != 0,
+            false,
+            static_cast<VkExternalMemoryHandleTypeFlagBits>(pExternalInfo->handleTypes),
+            &externalMemoryProperties);
+
+        if (externalMemoryProperties.externalMemoryFeatures & VK_EXTERNAL_MEMORY_FEATURE_DEDICATED_ONLY_BIT)
+        {
+            bufferFlags.dedicatedRequired = true;
+        }
+
+        if (externalMemoryProperties.externalMemoryFeatures & (VK_EXTERNAL_MEMORY_FEATURE_EXPORTABLE_BIT |
+                                                               VK_EXTERNAL_MEMORY_FEATURE_IMPORTABLE_BIT))
+        {
+            bufferFlags.externallyShareable = true;
+
+            if (pExternalInfo->handleTypes & VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT)
+            {
+                bufferFlags.externalPinnedHost = true;
+            }
+        }
+    }
+
+    return bufferFlags;
+}
+
 // =====================================================================================================================
 // Create a new Vulkan Buffer object
 VkResult Buffer::Create(
@@ -176,51 +220,15 @@ VkResult Buffer::Create(
         }
     }
 
-    BufferFlags bufferFlags;
-
-    bufferFlags.u32All = 0;
-
     if (palResult == Pal::Result::Success)
     {
-        const VkExternalMemoryBufferCreateInfo* pExternalInfo =
-            static_cast<const VkExternalMemoryBufferCreateInfo*>(pCreateInfo->pNext);
-        if ((pExternalInfo != nullptr) &&
-            (pExternalInfo->sType == VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO))
-        {
-            VkExternalMemoryProperties externalMemoryProperties = {};
-
-            pDevice->VkPhysicalDevice(DefaultDeviceIndex)->GetExternalMemoryProperties(
-                isSparse,
-                false,
-                static_cast<VkExternalMemoryHandleTypeFlagBits>(pExternalInfo->handleTypes),
-                &externalMemoryProperties);
-
-            if (externalMemoryProperties.externalMemoryFeatures & VK_EXTERNAL_MEMORY_FEATURE_DEDICATED_ONLY_BIT)
-            {
-                bufferFlags.dedicatedRequired = true;
-            }
-
-            if (externalMemoryProperties.externalMemoryFeatures & (VK_EXTERNAL_MEMORY_FEATURE_EXPORTABLE_BIT |
-                                                                   VK_EXTERNAL_MEMORY_FEATURE_IMPORTABLE_BIT))
-            {
-                bufferFlags.externallyShareable = true;
+        BufferFlags bufferFlags = ConvertBufferCreateInfo(pDevice, pCreateInfo);
 
-                if (pExternalInfo->handleTypes & VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT)
-                {
-                    bufferFlags.externalPinnedHost = true;
-                }
-            }
-        }
-    }
-
-    if (palResult == Pal::Result::Success)
-    {
         bufferFlags.internalMemBound = isSparse;
 
         // Construct API buffer object.
         VK_PLACEMENT_NEW (pMemory) Buffer (pDevice,
                                            pAllocator,
-                                           pCreateInfo->flags,
                                            pCreateInfo->usage,
                                            pGpuMemory,
                                            pCreateInfo->sharingMode,
@@ -235,6 +243,12 @@ VkResult Buffer::Create(
     if (palResult == Pal::Result::Success)
     {
         LogBufferCreate(size, pCreateInfo, *pBuffer, pDevice);
+
+        // Sparse buffers own their virtual address range from the start
+        if (isSparse && (size != 0))
+        {
+            Buffer::ObjectFromHandle(*pBuffer)->AddToGpuAddressMap(pDevice);
+        }
     }
 
     return PalToVkResult(palResult);
@@ -360,10 +374,23 @@ VkResult Buffer::Destroy(
         &data,
         sizeof(Pal::ResourceDestroyEventData));
 
+    GpuAddressMap* pAddressMap = pDevice->GetGpuAddressMap();
+
     for (uint32_t deviceIdx = 0; deviceIdx < pDevice->NumPalDevices(); deviceIdx++)
     {
         Pal::IGpuMemory* pMemoryObj = m_perGpu[deviceIdx].pGpuMemory;
 
+        if ((pAddressMap != nullptr) && (pMemoryObj != nullptr))
+        {
+            GpuAddressMap::Range range = {};
+            range.gpuVirtAddr = m_perGpu[deviceIdx].gpuVirtAddr;
+            range.size        = m_size;
+            range.type        = GpuAddressMap::ObjectType::Buffer;
+            range.pObject     = this;
+
+            pAddressMap->Remove(deviceIdx, range);
+        }
+
         if (m_internalFlags.internalMemBound == true)
         {
             if (IsSparse() == false)
@@ -426,27 +453,93 @@ VkResult Buffer::BindMemory(
                     m_perGpu[localDeviceIdx].pGpuMemory->Desc().gpuVirtAddr + memOffset;
             }
         }
+
+        AddToGpuAddressMap(pDevice);
     }
 
     return VK_SUCCESS;
 }
 
+// =====================================================================================================================
+// Registers the address range of this buffer on every device with the device's GPU address map, if there is one.
+void Buffer::AddToGpuAddressMap(
+    const Device* pDevice) const
+{
+    GpuAddressMap* pAddressMap = pDevice->GetGpuAddressMap();
+
+    if (pAddressMap != nullptr)
+    {
+        for (uint32_t deviceIdx = 0; deviceIdx < pDevice->NumPalDevices(); deviceIdx++)
+        {
+            if (m_perGpu[deviceIdx].pGpuMemory != nullptr)
+            {
+                GpuAddressMap::Range range = {};
+                range.gpuVirtAddr = m_perGpu[deviceIdx].gpuVirtAddr;
+                range.size        = m_size;
+                range.type        = GpuAddressMap::ObjectType::Buffer;
+                range.pObject     = this;
+
+                pAddressMap->Insert(deviceIdx, range);
+            }
+        }
+    }
+}
+
 // =====================================================================================================================
 // Get the buffer's memory requirements
 VkResult Buffer::GetMemoryRequirements(
     const Device*         pDevice,
     VkMemoryRequirements* pMemoryRequirements)
+{
+    CalculateMemoryRequirementsInternal(pDevice, m_size, m_internalFlags, pMemoryRequirements);
+
+    return VK_SUCCESS;
+}
+
+// =====================================================================================================================
+// Get the memory requirements of a buffer described by its create info, without creating the buffer
+void Buffer::CalculateMemoryRequirements(
+    const Device*             pDevice,
+    const VkBufferCreateInfo* pCreateInfo,
+    VkMemoryRequirements2*    pMemoryRequirements)
+{
+    const BufferFlags internalFlags = ConvertBufferCreateInfo(pDevice, pCreateInfo);
+
+    CalculateMemoryRequirementsInternal(
+        pDevice,
+        pCreateInfo->size,
+        internalFlags,
+        &pMemoryRequirements->memoryRequirements);
+
+    VkMemoryDedicatedRequirements* pMemDedicatedRequirements =
+        static_cast<VkMemoryDedicatedRequirements*>(pMemoryRequirements->pNext);
+
+    if ((pMemDedicatedRequirements != nullptr) &&
+        (pMemDedicatedRequirements->sType == VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS))
+    {
+        pMemDedicatedRequirements->prefersDedicatedAllocation  = internalFlags.dedicatedRequired;
+        pMemDedicatedRequirements->requiresDedicatedAllocation = internalFlags.dedicatedRequired;
+    }
+}
+
+// =====================================================================================================================
+// Calculates the memory requirements of a buffer of the given size and properties
+void Buffer::CalculateMemoryRequirementsInternal(
+    const Device*         pDevice,
+    VkDeviceSize          size,
+    BufferFlags           internalFlags,
+    VkMemoryRequirements* pMemoryRequirements)
 {
     pMemoryRequirements->alignment = 4;
 
     // In case of sparse buffers the alignment and granularity is the page size
-    if (m_internalFlags.createSparseBinding)
+    if (internalFlags.createSparseBinding)
     {
         pMemoryRequirements->alignment = Util::Max(pMemoryRequirements->alignment,
                                                    pDevice->GetProperties().virtualMemPageSize);
     }
 
-    if (m_internalFlags.usageUniformBuffer)
+    if (internalFlags.usageUniformBuffer)
     {
         constexpr VkDeviceSize UniformBufferAlignment = static_cast<VkDeviceSize>(sizeof(float) * 4);
 
@@ -454,13 +547,13 @@ VkResult Buffer::GetMemoryRequirements(
                                                    UniformBufferAlignment);
     }
 
-    pMemoryRequirements->size = Util::RoundUpToMultiple(m_size, pMemoryRequirements->alignment);
+    pMemoryRequirements->size = Util::RoundUpToMultiple(size, pMemoryRequirements->alignment);
 
     // MemoryRequirements cannot return smaller size than buffer size.
     // MAX_UINT64 can be used as buffer size.
-    if (m_size > pMemoryRequirements->size)
+    if (size > pMemoryRequirements->size)
     {
-        pMemoryRequirements->size = m_size;
+        pMemoryRequirements->size = size;
     }
 
     // Allow all available memory types for buffers
@@ -480,19 +573,19 @@ VkResult Buffer::GetMemoryRequirements(
     }
 
     // Limit heaps to those compatible with pinned system memory
-    if (m_internalFlags.externalPinnedHost)
+    if (internalFlags.externalPinnedHost)
     {
         pMemoryRequirements->memoryTypeBits &= pDevice->GetPinnedSystemMemoryTypes();
 
         VK_ASSERT(pMemoryRequirements->memoryTypeBits != 0);
     }
 
-    if (m_internalFlags.externallyShareable)
+    if (internalFlags.externallyShareable)
     {
         pMemoryRequirements->memoryTypeBits &= pDevice->GetMemoryTypeMaskForExternalSharing();
     }
 
-    if (m_internalFlags.createProtected)
+    if (internalFlags.createProtected)
     {
         // If the buffer is protected only keep the protected type
         pMemoryRequirements->memoryTypeBits &= pDevice->GetMemoryTypeMaskMatching(VK_MEMORY_PROPERTY_PROTECTED_BIT);
@@ -502,8 +595,6 @@ VkResult Buffer::GetMemoryRequirements(
         // Remove the protected types
         pMemoryRequirements->memoryTypeBits &= ~pDevice->GetMemoryTypeMaskMatching(VK_MEMORY_PROPERTY_PROTECTED_BIT);
     }
-
-    return VK_SUCCESS;
 }
 
 namespace entry
@@ -586,6 +677,17 @@ VKAPI_ATTR void VKAPI_CALL vkGetBufferMemoryRequirements2(
     }
 }
 
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceBufferMemoryRequirementsKHR(
+    VkDevice                                    device,
+    const VkDeviceBufferMemoryRequirementsKHR*  pInfo,
+    VkMemoryRequirements2*                      pMemoryRequirements)
+{
+    const Device* pDevice = ApiDevice::ObjectFromHandle(device);
+
+    Buffer::CalculateMemoryRequirements(pDevice, pInfo->pCreateInfo, pMemoryRequirements);
+}
+
 // =====================================================================================================================
 VKAPI_ATTR VkDeviceAddress VKAPI_CALL vkGetBufferDeviceAddress(
     VkDevice                                    device,
@@ -23,12 +23,14 @@
  *
  **********************************************************************************************************************/
 
+#include "include/gpu_address_map.h"
 #include "include/vk_buffer.h"
 #include "include/vk_cmdbuffer.h"
 #include "include/vk_compute_pipeline.h"
 #include "include/vk_conv.h"
 #include "include/vk_device.h"
 #include "include/vk_descriptor_set.h"
+#include "include/vk_descriptor_update_template.h"
 #include "include/vk_event.h"
 #include "include/vk_formats.h"
 #include "include/vk_framebuffer.h"
@@ -53,6 +55,7 @@
 #include "palQueryPool.h"
 #include "palSysMemory.h"
 #include "palDevice.h"
+#include "palFile.h"
 #include "palGpuUtil.h"
 #include "palFormatInfo.h"
 #include "palVectorImpl.h"
@@ -93,6 +96,76 @@ Pal::Box BuildClearBox(
     return box;
 }
 
+// =====================================================================================================================
+// Returns true if a render pass clear box covers every texel of the attachment's subresources.  Such clears can be
+// issued without a region, which lets PAL pick a metadata-only fast clear.
+bool IsFullSubresClearBox(
+    const Pal::Box&                box,
+    const Framebuffer::Attachment& attachment)
+{
+    return (attachment.pImage->Is2dArrayCompatible() == false)       &&
+           (box.offset.x == 0)                                       &&
+           (box.offset.y == 0)                                       &&
+           (box.extent.width  >= attachment.baseSubresExtent.width)  &&
+           (box.extent.height >= attachment.baseSubresExtent.height);
+}
+
+// =====================================================================================================================
+// Returns true if the outer box fully contains the inner box.
+bool BoxContains(
+    const Pal::Box& outer,
+    const Pal::Box& inner)
+{
+    return (inner.offset.x >= outer.offset.x) &&
+           (inner.offset.y >= outer.offset.y) &&
+           (inner.offset.z >= outer.offset.z) &&
+           ((inner.offset.x + static_cast<int32_t>(inner.extent.width)) <=
+            (outer.offset.x + static_cast<int32_t>(outer.extent.width)))  &&
+           ((inner.offset.y + static_cast<int32_t>(inner.extent.height)) <=
+            (outer.offset.y + static_cast<int32_t>(outer.extent.height))) &&
+           ((inner.offset.z + static_cast<int32_t>(inner.extent.depth)) <=
+            (outer.offset.z + static_cast<int32_t>(outer.extent.depth)));
+}
+
+// =====================================================================================================================
+// One PAL resolve of a render pass resolve attachment: all planes of an attachment that share a resolve mode and
+// layouts, for every render area.
+struct RPResolveOp
+{
+    const Image*            pSrcImage;
+    const Image*            pDstImage;
+    Pal::ImageLayout        srcLayout;
+    Pal::ImageLayout        dstLayout;
+    Pal::ResolveMode        mode;
+    uint32_t                samples;
+    uint32_t                regionCount;
+    Pal::ImageResolveRegion regions[MaxRangePerAttachment * MaxPalDevices];
+};
+
+// =====================================================================================================================
+// Orders render pass resolves such that the ones sharing a sample count and layouts are adjacent.
+bool RPResolveOpLess(
+    const RPResolveOp& lhs,
+    const RPResolveOp& rhs)
+{
+    bool less;
+
+    if (lhs.samples != rhs.samples)
+    {
+        less = (lhs.samples < rhs.samples);
+    }
+    else if (lhs.srcLayout.usages != rhs.srcLayout.usages)
+    {
+        less = (lhs.srcLayout.usages < rhs.srcLayout.usages);
+    }
+    else
+    {
+        less = (lhs.dstLayout.usages < rhs.dstLayout.usages);
+    }
+
+    return less;
+}
+
 // =====================================================================================================================
 // Creates a compatible PAL "clear box" structure from attachment + render area for a renderpass clear.
 Pal::Box BuildClearBox(
@@ -181,14 +254,13 @@ Util::Vector<Pal::Range, 16, Util::GenericAllocator> RangesOfOnesInBitMask(
 
 // =====================================================================================================================
 // Populate a vector with PAL clear regions converted from Vulkan clear rects.
-// If multiview is enabled layer ranges are overridden according to viewMask.
+// If multiview is enabled (viewMask is non-zero) layer ranges are overridden according to viewMask.
 // Returns Pal::Result::Success if completed successfully.
 template <typename PalClearRegionVect>
 Pal::Result CreateClearRegions (
     const uint32_t              rectCount,
     const VkClearRect* const    pRects,
-    const RenderPass&           renderPass,
-    const uint32_t              subpass,
+    const uint32_t              viewMask,
     const uint32_t              zOffset,
     PalClearRegionVect* const   pOutClearRegions)
 {
@@ -202,9 +274,8 @@ Pal::Result CreateClearRegions (
 
     pOutClearRegions->Clear();
 
-    if (renderPass.IsMultiviewEnabled())
+    if (viewMask != 0)
     {
-        const auto viewMask    = renderPass.GetViewMask(subpass);
         const auto layerRanges = RangesOfOnesInBitMask(viewMask);
 
         palResult = pOutClearRegions->Reserve(rectCount * layerRanges.NumElements());
@@ -237,6 +308,89 @@ Pal::Result CreateClearRegions (
     return palResult;
 }
 
+// =====================================================================================================================
+// Returns the index of a clear rect that covers all of the given render areas as well as the layers of every other
+// rect, which makes the other rects redundant.  Returns rectCount if there is no such rect.
+uint32_t FindCoveringClearRect(
+    const uint32_t              rectCount,
+    const VkClearRect* const    pRects,
+    const uint32_t              renderAreaCount,
+    const Pal::Rect* const      pRenderAreas)
+{
+    uint32_t coveringIdx = rectCount;
+
+    // Secondary command buffers don't know the render area of the render pass instance they execute in.
+    for (uint32_t rectIdx = 0; (renderAreaCount > 0) && (rectIdx < rectCount) && (coveringIdx == rectCount); ++rectIdx)
+    {
+        const VkRect2D& rect   = pRects[rectIdx].rect;
+        bool            isFull = true;
+
+        for (uint32_t areaIdx = 0; (areaIdx < renderAreaCount) && isFull; ++areaIdx)
+        {
+            const Pal::Rect& area = pRenderAreas[areaIdx];
+
+            isFull = (rect.offset.x <= area.offset.x) &&
+                     (rect.offset.y <= area.offset.y) &&
+                     ((int64_t(rect.offset.x) + rect.extent.width)  >= (int64_t(area.offset.x) + area.extent.width)) &&
+                     ((int64_t(rect.offset.y) + rect.extent.height) >= (int64_t(area.offset.y) + area.extent.height));
+        }
+
+        if (isFull)
+        {
+            coveringIdx = rectIdx;
+        }
+    }
+
+    if (coveringIdx < rectCount)
+    {
+        const VkClearRect& covering = pRects[coveringIdx];
+
+        for (uint32_t rectIdx = 0; rectIdx < rectCount; ++rectIdx)
+        {
+            const VkClearRect& other = pRects[rectIdx];
+
+            if ((other.baseArrayLayer < covering.baseArrayLayer) ||
+                ((other.baseArrayLayer + other.layerCount) > (covering.baseArrayLayer + covering.layerCount)))
+            {
+                coveringIdx = rectCount;
+                break;
+            }
+        }
+    }
+
+    return coveringIdx;
+}
+
+// =====================================================================================================================
+// Compacts away clear regions that are identical to the region kept right before them.  Returns the number of regions
+// left at the front of the array.
+uint32_t CollapseClearRegions(
+    const uint32_t                      regionCount,
+    Pal::ClearBoundTargetRegion* const  pRegions)
+{
+    uint32_t keptCount = Util::Min(regionCount, 1u);
+
+    for (uint32_t regionIdx = 1; regionIdx < regionCount; ++regionIdx)
+    {
+        const Pal::ClearBoundTargetRegion& prev = pRegions[keptCount - 1];
+        const Pal::ClearBoundTargetRegion& cur  = pRegions[regionIdx];
+
+        const bool isDuplicate = (cur.rect.offset.x      == prev.rect.offset.x)      &&
+                                 (cur.rect.offset.y      == prev.rect.offset.y)      &&
+                                 (cur.rect.extent.width  == prev.rect.extent.width)  &&
+                                 (cur.rect.extent.height == prev.rect.extent.height) &&
+                                 (cur.startSlice         == prev.startSlice)         &&
+                                 (cur.numSlices          == prev.numSlices);
+
+        if (isDuplicate == false)
+        {
+            pRegions[keptCount++] = cur;
+        }
+    }
+
+    return keptCount;
+}
+
 // =====================================================================================================================
 // Populate a vector with attachment's PAL subresource ranges defined by clearInfo with modified layer ranges
 // according to Vulkan clear rects (multiview disabled) or viewMask (multiview is enabled).
@@ -301,22 +455,22 @@ Pal::Result CreateClearSubresRanges(
 }
 
 // =====================================================================================================================
-// Returns attachment's PAL subresource ranges defined by clearInfo for LoadOp Clear.
-// When multiview is enabled, layer ranges are modified according active views during a renderpass.
+// Returns attachment's PAL subresource ranges of the given aspects for LoadOp Clear.
+// When multiview is enabled (activeViews is non-zero), layer ranges are modified according to the active views during a
+// render pass instance.
 Util::Vector<Pal::SubresRange, MaxPalAspectsPerMask * Pal::MaxViewInstanceCount, Util::GenericAllocator>
 LoadOpClearSubresRanges(
     const Framebuffer::Attachment& attachment,
-    const RPLoadOpClearInfo&       clearInfo,
-    const RenderPass&              renderPass)
+    const VkImageAspectFlags       aspectMask,
+    const uint32_t                 activeViews)
 {
     // Note that no allocation will be performed, so Util::Vector allocator is nullptr.
     Util::Vector<Pal::SubresRange, MaxPalAspectsPerMask * Pal::MaxViewInstanceCount, Util::GenericAllocator> clearSubresRanges { nullptr };
 
-    const auto attachmentSubresRanges = attachment.FindSubresRanges(clearInfo.aspect);
+    const auto attachmentSubresRanges = attachment.FindSubresRanges(aspectMask);
 
-    if (renderPass.IsMultiviewEnabled())
+    if (activeViews != 0)
     {
-        const auto activeViews = renderPass.GetActiveViewsBitMask();
         const auto layerRanges = RangesOfOnesInBitMask(activeViews);
 
         for (uint32_t rangeIndex = 0; rangeIndex < attachmentSubresRanges.NumElements(); ++rangeIndex)
@@ -367,8 +521,74 @@ Pal::Result CreateClearRects(
     return palResult;
 }
 
+// =====================================================================================================================
+// Stores the state of a dynamic rendering attachment that is needed until the end of the instance and accumulates the
+// maximum sample count of the instance's attachments.
+void StoreDynamicRenderingAttachment(
+    const VkRenderingAttachmentInfoKHR* pAttachmentInfo,
+    const RuntimeSettings&              settings,
+    DynamicRenderingAttachment*         pAttachment,
+    uint32_t*                           pMaxSampleCount)
+{
+    *pAttachment = {};
+
+    pAttachment->attachmentFormat     = VK_FORMAT_UNDEFINED;
+    pAttachment->palFormat            = Pal::UndefinedSwizzledFormat;
+    pAttachment->rasterizationSamples = 1;
+
+    if ((pAttachmentInfo != nullptr) && (pAttachmentInfo->imageView != VK_NULL_HANDLE))
+    {
+        const ImageView* pImageView = ImageView::ObjectFromHandle(pAttachmentInfo->imageView);
+
+        pAttachment->pImageView           = pImageView;
+        pAttachment->imageLayout          = pAttachmentInfo->imageLayout;
+        pAttachment->attachmentFormat     = pImageView->GetViewFormat();
+        pAttachment->palFormat            = VkToPalFormat(pAttachment->attachmentFormat, settings);
+        pAttachment->rasterizationSamples = pImageView->GetImage()->GetImageSamples();
+
+        if ((pAttachmentInfo->resolveMode != VK_RESOLVE_MODE_NONE) &&
+            (pAttachmentInfo->resolveImageView != VK_NULL_HANDLE))
+        {
+            pAttachment->resolveMode        = pAttachmentInfo->resolveMode;
+            pAttachment->pResolveImageView  = ImageView::ObjectFromHandle(pAttachmentInfo->resolveImageView);
+            pAttachment->resolveImageLayout = pAttachmentInfo->resolveImageLayout;
+        }
+
+        *pMaxSampleCount = Util::Max(*pMaxSampleCount, pAttachment->rasterizationSamples);
+    }
+}
+
+// =====================================================================================================================
+// Limits the layers of a dynamic rendering attachment to the instance's layer count when multiview is disabled.
+void ClampDynamicRenderingLayers(
+    const DynamicRenderingInstanceState& dynamicRendering,
+    Framebuffer::Attachment*             pAttachment)
+{
+    if (dynamicRendering.viewMask == 0)
+    {
+        for (uint32_t sr = 0; sr < pAttachment->subresRangeCount; ++sr)
+        {
+            pAttachment->subresRange[sr].numSlices =
+                Util::Min(pAttachment->subresRange[sr].numSlices, dynamicRendering.layerCount);
+        }
+    }
+}
+
 } // anonymous ns
 
+// =====================================================================================================================
+// Describes a resolve done at the end of a dynamic rendering instance
+struct DynamicRenderingResolveInfo
+{
+    Framebuffer::Attachment src;                                // Multisampled attachment
+    Framebuffer::Attachment dst;                                // Resolve attachment
+    VkImageLayout           srcLayout[MaxRangePerAttachment];   // Rendering layouts of src (per plane)
+    VkImageLayout           dstLayout[MaxRangePerAttachment];   // Rendering layouts of dst (per plane)
+    uint32_t                planeCount;                         // Number of planes to resolve
+    uint32_t                planes[MaxRangePerAttachment];      // Planes to resolve
+    Pal::ResolveMode        resolveMode[MaxRangePerAttachment]; // Resolve mode of each plane to resolve
+};
+
 // =====================================================================================================================
 CmdBuffer::CmdBuffer(
     Device*                         pDevice,
@@ -388,12 +608,17 @@ CmdBuffer::CmdBuffer(
     m_flags(),
     m_recordingResult(VK_SUCCESS),
     m_pSqttState(nullptr),
+    m_sqttCmdBufId(0),
     m_renderPassInstance(pDevice->VkInstance()->Allocator()),
+    m_clearStates(),
     m_pTransformFeedbackState(nullptr),
+    m_pBreadcrumbs(nullptr),
     m_palDepthStencilState(pDevice->VkInstance()->Allocator())
 {
     m_flags.wasBegun = false;
 
+    memset(m_pushDescShadow, 0, sizeof(m_pushDescShadow));
+
     const RuntimeSettings& settings = m_pDevice->GetRuntimeSettings();
 
     m_optimizeCmdbufMode             = settings.optimizeCmdbufMode;
@@ -758,6 +983,8 @@ void CmdBuffer::PalCmdDispatch(
     uint32_t y,
     uint32_t z)
 {
+    InvalidateClearStates();
+
     utils::IterateMask deviceGroup(m_curDeviceMask);
     do
     {
@@ -775,6 +1002,8 @@ void CmdBuffer::PalCmdDispatchOffset(
     uint32_t size_y,
     uint32_t size_z)
 {
+    InvalidateClearStates();
+
     utils::IterateMask deviceGroup(m_curDeviceMask);
     do
     {
@@ -788,6 +1017,8 @@ void CmdBuffer::PalCmdDispatchIndirect(
     Buffer*      pBuffer,
     Pal::gpusize offset)
 {
+    InvalidateClearStates();
+
     utils::IterateMask deviceGroup(m_curDeviceMask);
     do
     {
@@ -810,6 +1041,9 @@ void CmdBuffer::PalCmdCopyBuffer(
     uint32_t               regionCount,
     Pal::MemoryCopyRegion* pRegions)
 {
+    // The buffer may share memory with a tracked image.
+    InvalidateClearStates();
+
     if (m_pDevice->IsMultiGpu() == false)
     {
         Pal::IGpuMemory* const pSrcMemory = pSrcBuffer->PalMemory(DefaultDeviceIndex);
@@ -847,6 +1081,9 @@ void CmdBuffer::PalCmdUpdateBuffer(
     Pal::gpusize    size,
     const uint32_t* pData)
 {
+    // The buffer may share memory with a tracked image.
+    InvalidateClearStates();
+
     utils::IterateMask deviceGroup(m_curDeviceMask);
     do
     {
@@ -864,6 +1101,9 @@ void CmdBuffer::PalCmdFillBuffer(
     Pal::gpusize    size,
     uint32_t        data)
 {
+    // The buffer may share memory with a tracked image.
+    InvalidateClearStates();
+
     utils::IterateMask deviceGroup(m_curDeviceMask);
     do
     {
@@ -883,6 +1123,8 @@ void CmdBuffer::PalCmdCopyImage(
     uint32_t              regionCount,
     Pal::ImageCopyRegion* pRegions)
 {
+    InvalidateClearStates();
+
     if (m_pDevice->IsMultiGpu() == false)
     {
         PalCmdBuffer(DefaultDeviceIndex)->CmdCopyImage(
@@ -922,6 +1164,8 @@ void CmdBuffer::PalCmdScaledCopyImage(
     const Image* const   pDstImage,
     Pal::ScaledCopyInfo& copyInfo)
 {
+    InvalidateClearStates();
+
     if (m_pDevice->IsMultiGpu() == false)
     {
         copyInfo.pSrcImage = pSrcImage->PalImage(DefaultDeviceIndex);
@@ -955,6 +1199,8 @@ void CmdBuffer::PalCmdCopyMemoryToImage(
     uint32_t                    regionCount,
     Pal::MemoryImageCopyRegion* pRegions)
 {
+    InvalidateClearStates();
+
     if (m_pDevice->IsMultiGpu() == false)
     {
         PalCmdBuffer(DefaultDeviceIndex)->CmdCopyMemoryToImage(
@@ -990,6 +1236,9 @@ void CmdBuffer::PalCmdCopyImageToMemory(
     uint32_t                    regionCount,
     Pal::MemoryImageCopyRegion* pRegions)
 {
+    // The buffer may share memory with a tracked image.
+    InvalidateClearStates();
+
     if (m_pDevice->IsMultiGpu() == false)
     {
         PalCmdBuffer(DefaultDeviceIndex)->CmdCopyImageToMemory(
@@ -1096,6 +1345,34 @@ VkResult CmdBuffer::Begin(
                 inheritedStateParams.stateFlags.predication = pExtInfo->conditionalRenderingEnable;
                 m_flags.hasConditionalRendering             = pExtInfo->conditionalRenderingEnable;
             }
+            else if ((pHeader->sType == VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR) &&
+                     (pRenderPass == nullptr) &&
+                     ((pBeginInfo->flags & VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT) != 0))
+            {
+                const auto* pExtInfo = static_cast<const VkCommandBufferInheritanceRenderingInfoKHR*>(pNext);
+
+                // The secondary command buffer executes inside a dynamic rendering instance.  Only the attachment
+                // formats are known here; the image views are bound by the primary at vkCmdBeginRenderingKHR.
+                DynamicRenderingInstanceState* pDynamicRendering = &m_allGpuState.dynamicRendering;
+
+                pDynamicRendering->active               = true;
+                pDynamicRendering->flags                = pExtInfo->flags;
+                pDynamicRendering->viewMask             = pExtInfo->viewMask;
+                pDynamicRendering->colorAttachmentCount = pExtInfo->colorAttachmentCount;
+
+                for (uint32_t i = 0; i < pExtInfo->colorAttachmentCount; ++i)
+                {
+                    pDynamicRendering->colorAttachments[i].attachmentFormat     = pExtInfo->pColorAttachmentFormats[i];
+                    pDynamicRendering->colorAttachments[i].palFormat            =
+                        VkToPalFormat(pExtInfo->pColorAttachmentFormats[i], m_pDevice->GetRuntimeSettings());
+                    pDynamicRendering->colorAttachments[i].rasterizationSamples = pExtInfo->rasterizationSamples;
+                }
+
+                pDynamicRendering->depthAttachment.attachmentFormat       = pExtInfo->depthAttachmentFormat;
+                pDynamicRendering->depthAttachment.rasterizationSamples   = pExtInfo->rasterizationSamples;
+                pDynamicRendering->stencilAttachment.attachmentFormat     = pExtInfo->stencilAttachmentFormat;
+                pDynamicRendering->stencilAttachment.rasterizationSamples = pExtInfo->rasterizationSamples;
+            }
 
             pNext = pHeader->pNext;
         }
@@ -1145,6 +1422,22 @@ VkResult CmdBuffer::Begin(
             inheritedStateParams.sampleCount[i] = pRenderPass->GetColorAttachmentSamples(currentSubPass, i);
         }
     }
+    else if (m_allGpuState.dynamicRendering.active) // secondary VkCommandBuffer will be used inside dynamic rendering
+    {
+        VK_ASSERT(m_flags.is2ndLvl);
+
+        const DynamicRenderingInstanceState& dynamicRendering = m_allGpuState.dynamicRendering;
+
+        inheritedStateParams.colorTargetCount = dynamicRendering.colorAttachmentCount;
+        inheritedStateParams.stateFlags.targetViewState = 1;
+
+        for (uint32_t i = 0; i < inheritedStateParams.colorTargetCount; i++)
+        {
+            inheritedStateParams.colorTargetSwizzledFormats[i] =
+                VkToPalFormat(dynamicRendering.colorAttachments[i].attachmentFormat, m_pDevice->GetRuntimeSettings());
+            inheritedStateParams.sampleCount[i] = dynamicRendering.colorAttachments[i].rasterizationSamples;
+        }
+    }
 
     Pal::Result result = PalCmdBufferBegin(cmdInfo);
 
@@ -1165,6 +1458,15 @@ VkResult CmdBuffer::Begin(
         }
     }
 
+    if ((result == Pal::Result::Success) && (m_pDevice->GetRuntimeSettings().breadcrumbRingEntries > 0))
+    {
+        // Breadcrumbs are a debugging aid, so failing to allocate the ring doesn't fail recording
+        if ((m_pBreadcrumbs != nullptr) || (InitBreadcrumbRing() == VK_SUCCESS))
+        {
+            ResetBreadcrumbRing();
+        }
+    }
+
     if (result == Pal::Result::Success)
     {
         // If we have to resume an already started render pass then we have to do it here
@@ -1208,6 +1510,11 @@ VkResult CmdBuffer::Begin(
         // function setting ViewMask for a subpass during the VkRenderPass is called.
         SetViewInstanceMask(GetDeviceMask());
     }
+    else if (m_allGpuState.dynamicRendering.active)
+    {
+        // Same as above, the view mask of a dynamic rendering instance is provided by the inheritance info.
+        SetViewInstanceMask(GetDeviceMask());
+    }
 
     if (Pal::QueueTypeUniversal == m_palQueueType)
     {
@@ -1281,6 +1588,8 @@ VkResult CmdBuffer::End(void)
     if (m_pSqttState != nullptr)
     {
         m_pSqttState->End();
+
+        m_sqttCmdBufId = m_pSqttState->GetId().u32All;
     }
 
     DbgBarrierPostCmd(DbgBarrierCmdBufEnd);
@@ -1315,6 +1624,7 @@ void CmdBuffer::ResetPipelineState()
         m_allGpuState.pipelineState[bindIdx].boundSetCount    = 0;
         m_allGpuState.pipelineState[bindIdx].pushedConstCount = 0;
         m_allGpuState.pipelineState[bindIdx].dynamicBindInfo  = {};
+        m_allGpuState.pipelineState[bindIdx].pushDescSetIdx   = 0;
 
         bindIdx++;
     }
@@ -1344,6 +1654,11 @@ void CmdBuffer::ResetPipelineState()
         pPerGpuState->viewport.depthRange       = Pal::DepthRange::ZeroToOne;
         pPerGpuState->maxPipelineStackSize      = 0;
 
+        for (uint32_t bindPoint = 0; bindPoint < PipelineBindCount; bindPoint++)
+        {
+            m_pushDescShadow[deviceIdx][bindPoint].dwSize = 0;
+        }
+
         deviceIdx++;
     }
     while (deviceIdx < numPalDevices);
@@ -1371,6 +1686,17 @@ void CmdBuffer::ResetState()
     m_renderPassInstance.subpass      = VK_SUBPASS_EXTERNAL;
     m_renderPassInstance.flags.u32All = 0;
 
+    // A render pass instance left open may reference a framebuffer that has been destroyed since, so its program
+    // reference is not released here.  The framebuffer frees all of its programs when it is destroyed.
+    m_renderPassInstance.pProgram     = nullptr;
+
+    // Secondary command buffers don't inherit a render area, so a stale one from an earlier recording must not let
+    // vkCmdClearAttachments treat a rect as covering it.
+    m_renderPassInstance.renderAreaCount = 0;
+
+    m_clearStates.entryCount = 0;
+    m_clearStates.nextEntry  = 0;
+
     m_recordingResult = VK_SUCCESS;
 
     m_flags.hasConditionalRendering = false;
@@ -1702,6 +2028,8 @@ void CmdBuffer::ExecuteCommands(
 {
     DbgBarrierPreCmd(DbgBarrierExecuteCommands);
 
+    InvalidateClearStates();
+
     for (uint32_t i = 0; i < cmdBufferCount; i++)
     {
         CmdBuffer* pInteralCmdBuf = ApiCmdBuffer::ObjectFromHandle(pCmdBuffers[i]);
@@ -1742,6 +2070,15 @@ VkResult CmdBuffer::Destroy(void)
         pInstance->FreeMem(m_pTransformFeedbackState);
     }
 
+    if (m_pBreadcrumbs != nullptr)
+    {
+        m_pDevice->UnregisterBreadcrumbs(this);
+
+        Util::Destructor(m_pBreadcrumbs);
+
+        pInstance->FreeMem(m_pBreadcrumbs);
+    }
+
     // Unregister this command buffer from the pool
     m_pCmdPool->UnregisterCmdBuffer(this);
 
@@ -1795,6 +2132,24 @@ void CmdBuffer::ReleaseResources()
 
         m_pStackAllocator = nullptr;
     }
+
+    // Release push descriptor table copies
+    for (uint32_t deviceIdx = 0; deviceIdx < MaxPalDevices; deviceIdx++)
+    {
+        for (uint32_t bindPoint = 0; bindPoint < PipelineBindCount; bindPoint++)
+        {
+            PushDescriptorShadow* pShadow = &m_pushDescShadow[deviceIdx][bindPoint];
+
+            if (pShadow->pTable != nullptr)
+            {
+                pInstance->FreeMem(pShadow->pTable);
+            }
+
+            pShadow->pTable     = nullptr;
+            pShadow->dwCapacity = 0;
+            pShadow->dwSize     = 0;
+        }
+    }
 }
 
 // =====================================================================================================================
@@ -2008,107 +2363,366 @@ PFN_vkCmdBindDescriptorSets CmdBuffer::GetCmdBindDescriptorSetsFunc(
 }
 
 // =====================================================================================================================
-void CmdBuffer::BindIndexBuffer(
-    VkBuffer     buffer,
-    VkDeviceSize offset,
-    VkIndexType  indexType)
+// Returns the CPU copy of the push descriptor table of the given set, which the caller fills in before uploading it
+// with UploadPushDescriptorTable().  Descriptors that the caller doesn't update are inherited from the previous push to
+// the same set.  Returns nullptr if there is no memory for the copy.
+uint32_t* CmdBuffer::GetPushDescriptorShadow(
+    uint32_t          deviceIdx,
+    PipelineBindPoint apiBindPoint,
+    uint32_t          setIdx,
+    uint32_t          dwSize)
 {
-    DbgBarrierPreCmd(DbgBarrierBindIndexVertexBuffer);
-
-    const Pal::IndexType palIndexType = VkToPalIndexType(indexType);
-    Buffer* pBuffer = Buffer::ObjectFromHandle(buffer);
+    const PipelineBindState& bindState = m_allGpuState.pipelineState[apiBindPoint];
+    PushDescriptorShadow*    pShadow   = &m_pushDescShadow[deviceIdx][apiBindPoint];
 
-    if (pBuffer != NULL)
+    if ((pShadow->dwSize != dwSize) || (bindState.pushDescSetIdx != setIdx))
     {
-        PalCmdBindIndexData(pBuffer, offset, palIndexType);
+        pShadow->dwSize = 0;
     }
-    else
+
+    // A table that doesn't fit the storage can't have been pushed before, so there is nothing to keep when it grows
+    if (pShadow->dwCapacity < dwSize)
     {
-        PalCmdUnbindIndexData(palIndexType);
+        if (pShadow->pTable != nullptr)
+        {
+            m_pDevice->VkInstance()->FreeMem(pShadow->pTable);
+        }
+
+        pShadow->pTable = static_cast<uint32_t*>(m_pDevice->VkInstance()->AllocMem(
+            sizeof(uint32_t) * dwSize,
+            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+
+        if (pShadow->pTable != nullptr)
+        {
+            pShadow->dwCapacity = dwSize;
+        }
+        else
+        {
+            pShadow->dwCapacity = 0;
+
+            m_recordingResult = VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
     }
 
-    DbgBarrierPostCmd(DbgBarrierBindIndexVertexBuffer);
+    return pShadow->pTable;
 }
 
 // =====================================================================================================================
-// Initializes VB binding manager state.  Should be called when the command buffer is being initialized.
-void CmdBuffer::InitializeVertexBuffer()
+// Copies the CPU copy of a push descriptor table into a new table in command buffer embedded memory and writes its
+// address into the set binding data shadow.  Embedded memory is only ever written here, never read.
+void CmdBuffer::UploadPushDescriptorTable(
+    uint32_t              deviceIdx,
+    PipelineBindPoint     apiBindPoint,
+    const PipelineLayout* pLayout,
+    uint32_t              setIdx,
+    uint32_t              dwSize)
 {
-    for (uint32 deviceIdx = 0; deviceIdx < m_pDevice->NumPalDevices(); deviceIdx++)
-    {
-        Pal::BufferViewInfo* pBindings = &PerGpuState(deviceIdx)->vbBindings[0];
+    static_assert(PipelineLayout::SetPtrRegCount == 1, "Code below assumes one dword per set GPU VA");
 
-        for (uint32 i = 0; i < Pal::MaxVertexBuffers; ++i)
-        {
-            // Format needs to be set to invalid for struct srv SRDs
-            pBindings[i].swizzledFormat = Pal::UndefinedSwizzledFormat;
-            pBindings[i].gpuAddr        = 0;
-            pBindings[i].range          = 0;
-            pBindings[i].stride         = 0;
-            pBindings[i].flags.u32All   = 0;
-        }
-    }
+    PushDescriptorShadow* pShadow           = &m_pushDescShadow[deviceIdx][apiBindPoint];
+    PerGpuRenderState*    pPerGpuState      = PerGpuState(deviceIdx);
+    const uint32_t        alignmentInDwords =
+        m_pDevice->GetProperties().descriptorSizes.alignment / sizeof(uint32_t);
 
-    m_vbWatermark = 0;
+    Pal::gpusize gpuAddr = 0;
+
+    uint32_t* pTable = PalCmdBuffer(deviceIdx)->CmdAllocateEmbeddedData(dwSize, alignmentInDwords, &gpuAddr);
+
+    memcpy(pTable, pShadow->pTable, dwSize * sizeof(uint32_t));
+
+    pShadow->dwSize = dwSize;
+
+    const PipelineLayout::SetUserDataLayout& setLayoutInfo = pLayout->GetSetUserData(setIdx);
+
+    if (setLayoutInfo.setPtrRegOffset != PipelineLayout::InvalidReg)
+    {
+        // Embedded data shares the assumed high 32 bits of descriptor set addresses, thus only the lower 32 bits of
+        // the address have to be used here.
+        pPerGpuState->setBindingData[apiBindPoint][setLayoutInfo.setPtrRegOffset] =
+            static_cast<uint32_t>(gpuAddr & 0xFFFFFFFFull);
+    }
 }
 
 // =====================================================================================================================
-// Called to reset the state of the VB manager because the parent command buffer is being reset.
-void CmdBuffer::ResetVertexBuffer()
+// Programs the set pointer of a freshly written push descriptor table into user data.
+void CmdBuffer::BindPushDescriptorSet(
+    Pal::PipelineBindPoint palBindPoint,
+    PipelineBindPoint      apiBindPoint,
+    const PipelineLayout*  pLayout,
+    uint32_t               setIdx)
 {
-    for (uint32 deviceIdx = 0; deviceIdx < m_pDevice->NumPalDevices(); deviceIdx++)
+    PipelineBindState* pBindState = &m_allGpuState.pipelineState[apiBindPoint];
+
+    const PipelineLayout::Info&              layoutInfo    = pLayout->GetInfo();
+    const PipelineLayout::SetUserDataLayout& setLayoutInfo = pLayout->GetSetUserData(setIdx);
+
+    pBindState->pushDescSetIdx = setIdx;
+
+    if (setLayoutInfo.setPtrRegOffset != PipelineLayout::InvalidReg)
     {
-        Pal::BufferViewInfo* pBindings = &PerGpuState(deviceIdx)->vbBindings[0];
+        const uint32_t rangeOffsetEnd = setLayoutInfo.firstRegOffset + setLayoutInfo.totalRegCount;
 
-        for (uint32 i = 0; i < m_vbWatermark; ++i)
+        pBindState->boundSetCount = Util::Max(pBindState->boundSetCount, rangeOffsetEnd);
+
+        // Same as BindDescriptorSets: a future vkCmdBindPipeline reprograms the user data if the layouts differ.
+        if (PalPipelineBindingOwnedBy(palBindPoint, apiBindPoint) &&
+            (pBindState->userDataLayout.setBindingRegBase == layoutInfo.userDataLayout.setBindingRegBase))
         {
-            pBindings[i].gpuAddr = 0;
-            pBindings[i].range   = 0;
-            pBindings[i].stride  = 0;
+            utils::IterateMask deviceGroup(m_curDeviceMask);
+            do
+            {
+                const uint32_t deviceIdx = deviceGroup.Index();
+
+                PalCmdBuffer(deviceIdx)->CmdSetUserData(
+                    palBindPoint,
+                    pBindState->userDataLayout.setBindingRegBase + setLayoutInfo.setPtrRegOffset,
+                    PipelineLayout::SetPtrRegCount,
+                    &(PerGpuState(deviceIdx)->setBindingData[apiBindPoint][setLayoutInfo.setPtrRegOffset]));
+            } while (deviceGroup.IterateNext());
         }
     }
-
-    m_vbWatermark = 0;
 }
 
 // =====================================================================================================================
-// Implementation of vkCmdBindVertexBuffers
-void CmdBuffer::BindVertexBuffers(
-    uint32_t            firstBinding,
-    uint32_t            bindingCount,
-    const VkBuffer*     pBuffers,
-    const VkDeviceSize* pOffsets,
-    const VkDeviceSize* pSizes,
-    const VkDeviceSize* pStrides)
+// Implements vkCmdPushDescriptorSetKHR by writing the SRDs into the command buffer's copy of the table, uploading it to
+// command buffer embedded memory and binding it through user data, without going through a descriptor pool.
+template <size_t imageDescSize, size_t samplerDescSize, size_t bufferDescSize>
+void CmdBuffer::PushDescriptorSetKHR(
+    VkPipelineBindPoint         pipelineBindPoint,
+    VkPipelineLayout            layout,
+    uint32_t                    set,
+    uint32_t                    descriptorWriteCount,
+    const VkWriteDescriptorSet* pDescriptorWrites)
 {
-    DbgBarrierPreCmd(DbgBarrierBindIndexVertexBuffer);
+    DbgBarrierPreCmd(DbgBarrierBindSetsPushConstants);
 
-    const bool padVertexBuffers = m_flags.padVertexBuffers;
+    Pal::PipelineBindPoint palBindPoint;
+    PipelineBindPoint      apiBindPoint;
 
-    utils::IterateMask deviceGroup(GetDeviceMask());
-    do
-    {
-        const uint32_t deviceIdx = deviceGroup.Index();
+    ConvertPipelineBindPoint(pipelineBindPoint, &palBindPoint, &apiBindPoint);
 
-        Pal::BufferViewInfo* pBinding    = &PerGpuState(deviceIdx)->vbBindings[firstBinding];
-        Pal::BufferViewInfo* pEndBinding = pBinding + bindingCount;
-        uint32_t             inputIdx    = 0;
+    const PipelineLayout*      pLayout    = PipelineLayout::ObjectFromHandle(layout);
+    const DescriptorSetLayout* pSetLayout = pLayout->GetSetLayouts(set);
+    const uint32_t             dwSize     = pSetLayout->Info().sta.dwSize;
 
-        while (pBinding != pEndBinding)
+    if (dwSize > 0)
+    {
+        utils::IterateMask deviceGroup(m_curDeviceMask);
+        do
         {
-            const VkBuffer     buffer = pBuffers[inputIdx];
-            const VkDeviceSize offset = pOffsets[inputIdx];
+            const uint32_t deviceIdx = deviceGroup.Index();
 
-            if (buffer != VK_NULL_HANDLE)
-            {
-                const Buffer* pBuffer = Buffer::ObjectFromHandle(buffer);
+            uint32_t* pTable = GetPushDescriptorShadow(deviceIdx, apiBindPoint, set, dwSize);
 
-                pBinding->gpuAddr = pBuffer->GpuVirtAddr(deviceIdx) + offset;
-                pBinding->range   = (pSizes != nullptr) ? pSizes[inputIdx] : pBuffer->GetSize() - offset;
-            }
-            else
+            if (pTable != nullptr)
             {
-                pBinding->gpuAddr = 0;
+                DescriptorUpdate::WritePushDescriptors<imageDescSize, samplerDescSize, bufferDescSize>(
+                    m_pDevice,
+                    deviceIdx,
+                    pSetLayout,
+                    pTable,
+                    descriptorWriteCount,
+                    pDescriptorWrites);
+
+                UploadPushDescriptorTable(deviceIdx, apiBindPoint, pLayout, set, dwSize);
+            }
+        } while (deviceGroup.IterateNext());
+
+        BindPushDescriptorSet(palBindPoint, apiBindPoint, pLayout, set);
+    }
+
+    DbgBarrierPostCmd(DbgBarrierBindSetsPushConstants);
+}
+
+// =====================================================================================================================
+template <size_t imageDescSize, size_t samplerDescSize, size_t bufferDescSize>
+VKAPI_ATTR void VKAPI_CALL CmdBuffer::CmdPushDescriptorSetKHR(
+    VkCommandBuffer                             commandBuffer,
+    VkPipelineBindPoint                         pipelineBindPoint,
+    VkPipelineLayout                            layout,
+    uint32_t                                    set,
+    uint32_t                                    descriptorWriteCount,
+    const VkWriteDescriptorSet*                 pDescriptorWrites)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->PushDescriptorSetKHR<imageDescSize, samplerDescSize, bufferDescSize>(
+        pipelineBindPoint,
+        layout,
+        set,
+        descriptorWriteCount,
+        pDescriptorWrites);
+}
+
+// =====================================================================================================================
+PFN_vkCmdPushDescriptorSetKHR CmdBuffer::GetCmdPushDescriptorSetKHRFunc(
+    const Device* pDevice)
+{
+    const size_t imageDescSize   = pDevice->GetProperties().descriptorSizes.imageView;
+    const size_t samplerDescSize = pDevice->GetProperties().descriptorSizes.sampler;
+    const size_t bufferDescSize  = pDevice->GetProperties().descriptorSizes.bufferView;
+
+    PFN_vkCmdPushDescriptorSetKHR pFunc = nullptr;
+
+    if ((imageDescSize == 32) &&
+        (samplerDescSize == 16) &&
+        (bufferDescSize == 16))
+    {
+        pFunc = CmdPushDescriptorSetKHR<32, 16, 16>;
+    }
+    else
+    {
+        VK_NEVER_CALLED();
+        pFunc = nullptr;
+    }
+
+    return pFunc;
+}
+
+// =====================================================================================================================
+// Implements vkCmdPushDescriptorSetWithTemplateKHR.  The template entries were specialized for push descriptors at
+// creation time, so they only need to be pointed at the command buffer's copy of the table of each device.
+void CmdBuffer::PushDescriptorSetWithTemplateKHR(
+    VkDescriptorUpdateTemplate  descriptorUpdateTemplate,
+    VkPipelineLayout            layout,
+    uint32_t                    set,
+    const void*                 pData)
+{
+    DbgBarrierPreCmd(DbgBarrierBindSetsPushConstants);
+
+    const DescriptorUpdateTemplate* pTemplate  = DescriptorUpdateTemplate::ObjectFromHandle(descriptorUpdateTemplate);
+    const PipelineLayout*           pLayout    = PipelineLayout::ObjectFromHandle(layout);
+    const DescriptorSetLayout*      pSetLayout = pLayout->GetSetLayouts(set);
+    const uint32_t                  dwSize     = pSetLayout->Info().sta.dwSize;
+
+    Pal::PipelineBindPoint palBindPoint;
+    PipelineBindPoint      apiBindPoint;
+
+    ConvertPipelineBindPoint(pTemplate->GetPipelineBindPoint(), &palBindPoint, &apiBindPoint);
+
+    if (dwSize > 0)
+    {
+        utils::IterateMask deviceGroup(m_curDeviceMask);
+        do
+        {
+            const uint32_t deviceIdx = deviceGroup.Index();
+
+            uint32_t* pTable = GetPushDescriptorShadow(deviceIdx, apiBindPoint, set, dwSize);
+
+            if (pTable != nullptr)
+            {
+                pTemplate->PushUpdate(m_pDevice, deviceIdx, pTable, pData);
+
+                UploadPushDescriptorTable(deviceIdx, apiBindPoint, pLayout, set, dwSize);
+            }
+        } while (deviceGroup.IterateNext());
+
+        BindPushDescriptorSet(palBindPoint, apiBindPoint, pLayout, set);
+    }
+
+    DbgBarrierPostCmd(DbgBarrierBindSetsPushConstants);
+}
+
+// =====================================================================================================================
+void CmdBuffer::BindIndexBuffer(
+    VkBuffer     buffer,
+    VkDeviceSize offset,
+    VkIndexType  indexType)
+{
+    DbgBarrierPreCmd(DbgBarrierBindIndexVertexBuffer);
+
+    const Pal::IndexType palIndexType = VkToPalIndexType(indexType);
+    Buffer* pBuffer = Buffer::ObjectFromHandle(buffer);
+
+    if (pBuffer != NULL)
+    {
+        PalCmdBindIndexData(pBuffer, offset, palIndexType);
+    }
+    else
+    {
+        PalCmdUnbindIndexData(palIndexType);
+    }
+
+    DbgBarrierPostCmd(DbgBarrierBindIndexVertexBuffer);
+}
+
+// =====================================================================================================================
+// Initializes VB binding manager state.  Should be called when the command buffer is being initialized.
+void CmdBuffer::InitializeVertexBuffer()
+{
+    for (uint32 deviceIdx = 0; deviceIdx < m_pDevice->NumPalDevices(); deviceIdx++)
+    {
+        Pal::BufferViewInfo* pBindings = &PerGpuState(deviceIdx)->vbBindings[0];
+
+        for (uint32 i = 0; i < Pal::MaxVertexBuffers; ++i)
+        {
+            // Format needs to be set to invalid for struct srv SRDs
+            pBindings[i].swizzledFormat = Pal::UndefinedSwizzledFormat;
+            pBindings[i].gpuAddr        = 0;
+            pBindings[i].range          = 0;
+            pBindings[i].stride         = 0;
+            pBindings[i].flags.u32All   = 0;
+        }
+    }
+
+    m_vbWatermark = 0;
+}
+
+// =====================================================================================================================
+// Called to reset the state of the VB manager because the parent command buffer is being reset.
+void CmdBuffer::ResetVertexBuffer()
+{
+    for (uint32 deviceIdx = 0; deviceIdx < m_pDevice->NumPalDevices(); deviceIdx++)
+    {
+        Pal::BufferViewInfo* pBindings = &PerGpuState(deviceIdx)->vbBindings[0];
+
+        for (uint32 i = 0; i < m_vbWatermark; ++i)
+        {
+            pBindings[i].gpuAddr = 0;
+            pBindings[i].range   = 0;
+            pBindings[i].stride  = 0;
+        }
+    }
+
+    m_vbWatermark = 0;
+}
+
+// =====================================================================================================================
+// Implementation of vkCmdBindVertexBuffers
+void CmdBuffer::BindVertexBuffers(
+    uint32_t            firstBinding,
+    uint32_t            bindingCount,
+    const VkBuffer*     pBuffers,
+    const VkDeviceSize* pOffsets,
+    const VkDeviceSize* pSizes,
+    const VkDeviceSize* pStrides)
+{
+    DbgBarrierPreCmd(DbgBarrierBindIndexVertexBuffer);
+
+    const bool padVertexBuffers = m_flags.padVertexBuffers;
+
+    utils::IterateMask deviceGroup(GetDeviceMask());
+    do
+    {
+        const uint32_t deviceIdx = deviceGroup.Index();
+
+        Pal::BufferViewInfo* pBinding    = &PerGpuState(deviceIdx)->vbBindings[firstBinding];
+        Pal::BufferViewInfo* pEndBinding = pBinding + bindingCount;
+        uint32_t             inputIdx    = 0;
+
+        while (pBinding != pEndBinding)
+        {
+            const VkBuffer     buffer = pBuffers[inputIdx];
+            const VkDeviceSize offset = pOffsets[inputIdx];
+
+            if (buffer != VK_NULL_HANDLE)
+            {
+                const Buffer* pBuffer = Buffer::ObjectFromHandle(buffer);
+
+                pBinding->gpuAddr = pBuffer->GpuVirtAddr(deviceIdx) + offset;
+                pBinding->range   = (pSizes != nullptr) ? pSizes[inputIdx] : pBuffer->GetSize() - offset;
+            }
+            else
+            {
+                pBinding->gpuAddr = 0;
                 pBinding->range   = 0;
             }
 
@@ -2203,6 +2817,7 @@ void CmdBuffer::Draw(
     DbgBarrierPreCmd(DbgBarrierDrawNonIndexed);
 
     ValidateStates();
+    InvalidateClearStates();
 
     PalCmdDraw(firstVertex,
         vertexCount,
@@ -2224,6 +2839,7 @@ void CmdBuffer::DrawIndexed(
     DbgBarrierPreCmd(DbgBarrierDrawIndexed);
 
     ValidateStates();
+    InvalidateClearStates();
 
     PalCmdDrawIndexed(firstIndex,
                       indexCount,
@@ -2235,6 +2851,113 @@ void CmdBuffer::DrawIndexed(
     DbgBarrierPostCmd(DbgBarrierDrawIndexed);
 }
 
+// =====================================================================================================================
+// Records a batch of non-indexed draws sharing the same state (VK_EXT_multi_draw).  State is validated once for the
+// whole batch and the index of each draw within the batch is passed to PAL as its draw ID.
+void CmdBuffer::DrawMulti(
+    uint32_t                  drawCount,
+    const VkMultiDrawInfoEXT* pVertexInfo,
+    uint32_t                  instanceCount,
+    uint32_t                  firstInstance,
+    uint32_t                  stride)
+{
+    if (drawCount > 0)
+    {
+        DbgBarrierPreCmd(DbgBarrierDrawNonIndexed);
+
+        ValidateStates();
+        InvalidateClearStates();
+
+        // Currently only Vulkan graphics pipelines use PAL graphics pipeline bindings so there's no need to
+        // add a delayed validation check for graphics.
+        VK_ASSERT(PalPipelineBindingOwnedBy(Pal::PipelineBindPoint::Graphics, PipelineBindGraphics));
+
+        utils::IterateMask deviceGroup(m_curDeviceMask);
+        do
+        {
+            Pal::ICmdBuffer*          pPalCmdBuffer = PalCmdBuffer(deviceGroup.Index());
+            const VkMultiDrawInfoEXT* pDrawInfo     = pVertexInfo;
+
+            for (uint32_t drawIdx = 0; drawIdx < drawCount; ++drawIdx)
+            {
+                pPalCmdBuffer->CmdDraw(pDrawInfo->firstVertex,
+                    pDrawInfo->vertexCount,
+                    firstInstance,
+                    instanceCount,
+                    drawIdx);
+
+                pDrawInfo = static_cast<const VkMultiDrawInfoEXT*>(Util::VoidPtrInc(pDrawInfo, stride));
+            }
+        }
+        while (deviceGroup.IterateNext());
+
+        DbgBarrierPostCmd(DbgBarrierDrawNonIndexed);
+    }
+}
+
+// =====================================================================================================================
+// Records a batch of indexed draws sharing the same state (VK_EXT_multi_draw).  If pVertexOffset is given it overrides
+// the per-draw vertex offsets.
+void CmdBuffer::DrawMultiIndexed(
+    uint32_t                         drawCount,
+    const VkMultiDrawIndexedInfoEXT* pIndexInfo,
+    uint32_t                         instanceCount,
+    uint32_t                         firstInstance,
+    uint32_t                         stride,
+    const int32_t*                   pVertexOffset)
+{
+    if (drawCount > 0)
+    {
+        DbgBarrierPreCmd(DbgBarrierDrawIndexed);
+
+        ValidateStates();
+        InvalidateClearStates();
+
+        VK_ASSERT(PalPipelineBindingOwnedBy(Pal::PipelineBindPoint::Graphics, PipelineBindGraphics));
+
+        utils::IterateMask deviceGroup(m_curDeviceMask);
+        do
+        {
+            Pal::ICmdBuffer*                 pPalCmdBuffer = PalCmdBuffer(deviceGroup.Index());
+            const VkMultiDrawIndexedInfoEXT* pDrawInfo     = pIndexInfo;
+
+            if (pVertexOffset != nullptr)
+            {
+                const int32_t vertexOffset = *pVertexOffset;
+
+                for (uint32_t drawIdx = 0; drawIdx < drawCount; ++drawIdx)
+                {
+                    pPalCmdBuffer->CmdDrawIndexed(pDrawInfo->firstIndex,
+                        pDrawInfo->indexCount,
+                        vertexOffset,
+                        firstInstance,
+                        instanceCount,
+                        drawIdx);
+
+                    pDrawInfo = static_cast<const VkMultiDrawIndexedInfoEXT*>(Util::VoidPtrInc(pDrawInfo, stride));
+                }
+            }
+            else
+            {
+                for (uint32_t drawIdx = 0; drawIdx < drawCount; ++drawIdx)
+                {
+                    pPalCmdBuffer->CmdDrawIndexed(pDrawInfo->firstIndex,
+                        pDrawInfo->indexCount,
+                        pDrawInfo->vertexOffset,
+                        firstInstance,
+                        instanceCount,
+                        drawIdx);
+
+                    pDrawInfo = static_cast<const VkMultiDrawIndexedInfoEXT*>(Util::VoidPtrInc(pDrawInfo, stride));
+                }
+            }
+        }
+        while (deviceGroup.IterateNext());
+
+        DbgBarrierPostCmd(DbgBarrierDrawIndexed);
+    }
+}
+
 // =====================================================================================================================
 template< bool indexed, bool useBufferCount>
 void CmdBuffer::DrawIndirect(
@@ -2248,6 +2971,7 @@ void CmdBuffer::DrawIndirect(
     DbgBarrierPreCmd((indexed ? DbgBarrierDrawIndexed : DbgBarrierDrawNonIndexed) | DbgBarrierDrawIndirect);
 
     ValidateStates();
+    InvalidateClearStates();
 
     Buffer* pBuffer = Buffer::ObjectFromHandle(buffer);
 
@@ -2932,6 +3656,8 @@ void CmdBuffer::ClearAttachments(
     uint32_t                 rectCount,
     const VkClearRect*       pRects)
 {
+    InvalidateClearStates();
+
     if ((m_flags.is2ndLvl == false) && (m_allGpuState.pFramebuffer != nullptr))
     {
         ClearImageAttachments(attachmentCount, pAttachments, rectCount, pRects);
@@ -2943,7 +3669,9 @@ void CmdBuffer::ClearAttachments(
 }
 
 // =====================================================================================================================
-// Clears a set of attachments in the current subpass using PAL's CmdClearBound*Targets commands.
+// Clears a set of attachments in the current subpass using PAL's CmdClearBound*Targets commands.  All color attachments
+// are cleared by one command and all depth/stencil aspects by another, sharing the clear regions built for each rect
+// batch.
 void CmdBuffer::ClearBoundAttachments(
     uint32_t                 attachmentCount,
     const VkClearAttachment* pAttachments,
@@ -2954,26 +3682,30 @@ void CmdBuffer::ClearBoundAttachments(
 
     VirtualStackFrame virtStackFrame(m_pStackAllocator);
 
-    // Get the current renderpass and subpass
+    // Get the current renderpass and subpass.  Without a render pass the clear targets the attachments of the current
+    // dynamic rendering instance.
     const RenderPass* pRenderPass = m_allGpuState.pRenderPass;
     const uint32_t subpass        = m_renderPassInstance.subpass;
+    const uint32_t viewMask       = GetRenderingViewMask();
 
-    Util::Vector<Pal::ClearBoundTargetRegion, 8, VirtualStackFrame> clearRegions { &virtStackFrame };
-    Util::Vector<Pal::BoundColorTarget,       8, VirtualStackFrame> colorTargets { &virtStackFrame };
+    const DynamicRenderingInstanceState& dynamicRendering = m_allGpuState.dynamicRendering;
 
-    const auto maxRects   = EstimateMaxObjectsOnVirtualStack(sizeof(*pRects));
-    auto       rectBatch  = Util::Min(rectCount, maxRects);
-    const auto palResult1 = clearRegions.Reserve(rectBatch);
-    const auto palResult2 = colorTargets.Reserve(attachmentCount);
+    Util::Vector<Pal::BoundColorTarget, 8, VirtualStackFrame> colorTargets { &virtStackFrame };
 
-    if ((palResult1 != Pal::Result::Success) ||
-        (palResult2 != Pal::Result::Success))
+    if (colorTargets.Reserve(attachmentCount) != Pal::Result::Success)
     {
         m_recordingResult = VK_ERROR_OUT_OF_HOST_MEMORY;
 
         return;
     }
 
+    // There is a single bound depth/stencil target, so every depth/stencil clear attachment of the call is merged into
+    // one clear.  An aspect cleared more than once takes the value of its last clear attachment.
+    Pal::DepthStencilSelectFlags selectFlags  = {};
+    float                        clearDepth   = 0.0f;
+    uint32_t                     clearStencil = 0;
+    uint32_t                     dsSamples    = 1;
+
     for (uint32_t idx = 0; idx < attachmentCount; ++idx)
     {
         const VkClearAttachment& clearInfo = pAttachments[idx];
@@ -2981,22 +3713,38 @@ void CmdBuffer::ClearBoundAttachments(
         // Detect if color clear or depth clear
         if ((clearInfo.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) != 0)
         {
-            // Get the corresponding color reference in the current subpass
-            const AttachmentReference& colorRef = pRenderPass->GetSubpassColorReference(
-                subpass, clearInfo.colorAttachment);
+            const uint32_t tgtIdx = clearInfo.colorAttachment;
+
+            Pal::SwizzledFormat format  = Pal::UndefinedSwizzledFormat;
+            uint32_t            samples = 1;
+
+            if (pRenderPass != nullptr)
+            {
+                // Get the corresponding color reference in the current subpass
+                const AttachmentReference& colorRef = pRenderPass->GetSubpassColorReference(subpass, tgtIdx);
+
+                if (colorRef.attachment != VK_ATTACHMENT_UNUSED)
+                {
+                    format  = pRenderPass->GetColorAttachmentPalFormat(subpass, tgtIdx);
+                    samples = pRenderPass->GetColorAttachmentSamples(subpass, tgtIdx);
+                }
+            }
+            else if ((tgtIdx < dynamicRendering.colorAttachmentCount) &&
+                     (dynamicRendering.colorAttachments[tgtIdx].attachmentFormat != VK_FORMAT_UNDEFINED))
+            {
+                format  = dynamicRendering.colorAttachments[tgtIdx].palFormat;
+                samples = dynamicRendering.colorAttachments[tgtIdx].rasterizationSamples;
+            }
 
             // Clear only if the attachment reference is active
-            if (colorRef.attachment != VK_ATTACHMENT_UNUSED)
+            if (format.format != Pal::UndefinedSwizzledFormat.format)
             {
                 // Fill in bound target information for this target, but don't clear yet
-                const uint32_t tgtIdx = clearInfo.colorAttachment;
-
                 Pal::BoundColorTarget target = {};
                 target.targetIndex    = tgtIdx;
-                target.swizzledFormat = VkToPalFormat(pRenderPass->GetColorAttachmentFormat(subpass, tgtIdx),
-                                                      m_pDevice->GetRuntimeSettings());
-                target.samples        = pRenderPass->GetColorAttachmentSamples(subpass, tgtIdx);
-                target.fragments      = pRenderPass->GetColorAttachmentSamples(subpass, tgtIdx);
+                target.swizzledFormat = format;
+                target.samples        = samples;
+                target.fragments      = samples;
                 target.clearValue     = VkToPalClearColor(&clearInfo.clearValue.color, target.swizzledFormat);
 
                 colorTargets.PushBack(target);
@@ -3004,48 +3752,74 @@ void CmdBuffer::ClearBoundAttachments(
         }
         else // Depth-stencil clear
         {
-            // Get the corresponding color reference in the current subpass
-            const AttachmentReference& depthStencilRef = pRenderPass->GetSubpassDepthStencilReference(subpass);
+            bool     isActive = false;
+            uint32_t samples  = 1;
 
-            // Clear only if the attachment reference is active
-            if (depthStencilRef.attachment != VK_ATTACHMENT_UNUSED)
+            if (pRenderPass != nullptr)
             {
-                Pal::DepthStencilSelectFlags selectFlags = {};
+                // Get the corresponding color reference in the current subpass
+                const AttachmentReference& depthStencilRef = pRenderPass->GetSubpassDepthStencilReference(subpass);
+
+                isActive = (depthStencilRef.attachment != VK_ATTACHMENT_UNUSED);
+                samples  = isActive ? pRenderPass->GetDepthStencilAttachmentSamples(subpass) : 1;
+            }
+            else
+            {
+                const DynamicRenderingAttachment& depthStencil =
+                    (dynamicRendering.depthAttachment.attachmentFormat != VK_FORMAT_UNDEFINED) ?
+                        dynamicRendering.depthAttachment : dynamicRendering.stencilAttachment;
 
-                selectFlags.depth   = ((clearInfo.aspectMask & VK_IMAGE_ASPECT_DEPTH_BIT) != 0);
-                selectFlags.stencil = ((clearInfo.aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT) != 0);
+                isActive = (depthStencil.attachmentFormat != VK_FORMAT_UNDEFINED);
+                samples  = depthStencil.rasterizationSamples;
+            }
 
-                DbgBarrierPreCmd(DbgBarrierClearDepth);
+            // Clear only if the attachment reference is active
+            if (isActive)
+            {
+                dsSamples = samples;
 
-                for (uint32_t rectIdx = 0; rectIdx < rectCount; rectIdx += rectBatch)
+                if ((clearInfo.aspectMask & VK_IMAGE_ASPECT_DEPTH_BIT) != 0)
                 {
-                    rectBatch = Util::Min(rectCount - rectIdx, maxRects);
-
-                    CreateClearRegions(
-                        rectBatch, pRects + rectIdx,
-                        *pRenderPass, subpass, 0u,
-                        &clearRegions);
-
-                    // Clear the bound depth stencil target immediately
-                    PalCmdBuffer(DefaultDeviceIndex)->CmdClearBoundDepthStencilTargets(
-                        VkToPalClearDepth(clearInfo.clearValue.depthStencil.depth),
-                        clearInfo.clearValue.depthStencil.stencil,
-                        StencilWriteMaskFull,
-                        pRenderPass->GetDepthStencilAttachmentSamples(subpass),
-                        pRenderPass->GetDepthStencilAttachmentSamples(subpass),
-                        selectFlags,
-                        clearRegions.NumElements(),
-                        clearRegions.Data());
+                    selectFlags.depth = 1;
+                    clearDepth        = VkToPalClearDepth(clearInfo.clearValue.depthStencil.depth);
                 }
 
-                DbgBarrierPostCmd(DbgBarrierClearDepth);
+                if ((clearInfo.aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT) != 0)
+                {
+                    selectFlags.stencil = 1;
+                    clearStencil        = clearInfo.clearValue.depthStencil.stencil;
+                }
             }
         }
     }
 
-    if (colorTargets.NumElements() > 0)
+    const bool clearDepthStencil = ((selectFlags.depth != 0) || (selectFlags.stencil != 0));
+
+    if ((colorTargets.NumElements() > 0) || clearDepthStencil)
     {
-        DbgBarrierPreCmd(DbgBarrierClearColor);
+        // A rect covering the whole render area makes all the other rects redundant.
+        const uint32_t coveringIdx = FindCoveringClearRect(rectCount,
+                                                           pRects,
+                                                           m_renderPassInstance.renderAreaCount,
+                                                           m_renderPassInstance.renderArea);
+
+        if (coveringIdx < rectCount)
+        {
+            pRects    = &pRects[coveringIdx];
+            rectCount = 1;
+        }
+
+        Util::Vector<Pal::ClearBoundTargetRegion, 8, VirtualStackFrame> clearRegions { &virtStackFrame };
+
+        const auto maxRects  = EstimateMaxObjectsOnVirtualStack(sizeof(*pRects));
+        auto       rectBatch = Util::Min(rectCount, maxRects);
+
+        if (clearRegions.Reserve(rectBatch) != Pal::Result::Success)
+        {
+            m_recordingResult = VK_ERROR_OUT_OF_HOST_MEMORY;
+
+            return;
+        }
 
         for (uint32_t rectIdx = 0; rectIdx < rectCount; rectIdx += rectBatch)
         {
@@ -3053,32 +3827,59 @@ void CmdBuffer::ClearBoundAttachments(
 
             CreateClearRegions(
                 rectBatch, pRects + rectIdx,
-                *pRenderPass, subpass, 0u,
+                viewMask, 0u,
                 &clearRegions);
 
-            // Clear the bound color targets
-            PalCmdBuffer(DefaultDeviceIndex)->CmdClearBoundColorTargets(
-                colorTargets.NumElements(),
-                colorTargets.Data(),
-                clearRegions.NumElements(),
-                clearRegions.Data());
-        }
+            const uint32_t regionCount = CollapseClearRegions(clearRegions.NumElements(), clearRegions.Data());
 
-        DbgBarrierPostCmd(DbgBarrierClearColor);
-    }
-}
+            if (clearDepthStencil)
+            {
+                DbgBarrierPreCmd(DbgBarrierClearDepth);
 
-// =====================================================================================================================
-void CmdBuffer::PalCmdClearColorImage(
-    const Image&            image,
-    Pal::ImageLayout        imageLayout,
-    const Pal::ClearColor&  color,
+                // Clear the bound depth stencil target
+                PalCmdBuffer(DefaultDeviceIndex)->CmdClearBoundDepthStencilTargets(
+                    clearDepth,
+                    clearStencil,
+                    StencilWriteMaskFull,
+                    dsSamples,
+                    dsSamples,
+                    selectFlags,
+                    regionCount,
+                    clearRegions.Data());
+
+                DbgBarrierPostCmd(DbgBarrierClearDepth);
+            }
+
+            if (colorTargets.NumElements() > 0)
+            {
+                DbgBarrierPreCmd(DbgBarrierClearColor);
+
+                // Clear the bound color targets
+                PalCmdBuffer(DefaultDeviceIndex)->CmdClearBoundColorTargets(
+                    colorTargets.NumElements(),
+                    colorTargets.Data(),
+                    regionCount,
+                    clearRegions.Data());
+
+                DbgBarrierPostCmd(DbgBarrierClearColor);
+            }
+        }
+    }
+}
+
+// =====================================================================================================================
+void CmdBuffer::PalCmdClearColorImage(
+    const Image&            image,
+    Pal::ImageLayout        imageLayout,
+    const Pal::ClearColor&  color,
     uint32_t                rangeCount,
     const Pal::SubresRange* pRanges,
     uint32_t                boxCount,
     const Pal::Box*         pBoxes,
     uint32_t                flags)
 {
+    InvalidateClearStates();
+
     DbgBarrierPreCmd(DbgBarrierClearColor);
 
     PreBltBindMsaaState(image);
@@ -3119,6 +3920,8 @@ void CmdBuffer::PalCmdClearDepthStencil(
     const Pal::Rect*        pRects,
     uint32_t                flags)
 {
+    InvalidateClearStates();
+
     DbgBarrierPreCmd(DbgBarrierClearDepth);
 
     PreBltBindMsaaState(image);
@@ -3192,6 +3995,8 @@ void CmdBuffer::PalCmdResolveImage(
     const Pal::ImageResolveRegion* pRegions,
     uint32_t                       deviceMask)
 {
+    InvalidateClearStates();
+
     DbgBarrierPreCmd(DbgBarrierResolve);
 
     PreBltBindMsaaState(srcImage);
@@ -3290,7 +4095,7 @@ void CmdBuffer::ClearImageAttachments(
 
                         CreateClearRegions(
                             rectCount, pRects + rectIdx,
-                            *pRenderPass, subpass, zOffset,
+                            pRenderPass->GetViewMask(subpass), zOffset,
                             &clearBoxes);
 
                         CreateClearSubresRanges(
@@ -3834,6 +4639,9 @@ void CmdBuffer::WaitEvents(
 {
     DbgBarrierPreCmd(DbgBarrierPipelineBarrierWaitEvents);
 
+    // The host may write images while the command buffer waits on an event.
+    InvalidateClearStates();
+
     VirtualStackFrame virtStackFrame(m_pStackAllocator);
 
     // Allocate space to store signaled event pointers (automatically rewound on unscope)
@@ -3891,6 +4699,9 @@ void CmdBuffer::WaitEvents2(
 {
     DbgBarrierPreCmd(DbgBarrierPipelineBarrierWaitEvents);
 
+    // The host may write images while the command buffer waits on an event.
+    InvalidateClearStates();
+
     // If the ASIC provides split CmdRelease()/CmdReleaseEvent() and CmdAcquire()/CmdAcquireEvent() to express barrier,
     // we will find range of gpu-only events and gpu events with cpu-access, we are assuming the case won't be to have
     // a mixture, it means we can find ranges in the event list that are sync token or not sync token, and then call
@@ -4446,6 +5257,8 @@ void CmdBuffer::PipelineBarrier(
 {
     DbgBarrierPreCmd(DbgBarrierPipelineBarrierWaitEvents);
 
+    InvalidateClearStates(imageMemoryBarrierCount, pImageMemoryBarriers);
+
     VirtualStackFrame virtStackFrame(m_pStackAllocator);
 
     Pal::BarrierInfo barrier = {};
@@ -4482,6 +5295,8 @@ void CmdBuffer::PipelineBarrier2(
 {
     DbgBarrierPreCmd(DbgBarrierPipelineBarrierWaitEvents);
 
+    InvalidateClearStates(pDependencyInfo->imageMemoryBarrierCount, pDependencyInfo->pImageMemoryBarriers);
+
     if (m_flags.hasReleaseAcquire)
     {
         utils::IterateMask deviceGroup(m_curDeviceMask);
@@ -4653,7 +5468,7 @@ void CmdBuffer::BeginQueryIndexed(
     }
     while (deviceGroup.IterateNext());
 
-    const auto* const pRenderPass = m_allGpuState.pRenderPass;
+    const uint32_t viewMask = GetRenderingViewMask();
 
     // If queries are used while executing a render pass instance that has multiview enabled,
     // the query uses N consecutive query indices in the query pool (starting at query) where
@@ -4661,9 +5476,8 @@ void CmdBuffer::BeginQueryIndexed(
     //
     // Implementations may write the total result to the first query and
     // write zero to the other queries.
-    if (pRenderPass && pRenderPass->IsMultiviewEnabled())
+    if (viewMask != 0)
     {
-        const auto viewMask  = pRenderPass->GetViewMask(m_renderPassInstance.subpass);
         const auto viewCount = Util::CountSetBits(viewMask);
 
         // Call Begin() and immediately call End() for all remaining queries,
@@ -4826,6 +5640,104 @@ void CmdBuffer::FillTimestampQueryPool(
     }
 }
 
+// =====================================================================================================================
+// Waits until the given timestamp queries have been written.  Each slot is reset to TimestampNotReady, so the high dword
+// of a slot stays at TimestampNotReadyChunk until its 64-bit timestamp lands in memory.  The low dword is not waited on:
+// a valid timestamp has a low dword of TimestampNotReadyChunk once every 2^32 ticks, and such a wait would never pass.
+void CmdBuffer::WaitTimestampQueries(
+    const TimestampQueryPool& timestampQueryPool,
+    uint32_t                  firstQuery,
+    uint32_t                  queryCount)
+{
+    utils::IterateMask deviceGroup(m_curDeviceMask);
+    do
+    {
+        const uint32_t deviceIdx = deviceGroup.Index();
+
+        for (uint32_t i = 0; i < queryCount; ++i)
+        {
+            PalCmdBuffer(deviceIdx)->CmdWaitMemoryValue(
+                timestampQueryPool.PalMemory(deviceIdx),
+                timestampQueryPool.GetSlotOffset(firstQuery + i) + sizeof(uint32_t),
+                TimestampQueryPool::TimestampNotReadyChunk,
+                UINT32_MAX,
+                Pal::CompareFunc::NotEqual);
+        }
+    }
+    while (deviceGroup.IterateNext());
+}
+
+// =====================================================================================================================
+// Copies the results of timestamp queries which are known to be available straight from the query pool's memory.  The
+// slots hold nothing but the raw timestamp, so 64-bit results are a plain copy and 32-bit results are its low dword.
+// The memory waits only guarantee the timestamps have been written, so the timestamp writes are still made visible to
+// the copy with a barrier.
+void CmdBuffer::CopyTimestampQueriesDirect(
+    const TimestampQueryPool& timestampQueryPool,
+    uint32_t                  firstQuery,
+    uint32_t                  queryCount,
+    const Buffer*             pDestBuffer,
+    VkDeviceSize              destOffset,
+    VkDeviceSize              destStride,
+    VkQueryResultFlags        flags)
+{
+    VK_ASSERT(queryCount <= MaxDirectTimestampCopies);
+    VK_ASSERT((flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) == 0);
+
+    const Pal::gpusize resultSize = ((flags & VK_QUERY_RESULT_64_BIT) != 0) ? sizeof(uint64_t) : sizeof(uint32_t);
+
+    Pal::MemoryCopyRegion regions[MaxDirectTimestampCopies];
+
+    for (uint32_t i = 0; i < queryCount; ++i)
+    {
+        regions[i].srcOffset = timestampQueryPool.GetSlotOffset(firstQuery + i);
+        regions[i].dstOffset = pDestBuffer->MemOffset() + destOffset + (i * destStride);
+        regions[i].copySize  = resultSize;
+    }
+
+    static const Pal::BarrierTransition transition =
+    {
+        Pal::CoherTimestamp,    // srcCacheMask
+        Pal::CoherCopy,         // dstCacheMask
+        { }                     // imageInfo
+    };
+
+    static const Pal::BarrierFlags PalBarrierFlags = {0};
+
+    const Pal::BarrierInfo timestampVisible =
+    {
+        PalBarrierFlags,                                // flags
+        Pal::HwPipeTop,                                 // waitPoint
+        0,                                              // pipePointWaitCount
+        nullptr,                                        // pPipePoints
+        0,                                              // gpuEventWaitCount
+        nullptr,                                        // ppGpuEvents
+        0,                                              // rangeCheckedTargetWaitCount
+        nullptr,                                        // ppTargets
+        1,                                              // transitionCount
+        &transition,                                    // pTransitions
+        0,                                              // globalSrcCacheMask
+        0,                                              // globalDstCacheMask
+        nullptr,                                        // pSplitBarrierGpuEvent
+        RgpBarrierInternalPreCopyQueryPoolResultsSync   // reason
+    };
+
+    PalCmdBarrier(timestampVisible, m_curDeviceMask);
+
+    utils::IterateMask deviceGroup(m_curDeviceMask);
+    do
+    {
+        const uint32_t deviceIdx = deviceGroup.Index();
+
+        PalCmdBuffer(deviceIdx)->CmdCopyMemory(
+            timestampQueryPool.PalMemory(deviceIdx),
+            *pDestBuffer->PalMemory(deviceIdx),
+            queryCount,
+            regions);
+    }
+    while (deviceGroup.IterateNext());
+}
+
 // =====================================================================================================================
 void CmdBuffer::ResetQueryPool(
     VkQueryPool queryPool,
@@ -5006,6 +5918,9 @@ void CmdBuffer::CopyQueryPoolResults(
 {
     DbgBarrierPreCmd(DbgBarrierCopyBuffer | DbgBarrierCopyQueryPool);
 
+    // The buffer may share memory with a tracked image.
+    InvalidateClearStates();
+
     PalCmdSuspendPredication(true);
 
     const QueryPool* pBasePool = QueryPool::ObjectFromHandle(queryPool);
@@ -5035,15 +5950,43 @@ void CmdBuffer::CopyQueryPoolResults(
     }
     else
     {
-        const QueryPoolWithStorageView* pPool = pBasePool->AsQueryPoolWithStorageView();
+        const QueryPoolWithStorageView* pPool    = pBasePool->AsQueryPoolWithStorageView();
+        const RuntimeSettings&          settings = m_pDevice->GetRuntimeSettings();
 
         const Device::InternalPipeline& pipeline = m_pDevice->GetTimestampQueryCopyPipeline();
 
-        // Wait for all previous query timestamps to complete.  For now we have to do a full pipeline idle but once
-        // we have a PAL interface for doing a 64-bit WAIT_REG_MEM, we only have to wait on the queries being copied
-        // here
-        if ((flags & VK_QUERY_RESULT_WAIT_BIT) != 0)
+        // Only the queries being copied need to be complete, so a small batch of timestamps waits on the memory of
+        // each slot rather than idling the whole pipeline.  The results of those can then be copied as-is unless the
+        // shader has to generate availability values.
+        const bool waitForResults = ((flags & VK_QUERY_RESULT_WAIT_BIT) != 0);
+        const bool targetedWaits  = waitForResults                                          &&
+                                    (pBasePool->GetQueryType() == VK_QUERY_TYPE_TIMESTAMP) &&
+                                    (queryCount <= settings.timestampQueryCopyMaxTargetedWaits);
+        const bool directCopy     = targetedWaits                                                 &&
+                                    ((flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) == 0)        &&
+                                    (queryCount <= settings.timestampQueryCopyMaxDirectCopies)    &&
+                                    (queryCount <= MaxDirectTimestampCopies);
+
+        if (targetedWaits)
+        {
+            WaitTimestampQueries(*pBasePool->AsTimestampQueryPool(), firstQuery, queryCount);
+        }
+
+        if (directCopy)
+        {
+            CopyTimestampQueriesDirect(
+                *pBasePool->AsTimestampQueryPool(),
+                firstQuery,
+                queryCount,
+                pDestBuffer,
+                destOffset,
+                destStride,
+                flags);
+        }
+        else if (waitForResults)
         {
+            // Without targeted waits, wait for all previous query timestamps to complete with a full pipeline idle.
+            // With them, the timestamps are already in memory and only the shader caches need to be invalidated.
             static const Pal::BarrierTransition transition =
             {
                 pBasePool->GetQueryType() == VK_QUERY_TYPE_TIMESTAMP ? Pal::CoherTimestamp : Pal::CoherMemory,
@@ -5053,7 +5996,7 @@ void CmdBuffer::CopyQueryPoolResults(
             static const Pal::HwPipePoint pipePoint = Pal::HwPipeBottom;
             static const Pal::BarrierFlags PalBarrierFlags = {0};
 
-            static const Pal::BarrierInfo WriteWaitIdle =
+            Pal::BarrierInfo writeWait =
             {
                 PalBarrierFlags,                                // flags
                 Pal::HwPipePreCs,                               // waitPoint
@@ -5071,98 +6014,111 @@ void CmdBuffer::CopyQueryPoolResults(
                 RgpBarrierInternalPreCopyQueryPoolResultsSync   // reason
             };
 
-            PalCmdBarrier(WriteWaitIdle, m_curDeviceMask);
+            if (targetedWaits)
+            {
+                writeWait.pipePointWaitCount = 0;
+                writeWait.pPipePoints        = nullptr;
+            }
+
+            PalCmdBarrier(writeWait, m_curDeviceMask);
         }
 
-        uint32_t userData[16];
+        if (directCopy == false)
+        {
+            uint32_t userData[16];
 
-        // Figure out which user data registers should contain what compute constants
-        const uint32_t storageViewSize     = m_pDevice->GetProperties().descriptorSizes.bufferView;
-        const uint32_t storageViewDwSize   = storageViewSize / sizeof(uint32_t);
-        const uint32_t viewOffset = 0;
-        const uint32_t bufferViewOffset    = storageViewDwSize;
-        const uint32_t queryCountOffset    = bufferViewOffset + storageViewDwSize;
-        const uint32_t copyFlagsOffset     = queryCountOffset + 1;
-        const uint32_t copyStrideOffset    = copyFlagsOffset  + 1;
-        const uint32_t firstQueryOffset    = copyStrideOffset + 1;
-        const uint32_t userDataCount       = firstQueryOffset + 1;
+            // Figure out which user data registers should contain what compute constants
+            const uint32_t storageViewSize     = m_pDevice->GetProperties().descriptorSizes.bufferView;
+            const uint32_t storageViewDwSize   = storageViewSize / sizeof(uint32_t);
+            const uint32_t viewOffset = 0;
+            const uint32_t bufferViewOffset    = storageViewDwSize;
+            const uint32_t queryCountOffset    = bufferViewOffset + storageViewDwSize;
+            const uint32_t copyFlagsOffset     = queryCountOffset + 1;
+            const uint32_t copyStrideOffset    = copyFlagsOffset  + 1;
+            const uint32_t firstQueryOffset    = copyStrideOffset + 1;
+            const uint32_t userDataCount       = firstQueryOffset + 1;
 
-        // Make sure they agree with pipeline mapping
-        VK_ASSERT(viewOffset        == pipeline.userDataNodeOffsets[0]);
-        VK_ASSERT(bufferViewOffset  == pipeline.userDataNodeOffsets[1]);
-        VK_ASSERT(queryCountOffset  == pipeline.userDataNodeOffsets[2]);
-        VK_ASSERT(userDataCount <= VK_ARRAY_SIZE(userData));
+            // Make sure they agree with pipeline mapping
+            VK_ASSERT(viewOffset        == pipeline.userDataNodeOffsets[0]);
+            VK_ASSERT(bufferViewOffset  == pipeline.userDataNodeOffsets[1]);
+            VK_ASSERT(queryCountOffset  == pipeline.userDataNodeOffsets[2]);
+            VK_ASSERT(userDataCount <= VK_ARRAY_SIZE(userData));
 
-        // Create and set a raw storage view into the destination buffer (shader will choose to either write 32-bit or
-        // 64-bit values)
-        Pal::BufferViewInfo bufferViewInfo = {};
+            // Create and set a raw storage view into the destination buffer (shader will choose to either write 32-bit
+            // or 64-bit values)
+            Pal::BufferViewInfo bufferViewInfo = {};
 
-        bufferViewInfo.range          = destStride * queryCount;
-        bufferViewInfo.stride         = 0; // Raw buffers have a zero byte stride
-        bufferViewInfo.swizzledFormat = Pal::UndefinedSwizzledFormat;
+            bufferViewInfo.range          = destStride * queryCount;
+            bufferViewInfo.stride         = 0; // Raw buffers have a zero byte stride
+            bufferViewInfo.swizzledFormat = Pal::UndefinedSwizzledFormat;
 
-        // Set query count
-        userData[queryCountOffset] = queryCount;
+            // Set query count
+            userData[queryCountOffset] = queryCount;
 
-        // These are magic numbers that match literal values in the shader
-        constexpr uint32_t Copy64Bit                  = 0x1;
-        constexpr uint32_t CopyIncludeAvailabilityBit = 0x2;
+            // These are magic numbers that match literal values in the shader
+            constexpr uint32_t Copy64Bit                  = 0x1;
+            constexpr uint32_t CopyIncludeAvailabilityBit = 0x2;
 
-        // Set copy flags
-        userData[copyFlagsOffset]  = 0;
-        userData[copyFlagsOffset] |= (flags & VK_QUERY_RESULT_64_BIT) ? Copy64Bit : 0x0;
-        userData[copyFlagsOffset] |= (flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) ? CopyIncludeAvailabilityBit : 0x0;
+            // Set copy flags
+            userData[copyFlagsOffset]  = 0;
+            userData[copyFlagsOffset] |= (flags & VK_QUERY_RESULT_64_BIT) ? Copy64Bit : 0x0;
+            userData[copyFlagsOffset] |=
+                (flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) ? CopyIncludeAvailabilityBit : 0x0;
 
-        // Set destination stride
-        VK_ASSERT(destStride <= UINT_MAX); // TODO: Do we really need to handle this?
+            // Set destination stride
+            VK_ASSERT(destStride <= UINT_MAX); // TODO: Do we really need to handle this?
 
-        userData[copyStrideOffset] = static_cast<uint32_t>(destStride);
+            userData[copyStrideOffset] = static_cast<uint32_t>(destStride);
 
-        // Set start query index
-        userData[firstQueryOffset] = firstQuery;
+            // Set start query index
+            userData[firstQueryOffset] = firstQuery;
 
-        utils::IterateMask deviceGroup(m_curDeviceMask);
-        do
-        {
-            const uint32_t deviceIdx = deviceGroup.Index();
+            utils::IterateMask deviceGroup(m_curDeviceMask);
+            do
+            {
+                const uint32_t deviceIdx = deviceGroup.Index();
 
-            // Backup PAL compute state
-            PalCmdBuffer(deviceIdx)->CmdSaveComputeState(Pal::ComputeStatePipelineAndUserData);
+                // Backup PAL compute state
+                PalCmdBuffer(deviceIdx)->CmdSaveComputeState(Pal::ComputeStatePipelineAndUserData);
 
-            Pal::PipelineBindParams bindParams = {};
-            bindParams.pipelineBindPoint = Pal::PipelineBindPoint::Compute;
-            bindParams.pPipeline         = pipeline.pPipeline[deviceIdx];
-            bindParams.apiPsoHash        = Pal::InternalApiPsoHash;
+                Pal::PipelineBindParams bindParams = {};
+                bindParams.pipelineBindPoint = Pal::PipelineBindPoint::Compute;
+                bindParams.pPipeline         = pipeline.pPipeline[deviceIdx];
+                bindParams.apiPsoHash        = Pal::InternalApiPsoHash;
 
-            // Bind the copy compute pipeline
-            PalCmdBuffer(deviceIdx)->CmdBindPipeline(bindParams);
+                // Bind the copy compute pipeline
+                PalCmdBuffer(deviceIdx)->CmdBindPipeline(bindParams);
 
-            // Set the query buffer SRD (copy source) as typed 64-bit storage view
-            memcpy(&userData[viewOffset], pPool->GetStorageView(deviceIdx), storageViewSize);
+                // Set the query buffer SRD (copy source) as typed 64-bit storage view
+                memcpy(&userData[viewOffset], pPool->GetStorageView(deviceIdx), storageViewSize);
 
-            bufferViewInfo.gpuAddr = pDestBuffer->GpuVirtAddr(deviceIdx) + destOffset;
-            m_pDevice->PalDevice(deviceIdx)->CreateUntypedBufferViewSrds(1, &bufferViewInfo, &userData[bufferViewOffset]);
+                bufferViewInfo.gpuAddr = pDestBuffer->GpuVirtAddr(deviceIdx) + destOffset;
+                m_pDevice->PalDevice(deviceIdx)->CreateUntypedBufferViewSrds(
+                    1,
+                    &bufferViewInfo,
+                    &userData[bufferViewOffset]);
 
-            // Write user data registers
-            PalCmdBuffer(deviceIdx)->CmdSetUserData(
-                Pal::PipelineBindPoint::Compute,
-                0,
-                userDataCount,
-                userData);
+                // Write user data registers
+                PalCmdBuffer(deviceIdx)->CmdSetUserData(
+                    Pal::PipelineBindPoint::Compute,
+                    0,
+                    userDataCount,
+                    userData);
 
-            // Figure out how many thread groups we need to dispatch and dispatch
-            constexpr uint32_t ThreadsPerGroup = 64;
+                // Figure out how many thread groups we need to dispatch and dispatch
+                constexpr uint32_t ThreadsPerGroup = 64;
 
-            uint32_t threadGroupCount = Util::Max(1U, (queryCount + ThreadsPerGroup - 1) / ThreadsPerGroup);
+                uint32_t threadGroupCount = Util::Max(1U, (queryCount + ThreadsPerGroup - 1) / ThreadsPerGroup);
 
-            PalCmdBuffer(deviceIdx)->CmdDispatch(threadGroupCount, 1, 1);
+                PalCmdBuffer(deviceIdx)->CmdDispatch(threadGroupCount, 1, 1);
 
-            // Restore compute state
-            PalCmdBuffer(deviceIdx)->CmdRestoreComputeState(Pal::ComputeStatePipelineAndUserData);
+                // Restore compute state
+                PalCmdBuffer(deviceIdx)->CmdRestoreComputeState(Pal::ComputeStatePipelineAndUserData);
 
-            // Note that the application is responsible for doing a post-copy sync using a barrier.
+                // Note that the application is responsible for doing a post-copy sync using a barrier.
+            }
+            while (deviceGroup.IterateNext());
         }
-        while (deviceGroup.IterateNext());
     }
 
     PalCmdSuspendPredication(false);
@@ -5191,7 +6147,7 @@ void CmdBuffer::WriteTimestamp(
             pQueryPool->PalMemory(deviceIdx),
             pQueryPool->GetSlotOffset(query));
 
-        const auto* const pRenderPass = m_allGpuState.pRenderPass;
+        const uint32_t viewMask = GetRenderingViewMask();
 
         // If vkCmdWriteTimestamp is called while executing a render pass instance that has multiview enabled,
         // the timestamp uses N consecutive query indices in the query pool (starting at query) where
@@ -5199,9 +6155,8 @@ void CmdBuffer::WriteTimestamp(
         //
         // The first query is a timestamp value and (if more than one bit is set in the view mask)
         // zero is written to the remaining queries.
-        if (pRenderPass && pRenderPass->IsMultiviewEnabled())
+        if (viewMask != 0)
         {
-            const auto viewMask  = pRenderPass->GetViewMask(m_renderPassInstance.subpass);
             const auto viewCount = Util::CountSetBits(viewMask);
 
             VK_ASSERT(viewCount > 0);
@@ -5264,33 +6219,12 @@ void CmdBuffer::RPInitSamplePattern()
 }
 
 // =====================================================================================================================
-// Begins a render pass instance (vkCmdBeginRenderPass)
-void CmdBuffer::BeginRenderPass(
-    const VkRenderPassBeginInfo* pRenderPassBegin,
-    VkSubpassContents            contents)
+// Copies the render areas of a render pass or dynamic rendering instance (these may be per-device in a group) and
+// applies the instance's device mask.
+void CmdBuffer::RPSetRenderArea(
+    const VkRect2D&                             renderArea,
+    const VkDeviceGroupRenderPassBeginInfo*     pDeviceGroupRenderPassBeginInfo)
 {
-    VK_IGNORE(contents);
-
-    DbgBarrierPreCmd(DbgBarrierBeginRenderPass);
-
-    m_allGpuState.pRenderPass  = RenderPass::ObjectFromHandle(pRenderPassBegin->renderPass);
-    m_allGpuState.pFramebuffer = Framebuffer::ObjectFromHandle(pRenderPassBegin->framebuffer);
-
-    Pal::Result result = Pal::Result::Success;
-
-    EXTRACT_VK_STRUCTURES_3(
-        RP,
-        RenderPassBeginInfo,
-        DeviceGroupRenderPassBeginInfo,
-        RenderPassSampleLocationsBeginInfoEXT,
-        RenderPassAttachmentBeginInfo,
-        pRenderPassBegin,
-        RENDER_PASS_BEGIN_INFO,
-        DEVICE_GROUP_RENDER_PASS_BEGIN_INFO,
-        RENDER_PASS_SAMPLE_LOCATIONS_BEGIN_INFO_EXT,
-        RENDER_PASS_ATTACHMENT_BEGIN_INFO)
-
-    // Copy render areas (these may be per-device in a group)
     bool replicateRenderArea = true;
 
     // Set the render pass instance's device mask to the value the command buffer began with.
@@ -5334,7 +6268,7 @@ void CmdBuffer::BeginRenderPass(
     {
         m_renderPassInstance.renderAreaCount = m_pDevice->NumPalDevices();
 
-        const auto& srcRect = pRenderPassBeginInfo->renderArea;
+        const auto& srcRect = renderArea;
 
         for (uint32_t deviceIdx = 0; deviceIdx <  m_pDevice->NumPalDevices(); deviceIdx++)
         {
@@ -5346,6 +6280,36 @@ void CmdBuffer::BeginRenderPass(
             pDstRect->extent.height = srcRect.extent.height;
         }
     }
+}
+
+// =====================================================================================================================
+// Begins a render pass instance (vkCmdBeginRenderPass)
+void CmdBuffer::BeginRenderPass(
+    const VkRenderPassBeginInfo* pRenderPassBegin,
+    VkSubpassContents            contents)
+{
+    VK_IGNORE(contents);
+
+    DbgBarrierPreCmd(DbgBarrierBeginRenderPass);
+
+    m_allGpuState.pRenderPass  = RenderPass::ObjectFromHandle(pRenderPassBegin->renderPass);
+    m_allGpuState.pFramebuffer = Framebuffer::ObjectFromHandle(pRenderPassBegin->framebuffer);
+
+    Pal::Result result = Pal::Result::Success;
+
+    EXTRACT_VK_STRUCTURES_3(
+        RP,
+        RenderPassBeginInfo,
+        DeviceGroupRenderPassBeginInfo,
+        RenderPassSampleLocationsBeginInfoEXT,
+        RenderPassAttachmentBeginInfo,
+        pRenderPassBegin,
+        RENDER_PASS_BEGIN_INFO,
+        DEVICE_GROUP_RENDER_PASS_BEGIN_INFO,
+        RENDER_PASS_SAMPLE_LOCATIONS_BEGIN_INFO_EXT,
+        RENDER_PASS_ATTACHMENT_BEGIN_INFO)
+
+    RPSetRenderArea(pRenderPassBeginInfo->renderArea, pDeviceGroupRenderPassBeginInfo);
 
     const uint32_t attachmentCount = m_allGpuState.pRenderPass->GetAttachmentCount();
 
@@ -5549,6 +6513,10 @@ void CmdBuffer::BeginRenderPass(
 
         // Begin the first subpass
         m_renderPassInstance.pExecuteInfo = m_allGpuState.pRenderPass->GetExecuteInfo();
+        m_renderPassInstance.pProgram     = m_allGpuState.pFramebuffer->GetRenderPassProgram(
+                                                m_pDevice,
+                                                m_allGpuState.pRenderPass,
+                                                GetQueueFamilyIndex());
 
         utils::IterateMask deviceGroup(GetRpDeviceMask());
         do
@@ -5610,7 +6578,9 @@ void CmdBuffer::RPEndSubpass()
     // Synchronize preceding work before resolving if needed
     if (subpass.end.syncPreResolve.flags.active)
     {
-        RPSyncPoint(subpass.end.syncPreResolve, &virtStack);
+        RPSyncPoint(subpass.end.syncPreResolve,
+                    RPSyncPointIndex(m_renderPassInstance.subpass, RPSyncPointPreResolve),
+                    &virtStack);
     }
 
     // Execute any multisample resolve attachment operations
@@ -5622,7 +6592,9 @@ void CmdBuffer::RPEndSubpass()
     // Synchronize preceding work at the end of the subpass
     if (subpass.end.syncBottom.flags.active)
     {
-        RPSyncPoint(subpass.end.syncBottom, &virtStack);
+        RPSyncPoint(subpass.end.syncBottom,
+                    RPSyncPointIndex(m_renderPassInstance.subpass, RPSyncPointBottom),
+                    &virtStack);
     }
 }
 
@@ -5674,7 +6646,9 @@ void CmdBuffer::RPBeginSubpass()
     if (subpass.begin.syncTop.flags.active)
     {
         VirtualStackFrame virtStack(m_pStackAllocator);
-        RPSyncPoint(subpass.begin.syncTop, &virtStack);
+        RPSyncPoint(subpass.begin.syncTop,
+                    RPSyncPointIndex(m_renderPassInstance.subpass, RPSyncPointTop),
+                    &virtStack);
     }
 
     // Execute any color clear load operations
@@ -5723,8 +6697,18 @@ void CmdBuffer::RPBeginSubpass()
 // layout transitions.
 void CmdBuffer::RPSyncPoint(
     const RPSyncPointInfo& syncPoint,
+    uint32_t               syncPointIndex,
     VirtualStackFrame*     pVirtStack)
 {
+    if (m_renderPassInstance.pProgram != nullptr)
+    {
+        VK_ASSERT(syncPointIndex < m_renderPassInstance.pProgram->syncPointCount);
+
+        RPReplaySyncPoint(m_renderPassInstance.pProgram->pSyncPoints[syncPointIndex], pVirtStack);
+
+        return;
+    }
+
     const auto& rpBarrier = syncPoint.barrier;
 
     Pal::BarrierInfo barrier = {};
@@ -5743,20 +6727,11 @@ void CmdBuffer::RPSyncPoint(
                                               pVirtStack->AllocArray<const Image*>(maxTransitionCount) :
                                               nullptr;
 
-    // Construct global memory dependency to synchronize caches (subpass dependencies + implicit synchronization)
+    // Global memory dependency to synchronize caches (subpass dependencies + implicit synchronization)
     if (rpBarrier.flags.needsGlobalTransition)
     {
-        Pal::BarrierTransition globalTransition = { };
-
-        m_pDevice->GetBarrierPolicy().ApplyBarrierCacheFlags(
-            rpBarrier.srcAccessMask,
-            rpBarrier.dstAccessMask,
-            VK_IMAGE_LAYOUT_GENERAL,
-            VK_IMAGE_LAYOUT_GENERAL,
-            &globalTransition);
-
-        barrier.globalSrcCacheMask = globalTransition.srcCacheMask | rpBarrier.implicitSrcCacheMask;
-        barrier.globalDstCacheMask = globalTransition.dstCacheMask | rpBarrier.implicitDstCacheMask;
+        barrier.globalSrcCacheMask = rpBarrier.globalSrcCacheMask;
+        barrier.globalDstCacheMask = rpBarrier.globalDstCacheMask;
     }
 
     if ((pPalTransitions != nullptr) && (ppImages != nullptr))
@@ -5779,10 +6754,17 @@ void CmdBuffer::RPSyncPoint(
                     plane,
                     this);
 
-                const Pal::ImageLayout oldLayout = RPGetAttachmentLayout(
+                Pal::ImageLayout oldLayout = RPGetAttachmentLayout(
                     tr.attachment,
                     plane);
 
+                if ((oldLayout.usages & Pal::LayoutUninitializedTarget) != 0)
+                {
+                    oldLayout = RPResolveUninitializedLayout(tr.attachment, plane, oldLayout);
+
+                    RPSetAttachmentLayout(tr.attachment, plane, oldLayout);
+                }
+
                 if (oldLayout.usages  != newLayout.usages ||
                     oldLayout.engines != newLayout.engines)
                 {
@@ -5858,80 +6840,435 @@ void CmdBuffer::RPSyncPoint(
 }
 
 // =====================================================================================================================
-// Does one or more load-op color clears during a render pass instance.
-void CmdBuffer::RPLoadOpClearColor(
-    uint32_t                 count,
-    const RPLoadOpClearInfo* pClears)
+// Executes a sync point precompiled for the current render pass and framebuffer.  Only the attachment layout state and
+// the sample patterns of multisampled attachments need to be filled in here.
+void CmdBuffer::RPReplaySyncPoint(
+    const RPSyncPointProgram& program,
+    VirtualStackFrame*        pVirtStack)
 {
-    if (m_pSqttState != nullptr)
+    // Merged sync points were executed as part of an earlier one
+    if (program.flags.merged == 0)
     {
-        m_pSqttState->BeginRenderPassColorClear();
-    }
+        const uint32_t transitionCount = program.barrier.transitionCount;
 
-    VirtualStackFrame virtStackFrame(m_pStackAllocator);
+        for (uint32_t t = 0; t < transitionCount; ++t)
+        {
+            RPSetAttachmentLayout(
+                program.pTargets[t].attachment,
+                program.pTargets[t].plane,
+                program.pTransitions[t].imageInfo.newLayout);
+        }
 
-    Util::Vector<Pal::ClearBoundTargetRegion, 8, VirtualStackFrame> clearRegions{ &virtStackFrame };
+        if (program.flags.execute)
+        {
+            Pal::BarrierInfo        barrier      = program.barrier;
+            Pal::BarrierTransition* pTransitions = program.pTransitions;
 
-    const auto maxRects = EstimateMaxObjectsOnVirtualStack(sizeof(VkClearRect));
-    auto       rectBatch = Util::Min(count, maxRects);
-    const auto palResult = clearRegions.Reserve(rectBatch);
+            // Attachments holding a tracked clear value are transitioned from their actual layout instead of an
+            // uninitialized one.
+            const bool patchLayouts = (program.flags.discardsContents != 0) && (m_clearStates.entryCount > 0);
 
-    VK_ASSERT(palResult == Pal::Result::Success);
+            // The program is shared by all command buffers, so patch a copy of the transitions if needed
+            if ((transitionCount > 0) && (program.flags.hasSamplePatterns || m_pDevice->IsMultiGpu() || patchLayouts))
+            {
+                pTransitions = pVirtStack->AllocArray<Pal::BarrierTransition>(transitionCount);
 
-    for (uint32_t i = 0; i < count; ++i)
-    {
-        const RPLoadOpClearInfo& clear = pClears[i];
+                if (pTransitions != nullptr)
+                {
+                    memcpy(pTransitions, program.pTransitions, sizeof(Pal::BarrierTransition) * transitionCount);
 
-        const Framebuffer::Attachment& attachment = m_allGpuState.pFramebuffer->GetAttachment(clear.attachment);
+                    for (uint32_t t = 0; t < transitionCount; ++t)
+                    {
+                        const RPTransitionTarget& target = program.pTargets[t];
 
-        // Convert the clear color to the format of the attachment view
-        Pal::ClearColor clearColor = VkToPalClearColor(
-            &m_renderPassInstance.pAttachments[clear.attachment].clearValue.color,
-            attachment.viewFormat);
+                        if (target.samplePatternSource == RPSamplePatternInitial)
+                        {
+                            pTransitions[t].imageInfo.pQuadSamplePattern =
+                                &m_renderPassInstance.pAttachments[target.attachment].initialSamplePattern.locations;
+                        }
+                        else if (target.samplePatternSource == RPSamplePatternSubpass)
+                        {
+                            pTransitions[t].imageInfo.pQuadSamplePattern =
+                                &m_renderPassInstance.pSamplePatterns[target.subpass].locations;
+                        }
 
-        Pal::BoundColorTarget target = {};
-        if (m_flags.subpassLoadOpClearsBoundAttachments)
-        {
-            const uint32_t tgtIdx = clear.attachment;
-            const RenderPass* pRenderPass = m_allGpuState.pRenderPass;
-            const uint32_t subpass = m_renderPassInstance.subpass;
+                        if (patchLayouts &&
+                            ((pTransitions[t].imageInfo.oldLayout.usages & Pal::LayoutUninitializedTarget) != 0))
+                        {
+                            pTransitions[t].imageInfo.oldLayout = RPResolveUninitializedLayout(
+                                target.attachment,
+                                target.plane,
+                                pTransitions[t].imageInfo.oldLayout);
+                        }
+                    }
+                }
+                else
+                {
+                    m_recordingResult = VK_ERROR_OUT_OF_HOST_MEMORY;
+                }
+            }
 
-            target.targetIndex = tgtIdx;
-            target.swizzledFormat = attachment.viewFormat;
-            target.samples = pRenderPass->GetColorAttachmentSamples(subpass, tgtIdx);
-            target.fragments = pRenderPass->GetColorAttachmentSamples(subpass, tgtIdx);
-            target.clearValue = clearColor;
-        }
+            if ((pTransitions != nullptr) || (transitionCount == 0))
+            {
+                barrier.pTransitions = pTransitions;
 
-        Pal::SubresRange subresRange;
-        attachment.pView->GetFrameBufferAttachmentSubresRange(&subresRange);
+                PalCmdBarrier(&barrier, pTransitions, program.ppImages, GetRpDeviceMask());
+            }
 
-        const Pal::ImageLayout clearLayout = RPGetAttachmentLayout(clear.attachment, subresRange.startSubres.plane);
+            if ((pTransitions != nullptr) && (pTransitions != program.pTransitions))
+            {
+                pVirtStack->FreeArray(pTransitions);
+            }
+        }
+    }
+}
 
-        VK_ASSERT(clearLayout.usages & Pal::LayoutColorTarget);
+// =====================================================================================================================
+// Drops the tracked clear states of the images whose layout or owning queue family the barriers change.  This covers
+// barriers out of VK_IMAGE_LAYOUT_UNDEFINED, which discard the contents of an image.
+template <typename ImageBarrierType>
+void CmdBuffer::InvalidateClearStates(
+    uint32_t                imageBarrierCount,
+    const ImageBarrierType* pImageBarriers)
+{
+    for (uint32_t i = 0; (i < imageBarrierCount) && (m_clearStates.entryCount > 0); ++i)
+    {
+        const ImageBarrierType& imageBarrier = pImageBarriers[i];
 
-        const auto clearSubresRanges = LoadOpClearSubresRanges(
-            attachment, clear,
-            *m_allGpuState.pRenderPass);
+        if ((imageBarrier.oldLayout           != imageBarrier.newLayout) ||
+            (imageBarrier.srcQueueFamilyIndex != imageBarrier.dstQueueFamilyIndex))
+        {
+            DropImageClearState(Image::ObjectFromHandle(imageBarrier.image));
+        }
+    }
+}
 
-        utils::IterateMask deviceGroup(GetRpDeviceMask());
+// =====================================================================================================================
+// Returns true if the given render pass attachment is known to already hold its clear value within the given
+// per-device boxes, in which case a load-op clear of it is redundant.
+bool CmdBuffer::RPIsAttachmentCleared(
+    uint32_t           attachment,
+    VkImageAspectFlags aspectMask,
+    const Pal::Box*    pBoxes
+    ) const
+{
+    bool isCleared = false;
 
-        do
+    if (m_pDevice->GetRuntimeSettings().renderPassElideRedundantClears)
+    {
+        const Framebuffer::Attachment& fbAttachment = m_allGpuState.pFramebuffer->GetAttachment(attachment);
+        const VkClearValue&            clearValue   = m_renderPassInstance.pAttachments[attachment].clearValue;
+        const Pal::SubresRange&        subresRange  = fbAttachment.subresRange[0];
+        const uint32_t                 viewMask     = m_allGpuState.pRenderPass->GetActiveViewsBitMask();
+        const uint32_t                 deviceMask   = GetRpDeviceMask();
+        const bool                     isColor      = ((aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) != 0);
+
+        for (uint32_t i = 0; (i < m_clearStates.entryCount) && (isCleared == false); ++i)
         {
-            const uint32_t deviceIdx = deviceGroup.Index();
+            const ClearStateTracker::Entry& entry = m_clearStates.entries[i];
 
-            Pal::Box clearBox = BuildClearBox(m_renderPassInstance.renderArea[deviceIdx], attachment);
+            bool match = (entry.pImage                             == fbAttachment.pImage)                &&
+                         (entry.subresRange.startSubres.plane      == subresRange.startSubres.plane)      &&
+                         (entry.subresRange.startSubres.mipLevel   == subresRange.startSubres.mipLevel)   &&
+                         (entry.subresRange.startSubres.arraySlice == subresRange.startSubres.arraySlice) &&
+                         (entry.subresRange.numMips                == subresRange.numMips)                &&
+                         (entry.subresRange.numSlices              == subresRange.numSlices)              &&
+                         ((entry.aspectMask & aspectMask)          == aspectMask)                         &&
+                         (entry.viewMask                           == viewMask)                           &&
+                         ((entry.deviceMask & deviceMask)          == deviceMask);
 
-            if (m_flags.subpassLoadOpClearsBoundAttachments == false)
+            if (match)
             {
-                 PalCmdBuffer(deviceIdx)->CmdClearColorImage(
-                    *attachment.pImage->PalImage(deviceIdx),
-                    clearLayout,
-                    clearColor,
-                    clearSubresRanges.NumElements(),
-                    clearSubresRanges.Data(),
-                    1,
-                    &clearBox,
+                if (isColor)
+                {
+                    match = (memcmp(&entry.viewFormat, &fbAttachment.viewFormat, sizeof(Pal::SwizzledFormat)) == 0) &&
+                            (memcmp(&entry.clearValue.color, &clearValue.color, sizeof(VkClearColorValue)) == 0);
+                }
+                else
+                {
+                    match = (((aspectMask & VK_IMAGE_ASPECT_DEPTH_BIT) == 0) ||
+                             (memcmp(&entry.clearValue.depthStencil.depth,
+                                     &clearValue.depthStencil.depth,
+                                     sizeof(float)) == 0)) &&
+                            (((aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT) == 0) ||
+                             (entry.clearValue.depthStencil.stencil == clearValue.depthStencil.stencil));
+                }
+            }
+
+            if (match)
+            {
+                utils::IterateMask deviceGroup(deviceMask);
+
+                do
+                {
+                    const uint32_t deviceIdx = deviceGroup.Index();
+
+                    match = BoxContains(entry.box[deviceIdx], pBoxes[deviceIdx]);
+                }
+                while (match && deviceGroup.IterateNext());
+            }
+
+            isCleared = match;
+        }
+    }
+
+    return isCleared;
+}
+
+// =====================================================================================================================
+// Records that the given render pass attachment holds its clear value within the given per-device boxes.
+void CmdBuffer::RPSetAttachmentCleared(
+    uint32_t           attachment,
+    VkImageAspectFlags aspectMask,
+    const Pal::Box*    pBoxes)
+{
+    if (m_pDevice->GetRuntimeSettings().renderPassElideRedundantClears)
+    {
+        RPDropAttachmentClearState(attachment);
+
+        // Aliased attachments may be written through other images that are not tracked.
+        if ((m_allGpuState.pRenderPass->GetAttachmentDesc(attachment).flags &
+             VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT) != 0)
+        {
+            InvalidateClearStates();
+        }
+        else
+        {
+            const Framebuffer::Attachment& fbAttachment = m_allGpuState.pFramebuffer->GetAttachment(attachment);
+
+            uint32_t entryIdx;
+
+            if (m_clearStates.entryCount < ClearStateTracker::MaxEntries)
+            {
+                entryIdx = m_clearStates.entryCount++;
+            }
+            else
+            {
+                entryIdx = m_clearStates.nextEntry;
+
+                m_clearStates.nextEntry = (m_clearStates.nextEntry + 1) % ClearStateTracker::MaxEntries;
+            }
+
+            ClearStateTracker::Entry* pEntry = &m_clearStates.entries[entryIdx];
+
+            pEntry->pImage      = fbAttachment.pImage;
+            pEntry->subresRange = fbAttachment.subresRange[0];
+            pEntry->aspectMask  = aspectMask;
+            pEntry->viewMask    = m_allGpuState.pRenderPass->GetActiveViewsBitMask();
+            pEntry->deviceMask  = GetRpDeviceMask();
+            pEntry->viewFormat  = fbAttachment.viewFormat;
+            pEntry->clearValue  = m_renderPassInstance.pAttachments[attachment].clearValue;
+
+            memcpy(pEntry->box, pBoxes, sizeof(pEntry->box));
+
+            RPUpdateAttachmentClearLayouts(attachment);
+        }
+    }
+}
+
+// =====================================================================================================================
+// Forgets any tracked clear state of the image behind the given render pass attachment.
+void CmdBuffer::RPDropAttachmentClearState(
+    uint32_t attachment)
+{
+    DropImageClearState(m_allGpuState.pFramebuffer->GetAttachment(attachment).pImage);
+}
+
+// =====================================================================================================================
+// Returns the index of the tracked clear state covering exactly the subresources of the given render pass attachment,
+// or the entry count if there is none.
+uint32_t CmdBuffer::RPFindAttachmentClearState(
+    uint32_t attachment
+    ) const
+{
+    const Framebuffer::Attachment& fbAttachment = m_allGpuState.pFramebuffer->GetAttachment(attachment);
+    const Pal::SubresRange&        subresRange  = fbAttachment.subresRange[0];
+
+    uint32_t entryIdx = 0;
+
+    for (; entryIdx < m_clearStates.entryCount; ++entryIdx)
+    {
+        const ClearStateTracker::Entry& entry = m_clearStates.entries[entryIdx];
+
+        if ((entry.pImage                             == fbAttachment.pImage)                &&
+            (entry.subresRange.startSubres.plane      == subresRange.startSubres.plane)      &&
+            (entry.subresRange.startSubres.mipLevel   == subresRange.startSubres.mipLevel)   &&
+            (entry.subresRange.startSubres.arraySlice == subresRange.startSubres.arraySlice) &&
+            (entry.subresRange.numMips                == subresRange.numMips)                &&
+            (entry.subresRange.numSlices              == subresRange.numSlices))
+        {
+            break;
+        }
+    }
+
+    return entryIdx;
+}
+
+// =====================================================================================================================
+// Records the current layouts of the given render pass attachment with its tracked clear state, if any.
+void CmdBuffer::RPUpdateAttachmentClearLayouts(
+    uint32_t attachment)
+{
+    const uint32_t entryIdx = RPFindAttachmentClearState(attachment);
+
+    if (entryIdx < m_clearStates.entryCount)
+    {
+        const Framebuffer::Attachment& fbAttachment = m_allGpuState.pFramebuffer->GetAttachment(attachment);
+
+        for (uint32_t sr = 0; sr < fbAttachment.subresRangeCount; ++sr)
+        {
+            const uint32_t plane = fbAttachment.subresRange[sr].startSubres.plane;
+
+            m_clearStates.entries[entryIdx].layouts[plane] = RPGetAttachmentLayout(attachment, plane);
+        }
+    }
+}
+
+// =====================================================================================================================
+// Returns the layout to transition a render pass attachment from in place of an uninitialized one.  An attachment that
+// holds the value of an earlier load-op clear is in a known layout, so transitioning it from that layout keeps its
+// contents and lets the load-op clear of this instance be skipped.  Otherwise the contents of the image are discarded
+// and any clear state tracked for it is dropped.
+Pal::ImageLayout CmdBuffer::RPResolveUninitializedLayout(
+    uint32_t         attachment,
+    uint32_t         plane,
+    Pal::ImageLayout layout)
+{
+    const uint32_t entryIdx = RPFindAttachmentClearState(attachment);
+
+    if (entryIdx < m_clearStates.entryCount)
+    {
+        layout = m_clearStates.entries[entryIdx].layouts[plane];
+    }
+    else
+    {
+        RPDropAttachmentClearState(attachment);
+    }
+
+    return layout;
+}
+
+// =====================================================================================================================
+// Forgets any tracked clear state of the given image.
+void CmdBuffer::DropImageClearState(
+    const Image* pImage)
+{
+    uint32_t i = 0;
+
+    while (i < m_clearStates.entryCount)
+    {
+        if (m_clearStates.entries[i].pImage == pImage)
+        {
+            m_clearStates.entries[i] = m_clearStates.entries[--m_clearStates.entryCount];
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    if (m_clearStates.nextEntry >= m_clearStates.entryCount)
+    {
+        m_clearStates.nextEntry = 0;
+    }
+}
+
+// =====================================================================================================================
+// Does one or more load-op color clears during a render pass instance.
+void CmdBuffer::RPLoadOpClearColor(
+    uint32_t                 count,
+    const RPLoadOpClearInfo* pClears)
+{
+    if (m_pSqttState != nullptr)
+    {
+        m_pSqttState->BeginRenderPassColorClear();
+    }
+
+    VirtualStackFrame virtStackFrame(m_pStackAllocator);
+
+    Util::Vector<Pal::ClearBoundTargetRegion, 8, VirtualStackFrame> clearRegions{ &virtStackFrame };
+
+    const auto maxRects = EstimateMaxObjectsOnVirtualStack(sizeof(VkClearRect));
+    auto       rectBatch = Util::Min(count, maxRects);
+    const auto palResult = clearRegions.Reserve(rectBatch);
+
+    VK_ASSERT(palResult == Pal::Result::Success);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const RPLoadOpClearInfo& clear = pClears[i];
+
+        const Framebuffer::Attachment& attachment = m_allGpuState.pFramebuffer->GetAttachment(clear.attachment);
+
+        Pal::Box clearBoxes[MaxPalDevices] = {};
+        bool     fullClear                 = true;
+
+        utils::IterateMask boxDeviceGroup(GetRpDeviceMask());
+
+        do
+        {
+            const uint32_t deviceIdx = boxDeviceGroup.Index();
+
+            clearBoxes[deviceIdx] = BuildClearBox(m_renderPassInstance.renderArea[deviceIdx], attachment);
+            fullClear            &= IsFullSubresClearBox(clearBoxes[deviceIdx], attachment);
+        }
+        while (boxDeviceGroup.IterateNext());
+
+        // Skip the clear if the attachment still holds the clear value from an earlier one
+        if (RPIsAttachmentCleared(clear.attachment, clear.aspect, clearBoxes))
+        {
+            continue;
+        }
+
+        // Convert the clear color to the format of the attachment view
+        Pal::ClearColor clearColor = VkToPalClearColor(
+            &m_renderPassInstance.pAttachments[clear.attachment].clearValue.color,
+            attachment.viewFormat);
+
+        Pal::BoundColorTarget target = {};
+        if (m_flags.subpassLoadOpClearsBoundAttachments)
+        {
+            const uint32_t tgtIdx = clear.attachment;
+            const RenderPass* pRenderPass = m_allGpuState.pRenderPass;
+            const uint32_t subpass = m_renderPassInstance.subpass;
+
+            target.targetIndex = tgtIdx;
+            target.swizzledFormat = attachment.viewFormat;
+            target.samples = pRenderPass->GetColorAttachmentSamples(subpass, tgtIdx);
+            target.fragments = pRenderPass->GetColorAttachmentSamples(subpass, tgtIdx);
+            target.clearValue = clearColor;
+        }
+
+        Pal::SubresRange subresRange;
+        attachment.pView->GetFrameBufferAttachmentSubresRange(&subresRange);
+
+        const Pal::ImageLayout clearLayout = RPGetAttachmentLayout(clear.attachment, subresRange.startSubres.plane);
+
+        VK_ASSERT(clearLayout.usages & Pal::LayoutColorTarget);
+
+        const auto clearSubresRanges = LoadOpClearSubresRanges(
+            attachment, clear.aspect,
+            m_allGpuState.pRenderPass->GetActiveViewsBitMask());
+
+        utils::IterateMask deviceGroup(GetRpDeviceMask());
+
+        do
+        {
+            const uint32_t deviceIdx = deviceGroup.Index();
+
+            const Pal::Box& clearBox = clearBoxes[deviceIdx];
+
+            if (m_flags.subpassLoadOpClearsBoundAttachments == false)
+            {
+                // A clear of the whole subresource is issued without a box so PAL may use a fast clear.
+                PalCmdBuffer(deviceIdx)->CmdClearColorImage(
+                    *attachment.pImage->PalImage(deviceIdx),
+                    clearLayout,
+                    clearColor,
+                    clearSubresRanges.NumElements(),
+                    clearSubresRanges.Data(),
+                    fullClear ? 0 : 1,
+                    fullClear ? nullptr : &clearBox,
                     count == 1 ? Pal::ColorClearAutoSync : 0); // Multi-RT clears are synchronized later in RPBeginSubpass()
             }
             else
@@ -5954,7 +7291,7 @@ void CmdBuffer::RPLoadOpClearColor(
 
                 CreateClearRegions(
                     1, &clearRect,
-                    *pRenderPass, subpass, 0u,
+                    pRenderPass->GetViewMask(subpass), 0u,
                     &clearRegions);
 
                // Clear the bound color targets
@@ -5966,6 +7303,8 @@ void CmdBuffer::RPLoadOpClearColor(
             }
         }
         while (deviceGroup.IterateNext());
+
+        RPSetAttachmentCleared(clear.attachment, clear.aspect, clearBoxes);
     }
 
     if (m_pSqttState != nullptr)
@@ -5998,6 +7337,26 @@ void CmdBuffer::RPLoadOpClearDepthStencil(
 
         const Framebuffer::Attachment& attachment = m_allGpuState.pFramebuffer->GetAttachment(clear.attachment);
 
+        Pal::Box clearBoxes[MaxPalDevices] = {};
+        bool     fullClear                 = true;
+
+        utils::IterateMask boxDeviceGroup(GetRpDeviceMask());
+
+        do
+        {
+            const uint32_t deviceIdx = boxDeviceGroup.Index();
+
+            clearBoxes[deviceIdx] = BuildClearBox(m_renderPassInstance.renderArea[deviceIdx], attachment);
+            fullClear            &= IsFullSubresClearBox(clearBoxes[deviceIdx], attachment);
+        }
+        while (boxDeviceGroup.IterateNext());
+
+        // Skip the clear if the attachment still holds the clear values from an earlier one
+        if (RPIsAttachmentCleared(clear.attachment, clear.aspect, clearBoxes))
+        {
+            continue;
+        }
+
         const Pal::ImageLayout depthLayout   = RPGetAttachmentLayout(clear.attachment, 0);
         const Pal::ImageLayout stencilLayout = RPGetAttachmentLayout(clear.attachment, 1);
 
@@ -6008,8 +7367,8 @@ void CmdBuffer::RPLoadOpClearDepthStencil(
         Pal::uint8 clearStencil = clearValue.depthStencil.stencil;
 
         const auto clearSubresRanges = LoadOpClearSubresRanges(
-            attachment, clear,
-            *m_allGpuState.pRenderPass);
+            attachment, clear.aspect,
+            m_allGpuState.pRenderPass->GetActiveViewsBitMask());
 
         utils::IterateMask deviceGroup(GetRpDeviceMask());
 
@@ -6024,6 +7383,7 @@ void CmdBuffer::RPLoadOpClearDepthStencil(
 
             if (m_flags.subpassLoadOpClearsBoundAttachments == false)
             {
+                // A clear of the whole subresource is issued without a rect so PAL may use a fast clear.
                 PalCmdBuffer(deviceIdx)->CmdClearDepthStencil(
                     *attachment.pImage->PalImage(deviceIdx),
                     depthLayout,
@@ -6033,8 +7393,8 @@ void CmdBuffer::RPLoadOpClearDepthStencil(
                     StencilWriteMaskFull,
                     clearSubresRanges.NumElements(),
                     clearSubresRanges.Data(),
-                    1,
-                    &palClearRect,
+                    fullClear ? 0 : 1,
+                    fullClear ? nullptr : &palClearRect,
                     Pal::DsClearAutoSync);
             }
             else
@@ -6070,7 +7430,7 @@ void CmdBuffer::RPLoadOpClearDepthStencil(
 
                 CreateClearRegions(
                     1, &clearRect,
-                    *pRenderPass, subpass, 0u,
+                    pRenderPass->GetViewMask(subpass), 0u,
                     &clearRegions);
 
                 // Clear the bound depth stencil target immediately
@@ -6086,6 +7446,8 @@ void CmdBuffer::RPLoadOpClearDepthStencil(
             }
         }
         while (deviceGroup.IterateNext());
+
+        RPSetAttachmentCleared(clear.attachment, clear.aspect, clearBoxes);
     }
 
     if (m_pSqttState != nullptr)
@@ -6095,7 +7457,9 @@ void CmdBuffer::RPLoadOpClearDepthStencil(
 }
 
 // =====================================================================================================================
-// Launches one or more MSAA resolves during a render pass instance.
+// Launches one or more MSAA resolves during a render pass instance.  The resolves of a subpass are independent of each
+// other, so they are ordered such that resolves with the same sample count and layouts are issued back to back under
+// a single blt MSAA state bind, and planes sharing a resolve mode and layouts are resolved by a single PAL call.
 void CmdBuffer::RPResolveAttachments(
     uint32_t             count,
     const RPResolveInfo* pResolves)
@@ -6106,111 +7470,165 @@ void CmdBuffer::RPResolveAttachments(
         m_pSqttState->BeginRenderPassResolve();
     }
 
-    for (uint32_t i = 0; i < count; ++i)
-    {
-        const RPResolveInfo& params = pResolves[i];
+    VirtualStackFrame virtStackFrame(m_pStackAllocator);
 
-        const Framebuffer::Attachment& srcAttachment =
-            m_allGpuState.pFramebuffer->GetAttachment(params.src.attachment);
-        const Framebuffer::Attachment& dstAttachment =
-            m_allGpuState.pFramebuffer->GetAttachment(params.dst.attachment);
+    RPResolveOp* pOps = virtStackFrame.AllocArray<RPResolveOp>(count * MaxRangePerAttachment);
 
-        // Both color and depth-stencil resolves are allowed by resolve attachments
-        // SubresRange shall be exactly same for src and dst.
-        VK_ASSERT(srcAttachment.subresRangeCount == dstAttachment.subresRangeCount);
-        VK_ASSERT(srcAttachment.subresRange[0].numMips == 1);
+    if (pOps != nullptr)
+    {
+        const uint32_t subpass = m_renderPassInstance.subpass;
+        uint32_t       opCount = 0;
 
-        const uint32_t sliceCount = Util::Min(
-            srcAttachment.subresRange[0].numSlices,
-            dstAttachment.subresRange[0].numSlices);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const RPResolveInfo& params = pResolves[i];
 
-        // We expect MSAA images to never have mipmaps
-        VK_ASSERT(srcAttachment.subresRange[0].startSubres.mipLevel == 0);
+            const Framebuffer::Attachment& srcAttachment =
+                m_allGpuState.pFramebuffer->GetAttachment(params.src.attachment);
+            const Framebuffer::Attachment& dstAttachment =
+                m_allGpuState.pFramebuffer->GetAttachment(params.dst.attachment);
 
-        uint32_t aspectRegionCount                    = 0;
-        uint32_t resolvePlanes[MaxRangePerAttachment] = {};
-        const VkFormat   resolveFormat                       = srcAttachment.pView->GetViewFormat();
-        Pal::ResolveMode resolveModes[MaxRangePerAttachment] = {};
+            // Both color and depth-stencil resolves are allowed by resolve attachments
+            // SubresRange shall be exactly same for src and dst.
+            VK_ASSERT(srcAttachment.subresRangeCount == dstAttachment.subresRangeCount);
+            VK_ASSERT(srcAttachment.subresRange[0].numMips == 1);
 
-        const Pal::MsaaQuadSamplePattern* pSampleLocations = nullptr;
+            const uint32_t sliceCount = Util::Min(
+                srcAttachment.subresRange[0].numSlices,
+                dstAttachment.subresRange[0].numSlices);
 
-        if (Formats::IsDepthStencilFormat(resolveFormat) == false)
-        {
-            resolveModes[0]   = Pal::ResolveMode::Average;
-            resolvePlanes[0]  = 0;
-            aspectRegionCount = 1;
-        }
-        else
-        {
-            const uint32_t subpass = m_renderPassInstance.subpass;
+            // We expect MSAA images to never have mipmaps
+            VK_ASSERT(srcAttachment.subresRange[0].startSubres.mipLevel == 0);
 
-            const VkResolveModeFlagBits depthResolveMode =
-                m_allGpuState.pRenderPass->GetDepthResolveMode(subpass);
-            const VkResolveModeFlagBits stencilResolveMode =
-                m_allGpuState.pRenderPass->GetStencilResolveMode(subpass);
+            const Pal::MsaaQuadSamplePattern* pSampleLocations = params.needsSampleLocations ?
+                &m_renderPassInstance.pSamplePatterns[subpass].locations : nullptr;
 
-            if (Formats::HasDepth(resolveFormat))
+            const uint32_t firstOp = opCount;
+
+            for (uint32_t p = 0; p < params.planeCount; ++p)
             {
-                if (depthResolveMode != VK_RESOLVE_MODE_NONE)
+                const uint32_t plane = params.planes[p];
+
+                const Pal::ImageLayout srcLayout = RPGetAttachmentLayout(params.src.attachment, plane);
+                const Pal::ImageLayout dstLayout = RPGetAttachmentLayout(params.dst.attachment, plane);
+
+                // Resolve the plane along with an earlier plane of the same attachment if nothing differs
+                RPResolveOp* pOp = nullptr;
+
+                for (uint32_t o = firstOp; (o < opCount) && (pOp == nullptr); ++o)
                 {
-                    resolveModes[aspectRegionCount]    = VkToPalResolveMode(depthResolveMode);
-                    resolvePlanes[aspectRegionCount++] = 0;
+                    if ((pOps[o].mode == params.modes[p])                    &&
+                        (pOps[o].srcLayout.usages  == srcLayout.usages)      &&
+                        (pOps[o].srcLayout.engines == srcLayout.engines)     &&
+                        (pOps[o].dstLayout.usages  == dstLayout.usages)      &&
+                        (pOps[o].dstLayout.engines == dstLayout.engines))
+                    {
+                        pOp = &pOps[o];
+                    }
+                }
+
+                if (pOp == nullptr)
+                {
+                    pOp = &pOps[opCount++];
+
+                    pOp->pSrcImage   = srcAttachment.pImage;
+                    pOp->pDstImage   = dstAttachment.pImage;
+                    pOp->srcLayout   = srcLayout;
+                    pOp->dstLayout   = dstLayout;
+                    pOp->mode        = params.modes[p];
+                    pOp->samples     = srcAttachment.pImage->GetImageSamples();
+                    pOp->regionCount = 0;
                 }
 
-                // Must be specified because the source image was created with sampleLocsAlwaysKnown set
-                pSampleLocations = &m_renderPassInstance.pSamplePatterns[subpass].locations;
+                // During split-frame-rendering, the image to resolve could be split across multiple devices.
+                for (uint32_t idx = 0; idx < m_renderPassInstance.renderAreaCount; idx++)
+                {
+                    const Pal::Rect&         renderArea = m_renderPassInstance.renderArea[idx];
+                    Pal::ImageResolveRegion* pRegion    = &pOp->regions[pOp->regionCount++];
+
+                    pRegion->srcPlane       = plane;
+                    pRegion->srcSlice       = srcAttachment.subresRange[0].startSubres.arraySlice;
+                    pRegion->srcOffset.x    = renderArea.offset.x;
+                    pRegion->srcOffset.y    = renderArea.offset.y;
+                    pRegion->srcOffset.z    = 0;
+                    pRegion->dstPlane       = plane;
+                    pRegion->dstMipLevel    = dstAttachment.subresRange[0].startSubres.mipLevel;
+                    pRegion->dstSlice       = dstAttachment.subresRange[0].startSubres.arraySlice;
+                    pRegion->dstOffset.x    = renderArea.offset.x;
+                    pRegion->dstOffset.y    = renderArea.offset.y;
+                    pRegion->dstOffset.z    = 0;
+                    pRegion->extent.width   = renderArea.extent.width;
+                    pRegion->extent.height  = renderArea.extent.height;
+                    pRegion->extent.depth   = 1;
+                    pRegion->numSlices      = sliceCount;
+                    pRegion->swizzledFormat = Pal::UndefinedSwizzledFormat;
+
+                    pRegion->pQuadSamplePattern = pSampleLocations;
+                }
             }
+        }
 
-            if (Formats::HasStencil(resolveFormat) && (stencilResolveMode != VK_RESOLVE_MODE_NONE))
+        // Order the resolves by sample count and layouts (stable, there are only a handful of them)
+        for (uint32_t i = 1; i < opCount; ++i)
+        {
+            for (uint32_t j = i; (j > 0) && RPResolveOpLess(pOps[j], pOps[j - 1]); --j)
             {
-                resolveModes[aspectRegionCount]    = VkToPalResolveMode(stencilResolveMode);
-                resolvePlanes[aspectRegionCount++] = Formats::HasDepth(resolveFormat) ? 1 : 0;
+                const RPResolveOp tmp = pOps[j];
+
+                pOps[j]     = pOps[j - 1];
+                pOps[j - 1] = tmp;
             }
         }
 
-        // Depth and stencil might have different resolve mode, so allowing resolve each aspect independently.
-        for (uint32_t aspectRegionIndex = 0; aspectRegionIndex < aspectRegionCount; ++aspectRegionIndex)
+        InvalidateClearStates();
+
+        DbgBarrierPreCmd(DbgBarrierResolve);
+
+        for (uint32_t first = 0; first < opCount;)
         {
-            // During split-frame-rendering, the image to resolve could be split across multiple devices.
-            Pal::ImageResolveRegion regions[MaxPalDevices];
+            uint32_t last = first + 1;
 
-            const Pal::ImageLayout srcLayout = RPGetAttachmentLayout(params.src.attachment, resolvePlanes[aspectRegionIndex]);
-            const Pal::ImageLayout dstLayout = RPGetAttachmentLayout(params.dst.attachment, resolvePlanes[aspectRegionIndex]);
+            while ((last < opCount) && (pOps[last].samples == pOps[first].samples))
+            {
+                ++last;
+            }
 
-            for (uint32_t idx = 0; idx < m_renderPassInstance.renderAreaCount; idx++)
+            PreBltBindMsaaState(*pOps[first].pSrcImage);
+
+            for (uint32_t o = first; o < last; ++o)
             {
-                const Pal::Rect& renderArea = m_renderPassInstance.renderArea[idx];
+                const RPResolveOp& op = pOps[o];
 
-                regions[idx].srcPlane       = resolvePlanes[aspectRegionIndex];
-                regions[idx].srcSlice       = srcAttachment.subresRange[0].startSubres.arraySlice;
-                regions[idx].srcOffset.x    = renderArea.offset.x;
-                regions[idx].srcOffset.y    = renderArea.offset.y;
-                regions[idx].srcOffset.z    = 0;
-                regions[idx].dstPlane       = resolvePlanes[aspectRegionIndex];
-                regions[idx].dstMipLevel    = dstAttachment.subresRange[0].startSubres.mipLevel;
-                regions[idx].dstSlice       = dstAttachment.subresRange[0].startSubres.arraySlice;
-                regions[idx].dstOffset.x    = renderArea.offset.x;
-                regions[idx].dstOffset.y    = renderArea.offset.y;
-                regions[idx].dstOffset.z    = 0;
-                regions[idx].extent.width   = renderArea.extent.width;
-                regions[idx].extent.height  = renderArea.extent.height;
-                regions[idx].extent.depth   = 1;
-                regions[idx].numSlices      = sliceCount;
-                regions[idx].swizzledFormat = Pal::UndefinedSwizzledFormat;
+                utils::IterateMask deviceGroup(GetRpDeviceMask());
+                do
+                {
+                    const uint32_t deviceIdx = deviceGroup.Index();
 
-                regions[idx].pQuadSamplePattern = pSampleLocations;
+                    PalCmdBuffer(deviceIdx)->CmdResolveImage(
+                        *op.pSrcImage->PalImage(deviceIdx),
+                        op.srcLayout,
+                        *op.pDstImage->PalImage(deviceIdx),
+                        op.dstLayout,
+                        op.mode,
+                        op.regionCount,
+                        op.regions,
+                        0);
+                }
+                while (deviceGroup.IterateNext());
             }
 
-            PalCmdResolveImage<false>(
-                *srcAttachment.pImage,
-                srcLayout,
-                *dstAttachment.pImage,
-                dstLayout,
-                resolveModes[aspectRegionIndex],
-                m_renderPassInstance.renderAreaCount,
-                regions,
-                GetRpDeviceMask());
+            PostBltRestoreMsaaState();
+
+            first = last;
         }
+
+        DbgBarrierPostCmd(DbgBarrierResolve);
+
+        virtStackFrame.FreeArray(pOps);
+    }
+    else
+    {
+        m_recordingResult = VK_ERROR_OUT_OF_HOST_MEMORY;
     }
 
     if (m_pSqttState != nullptr)
@@ -6284,89 +7702,678 @@ void CmdBuffer::RPBindTargets(
 
             PalCmdBuffer(deviceIdx)->CmdBindSampleRateImage(attachment.pImage->PalImage(deviceIdx));
         }
-
+
+    }
+    while (deviceGroup.IterateNext());
+}
+
+// =====================================================================================================================
+// Sets view instance mask for a subpass during a render pass instance (on devices within passed in device mask).
+void CmdBuffer::SetViewInstanceMask(
+    uint32_t deviceMask)
+{
+    const uint32_t subpassViewMask = GetRenderingViewMask();
+
+    utils::IterateMask deviceGroup(deviceMask);
+
+    do
+    {
+        const uint32_t deviceIdx = deviceGroup.Index();
+        const uint32_t deviceViewMask = uint32_t { 0x1 } << deviceIdx;
+
+        uint32_t viewMask = 0x0;
+
+        if (m_allGpuState.viewIndexFromDeviceIndex)
+        {
+            // VK_KHR_multiview interaction with VK_KHR_device_group.
+            // When GraphicsPipeline is created with flag
+            // VK_PIPELINE_CREATE_VIEW_INDEX_FROM_DEVICE_INDEX_BIT
+            // rendering to views is split across multiple devices.
+            // Essentially this flag allows application to divide work
+            // between devices when multiview rendering is enabled.
+            // Basically each device renders one view.
+
+            // Vulkan Spec: VK_PIPELINE_CREATE_VIEW_INDEX_FROM_DEVICE_INDEX_BIT
+            // specifies that any shader input variables decorated as DeviceIndex
+            // will be assigned values as if they were decorated as ViewIndex.
+            // To satisfy above requirement DeviceMask and ViewMask has to match.
+            VK_ASSERT(m_curDeviceMask == viewMask);
+
+            // Currently Vulkan CTS lacks tests covering this functionality.
+            VK_NOT_TESTED();
+
+            viewMask = deviceViewMask;
+        }
+        else
+        {
+            // In default mode work is duplicated on each device,
+            // because the same viewMask is set for all devices.
+            // Basically each device renders all views.
+            viewMask = subpassViewMask;
+        }
+
+        PalCmdBuffer(deviceIdx)->CmdSetViewInstanceMask(viewMask);
+    }
+    while (deviceGroup.IterateNext());
+}
+
+// =====================================================================================================================
+// Ends a render pass instance (vkCmdEndRenderPass)
+void CmdBuffer::EndRenderPass()
+{
+    DbgBarrierPreCmd(DbgBarrierEndRenderPass);
+
+    if (m_renderPassInstance.subpass != VK_SUBPASS_EXTERNAL)
+    {
+        // Close the previous subpass
+        RPEndSubpass();
+
+        // Get the end state for this render pass instance
+        const RPExecuteEndRenderPassInfo& end = m_allGpuState.pRenderPass->GetExecuteInfo()->end;
+
+        // Synchronize any prior work before leaving the instance (external dependencies) and also handle final layout
+        // transitions.
+        if (end.syncEnd.flags.active)
+        {
+            VirtualStackFrame virtStack(m_pStackAllocator);
+
+            RPSyncPoint(end.syncEnd,
+                        RPSyncPointIndex(m_allGpuState.pRenderPass->GetSubpassCount(), RPSyncPointTop),
+                        &virtStack);
+        }
+
+        // The contents of attachments that are not stored are undefined after the instance.  The store ops only apply
+        // to the aspects the format of the attachment has.
+        for (uint32_t a = 0; a < m_allGpuState.pRenderPass->GetAttachmentCount(); ++a)
+        {
+            const AttachmentDescription& desc = m_allGpuState.pRenderPass->GetAttachmentDesc(a);
+
+            bool discarded = false;
+
+            if (Formats::IsDepthStencilFormat(desc.format))
+            {
+                discarded = (Formats::HasDepth(desc.format) && (desc.storeOp == VK_ATTACHMENT_STORE_OP_DONT_CARE)) ||
+                            (Formats::HasStencil(desc.format) &&
+                             (desc.stencilStoreOp == VK_ATTACHMENT_STORE_OP_DONT_CARE));
+            }
+            else
+            {
+                discarded = (desc.storeOp == VK_ATTACHMENT_STORE_OP_DONT_CARE);
+            }
+
+            if (discarded)
+            {
+                RPDropAttachmentClearState(a);
+            }
+            else
+            {
+                RPUpdateAttachmentClearLayouts(a);
+            }
+        }
+    }
+
+    if (m_renderPassInstance.pProgram != nullptr)
+    {
+        m_allGpuState.pFramebuffer->ReleaseRenderPassProgram(m_pDevice, m_renderPassInstance.pProgram);
+    }
+
+    // Clean up instance state
+    m_allGpuState.pRenderPass   = nullptr;
+    m_allGpuState.pFramebuffer  = nullptr;
+    m_renderPassInstance.pExecuteInfo = nullptr;
+    m_renderPassInstance.pProgram     = nullptr;
+
+    DbgBarrierPostCmd(DbgBarrierEndRenderPass);
+}
+
+// =====================================================================================================================
+// Begins a dynamic rendering instance (vkCmdBeginRenderingKHR).  Unlike a render pass instance there is no RenderPass
+// or Framebuffer object to execute: the attachments are bound directly and their load operations are done here.
+void CmdBuffer::BeginRendering(
+    const VkRenderingInfoKHR* pRenderingInfo)
+{
+    DbgBarrierPreCmd(DbgBarrierBeginRenderPass);
+
+    InvalidateClearStates();
+
+    EXTRACT_VK_STRUCTURES_1(
+        Rendering,
+        RenderingInfoKHR,
+        DeviceGroupRenderPassBeginInfo,
+        pRenderingInfo,
+        RENDERING_INFO_KHR,
+        DEVICE_GROUP_RENDER_PASS_BEGIN_INFO)
+
+    DynamicRenderingInstanceState* pDynamicRendering = &m_allGpuState.dynamicRendering;
+
+    VK_ASSERT(pRenderingInfoKHR->colorAttachmentCount <= Pal::MaxColorTargets);
+
+    pDynamicRendering->active               = true;
+    pDynamicRendering->flags                = pRenderingInfoKHR->flags;
+    pDynamicRendering->viewMask             = pRenderingInfoKHR->viewMask;
+    pDynamicRendering->layerCount           = pRenderingInfoKHR->layerCount;
+    pDynamicRendering->colorAttachmentCount = pRenderingInfoKHR->colorAttachmentCount;
+
+    uint32_t maxSampleCount = 0;
+
+    for (uint32_t i = 0; i < pRenderingInfoKHR->colorAttachmentCount; ++i)
+    {
+        StoreDynamicRenderingAttachment(&pRenderingInfoKHR->pColorAttachments[i],
+                                        m_pDevice->GetRuntimeSettings(),
+                                        &pDynamicRendering->colorAttachments[i],
+                                        &maxSampleCount);
+    }
+
+    StoreDynamicRenderingAttachment(pRenderingInfoKHR->pDepthAttachment,
+                                    m_pDevice->GetRuntimeSettings(),
+                                    &pDynamicRendering->depthAttachment,
+                                    &maxSampleCount);
+    StoreDynamicRenderingAttachment(pRenderingInfoKHR->pStencilAttachment,
+                                    m_pDevice->GetRuntimeSettings(),
+                                    &pDynamicRendering->stencilAttachment,
+                                    &maxSampleCount);
+
+    RPSetRenderArea(pRenderingInfoKHR->renderArea, pDeviceGroupRenderPassBeginInfo);
+
+    // A resuming instance continues the rendering of a previously suspended one, so its load operations have already
+    // been performed.
+    if ((pRenderingInfoKHR->flags & VK_RENDERING_RESUMING_BIT_KHR) == 0)
+    {
+        LoadOpClearDynamicRenderingAttachments(pRenderingInfoKHR);
+    }
+
+    BindDynamicRenderingTargets();
+
+    utils::IterateMask deviceGroup(GetRpDeviceMask());
+    do
+    {
+        const uint32_t deviceIdx = deviceGroup.Index();
+
+        Pal::GlobalScissorParams scissorParams = {};
+        scissorParams.scissorRegion = m_renderPassInstance.renderArea[deviceIdx];
+
+        PalCmdBuffer(deviceIdx)->CmdSetGlobalScissor(scissorParams);
+    }
+    while (deviceGroup.IterateNext());
+
+    SetViewInstanceMask(GetRpDeviceMask());
+
+    pDynamicRendering->samplePattern = {};
+
+    if (maxSampleCount > 0)
+    {
+        // If sample patterns are set in a bound pipeline, use those as the defaults
+        const Pal::MsaaQuadSamplePattern* pipelineSampleLocations =
+            ((m_allGpuState.pGraphicsPipeline != nullptr) &&
+              m_allGpuState.pGraphicsPipeline->CustomSampleLocationsEnabled()) ?
+                m_allGpuState.pGraphicsPipeline->GetSampleLocations() : nullptr;
+
+        pDynamicRendering->samplePattern.sampleCount = maxSampleCount;
+        pDynamicRendering->samplePattern.locations   = (pipelineSampleLocations != nullptr) ?
+            *pipelineSampleLocations : *Device::GetDefaultQuadSamplePattern(maxSampleCount);
+
+        PalCmdSetMsaaQuadSamplePattern(
+            pDynamicRendering->samplePattern.sampleCount,
+            pDynamicRendering->samplePattern.locations);
+    }
+
+    DbgBarrierPostCmd(DbgBarrierBeginRenderPass);
+}
+
+// =====================================================================================================================
+// Does the load-op clears of the attachments of a dynamic rendering instance.
+void CmdBuffer::LoadOpClearDynamicRenderingAttachments(
+    const VkRenderingInfoKHR* pRenderingInfo)
+{
+    const DynamicRenderingInstanceState& dynamicRendering = m_allGpuState.dynamicRendering;
+
+    if (m_pSqttState != nullptr)
+    {
+        m_pSqttState->BeginRenderPassColorClear();
+    }
+
+    for (uint32_t i = 0; i < dynamicRendering.colorAttachmentCount; ++i)
+    {
+        const DynamicRenderingAttachment&   color     = dynamicRendering.colorAttachments[i];
+        const VkRenderingAttachmentInfoKHR& colorInfo = pRenderingInfo->pColorAttachments[i];
+
+        if ((color.pImageView != nullptr) && (colorInfo.loadOp == VK_ATTACHMENT_LOAD_OP_CLEAR))
+        {
+            Framebuffer::Attachment attachment = color.pImageView->GetFramebufferAttachment();
+
+            ClampDynamicRenderingLayers(dynamicRendering, &attachment);
+
+            const Pal::ClearColor clearColor = VkToPalClearColor(&colorInfo.clearValue.color, attachment.viewFormat);
+
+            const Pal::ImageLayout clearLayout =
+                attachment.pImage->GetAttachmentLayout({ color.imageLayout, 0 }, 0, this);
+
+            const auto clearSubresRanges = LoadOpClearSubresRanges(
+                attachment, VK_IMAGE_ASPECT_COLOR_BIT,
+                dynamicRendering.viewMask);
+
+            utils::IterateMask deviceGroup(GetRpDeviceMask());
+
+            do
+            {
+                const uint32_t deviceIdx = deviceGroup.Index();
+
+                const Pal::Box clearBox = BuildClearBox(m_renderPassInstance.renderArea[deviceIdx], attachment);
+
+                PalCmdBuffer(deviceIdx)->CmdClearColorImage(
+                    *attachment.pImage->PalImage(deviceIdx),
+                    clearLayout,
+                    clearColor,
+                    clearSubresRanges.NumElements(),
+                    clearSubresRanges.Data(),
+                    1,
+                    &clearBox,
+                    Pal::ColorClearAutoSync);
+            }
+            while (deviceGroup.IterateNext());
+        }
+    }
+
+    if (m_pSqttState != nullptr)
+    {
+        m_pSqttState->EndRenderPassColorClear();
+        m_pSqttState->BeginRenderPassDepthStencilClear();
+    }
+
+    const DynamicRenderingAttachment& depth   = dynamicRendering.depthAttachment;
+    const DynamicRenderingAttachment& stencil = dynamicRendering.stencilAttachment;
+
+    VkImageAspectFlags clearAspects = 0;
+
+    if ((depth.pImageView != nullptr) && (pRenderingInfo->pDepthAttachment->loadOp == VK_ATTACHMENT_LOAD_OP_CLEAR))
+    {
+        clearAspects |= VK_IMAGE_ASPECT_DEPTH_BIT;
+    }
+
+    if ((stencil.pImageView != nullptr) && (pRenderingInfo->pStencilAttachment->loadOp == VK_ATTACHMENT_LOAD_OP_CLEAR))
+    {
+        clearAspects |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+
+    if (clearAspects != 0)
+    {
+        // The depth and stencil attachments must use the same image view if both are present
+        const DynamicRenderingAttachment& depthStencil = (depth.pImageView != nullptr) ? depth : stencil;
+
+        Framebuffer::Attachment attachment = depthStencil.pImageView->GetFramebufferAttachment();
+
+        ClampDynamicRenderingLayers(dynamicRendering, &attachment);
+
+        const Pal::ImageLayout depthLayout = attachment.pImage->GetAttachmentLayout(
+            { (depth.pImageView != nullptr) ? depth.imageLayout : stencil.imageLayout, 0 }, 0, this);
+        const Pal::ImageLayout stencilLayout = attachment.pImage->GetAttachmentLayout(
+            { (stencil.pImageView != nullptr) ? stencil.imageLayout : depth.imageLayout, 0 }, 1, this);
+
+        const float clearDepth = ((clearAspects & VK_IMAGE_ASPECT_DEPTH_BIT) != 0) ?
+            VkToPalClearDepth(pRenderingInfo->pDepthAttachment->clearValue.depthStencil.depth) : 0.0f;
+        const Pal::uint8 clearStencil = ((clearAspects & VK_IMAGE_ASPECT_STENCIL_BIT) != 0) ?
+            pRenderingInfo->pStencilAttachment->clearValue.depthStencil.stencil : 0;
+
+        const auto clearSubresRanges = LoadOpClearSubresRanges(
+            attachment, clearAspects,
+            dynamicRendering.viewMask);
+
+        utils::IterateMask deviceGroup(GetRpDeviceMask());
+
+        do
+        {
+            const uint32_t deviceIdx = deviceGroup.Index();
+
+            PalCmdBuffer(deviceIdx)->CmdClearDepthStencil(
+                *attachment.pImage->PalImage(deviceIdx),
+                depthLayout,
+                stencilLayout,
+                clearDepth,
+                clearStencil,
+                StencilWriteMaskFull,
+                clearSubresRanges.NumElements(),
+                clearSubresRanges.Data(),
+                1,
+                &m_renderPassInstance.renderArea[deviceIdx],
+                Pal::DsClearAutoSync);
+        }
+        while (deviceGroup.IterateNext());
+    }
+
+    if (m_pSqttState != nullptr)
+    {
+        m_pSqttState->EndRenderPassDepthStencilClear();
+    }
+}
+
+// =====================================================================================================================
+// Binds the color/depth targets of a dynamic rendering instance.
+void CmdBuffer::BindDynamicRenderingTargets()
+{
+    const DynamicRenderingInstanceState& dynamicRendering = m_allGpuState.dynamicRendering;
+
+    const DynamicRenderingAttachment& depth   = dynamicRendering.depthAttachment;
+    const DynamicRenderingAttachment& stencil = dynamicRendering.stencilAttachment;
+
+    const ImageView* pDepthStencilView = (depth.pImageView != nullptr) ? depth.pImageView : stencil.pImageView;
+
+    Pal::BindTargetParams params = {};
+
+    params.colorTargetCount = dynamicRendering.colorAttachmentCount;
+
+    static constexpr Pal::ImageLayout NullLayout = {};
+
+    utils::IterateMask deviceGroup(GetRpDeviceMask());
+    do
+    {
+        const uint32_t deviceIdx = deviceGroup.Index();
+
+        for (uint32_t i = 0; i < dynamicRendering.colorAttachmentCount; ++i)
+        {
+            const DynamicRenderingAttachment& color = dynamicRendering.colorAttachments[i];
+
+            if (color.pImageView != nullptr)
+            {
+                params.colorTargets[i].pColorTargetView = color.pImageView->PalColorTargetView(deviceIdx);
+                params.colorTargets[i].imageLayout      =
+                    color.pImageView->GetImage()->GetAttachmentLayout({ color.imageLayout, 0 }, 0, this);
+            }
+            else
+            {
+                params.colorTargets[i].pColorTargetView = nullptr;
+                params.colorTargets[i].imageLayout      = NullLayout;
+            }
+        }
+
+        if (pDepthStencilView != nullptr)
+        {
+            const Image* pImage = pDepthStencilView->GetImage();
+
+            const VkImageLayout depthLayout   = (depth.pImageView != nullptr) ? depth.imageLayout : stencil.imageLayout;
+            const VkImageLayout stencilLayout = (stencil.pImageView != nullptr) ? stencil.imageLayout : depth.imageLayout;
+
+            params.depthTarget.pDepthStencilView = pDepthStencilView->PalDepthStencilView(deviceIdx);
+            params.depthTarget.depthLayout       = pImage->GetAttachmentLayout({ depthLayout, 0 }, 0, this);
+            params.depthTarget.stencilLayout     = pImage->GetAttachmentLayout({ stencilLayout, 0 }, 1, this);
+        }
+        else
+        {
+            params.depthTarget.pDepthStencilView = nullptr;
+            params.depthTarget.depthLayout       = NullLayout;
+            params.depthTarget.stencilLayout     = NullLayout;
+        }
+
+        PalCmdBuffer(deviceIdx)->CmdBindTargets(params);
+    }
+    while (deviceGroup.IterateNext());
+}
+
+// =====================================================================================================================
+// Resolves the multisampled attachments of a dynamic rendering instance into their resolve attachments.  All attachments
+// are made resolve-compatible with a single barrier before the resolves and returned to their rendering layouts with a
+// single barrier afterwards.
+void CmdBuffer::ResolveDynamicRenderingAttachments()
+{
+    const DynamicRenderingInstanceState& dynamicRendering = m_allGpuState.dynamicRendering;
+
+    DynamicRenderingResolveInfo resolves[Pal::MaxColorTargets + 1];
+    uint32_t                    resolveCount = 0;
+
+    for (uint32_t i = 0; i < dynamicRendering.colorAttachmentCount; ++i)
+    {
+        const DynamicRenderingAttachment& color = dynamicRendering.colorAttachments[i];
+
+        if (color.resolveMode != VK_RESOLVE_MODE_NONE)
+        {
+            DynamicRenderingResolveInfo* pResolve = &resolves[resolveCount++];
+
+            pResolve->src = color.pImageView->GetFramebufferAttachment();
+            pResolve->dst = color.pResolveImageView->GetFramebufferAttachment();
+
+            ClampDynamicRenderingLayers(dynamicRendering, &pResolve->src);
+            ClampDynamicRenderingLayers(dynamicRendering, &pResolve->dst);
+
+            pResolve->srcLayout[0]   = color.imageLayout;
+            pResolve->dstLayout[0]   = color.resolveImageLayout;
+            pResolve->planeCount     = 1;
+            pResolve->planes[0]      = 0;
+            pResolve->resolveMode[0] = VkToPalResolveMode(color.resolveMode);
+        }
+    }
+
+    const DynamicRenderingAttachment& depth   = dynamicRendering.depthAttachment;
+    const DynamicRenderingAttachment& stencil = dynamicRendering.stencilAttachment;
+
+    if ((depth.resolveMode != VK_RESOLVE_MODE_NONE) || (stencil.resolveMode != VK_RESOLVE_MODE_NONE))
+    {
+        // The depth and stencil attachments (and their resolve attachments) must use the same image views if both are
+        // present
+        const DynamicRenderingAttachment& depthStencil = (depth.resolveMode != VK_RESOLVE_MODE_NONE) ? depth : stencil;
+        const VkFormat                    format       = depthStencil.attachmentFormat;
+
+        DynamicRenderingResolveInfo* pResolve = &resolves[resolveCount++];
+
+        pResolve->src = depthStencil.pImageView->GetFramebufferAttachment();
+        pResolve->dst = depthStencil.pResolveImageView->GetFramebufferAttachment();
+
+        ClampDynamicRenderingLayers(dynamicRendering, &pResolve->src);
+        ClampDynamicRenderingLayers(dynamicRendering, &pResolve->dst);
+
+        pResolve->planeCount = 0;
+
+        if (Formats::HasDepth(format))
+        {
+            pResolve->srcLayout[0] = (depth.pImageView != nullptr) ? depth.imageLayout : stencil.imageLayout;
+            pResolve->dstLayout[0] = (depth.pImageView != nullptr) ? depth.resolveImageLayout : stencil.resolveImageLayout;
+
+            if (depth.resolveMode != VK_RESOLVE_MODE_NONE)
+            {
+                pResolve->resolveMode[pResolve->planeCount] = VkToPalResolveMode(depth.resolveMode);
+                pResolve->planes[pResolve->planeCount++]    = 0;
+            }
+        }
+
+        if (Formats::HasStencil(format))
+        {
+            const uint32_t stencilPlane = Formats::HasDepth(format) ? 1 : 0;
+
+            pResolve->srcLayout[stencilPlane] =
+                (stencil.pImageView != nullptr) ? stencil.imageLayout : depth.imageLayout;
+            pResolve->dstLayout[stencilPlane] =
+                (stencil.pImageView != nullptr) ? stencil.resolveImageLayout : depth.resolveImageLayout;
+
+            if (stencil.resolveMode != VK_RESOLVE_MODE_NONE)
+            {
+                pResolve->resolveMode[pResolve->planeCount] = VkToPalResolveMode(stencil.resolveMode);
+                pResolve->planes[pResolve->planeCount++]    = stencilPlane;
+            }
+        }
+    }
+
+    if (resolveCount > 0)
+    {
+        if (m_pSqttState != nullptr)
+        {
+            m_pSqttState->BeginRenderPassResolve();
+        }
+
+        DynamicRenderingResolveBarrier(resolveCount, resolves, true);
+
+        for (uint32_t i = 0; i < resolveCount; ++i)
+        {
+            const DynamicRenderingResolveInfo& resolve = resolves[i];
+
+            // With multiview only the layers of the active views are resolved, and otherwise all layers of the instance
+            const auto     layerRanges     = RangesOfOnesInBitMask(dynamicRendering.viewMask);
+            const uint32_t layerRangeCount = (dynamicRendering.viewMask != 0) ? layerRanges.NumElements() : 1;
+            const uint32_t sliceCount      = Util::Min(
+                resolve.src.subresRange[0].numSlices,
+                resolve.dst.subresRange[0].numSlices);
+
+            for (uint32_t p = 0; p < resolve.planeCount; ++p)
+            {
+                const uint32_t plane = resolve.planes[p];
+
+                // During split-frame-rendering, the image to resolve could be split across multiple devices.
+                Pal::ImageResolveRegion regions[MaxPalDevices * Pal::MaxViewInstanceCount];
+                uint32_t                regionCount = 0;
+
+                for (uint32_t r = 0; r < layerRangeCount; ++r)
+                {
+                    const Pal::Range layerRange = (dynamicRendering.viewMask != 0) ?
+                        layerRanges.At(r) : Pal::Range { 0, sliceCount };
+
+                    for (uint32_t idx = 0; idx < m_renderPassInstance.renderAreaCount; idx++)
+                    {
+                        const Pal::Rect&         renderArea = m_renderPassInstance.renderArea[idx];
+                        Pal::ImageResolveRegion* pRegion    = &regions[regionCount++];
+
+                        pRegion->srcPlane       = plane;
+                        pRegion->srcSlice       = resolve.src.subresRange[0].startSubres.arraySlice + layerRange.offset;
+                        pRegion->srcOffset.x    = renderArea.offset.x;
+                        pRegion->srcOffset.y    = renderArea.offset.y;
+                        pRegion->srcOffset.z    = 0;
+                        pRegion->dstPlane       = plane;
+                        pRegion->dstMipLevel    = resolve.dst.subresRange[0].startSubres.mipLevel;
+                        pRegion->dstSlice       = resolve.dst.subresRange[0].startSubres.arraySlice + layerRange.offset;
+                        pRegion->dstOffset.x    = renderArea.offset.x;
+                        pRegion->dstOffset.y    = renderArea.offset.y;
+                        pRegion->dstOffset.z    = 0;
+                        pRegion->extent.width   = renderArea.extent.width;
+                        pRegion->extent.height  = renderArea.extent.height;
+                        pRegion->extent.depth   = 1;
+                        pRegion->numSlices      = layerRange.extent;
+                        pRegion->swizzledFormat = Pal::UndefinedSwizzledFormat;
+
+                        // Must be specified for depth because the source image was created with sampleLocsAlwaysKnown
+                        pRegion->pQuadSamplePattern = resolve.src.pImage->HasDepth() ?
+                            &dynamicRendering.samplePattern.locations : nullptr;
+                    }
+                }
+
+                PalCmdResolveImage<false>(
+                    *resolve.src.pImage,
+                    resolve.src.pImage->GetAttachmentLayout(
+                        { resolve.srcLayout[plane], Pal::LayoutResolveSrc }, plane, this),
+                    *resolve.dst.pImage,
+                    resolve.dst.pImage->GetAttachmentLayout(
+                        { resolve.dstLayout[plane], Pal::LayoutResolveDst }, plane, this),
+                    resolve.resolveMode[p],
+                    regionCount,
+                    regions,
+                    GetRpDeviceMask());
+            }
+        }
+
+        DynamicRenderingResolveBarrier(resolveCount, resolves, false);
+
+        if (m_pSqttState != nullptr)
+        {
+            m_pSqttState->EndRenderPassResolve();
+        }
     }
-    while (deviceGroup.IterateNext());
 }
 
 // =====================================================================================================================
-// Sets view instance mask for a subpass during a render pass instance (on devices within passed in device mask).
-void CmdBuffer::SetViewInstanceMask(
-    uint32_t deviceMask)
+// Synchronizes rendering with the resolves of a dynamic rendering instance (preResolve) or the resolves with any later
+// work (!preResolve), moving the attachments between their rendering and resolve-compatible layouts.
+void CmdBuffer::DynamicRenderingResolveBarrier(
+    uint32_t                           resolveCount,
+    const DynamicRenderingResolveInfo* pResolves,
+    bool                               preResolve)
 {
-    const uint32_t subpassViewMask = m_allGpuState.pRenderPass->GetViewMask(m_renderPassInstance.subpass);
+    static constexpr uint32_t MaxTransitionCount = (Pal::MaxColorTargets + 1) * 2 * MaxRangePerAttachment;
 
-    utils::IterateMask deviceGroup(deviceMask);
+    Pal::BarrierTransition transitions[MaxTransitionCount];
+    const Image*           images[MaxTransitionCount];
 
-    do
+    Pal::BarrierInfo barrier = {};
+
+    barrier.reason             = RgpBarrierExternalRenderPassSync;
+    barrier.pipePointWaitCount = 1;
+
+    if (preResolve)
     {
-        const uint32_t deviceIdx = deviceGroup.Index();
-        const uint32_t deviceViewMask = uint32_t { 0x1 } << deviceIdx;
+        static const Pal::HwPipePoint PreResolvePipePoint = Pal::HwPipeBottom;
 
-        uint32_t viewMask = 0x0;
+        barrier.waitPoint          = Pal::HwPipePreBlt;
+        barrier.pPipePoints        = &PreResolvePipePoint;
+        barrier.globalSrcCacheMask = Pal::CoherColorTarget | Pal::CoherDepthStencilTarget;
+        barrier.globalDstCacheMask = Pal::CoherResolve;
+    }
+    else
+    {
+        static const Pal::HwPipePoint PostResolvePipePoint = Pal::HwPipePostBlt;
 
-        if (m_allGpuState.viewIndexFromDeviceIndex)
+        barrier.waitPoint          = Pal::HwPipeTop;
+        barrier.pPipePoints        = &PostResolvePipePoint;
+        barrier.globalSrcCacheMask = Pal::CoherResolve;
+        barrier.globalDstCacheMask = Pal::CoherColorTarget | Pal::CoherDepthStencilTarget;
+    }
+
+    for (uint32_t i = 0; i < resolveCount; ++i)
+    {
+        for (uint32_t isDst = 0; isDst < 2; ++isDst)
         {
-            // VK_KHR_multiview interaction with VK_KHR_device_group.
-            // When GraphicsPipeline is created with flag
-            // VK_PIPELINE_CREATE_VIEW_INDEX_FROM_DEVICE_INDEX_BIT
-            // rendering to views is split across multiple devices.
-            // Essentially this flag allows application to divide work
-            // between devices when multiview rendering is enabled.
-            // Basically each device renders one view.
+            const Framebuffer::Attachment& attachment = (isDst != 0) ? pResolves[i].dst : pResolves[i].src;
+            const VkImageLayout*           pLayouts   = (isDst != 0) ? pResolves[i].dstLayout : pResolves[i].srcLayout;
+            const uint32_t                 usage      = (isDst != 0) ? Pal::LayoutResolveDst : Pal::LayoutResolveSrc;
 
-            // Vulkan Spec: VK_PIPELINE_CREATE_VIEW_INDEX_FROM_DEVICE_INDEX_BIT
-            // specifies that any shader input variables decorated as DeviceIndex
-            // will be assigned values as if they were decorated as ViewIndex.
-            // To satisfy above requirement DeviceMask and ViewMask has to match.
-            VK_ASSERT(m_curDeviceMask == viewMask);
+            for (uint32_t sr = 0; sr < attachment.subresRangeCount; ++sr)
+            {
+                const uint32_t plane = attachment.subresRange[sr].startSubres.plane;
 
-            // Currently Vulkan CTS lacks tests covering this functionality.
-            VK_NOT_TESTED();
+                const Pal::ImageLayout renderLayout  =
+                    attachment.pImage->GetAttachmentLayout({ pLayouts[plane], 0 }, plane, this);
+                const Pal::ImageLayout resolveLayout =
+                    attachment.pImage->GetAttachmentLayout({ pLayouts[plane], usage }, plane, this);
 
-            viewMask = deviceViewMask;
-        }
-        else
-        {
-            // In default mode work is duplicated on each device,
-            // because the same viewMask is set for all devices.
-            // Basically each device renders all views.
-            viewMask = subpassViewMask;
-        }
+                if ((renderLayout.usages  != resolveLayout.usages) ||
+                    (renderLayout.engines != resolveLayout.engines))
+                {
+                    VK_ASSERT(barrier.transitionCount < MaxTransitionCount);
 
-        PalCmdBuffer(deviceIdx)->CmdSetViewInstanceMask(viewMask);
+                    images[barrier.transitionCount] = attachment.pImage;
+
+                    Pal::BarrierTransition* pTransition = &transitions[barrier.transitionCount++];
+
+                    *pTransition = {};
+
+                    pTransition->imageInfo.pImage      = attachment.pImage->PalImage(DefaultDeviceIndex);
+                    pTransition->imageInfo.oldLayout   = preResolve ? renderLayout : resolveLayout;
+                    pTransition->imageInfo.newLayout   = preResolve ? resolveLayout : renderLayout;
+                    pTransition->imageInfo.subresRange = attachment.subresRange[sr];
+
+                    if (attachment.pImage->GetImageSamples() > 1)
+                    {
+                        pTransition->imageInfo.pQuadSamplePattern = &m_allGpuState.dynamicRendering.samplePattern.locations;
+                    }
+                }
+            }
+        }
     }
-    while (deviceGroup.IterateNext());
+
+    barrier.pTransitions = transitions;
+
+    PalCmdBarrier(&barrier, transitions, images, GetRpDeviceMask());
 }
 
 // =====================================================================================================================
-// Ends a render pass instance (vkCmdEndRenderPass)
-void CmdBuffer::EndRenderPass()
+// Ends a dynamic rendering instance (vkCmdEndRenderingKHR)
+void CmdBuffer::EndRendering()
 {
     DbgBarrierPreCmd(DbgBarrierEndRenderPass);
 
-    if (m_renderPassInstance.subpass != VK_SUBPASS_EXTERNAL)
-    {
-        // Close the previous subpass
-        RPEndSubpass();
-
-        // Get the end state for this render pass instance
-        const RPExecuteEndRenderPassInfo& end = m_allGpuState.pRenderPass->GetExecuteInfo()->end;
-
-        // Synchronize any prior work before leaving the instance (external dependencies) and also handle final layout
-        // transitions.
-        if (end.syncEnd.flags.active)
-        {
-            VirtualStackFrame virtStack(m_pStackAllocator);
+    InvalidateClearStates();
 
-            RPSyncPoint(end.syncEnd, &virtStack);
-        }
+    // A suspended instance is continued by a later resuming instance, which is the one that performs the resolves.
+    if ((m_allGpuState.dynamicRendering.flags & VK_RENDERING_SUSPENDING_BIT_KHR) == 0)
+    {
+        ResolveDynamicRenderingAttachments();
     }
 
     // Clean up instance state
-    m_allGpuState.pRenderPass   = nullptr;
-    m_allGpuState.pFramebuffer  = nullptr;
-    m_renderPassInstance.pExecuteInfo = nullptr;
+    m_allGpuState.dynamicRendering.active = false;
 
     DbgBarrierPostCmd(DbgBarrierEndRenderPass);
 }
@@ -6808,19 +8815,175 @@ void CmdBuffer::WriteBufferMarker(
     const Buffer* pDestBuffer        = Buffer::ObjectFromHandle(dstBuffer);
     const Pal::HwPipePoint pipePoint = VkToPalSrcPipePointForMarkers(pipelineStage, m_palEngineType);
 
+    Pal::gpusize dstAddr[MaxPalDevices] = {};
+
     utils::IterateMask deviceGroup(m_curDeviceMask);
 
     do
     {
         const uint32_t deviceIdx = deviceGroup.Index();
 
+        dstAddr[deviceIdx] = pDestBuffer->GpuVirtAddr(deviceIdx) + dstOffset;
+
         PalCmdBuffer(deviceIdx)->CmdWriteImmediate(
             pipePoint,
             marker,
             Pal::ImmediateDataWidth::ImmediateData32Bit,
-            pDestBuffer->GpuVirtAddr(deviceIdx) + dstOffset);
+            dstAddr[deviceIdx]);
     }
     while (deviceGroup.IterateNext());
+
+    if (m_pBreadcrumbs != nullptr)
+    {
+        RecordBreadcrumb(pipePoint, marker, dstAddr);
+    }
+}
+
+// =====================================================================================================================
+// Allocates this command buffer's breadcrumb ring and registers it with the device.  The ring is kept until the command
+// buffer is destroyed.
+VkResult CmdBuffer::InitBreadcrumbRing()
+{
+    VK_ASSERT(m_pBreadcrumbs == nullptr);
+
+    const uint32_t entryCount = m_pDevice->GetRuntimeSettings().breadcrumbRingEntries;
+
+    void* pMemory = m_pDevice->VkInstance()->AllocMem(
+        sizeof(BreadcrumbRing) + (entryCount * sizeof(Breadcrumb)),
+        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+    VkResult result = (pMemory != nullptr) ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+
+    if (result == VK_SUCCESS)
+    {
+        BreadcrumbRing* pRing = VK_PLACEMENT_NEW(pMemory) BreadcrumbRing();
+
+        pRing->entryCount = entryCount;
+        pRing->pEntries   = static_cast<Breadcrumb*>(Util::VoidPtrInc(pMemory, sizeof(BreadcrumbRing)));
+
+        m_pBreadcrumbs = pRing;
+
+        m_pDevice->RegisterBreadcrumbs(this);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Starts a new recording of the breadcrumb ring.
+void CmdBuffer::ResetBreadcrumbRing()
+{
+    m_pBreadcrumbs->markerCount  = 0;
+    m_pBreadcrumbs->submitId     = 0;
+    m_pBreadcrumbs->pSubmitQueue = nullptr;
+}
+
+// =====================================================================================================================
+// Records a marker in the breadcrumb ring.  Only the CPU copy is kept; the application's write is what the GPU leaves
+// behind.
+void CmdBuffer::RecordBreadcrumb(
+    Pal::HwPipePoint    pipePoint,
+    uint32_t            marker,
+    const Pal::gpusize* pDstAddr)
+{
+    BreadcrumbRing* pRing  = m_pBreadcrumbs;
+    Breadcrumb*     pEntry = &pRing->pEntries[pRing->markerCount % pRing->entryCount];
+
+    pEntry->marker    = marker;
+    pEntry->pipePoint = pipePoint;
+
+    memcpy(pEntry->dstAddr, pDstAddr, sizeof(pEntry->dstAddr));
+
+    pRing->markerCount++;
+}
+
+// =====================================================================================================================
+// Remembers the submission this command buffer was last part of, so that reports can be matched to submissions.  Only
+// the submission bookkeeping on the CPU is touched, which is why this may be called on a const command buffer.
+void CmdBuffer::MarkBreadcrumbSubmit(
+    const Queue* pQueue,
+    uint64_t     submitId) const
+{
+    if (m_pBreadcrumbs != nullptr)
+    {
+        m_pBreadcrumbs->submitId     = submitId;
+        m_pBreadcrumbs->pSubmitQueue = pQueue;
+    }
+}
+
+// =====================================================================================================================
+// Writes the breadcrumbs still held in the ring to the file.  Each marker's destination is read back through the
+// device's GPU address map, which BreadcrumbRingEntries always enables, so a marker counts as reached when its
+// destination still holds its value.  With incompleteOnly, command buffers whose last marker was found on every device
+// are skipped.
+void CmdBuffer::ReportBreadcrumbs(
+    Util::File* pFile,
+    bool        incompleteOnly) const
+{
+    const BreadcrumbRing* pRing       = m_pBreadcrumbs;
+    GpuAddressMap*        pAddressMap = m_pDevice->GetGpuAddressMap();
+
+    const uint32_t retained = Util::Min(pRing->markerCount, pRing->entryCount);
+
+    if (retained > 0)
+    {
+        utils::IterateMask deviceGroup(m_cbBeginDeviceMask);
+
+        do
+        {
+            const uint32_t    deviceIdx = deviceGroup.Index();
+            const Breadcrumb& last      = pRing->pEntries[(pRing->markerCount - 1) % pRing->entryCount];
+
+            uint32_t value = 0;
+
+            const bool lastReached = (pAddressMap != nullptr) &&
+                                     pAddressMap->ReadDword(deviceIdx, last.dstAddr[deviceIdx], &value) &&
+                                     (value == last.marker);
+
+            if ((incompleteOnly == false) || (lastReached == false))
+            {
+                pFile->Printf("CmdBuffer %p device %u: submission %llu on queue %p, %u markers, last %u kept\n",
+                              this,
+                              deviceIdx,
+                              static_cast<unsigned long long>(pRing->submitId),
+                              pRing->pSubmitQueue,
+                              pRing->markerCount,
+                              retained);
+
+                for (uint32_t i = pRing->markerCount - retained; i < pRing->markerCount; ++i)
+                {
+                    const Breadcrumb&  entry   = pRing->pEntries[i % pRing->entryCount];
+                    const Pal::gpusize dstAddr = entry.dstAddr[deviceIdx];
+
+                    pFile->Printf("    marker %u: 0x%08x at pipe point %u to 0x%llx",
+                                  i,
+                                  entry.marker,
+                                  static_cast<uint32_t>(entry.pipePoint),
+                                  static_cast<unsigned long long>(dstAddr));
+
+                    GpuAddressMap::Range owner = {};
+
+                    if ((pAddressMap != nullptr) && pAddressMap->Find(deviceIdx, dstAddr, &owner))
+                    {
+                        pFile->Printf(" (%s %p + 0x%llx)",
+                                      (owner.type == GpuAddressMap::ObjectType::Buffer) ? "buffer" : "memory",
+                                      owner.pObject,
+                                      static_cast<unsigned long long>(dstAddr - owner.gpuVirtAddr));
+                    }
+
+                    if ((pAddressMap != nullptr) && pAddressMap->ReadDword(deviceIdx, dstAddr, &value))
+                    {
+                        pFile->Printf(", holds 0x%08x (%s)\n", value, (value == entry.marker) ? "reached" : "pending");
+                    }
+                    else
+                    {
+                        pFile->Printf(", not readable\n");
+                    }
+                }
+            }
+        }
+        while (deviceGroup.IterateNext());
+    }
 }
 
 // =====================================================================================================================
@@ -7008,6 +9171,7 @@ void CmdBuffer::DrawIndirectByteCount(
     Buffer* pCounterBuffer = Buffer::ObjectFromHandle(counterBuffer);
 
     ValidateStates();
+    InvalidateClearStates();
 
     utils::IterateMask deviceGroup(m_curDeviceMask);
     do
@@ -7171,7 +9335,20 @@ void CmdBuffer::ValidateStates()
             {
                 DbgBarrierPreCmd(DbgBarrierSetDynamicPipelineState);
 
-                PalCmdBuffer(deviceIdx)->CmdSetScissorRects(PerGpuState(deviceIdx)->scissor);
+                if (m_allGpuState.rasterizerDiscardEnable)
+                {
+                    // Empty scissor rects reject every fragment, which matches rasterizer discard for a pipeline
+                    // that was built with rasterization enabled.
+                    Pal::ScissorRectParams discardScissor = {};
+
+                    discardScissor.count = Util::Max(PerGpuState(deviceIdx)->scissor.count, 1u);
+
+                    PalCmdBuffer(deviceIdx)->CmdSetScissorRects(discardScissor);
+                }
+                else
+                {
+                    PalCmdBuffer(deviceIdx)->CmdSetScissorRects(PerGpuState(deviceIdx)->scissor);
+                }
 
                 DbgBarrierPostCmd(DbgBarrierSetDynamicPipelineState);
             }
@@ -7476,11 +9653,52 @@ void CmdBuffer::SetColorWriteEnableEXT(
     }
 }
 
+// =====================================================================================================================
+void CmdBuffer::SetRasterizerDiscardEnableEXT(
+    VkBool32 rasterizerDiscardEnable)
+{
+    if (m_allGpuState.rasterizerDiscardEnable != static_cast<bool>(rasterizerDiscardEnable))
+    {
+        m_allGpuState.rasterizerDiscardEnable = rasterizerDiscardEnable;
+        m_allGpuState.dirty.scissor           = 1;
+    }
+}
+
+// =====================================================================================================================
+void CmdBuffer::SetDepthBiasEnableEXT(
+    VkBool32 depthBiasEnable)
+{
+    const uint32_t palDepthBiasEnable = (depthBiasEnable != VK_FALSE) ? 1 : 0;
+
+    if (m_allGpuState.triangleRasterState.flags.depthBiasEnable != palDepthBiasEnable)
+    {
+        m_allGpuState.triangleRasterState.flags.depthBiasEnable = palDepthBiasEnable;
+        m_allGpuState.dirty.rasterState                         = 1;
+    }
+
+    m_allGpuState.staticTokens.triangleRasterState = DynamicRenderStateToken;
+}
+
+// =====================================================================================================================
+void CmdBuffer::SetPrimitiveRestartEnableEXT(
+    VkBool32 primitiveRestartEnable)
+{
+    if (m_allGpuState.inputAssemblyState.primitiveRestartEnable != static_cast<bool>(primitiveRestartEnable))
+    {
+        m_allGpuState.inputAssemblyState.primitiveRestartEnable = primitiveRestartEnable;
+        m_allGpuState.inputAssemblyState.primitiveRestartIndex  = primitiveRestartEnable ? 0xFFFFFFFF : 0;
+        m_allGpuState.dirty.inputAssembly                       = 1;
+    }
+
+    m_allGpuState.staticTokens.inputAssemblyState = DynamicRenderStateToken;
+}
+
 // =====================================================================================================================
 RenderPassInstanceState::RenderPassInstanceState(
     PalAllocator* pAllocator)
     :
     pExecuteInfo(nullptr),
+    pProgram(nullptr),
     subpass(VK_SUBPASS_EXTERNAL),
     renderAreaCount(0),
     maxAttachmentCount(0),
@@ -7610,6 +9828,42 @@ VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndexed(
         instanceCount);
 }
 
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawMultiEXT(
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    drawCount,
+    const VkMultiDrawInfoEXT*                   pVertexInfo,
+    uint32_t                                    instanceCount,
+    uint32_t                                    firstInstance,
+    uint32_t                                    stride)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->DrawMulti(
+        drawCount,
+        pVertexInfo,
+        instanceCount,
+        firstInstance,
+        stride);
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawMultiIndexedEXT(
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    drawCount,
+    const VkMultiDrawIndexedInfoEXT*            pIndexInfo,
+    uint32_t                                    instanceCount,
+    uint32_t                                    firstInstance,
+    uint32_t                                    stride,
+    const int32_t*                              pVertexOffset)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->DrawMultiIndexed(
+        drawCount,
+        pIndexInfo,
+        instanceCount,
+        firstInstance,
+        stride,
+        pVertexOffset);
+}
+
 // =====================================================================================================================
 VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndirect(
     VkCommandBuffer                             cmdBuffer,
@@ -8051,6 +10305,39 @@ VKAPI_ATTR void VKAPI_CALL vkCmdPushConstants(
         pValues);
 }
 
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdPushDescriptorSetKHR(
+    VkCommandBuffer                             commandBuffer,
+    VkPipelineBindPoint                         pipelineBindPoint,
+    VkPipelineLayout                            layout,
+    uint32_t                                    set,
+    uint32_t                                    descriptorWriteCount,
+    const VkWriteDescriptorSet*                 pDescriptorWrites)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->VkDevice()->GetEntryPoints().vkCmdPushDescriptorSetKHR(
+        commandBuffer,
+        pipelineBindPoint,
+        layout,
+        set,
+        descriptorWriteCount,
+        pDescriptorWrites);
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdPushDescriptorSetWithTemplateKHR(
+    VkCommandBuffer                             commandBuffer,
+    VkDescriptorUpdateTemplate                  descriptorUpdateTemplate,
+    VkPipelineLayout                            layout,
+    uint32_t                                    set,
+    const void*                                 pData)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->PushDescriptorSetWithTemplateKHR(
+        descriptorUpdateTemplate,
+        layout,
+        set,
+        pData);
+}
+
 // =====================================================================================================================
 VKAPI_ATTR void VKAPI_CALL vkCmdBeginRenderPass(
     VkCommandBuffer                             commandBuffer,
@@ -8101,6 +10388,21 @@ VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderPass2(
     ApiCmdBuffer::ObjectFromHandle(commandBuffer)->EndRenderPass();
 }
 
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdBeginRenderingKHR(
+    VkCommandBuffer                             commandBuffer,
+    const VkRenderingInfoKHR*                   pRenderingInfo)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->BeginRendering(pRenderingInfo);
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderingKHR(
+    VkCommandBuffer                             commandBuffer)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->EndRendering();
+}
+
 // =====================================================================================================================
 VKAPI_ATTR void VKAPI_CALL vkCmdExecuteCommands(
     VkCommandBuffer                             cmdBuffer,
@@ -8598,6 +10900,52 @@ VKAPI_ATTR void VKAPI_CALL vkCmdSetColorWriteEnableEXT(
     ApiCmdBuffer::ObjectFromHandle(commandBuffer)->SetColorWriteEnableEXT(attachmentCount, pColorWriteEnables);
 }
 
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdSetPatchControlPointsEXT(
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    patchControlPoints)
+{
+    // The extension requires this command to be exported, but calling it is only valid with the
+    // extendedDynamicState2PatchControlPoints feature, which is not reported: LLPC compiles the control point count
+    // into the hull shader, so VK_DYNAMIC_STATE_PATCH_CONTROL_POINTS_EXT is never accepted by a pipeline.
+    VK_NEVER_CALLED();
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdSetRasterizerDiscardEnableEXT(
+    VkCommandBuffer                             commandBuffer,
+    VkBool32                                    rasterizerDiscardEnable)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->SetRasterizerDiscardEnableEXT(rasterizerDiscardEnable);
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdSetDepthBiasEnableEXT(
+    VkCommandBuffer                             commandBuffer,
+    VkBool32                                    depthBiasEnable)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->SetDepthBiasEnableEXT(depthBiasEnable);
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdSetLogicOpEXT(
+    VkCommandBuffer                             commandBuffer,
+    VkLogicOp                                   logicOp)
+{
+    // The extension requires this command to be exported, but calling it is only valid with the
+    // extendedDynamicState2LogicOp feature, which is not reported: PAL programs the logic op as part of the pipeline's
+    // color blend state, so VK_DYNAMIC_STATE_LOGIC_OP_EXT is never accepted by a pipeline.
+    VK_NEVER_CALLED();
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkCmdSetPrimitiveRestartEnableEXT(
+    VkCommandBuffer                             commandBuffer,
+    VkBool32                                    primitiveRestartEnable)
+{
+    ApiCmdBuffer::ObjectFromHandle(commandBuffer)->SetPrimitiveRestartEnableEXT(primitiveRestartEnable);
+}
+
 } // namespace entry
 
 } // namespace vk
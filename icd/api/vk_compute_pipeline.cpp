@@ -51,7 +51,10 @@ uint64_t ComputePipeline::BuildApiHash(
     Util::MetroHash128 baseHasher;
     Util::MetroHash128 apiHasher;
 
-    baseHasher.Update(pCreateInfo->flags);
+    // Flags which only control how the pipeline is created are left out of the base hash, so that a pipeline created
+    // from shader module identifiers matches the earlier creation from the modules themselves.
+    baseHasher.Update(PipelineCompiler::GetCacheIdControlFlags(pCreateInfo->flags));
+    apiHasher.Update(pCreateInfo->flags);
 
     GenerateHashFromShaderStageCreateInfo(&baseHasher, pCreateInfo->stage);
 
@@ -140,7 +143,9 @@ VkResult ComputePipeline::Create(
     VkResult result = pDefaultCompiler->ConvertComputePipelineInfo(
         pDevice, pCreateInfo, &binaryCreateInfo, &pPipelineCreationFeadbackCreateInfo);
 
-    uint64_t pipelineHash = Vkgc::IPipelineDumper::GetPipelineHash(&binaryCreateInfo.pipelineInfo);
+    // The LLPC pipeline hash needs module data, which a stage given by a module identifier doesn't have
+    uint64_t pipelineHash = binaryCreateInfo.usesModuleIdentifiers ?
+        apiPsoHash : Vkgc::IPipelineDumper::GetPipelineHash(&binaryCreateInfo.pipelineInfo);
     for (uint32_t deviceIdx = 0;
         (result == VK_SUCCESS) && (deviceIdx < pDevice->NumPalDevices())
         ; deviceIdx++)
@@ -0,0 +1,352 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2020-2021 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+/**
+ ***********************************************************************************************************************
+ * @file  vk_deferred_operation.cpp
+ * @brief Contains implementation of Vulkan deferred host operation object.
+ ***********************************************************************************************************************
+ */
+
+#include "include/vk_deferred_operation.h"
+#include "include/vk_device.h"
+#include "include/vk_instance.h"
+
+#include "palSysUtil.h"
+#include "palThread.h"
+
+namespace vk
+{
+
+// =====================================================================================================================
+VkResult DeferredHostOperation::Create(
+    Device*                         pDevice,
+    const VkAllocationCallbacks*    pAllocator,
+    VkDeferredOperationKHR*         pDeferredOperation)
+{
+    VkResult result = VK_SUCCESS;
+
+    void* pMemory = pDevice->AllocApiObject(pAllocator, sizeof(DeferredHostOperation));
+
+    if (pMemory != nullptr)
+    {
+        DeferredHostOperation* pOperation = VK_PLACEMENT_NEW(pMemory) DeferredHostOperation(pDevice);
+
+        *pDeferredOperation = DeferredHostOperation::HandleFromObject(pOperation);
+    }
+    else
+    {
+        result = VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+DeferredHostOperation::DeferredHostOperation(
+    Device* pDevice)
+    :
+    m_pDevice(pDevice),
+    m_pfnWorkUnit(nullptr),
+    m_pPayload(nullptr),
+    m_unitCount(0),
+    m_nextUnit(0),
+    m_completedUnits(0),
+    m_result(VK_SUCCESS),
+    m_cpuCoreCount(1)
+{
+    Util::SystemInfo sysInfo = {};
+
+    if (Util::QuerySystemInfo(&sysInfo) == Pal::Result::Success)
+    {
+        m_cpuCoreCount = Util::Max(1u, sysInfo.cpuLogicalCoreCount);
+    }
+}
+
+// =====================================================================================================================
+void DeferredHostOperation::Destroy(
+    Device*                         pDevice,
+    const VkAllocationCallbacks*    pAllocator)
+{
+    // The application must not destroy an operation which is still executing.
+    VK_ASSERT(IsComplete());
+
+    Util::Destructor(this);
+    pDevice->FreeApiObject(pAllocator, this);
+}
+
+// =====================================================================================================================
+// Attaches a workload to the operation.  Must be called before any thread joins the operation.
+void DeferredHostOperation::SetWorkload(
+    PfnWorkUnit pfnWorkUnit,
+    void*       pPayload,
+    uint32_t    unitCount)
+{
+    VK_ASSERT(m_pfnWorkUnit == nullptr);
+
+    m_pfnWorkUnit    = pfnWorkUnit;
+    m_pPayload       = pPayload;
+    m_unitCount      = unitCount;
+    m_nextUnit       = 0;
+    m_completedUnits = 0;
+    m_result         = VK_SUCCESS;
+}
+
+// =====================================================================================================================
+// Executes work units on the calling thread until there are none left to claim.  Returns VK_SUCCESS if the whole
+// workload has finished, or VK_THREAD_DONE_KHR if other threads are still executing the last claimed units.
+VkResult DeferredHostOperation::Join()
+{
+    while (m_nextUnit < m_unitCount)
+    {
+        const uint32_t unitIdx = Util::AtomicIncrement(&m_nextUnit) - 1;
+
+        if (unitIdx < m_unitCount)
+        {
+            const VkResult unitResult = m_pfnWorkUnit(m_pDevice, m_pPayload, unitIdx);
+
+            if (unitResult != VK_SUCCESS)
+            {
+                // Only the first failure is kept
+                Util::AtomicCompareAndSwap(reinterpret_cast<volatile uint32_t*>(&m_result),
+                                           static_cast<uint32_t>(VK_SUCCESS),
+                                           static_cast<uint32_t>(unitResult));
+            }
+
+            Util::AtomicIncrement(&m_completedUnits);
+        }
+    }
+
+    return IsComplete() ? VK_SUCCESS : VK_THREAD_DONE_KHR;
+}
+
+// =====================================================================================================================
+VkResult DeferredHostOperation::GetResult() const
+{
+    return IsComplete() ? static_cast<VkResult>(m_result) : VK_NOT_READY;
+}
+
+// =====================================================================================================================
+// Returns the number of threads that can still usefully join the operation: one per unclaimed work unit, capped at the
+// number of logical CPU cores.  A complete operation reports zero.
+uint32_t DeferredHostOperation::GetMaxConcurrency() const
+{
+    uint32_t concurrency = 0;
+
+    if (IsComplete() == false)
+    {
+        const uint32_t claimedUnits = Util::Min(m_nextUnit, m_unitCount);
+
+        concurrency = Util::Max(1u, Util::Min(m_unitCount - claimedUnits, m_cpuCoreCount));
+    }
+
+    return concurrency;
+}
+
+// =====================================================================================================================
+DeferredWorkerPool::DeferredWorkerPool()
+    :
+    m_threadCount(0),
+    m_pOperation(nullptr),
+    m_generation(0),
+    m_activeWorkers(0),
+    m_stop(false)
+{
+}
+
+// =====================================================================================================================
+DeferredWorkerPool::~DeferredWorkerPool()
+{
+    m_stop = true;
+    m_workEvent.Set();
+
+    for (uint32_t i = 0; i < m_threadCount; ++i)
+    {
+        m_threads[i].Join();
+    }
+}
+
+// =====================================================================================================================
+// Starts the helper threads.  A pool that fails to start some of them keeps the ones it has.
+VkResult DeferredWorkerPool::Init(
+    uint32_t threadCount)
+{
+    Util::EventCreateFlags flags = {};
+    flags.manualReset       = true;
+    flags.initiallySignaled = false;
+
+    VkResult result = PalToVkResult(m_workEvent.Init(flags));
+
+    threadCount = Util::Min(threadCount, MaxWorkerThreads);
+
+    while ((result == VK_SUCCESS) && (m_threadCount < threadCount))
+    {
+        if (m_threads[m_threadCount].Begin(WorkerThreadFunc, this) == Util::Result::Success)
+        {
+            m_threadCount++;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Executes the whole workload of the operation on the calling thread and the helper threads, and returns once every
+// work unit has finished and no helper refers to the operation anymore.
+VkResult DeferredWorkerPool::Execute(
+    DeferredHostOperation* pOperation)
+{
+    if (m_executeLock.TryLock())
+    {
+        Util::AtomicIncrement(&m_generation);
+        Util::AtomicExchangePointer(reinterpret_cast<void* volatile*>(&m_pOperation), pOperation);
+        m_workEvent.Set();
+
+        pOperation->Join();
+
+        m_workEvent.Reset();
+        Util::AtomicExchangePointer(reinterpret_cast<void* volatile*>(&m_pOperation), nullptr);
+
+        // Helpers which picked the operation up may still be finishing its last units
+        while (m_activeWorkers > 0)
+        {
+            Util::YieldThread();
+        }
+
+        m_executeLock.Unlock();
+    }
+    else
+    {
+        pOperation->Join();
+    }
+
+    VK_ASSERT(pOperation->IsComplete());
+
+    return pOperation->GetResult();
+}
+
+// =====================================================================================================================
+void DeferredWorkerPool::WorkerThreadFunc(
+    void* pParam)
+{
+    static_cast<DeferredWorkerPool*>(pParam)->WorkerLoop();
+}
+
+// =====================================================================================================================
+void DeferredWorkerPool::WorkerLoop()
+{
+    uint32_t lastGeneration = 0;
+
+    while (m_stop == false)
+    {
+        m_workEvent.Wait(1.0f);
+
+        // Announce ourselves before looking at the operation, so that Execute() can't return while we are using it
+        Util::AtomicIncrement(&m_activeWorkers);
+
+        DeferredHostOperation* const pOperation = m_pOperation;
+        const uint32_t               generation = m_generation;
+
+        if ((pOperation != nullptr) && (generation != lastGeneration))
+        {
+            pOperation->Join();
+
+            lastGeneration = generation;
+
+            Util::AtomicDecrement(&m_activeWorkers);
+        }
+        else
+        {
+            Util::AtomicDecrement(&m_activeWorkers);
+
+            if (pOperation != nullptr)
+            {
+                // Nothing left for us in this operation; let the caller finish it
+                Util::YieldThread();
+            }
+        }
+    }
+}
+
+namespace entry
+{
+
+// =====================================================================================================================
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateDeferredOperationKHR(
+    VkDevice                                    device,
+    const VkAllocationCallbacks*                pAllocator,
+    VkDeferredOperationKHR*                     pDeferredOperation)
+{
+    Device*                      pDevice  = ApiDevice::ObjectFromHandle(device);
+    const VkAllocationCallbacks* pAllocCB = pAllocator ? pAllocator : pDevice->VkInstance()->GetAllocCallbacks();
+
+    return DeferredHostOperation::Create(pDevice, pAllocCB, pDeferredOperation);
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkDestroyDeferredOperationKHR(
+    VkDevice                                    device,
+    VkDeferredOperationKHR                      operation,
+    const VkAllocationCallbacks*                pAllocator)
+{
+    if (operation != VK_NULL_HANDLE)
+    {
+        Device*                      pDevice  = ApiDevice::ObjectFromHandle(device);
+        const VkAllocationCallbacks* pAllocCB = pAllocator ? pAllocator : pDevice->VkInstance()->GetAllocCallbacks();
+
+        DeferredHostOperation::ObjectFromHandle(operation)->Destroy(pDevice, pAllocCB);
+    }
+}
+
+// =====================================================================================================================
+VKAPI_ATTR uint32_t VKAPI_CALL vkGetDeferredOperationMaxConcurrencyKHR(
+    VkDevice                                    device,
+    VkDeferredOperationKHR                      operation)
+{
+    return DeferredHostOperation::ObjectFromHandle(operation)->GetMaxConcurrency();
+}
+
+// =====================================================================================================================
+VKAPI_ATTR VkResult VKAPI_CALL vkGetDeferredOperationResultKHR(
+    VkDevice                                    device,
+    VkDeferredOperationKHR                      operation)
+{
+    return DeferredHostOperation::ObjectFromHandle(operation)->GetResult();
+}
+
+// =====================================================================================================================
+VKAPI_ATTR VkResult VKAPI_CALL vkDeferredOperationJoinKHR(
+    VkDevice                                    device,
+    VkDeferredOperationKHR                      operation)
+{
+    return DeferredHostOperation::ObjectFromHandle(operation)->Join();
+}
+
+} // namespace entry
+
+} // namespace vk
@@ -642,6 +642,147 @@ void DescriptorUpdate::WriteDescriptorSets(
     }
 }
 
+// =====================================================================================================================
+// Write push descriptors directly into a descriptor table that lives outside of any descriptor pool (e.g. the command
+// buffer's CPU copy of a push descriptor table).  Push descriptor set layouts cannot contain dynamic buffers or inline
+// uniform blocks, and push descriptors are only supported when fmask based MSAA reads are disabled, so only the static
+// section is written.
+template <size_t imageDescSize, size_t samplerDescSize, size_t bufferDescSize>
+void DescriptorUpdate::WritePushDescriptors(
+    const Device*                pDevice,
+    uint32_t                     deviceIdx,
+    const DescriptorSetLayout*   pLayout,
+    uint32_t*                    pDestTable,
+    uint32_t                     descriptorWriteCount,
+    const VkWriteDescriptorSet*  pDescriptorWrites)
+{
+    for (uint32_t i = 0; i < descriptorWriteCount; ++i)
+    {
+        const VkWriteDescriptorSet& params = pDescriptorWrites[i];
+
+        VK_ASSERT(params.sType == VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+
+        const DescriptorSetLayout::BindingInfo& destBinding = pLayout->Binding(params.dstBinding);
+
+        uint32_t* pDestAddr = pDestTable + pLayout->GetDstStaOffset(destBinding, params.dstArrayElement);
+
+        // Determine whether the binding has immutable sampler descriptors.
+        const bool hasImmutableSampler = (destBinding.imm.dwSize != 0);
+
+        switch (static_cast<uint32_t>(params.descriptorType))
+        {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+            if (hasImmutableSampler)
+            {
+                VK_ASSERT(!"Immutable samplers cannot be updated");
+            }
+            else
+            {
+                WriteSamplerDescriptors<samplerDescSize>(
+                    params.pImageInfo,
+                    pDestAddr,
+                    params.descriptorCount,
+                    destBinding.sta.dwArrayStride);
+            }
+            break;
+
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            if (hasImmutableSampler)
+            {
+                if (destBinding.bindingFlags.ycbcrConversionUsage == 0)
+                {
+                    WriteImageDescriptors<imageDescSize, false>(
+                        params.pImageInfo,
+                        deviceIdx,
+                        pDestAddr,
+                        params.descriptorCount,
+                        destBinding.sta.dwArrayStride);
+                }
+                else
+                {
+                    WriteImageDescriptorsYcbcr<imageDescSize>(
+                        params.pImageInfo,
+                        deviceIdx,
+                        pDestAddr,
+                        params.descriptorCount,
+                        destBinding.sta.dwArrayStride);
+                }
+            }
+            else
+            {
+                WriteImageSamplerDescriptors<imageDescSize, samplerDescSize>(
+                    params.pImageInfo,
+                    deviceIdx,
+                    pDestAddr,
+                    params.descriptorCount,
+                    destBinding.sta.dwArrayStride);
+            }
+            break;
+
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            WriteImageDescriptors<imageDescSize, true>(
+                params.pImageInfo,
+                deviceIdx,
+                pDestAddr,
+                params.descriptorCount,
+                destBinding.sta.dwArrayStride);
+            break;
+
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            WriteImageDescriptors<imageDescSize, false>(
+                params.pImageInfo,
+                deviceIdx,
+                pDestAddr,
+                params.descriptorCount,
+                destBinding.sta.dwArrayStride);
+            break;
+
+        case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            WriteBufferDescriptors<bufferDescSize, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER>(
+                params.pTexelBufferView,
+                deviceIdx,
+                pDestAddr,
+                params.descriptorCount,
+                destBinding.sta.dwArrayStride);
+            break;
+
+        case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+            WriteBufferDescriptors<bufferDescSize, VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER>(
+                params.pTexelBufferView,
+                deviceIdx,
+                pDestAddr,
+                params.descriptorCount,
+                destBinding.sta.dwArrayStride);
+            break;
+
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            WriteBufferInfoDescriptors<bufferDescSize, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER>(
+                pDevice,
+                params.pBufferInfo,
+                deviceIdx,
+                pDestAddr,
+                params.descriptorCount,
+                destBinding.sta.dwArrayStride);
+            break;
+
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            WriteBufferInfoDescriptors<bufferDescSize, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER>(
+                pDevice,
+                params.pBufferInfo,
+                deviceIdx,
+                pDestAddr,
+                params.descriptorCount,
+                destBinding.sta.dwArrayStride);
+            break;
+
+        default:
+            VK_ASSERT(!"Unexpected push descriptor type");
+            break;
+        }
+    }
+}
+
 // =====================================================================================================================
 // Copy from one descriptor set to another
 template <size_t imageDescSize, size_t fmaskDescSize, bool fmaskBasedMsaaReadEnabled, uint32_t numPalDevices>
@@ -1035,6 +1176,15 @@ void DescriptorUpdate::WriteBufferInfoDescriptors<16, VK_DESCRIPTOR_TYPE_STORAGE
     uint32_t                        dwStride,
     size_t                          descriptorStrideInBytes);
 
+template
+void DescriptorUpdate::WritePushDescriptors<32, 16, 16>(
+    const Device*                   pDevice,
+    uint32_t                        deviceIdx,
+    const DescriptorSetLayout*      pLayout,
+    uint32_t*                       pDestTable,
+    uint32_t                        descriptorWriteCount,
+    const VkWriteDescriptorSet*     pDescriptorWrites);
+
 template
 DescriptorSet<1>::DescriptorSet(uint32_t heapIndex);
 
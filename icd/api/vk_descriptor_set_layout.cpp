@@ -465,6 +465,10 @@ VkResult DescriptorSetLayout::ConvertCreateInfo(
 
     VK_IGNORE(pIn->flags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT);
 
+    // Push descriptor sets use the same static section layout as regular sets.  Their tables are written directly into
+    // command buffer embedded memory by vkCmdPushDescriptorSetKHR, so nothing else is needed here.
+    VK_IGNORE(pIn->flags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR);
+
     // First, copy the binding info into our output array in order.
     for (uint32 inIndex = 0; inIndex < pIn->bindingCount; ++inIndex)
     {
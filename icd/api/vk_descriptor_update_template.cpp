@@ -46,7 +46,8 @@ VkResult DescriptorUpdateTemplate::Create(
 {
     VkResult                    result      = VK_SUCCESS;
     const uint32_t              numEntries  = pCreateInfo->descriptorUpdateEntryCount;
-    const DescriptorSetLayout*  pLayout     = DescriptorSetLayout::ObjectFromHandle(pCreateInfo->descriptorSetLayout);
+    const bool                  isPush      =
+        (pCreateInfo->templateType == VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR);
     const size_t                apiSize     = sizeof(DescriptorUpdateTemplate);
     const size_t                entriesSize = numEntries * sizeof(TemplateUpdateInfo);
     const size_t                objSize     = apiSize + entriesSize;
@@ -60,9 +61,11 @@ VkResult DescriptorUpdateTemplate::Create(
 
     if (result == VK_SUCCESS)
     {
-        // It's safe to ignore pCreateInfo.pipelineBindPoint, pCreateInfo.pipelineLayout, and pCreateInfo.set because
-        // we don't support VK_KHR_push_descriptors.
-        VK_ASSERT(pCreateInfo->templateType == VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET);
+        // For push descriptor templates the set layout comes from pCreateInfo.pipelineLayout and pCreateInfo.set, and
+        // the bind point has to be kept around for vkCmdPushDescriptorSetWithTemplateKHR.
+        const DescriptorSetLayout* pLayout = isPush ?
+            PipelineLayout::ObjectFromHandle(pCreateInfo->pipelineLayout)->GetSetLayouts(pCreateInfo->set) :
+            DescriptorSetLayout::ObjectFromHandle(pCreateInfo->descriptorSetLayout);
 
         TemplateUpdateInfo* pEntries = static_cast<TemplateUpdateInfo*>(Util::VoidPtrInc(pSysMem, apiSize));
 
@@ -95,11 +98,23 @@ VkResult DescriptorUpdateTemplate::Create(
             pEntries[ii].dstDynOffset                   =
                 pLayout->GetDstDynOffset(dstBinding, dstArrayElement);
 
-            pEntries[ii].pFunc                          =
-                GetUpdateEntryFunc(pDevice, srcEntry.descriptorType, dstBinding);
+            if (isPush)
+            {
+                pEntries[ii].pFunc                      = nullptr;
+                pEntries[ii].pPushFunc                  =
+                    GetPushEntryFunc(pDevice, srcEntry.descriptorType, dstBinding);
+            }
+            else
+            {
+                pEntries[ii].pFunc                      =
+                    GetUpdateEntryFunc(pDevice, srcEntry.descriptorType, dstBinding);
+                pEntries[ii].pPushFunc                  = nullptr;
+            }
         }
 
-        VK_PLACEMENT_NEW(pSysMem) DescriptorUpdateTemplate(pCreateInfo->descriptorUpdateEntryCount);
+        VK_PLACEMENT_NEW(pSysMem) DescriptorUpdateTemplate(
+            isPush ? pCreateInfo->pipelineBindPoint : VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pCreateInfo->descriptorUpdateEntryCount);
 
         *pDescriptorUpdateTemplate = DescriptorUpdateTemplate::HandleFromVoidPointer(pSysMem);
     }
@@ -291,10 +306,97 @@ DescriptorUpdateTemplate::PfnUpdateEntry DescriptorUpdateTemplate::GetUpdateEntr
     return pFunc;
 }
 
+// =====================================================================================================================
+template <size_t imageDescSize, size_t samplerDescSize, size_t bufferDescSize>
+DescriptorUpdateTemplate::PfnPushEntry DescriptorUpdateTemplate::GetPushEntryFunc(
+    VkDescriptorType                        descriptorType,
+    const DescriptorSetLayout::BindingInfo& dstBinding)
+{
+    PfnPushEntry pFunc = nullptr;
+
+    switch (static_cast<uint32_t>(descriptorType))
+    {
+    case VK_DESCRIPTOR_TYPE_SAMPLER:
+        pFunc = &PushEntrySampler<samplerDescSize>;
+        break;
+    case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+        if (dstBinding.imm.dwSize != 0)
+        {
+            if (dstBinding.bindingFlags.ycbcrConversionUsage != 0)
+            {
+                pFunc = &PushEntryCombinedImageSampler<imageDescSize, samplerDescSize, true, true>;
+            }
+            else
+            {
+                pFunc = &PushEntryCombinedImageSampler<imageDescSize, samplerDescSize, true, false>;
+            }
+        }
+        else
+        {
+            pFunc = &PushEntryCombinedImageSampler<imageDescSize, samplerDescSize, false, false>;
+        }
+        break;
+    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+    case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+        pFunc = &PushEntrySampledImage<imageDescSize, false>;
+        break;
+    case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        pFunc = &PushEntrySampledImage<imageDescSize, true>;
+        break;
+    case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+        pFunc = &PushEntryTexelBuffer<bufferDescSize, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER>;
+        break;
+    case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+        pFunc = &PushEntryTexelBuffer<bufferDescSize, VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER>;
+        break;
+    case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        pFunc = &PushEntryBuffer<bufferDescSize, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER>;
+        break;
+    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        pFunc = &PushEntryBuffer<bufferDescSize, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER>;
+        break;
+    default:
+        // Dynamic buffers and inline uniform blocks are not allowed in push descriptor set layouts.
+        VK_ASSERT(!"Unexpected push descriptor type");
+        break;
+    }
+
+    return pFunc;
+}
+
+// =====================================================================================================================
+DescriptorUpdateTemplate::PfnPushEntry DescriptorUpdateTemplate::GetPushEntryFunc(
+    const Device*                           pDevice,
+    VkDescriptorType                        descriptorType,
+    const DescriptorSetLayout::BindingInfo& dstBinding)
+{
+    const size_t imageDescSize      = pDevice->GetProperties().descriptorSizes.imageView;
+    const size_t samplerDescSize    = pDevice->GetProperties().descriptorSizes.sampler;
+    const size_t bufferDescSize     = pDevice->GetProperties().descriptorSizes.bufferView;
+
+    DescriptorUpdateTemplate::PfnPushEntry pFunc = nullptr;
+
+    if ((imageDescSize == 32) &&
+        (samplerDescSize == 16) &&
+        (bufferDescSize == 16))
+    {
+        pFunc = GetPushEntryFunc<32, 16, 16>(descriptorType, dstBinding);
+    }
+    else
+    {
+        VK_NEVER_CALLED();
+        pFunc = nullptr;
+    }
+
+    return pFunc;
+}
+
 // =====================================================================================================================
 DescriptorUpdateTemplate::DescriptorUpdateTemplate(
+    VkPipelineBindPoint         pipelineBindPoint,
     uint32_t                    numEntries)
     :
+    m_pipelineBindPoint(pipelineBindPoint),
     m_numEntries(numEntries)
 {
 }
@@ -332,6 +434,26 @@ void DescriptorUpdateTemplate::Update(
     }
 }
 
+// =====================================================================================================================
+// Applies a push descriptor template to the push descriptor table of a single device.
+void DescriptorUpdateTemplate::PushUpdate(
+    const Device*   pDevice,
+    uint32_t        deviceIdx,
+    uint32_t*       pDestTable,
+    const void*     pData) const
+{
+    auto pEntries = GetEntries();
+
+    for (uint32_t i = 0; i < m_numEntries; ++i)
+    {
+        const void* pDescriptorInfo = Util::VoidPtrInc(pData, pEntries[i].srcOffset);
+
+        VK_ASSERT(pEntries[i].pPushFunc != nullptr);
+
+        pEntries[i].pPushFunc(pDevice, deviceIdx, pDestTable, pDescriptorInfo, pEntries[i]);
+    }
+}
+
 // =====================================================================================================================
 template <size_t imageDescSize, size_t fmaskDescSize, size_t samplerDescSize, bool updateFmask, bool immutable,
     bool ycbcrUsage, uint32_t numPalDevices>
@@ -588,6 +710,126 @@ void DescriptorUpdateTemplate::UpdateEntryInlineUniformBlock(
     } while (deviceIdx < numPalDevices);
 }
 
+// =====================================================================================================================
+template <size_t imageDescSize, size_t samplerDescSize, bool immutable, bool ycbcrUsage>
+void DescriptorUpdateTemplate::PushEntryCombinedImageSampler(
+    const Device*               pDevice,
+    uint32_t                    deviceIdx,
+    uint32_t*                   pDestTable,
+    const void*                 pDescriptorInfo,
+    const TemplateUpdateInfo&   entry)
+{
+    const VkDescriptorImageInfo* pImageInfo = static_cast<const VkDescriptorImageInfo*>(pDescriptorInfo);
+
+    uint32_t* pDestAddr = pDestTable + entry.dstStaOffset;
+
+    if (immutable)
+    {
+        if (ycbcrUsage == false)
+        {
+            DescriptorUpdate::WriteImageDescriptors<imageDescSize, false>(
+                pImageInfo,
+                deviceIdx,
+                pDestAddr,
+                entry.descriptorCount,
+                entry.dstBindStaDwArrayStride,
+                entry.srcStride);
+        }
+        else
+        {
+            DescriptorUpdate::WriteImageDescriptorsYcbcr<imageDescSize>(
+                pImageInfo,
+                deviceIdx,
+                pDestAddr,
+                entry.descriptorCount,
+                entry.dstBindStaDwArrayStride,
+                entry.srcStride);
+        }
+    }
+    else
+    {
+        DescriptorUpdate::WriteImageSamplerDescriptors<imageDescSize, samplerDescSize>(
+            pImageInfo,
+            deviceIdx,
+            pDestAddr,
+            entry.descriptorCount,
+            entry.dstBindStaDwArrayStride,
+            entry.srcStride);
+    }
+}
+
+// =====================================================================================================================
+template <size_t bufferDescSize, VkDescriptorType descriptorType>
+void DescriptorUpdateTemplate::PushEntryTexelBuffer(
+    const Device*               pDevice,
+    uint32_t                    deviceIdx,
+    uint32_t*                   pDestTable,
+    const void*                 pDescriptorInfo,
+    const TemplateUpdateInfo&   entry)
+{
+    DescriptorUpdate::WriteBufferDescriptors<bufferDescSize, descriptorType>(
+        static_cast<const VkBufferView*>(pDescriptorInfo),
+        deviceIdx,
+        pDestTable + entry.dstStaOffset,
+        entry.descriptorCount,
+        entry.dstBindStaDwArrayStride,
+        entry.srcStride);
+}
+
+// =====================================================================================================================
+template <size_t bufferDescSize, VkDescriptorType descriptorType>
+void DescriptorUpdateTemplate::PushEntryBuffer(
+    const Device*               pDevice,
+    uint32_t                    deviceIdx,
+    uint32_t*                   pDestTable,
+    const void*                 pDescriptorInfo,
+    const TemplateUpdateInfo&   entry)
+{
+    DescriptorUpdate::WriteBufferInfoDescriptors<bufferDescSize, descriptorType>(
+        pDevice,
+        static_cast<const VkDescriptorBufferInfo*>(pDescriptorInfo),
+        deviceIdx,
+        pDestTable + entry.dstStaOffset,
+        entry.descriptorCount,
+        entry.dstBindStaDwArrayStride,
+        entry.srcStride);
+}
+
+// =====================================================================================================================
+template <size_t samplerDescSize>
+void DescriptorUpdateTemplate::PushEntrySampler(
+    const Device*               pDevice,
+    uint32_t                    deviceIdx,
+    uint32_t*                   pDestTable,
+    const void*                 pDescriptorInfo,
+    const TemplateUpdateInfo&   entry)
+{
+    DescriptorUpdate::WriteSamplerDescriptors<samplerDescSize>(
+        static_cast<const VkDescriptorImageInfo*>(pDescriptorInfo),
+        pDestTable + entry.dstStaOffset,
+        entry.descriptorCount,
+        entry.dstBindStaDwArrayStride,
+        entry.srcStride);
+}
+
+// =====================================================================================================================
+template <size_t imageDescSize, bool isShaderStorageDesc>
+void DescriptorUpdateTemplate::PushEntrySampledImage(
+    const Device*               pDevice,
+    uint32_t                    deviceIdx,
+    uint32_t*                   pDestTable,
+    const void*                 pDescriptorInfo,
+    const TemplateUpdateInfo&   entry)
+{
+    DescriptorUpdate::WriteImageDescriptors<imageDescSize, isShaderStorageDesc>(
+        static_cast<const VkDescriptorImageInfo*>(pDescriptorInfo),
+        deviceIdx,
+        pDestTable + entry.dstStaOffset,
+        entry.descriptorCount,
+        entry.dstBindStaDwArrayStride,
+        entry.srcStride);
+}
+
 namespace entry
 {
 
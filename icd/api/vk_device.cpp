@@ -40,6 +40,7 @@
 #include "include/vk_descriptor_set.h"
 #include "include/vk_descriptor_set_layout.h"
 #include "include/vk_descriptor_update_template.h"
+#include "include/vk_deferred_operation.h"
 #include "include/vk_device.h"
 #include "include/vk_fence.h"
 #include "include/vk_formats.h"
@@ -66,6 +67,7 @@
 #include "include/vk_utils.h"
 #include "include/vk_conv.h"
 #include "include/internal_layer_hooks.h"
+#include "include/gpu_address_map.h"
 
 #include "sqtt/sqtt_layer.h"
 #include "sqtt/sqtt_mgr.h"
@@ -86,10 +88,13 @@
 #include "palLib.h"
 #include "palLinearAllocator.h"
 #include "palListImpl.h"
+#include "palMetroHash.h"
 #include "palHashMapImpl.h"
 #include "palDevice.h"
+#include "palFile.h"
 #include "palSwapChain.h"
 #include "palSysMemory.h"
+#include "palSysUtil.h"
 #include "palQueue.h"
 #include "palQueueSemaphore.h"
 #include "palAutoBuffer.h"
@@ -226,12 +231,17 @@ Device::Device(
     m_dispatchTable(DispatchTable::Type::DEVICE, m_pInstance, this),
     m_pSqttMgr(nullptr),
     m_pAsyncLayer(nullptr),
+    m_pGpuAddressMap(nullptr),
+    m_pPipelineBatchPool(nullptr),
     m_pAppOptLayer(nullptr),
     m_pBarrierFilterLayer(nullptr),
     m_allocationSizeTracking(m_settings.memoryDeviceOverallocationAllowed ? false : true),
     m_useComputeAsTransferQueue(useComputeAsTransferQueue),
     m_useGlobalGpuVa(false)
     , m_pBorderColorUsedIndexes(nullptr)
+    , m_pBreadcrumbCmdBuffers(nullptr)
+    , m_nextBreadcrumbSubmitId(0)
+    , m_imageMemReqsCache(32, pPhysicalDevices[DefaultDeviceIndex]->VkInstance()->Allocator())
 {
     memset(m_pBltMsaaState, 0, sizeof(m_pBltMsaaState));
 
@@ -939,6 +949,78 @@ VkResult Device::Create(
             break;
         }
 
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT:
+        {
+            vkResult = VerifyRequestedPhysicalDeviceFeatures<VkPhysicalDeviceMultiDrawFeaturesEXT>(
+                pPhysicalDevice,
+                reinterpret_cast<const VkPhysicalDeviceMultiDrawFeaturesEXT*>(pHeader));
+
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR:
+        {
+            vkResult = VerifyRequestedPhysicalDeviceFeatures<VkPhysicalDeviceDynamicRenderingFeaturesKHR>(
+                pPhysicalDevice,
+                reinterpret_cast<const VkPhysicalDeviceDynamicRenderingFeaturesKHR*>(pHeader));
+
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT:
+        {
+            vkResult = VerifyRequestedPhysicalDeviceFeatures<VkPhysicalDeviceExtendedDynamicState2FeaturesEXT>(
+                pPhysicalDevice,
+                reinterpret_cast<const VkPhysicalDeviceExtendedDynamicState2FeaturesEXT*>(pHeader));
+
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT:
+        {
+            vkResult = VerifyRequestedPhysicalDeviceFeatures<VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>(
+                pPhysicalDevice,
+                reinterpret_cast<const VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT*>(pHeader));
+
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MODULE_IDENTIFIER_FEATURES_EXT:
+        {
+            vkResult = VerifyRequestedPhysicalDeviceFeatures<VkPhysicalDeviceShaderModuleIdentifierFeaturesEXT>(
+                pPhysicalDevice,
+                reinterpret_cast<const VkPhysicalDeviceShaderModuleIdentifierFeaturesEXT*>(pHeader));
+
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_4_FEATURES_KHR:
+        {
+            vkResult = VerifyRequestedPhysicalDeviceFeatures<VkPhysicalDeviceMaintenance4FeaturesKHR>(
+                pPhysicalDevice,
+                reinterpret_cast<const VkPhysicalDeviceMaintenance4FeaturesKHR*>(pHeader));
+
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR:
+        {
+            vkResult = VerifyRequestedPhysicalDeviceFeatures<VkPhysicalDevicePresentIdFeaturesKHR>(
+                pPhysicalDevice,
+                reinterpret_cast<const VkPhysicalDevicePresentIdFeaturesKHR*>(pHeader));
+
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR:
+        {
+            vkResult = VerifyRequestedPhysicalDeviceFeatures<VkPhysicalDevicePresentWaitFeaturesKHR>(
+                pPhysicalDevice,
+                reinterpret_cast<const VkPhysicalDevicePresentWaitFeaturesKHR*>(pHeader));
+
+            break;
+        }
+
         default:
             break;
         }
@@ -1378,6 +1460,11 @@ VkResult Device::Initialize(
         result = m_renderStateCache.Init();
     }
 
+    if (result == VK_SUCCESS)
+    {
+        result = PalToVkResult(m_imageMemReqsCache.Init());
+    }
+
     if (result == VK_SUCCESS)
     {
         // Create a common CmdAllocator for internal use. For the driver setting, useSharedCmdAllocator,
@@ -1605,6 +1692,47 @@ VkResult Device::Initialize(
         }
     }
 
+    if ((result == VK_SUCCESS) && m_settings.enableGpuAddressMap)
+    {
+        void* pMemory = VkInstance()->AllocMem(sizeof(GpuAddressMap), VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+
+        if (pMemory != nullptr)
+        {
+            m_pGpuAddressMap = VK_PLACEMENT_NEW(pMemory) GpuAddressMap(VkInstance());
+        }
+        else
+        {
+            result = VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    uint32_t pipelineBatchThreads = m_settings.pipelineBatchCompileThreads;
+
+    if (pipelineBatchThreads == 0)
+    {
+        Util::SystemInfo sysInfo = {};
+        Util::QuerySystemInfo(&sysInfo);
+
+        pipelineBatchThreads = Util::Max(1u, sysInfo.cpuLogicalCoreCount / 2);
+    }
+
+    if ((result == VK_SUCCESS) && (pipelineBatchThreads > 1))
+    {
+        void* pMemory = VkInstance()->AllocMem(sizeof(DeferredWorkerPool), VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+
+        if (pMemory != nullptr)
+        {
+            m_pPipelineBatchPool = VK_PLACEMENT_NEW(pMemory) DeferredWorkerPool();
+
+            // The calling thread of a batch is the last compile thread
+            result = m_pPipelineBatchPool->Init(pipelineBatchThreads - 1);
+        }
+        else
+        {
+            result = VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
     const Pal::DeviceProperties& palProps = pPhysicalDevice->PalProperties();
 
     if (result == VK_SUCCESS)
@@ -1718,6 +1846,7 @@ void Device::InitDispatchTable()
 
     ep->vkUpdateDescriptorSets      = DescriptorUpdate::GetUpdateDescriptorSetsFunc(this);
     ep->vkCmdBindDescriptorSets     = CmdBuffer::GetCmdBindDescriptorSetsFunc(this);
+    ep->vkCmdPushDescriptorSetKHR   = CmdBuffer::GetCmdPushDescriptorSetKHRFunc(this);
     ep->vkCreateDescriptorPool      = DescriptorPool::GetCreateDescriptorPoolFunc(this);
     ep->vkFreeDescriptorSets        = DescriptorPool::GetFreeDescriptorSetsFunc(this);
     ep->vkResetDescriptorPool       = DescriptorPool::GetResetDescriptorPoolFunc(this);
@@ -1975,6 +2104,20 @@ VkResult Device::Destroy(const VkAllocationCallbacks* pAllocator)
         VkInstance()->FreeMem(m_pAsyncLayer);
     }
 
+    if (m_pGpuAddressMap != nullptr)
+    {
+        Util::Destructor(m_pGpuAddressMap);
+
+        VkInstance()->FreeMem(m_pGpuAddressMap);
+    }
+
+    if (m_pPipelineBatchPool != nullptr)
+    {
+        Util::Destructor(m_pPipelineBatchPool);
+
+        VkInstance()->FreeMem(m_pPipelineBatchPool);
+    }
+
     for (uint32_t i = 0; i < Queue::MaxQueueFamilies; ++i)
     {
         for (uint32_t j = 0; (j < Queue::MaxQueuesPerFamily) && (m_pQueues[i][j] != nullptr); ++j)
@@ -2471,7 +2614,14 @@ VkResult Device::WaitForFences(
             }
         }
     }
-    return PalToVkResult(palResult);
+    const VkResult result = PalToVkResult(palResult);
+
+    if ((result == VK_ERROR_DEVICE_LOST) && (m_settings.breadcrumbRingEntries > 0))
+    {
+        ReportBreadcrumbs();
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
@@ -2637,18 +2787,57 @@ VkResult Device::CreateImageView(
 }
 
 // =====================================================================================================================
-VkResult Device::CreateGraphicsPipelines(
-    VkPipelineCache                             pipelineCache,
-    uint32_t                                    count,
-    const VkGraphicsPipelineCreateInfo*         pCreateInfos,
-    const VkAllocationCallbacks*                pAllocator,
-    VkPipeline*                                 pPipelines)
+// Describes a vkCreate*Pipelines batch which is split into one deferred work unit per pipeline.
+template <typename CreateInfoType>
+struct PipelineBatch
 {
-    VK_ASSERT(pCreateInfos != nullptr);
-    VK_ASSERT(pPipelines != nullptr);
+    PipelineCache*               pPipelineCache;
+    const CreateInfoType*        pCreateInfos;
+    const VkAllocationCallbacks* pAllocator;
+    VkPipeline*                  pPipelines;
+};
+
+// =====================================================================================================================
+// Deferred work unit which creates a single pipeline of a batch.
+template <typename PipelineType, typename CreateInfoType>
+static VkResult CreateBatchedPipeline(
+    Device*  pDevice,
+    void*    pPayload,
+    uint32_t unitIdx)
+{
+    const auto* pBatch = static_cast<const PipelineBatch<CreateInfoType>*>(pPayload);
+
+    VkResult result = PipelineType::Create(
+        pDevice,
+        pBatch->pPipelineCache,
+        &pBatch->pCreateInfos[unitIdx],
+        pBatch->pAllocator,
+        &pBatch->pPipelines[unitIdx]);
+
+    // In case of failure, VK_NULL_HANDLE must be set
+    VK_ASSERT((result == VK_SUCCESS) || (pBatch->pPipelines[unitIdx] == VK_NULL_HANDLE));
+
+    return result;
+}
 
+// =====================================================================================================================
+// Creates a batch of graphics or compute pipelines.  The pipelines of a batch do not depend on each other, so large
+// enough batches are executed as a deferred host operation which the calling thread runs together with the device's
+// pipeline batch pool.  Batches stay on the calling thread when:
+// - the pool is off (PipelineBatchCompileThreads is 1, or 0 on a machine with fewer than four logical cores),
+// - the batch is smaller than PipelineBatchParallelMinCount, where waking the pool costs more than it saves,
+// - the application asked for early return on failure, which requires the pipelines to be created in order,
+// - the application provided its own allocator, as those may only be called from the thread of the API command.
+template <typename PipelineType, typename CreateInfoType>
+static VkResult CreatePipelineBatch(
+    Device*                      pDevice,
+    PipelineCache*               pPipelineCache,
+    uint32_t                     count,
+    const CreateInfoType*        pCreateInfos,
+    const VkAllocationCallbacks* pAllocator,
+    VkPipeline*                  pPipelines)
+{
     VkResult finalResult = VK_SUCCESS;
-    PipelineCache* pPipelineCache = PipelineCache::ObjectFromHandle(pipelineCache);
 
     // Initialize output array to VK_NULL_HANDLE
     for (uint32_t i = 0; i < count; ++i)
@@ -2656,28 +2845,57 @@ VkResult Device::CreateGraphicsPipelines(
         pPipelines[i] = VK_NULL_HANDLE;
     }
 
-    for (uint32_t i = 0; i < count; ++i)
+    DeferredWorkerPool* const pPool = pDevice->GetPipelineBatchPool();
+
+    const uint32_t minParallelCount = Util::Max(2u, pDevice->GetRuntimeSettings().pipelineBatchParallelMinCount);
+
+    bool parallel = (pPool != nullptr)           &&
+                    (count >= minParallelCount)  &&
+                    (pAllocator->pfnAllocation == allocator::g_DefaultAllocCallback.pfnAllocation);
+
+    for (uint32_t i = 0; (i < count) && parallel; ++i)
     {
-        const VkGraphicsPipelineCreateInfo* pCreateInfo = &pCreateInfos[i];
+        if (pCreateInfos[i].flags & VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT)
+        {
+            parallel = false;
+        }
+    }
 
-        VkResult result = GraphicsPipeline::Create(
-            this,
-            pPipelineCache,
-            pCreateInfo,
-            pAllocator,
-            &pPipelines[i]);
+    if (parallel)
+    {
+        PipelineBatch<CreateInfoType> batch = { pPipelineCache, pCreateInfos, pAllocator, pPipelines };
+
+        DeferredHostOperation batchOperation(pDevice);
 
-        if (result != VK_SUCCESS)
+        batchOperation.SetWorkload(CreateBatchedPipeline<PipelineType, CreateInfoType>, &batch, count);
+
+        finalResult = pPool->Execute(&batchOperation);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; ++i)
         {
-            // In case of failure, VK_NULL_HANDLE must be set
-            VK_ASSERT(pPipelines[i] == VK_NULL_HANDLE);
+            const CreateInfoType* pCreateInfo = &pCreateInfos[i];
 
-            // Capture the first failure result and save it to be returned
-            finalResult = (finalResult != VK_SUCCESS) ? finalResult : result;
+            VkResult result = PipelineType::Create(
+                pDevice,
+                pPipelineCache,
+                pCreateInfo,
+                pAllocator,
+                &pPipelines[i]);
 
-            if (pCreateInfo->flags & VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT)
+            if (result != VK_SUCCESS)
             {
-                break;
+                // In case of failure, VK_NULL_HANDLE must be set
+                VK_ASSERT(pPipelines[i] == VK_NULL_HANDLE);
+
+                // Capture the first failure result and save it to be returned
+                finalResult = (finalResult != VK_SUCCESS) ? finalResult : result;
+
+                if (pCreateInfo->flags & VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT)
+                {
+                    break;
+                }
             }
         }
     }
@@ -2686,52 +2904,43 @@ VkResult Device::CreateGraphicsPipelines(
 }
 
 // =====================================================================================================================
-VkResult Device::CreateComputePipelines(
+VkResult Device::CreateGraphicsPipelines(
     VkPipelineCache                             pipelineCache,
     uint32_t                                    count,
-    const VkComputePipelineCreateInfo*          pCreateInfos,
+    const VkGraphicsPipelineCreateInfo*         pCreateInfos,
     const VkAllocationCallbacks*                pAllocator,
     VkPipeline*                                 pPipelines)
 {
     VK_ASSERT(pCreateInfos != nullptr);
     VK_ASSERT(pPipelines != nullptr);
 
-    VkResult finalResult = VK_SUCCESS;
-    PipelineCache* pPipelineCache = PipelineCache::ObjectFromHandle(pipelineCache);
-
-    // Initialize output array to VK_NULL_HANDLE
-    for (uint32_t i = 0; i < count; ++i)
-    {
-        pPipelines[i] = VK_NULL_HANDLE;
-    }
-
-    for (uint32_t i = 0; i < count; ++i)
-    {
-        const VkComputePipelineCreateInfo* pCreateInfo = &pCreateInfos[i];
-
-        VkResult result = ComputePipeline::Create(
-            this,
-            pPipelineCache,
-            pCreateInfo,
-            pAllocator,
-            &pPipelines[i]);
-
-        if (result != VK_SUCCESS)
-        {
-            // In case of failure, VK_NULL_HANDLE must be set
-            VK_ASSERT(pPipelines[i] == VK_NULL_HANDLE);
-
-            // Capture the first failure result and save it to be returned
-            finalResult = (finalResult != VK_SUCCESS) ? finalResult : result;
+    return CreatePipelineBatch<GraphicsPipeline>(
+        this,
+        PipelineCache::ObjectFromHandle(pipelineCache),
+        count,
+        pCreateInfos,
+        pAllocator,
+        pPipelines);
+}
 
-            if (pCreateInfo->flags & VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT)
-            {
-                break;
-            }
-        }
-    }
+// =====================================================================================================================
+VkResult Device::CreateComputePipelines(
+    VkPipelineCache                             pipelineCache,
+    uint32_t                                    count,
+    const VkComputePipelineCreateInfo*          pCreateInfos,
+    const VkAllocationCallbacks*                pAllocator,
+    VkPipeline*                                 pPipelines)
+{
+    VK_ASSERT(pCreateInfos != nullptr);
+    VK_ASSERT(pPipelines != nullptr);
 
-    return finalResult;
+    return CreatePipelineBatch<ComputePipeline>(
+        this,
+        PipelineCache::ObjectFromHandle(pipelineCache),
+        count,
+        pCreateInfos,
+        pAllocator,
+        pPipelines);
 }
 
 // =====================================================================================================================
@@ -3168,6 +3377,53 @@ VkDeviceSize Device::GetMemoryBaseAddrAlignment(
     return minAlignment;
 }
 
+// =====================================================================================================================
+// Looks up the cached memory requirements of an image create info.  Returns false if none have been cached.
+bool Device::FindImageMemoryRequirements(
+    const ImageMemoryRequirementsKey& key,
+    ImageMemoryRequirements*          pRequirements)
+{
+    uint64_t keyHash = 0;
+
+    Util::MetroHash64::Hash(reinterpret_cast<const uint8_t*>(&key), sizeof(key), reinterpret_cast<uint8_t*>(&keyHash));
+
+    Util::RWLockAuto<Util::RWLock::LockType::ReadOnly> readLock(&m_imageMemReqsLock);
+
+    const ImageMemoryRequirementsEntry* pCached = m_imageMemReqsCache.FindKey(keyHash);
+
+    const bool found = (pCached != nullptr) && (memcmp(&pCached->key, &key, sizeof(key)) == 0);
+
+    if (found)
+    {
+        *pRequirements = pCached->requirements;
+    }
+
+    return found;
+}
+
+// =====================================================================================================================
+// Caches the memory requirements of an image create info.  The cache stops growing once it is full; applications
+// that plan memory this way query a working set of descriptions far smaller than the limit.  A description whose hash
+// collides with a cached one is not cached.
+void Device::CacheImageMemoryRequirements(
+    const ImageMemoryRequirementsKey& key,
+    const ImageMemoryRequirements&    requirements)
+{
+    uint64_t keyHash = 0;
+
+    Util::MetroHash64::Hash(reinterpret_cast<const uint8_t*>(&key), sizeof(key), reinterpret_cast<uint8_t*>(&keyHash));
+
+    Util::RWLockAuto<Util::RWLock::LockType::ReadWrite> writeLock(&m_imageMemReqsLock);
+
+    if ((m_imageMemReqsCache.GetNumEntries() < MaxCachedImageMemoryRequirements) &&
+        (m_imageMemReqsCache.FindKey(keyHash) == nullptr))
+    {
+        const ImageMemoryRequirementsEntry entry = { key, requirements };
+
+        m_imageMemReqsCache.Insert(keyHash, entry);
+    }
+}
+
 // =====================================================================================================================
 // Returns the memory types compatible with pinned system memory.
 uint32_t Device::GetPinnedSystemMemoryTypes() const
@@ -3475,13 +3731,15 @@ void Device::DestroyBorderColorPalette()
 }
 
 // =====================================================================================================================
-// Issue the software compositing and/or synchronization with the updated presenting queue
+// Issue the software compositing and/or synchronization with the updated presenting queue.  pSync holds the semaphores
+// of the intermediate image being copied to and is only used for non-presenting devices.
 Pal::IQueue* Device::PerformSwCompositing(
-    uint32_t         deviceIdx,
-    uint32_t         presentationDeviceIdx,
-    Pal::ICmdBuffer* pCommandBuffer,
-    Pal::QueueType   cmdBufferQueueType,
-    const Queue*     pQueue)
+    uint32_t                 deviceIdx,
+    uint32_t                 presentationDeviceIdx,
+    Pal::ICmdBuffer*         pCommandBuffer,
+    Pal::QueueType           cmdBufferQueueType,
+    const Queue*             pQueue,
+    const SwCompositingSync* pSync)
 {
     Pal::IQueue* pPresentQueue = nullptr;
     VkResult     result        = VK_SUCCESS;
@@ -3519,21 +3777,29 @@ Pal::IQueue* Device::PerformSwCompositing(
             submitInfo.pPerSubQueueInfo     = &perSubQueueInfo;
             submitInfo.perSubQueueInfoCount = 1;
 
-            // Use the separate SDMA queue and synchronize the slave device's queue with the peer transfer
+            VK_ASSERT(pSync != nullptr);
+
+            // Use the separate SDMA queue and synchronize the slave device's queue with the peer transfer, so the
+            // slave can start rendering its next frame while the copy is still in flight
             if (cmdBufferQueueType == Pal::QueueType::QueueTypeDma)
             {
                 pCompositingQueue = m_perGpu[deviceIdx].pSwCompositingQueue;
 
-                pRenderQueue->SignalQueueSemaphore(m_perGpu[deviceIdx].pSwCompositingSemaphore);
-                pCompositingQueue->WaitQueueSemaphore(m_perGpu[deviceIdx].pSwCompositingSemaphore);
+                pRenderQueue->SignalQueueSemaphore(pSync->pRenderDone);
+                pCompositingQueue->WaitQueueSemaphore(pSync->pRenderDone);
             }
 
             VK_ASSERT(cmdBufferQueueType == pCompositingQueue->Type());
             pCompositingQueue->Submit(submitInfo);
-        }
 
-        pCompositingQueue->SignalQueueSemaphore(m_perGpu[deviceIdx].pSwCompositingSemaphore);
-        pPresentQueue->WaitQueueSemaphore(m_perGpu[deviceIdx].pSwCompositingSemaphore);
+            pCompositingQueue->SignalQueueSemaphore(pSync->pCopyDone);
+            pPresentQueue->WaitQueueSemaphore(pSync->pCopyDone);
+        }
+        else
+        {
+            pCompositingQueue->SignalQueueSemaphore(m_perGpu[deviceIdx].pSwCompositingSemaphore);
+            pPresentQueue->WaitQueueSemaphore(m_perGpu[deviceIdx].pSwCompositingSemaphore);
+        }
     }
 
     return pPresentQueue;
@@ -3658,6 +3924,95 @@ void Device::ReleaseBorderColorIndex(
     m_pBorderColorUsedIndexes[borderColorIndex] = false;
 }
 
+// =====================================================================================================================
+// Adds a command buffer that owns a breadcrumb ring to the list reported by ReportBreadcrumbs()
+void Device::RegisterBreadcrumbs(
+    CmdBuffer* pCmdBuffer)
+{
+    BreadcrumbRing* pRing = pCmdBuffer->GetBreadcrumbRing();
+
+    MutexAuto lock(&m_breadcrumbLock);
+
+    pRing->pPrev = nullptr;
+    pRing->pNext = m_pBreadcrumbCmdBuffers;
+
+    if (m_pBreadcrumbCmdBuffers != nullptr)
+    {
+        m_pBreadcrumbCmdBuffers->GetBreadcrumbRing()->pPrev = pCmdBuffer;
+    }
+
+    m_pBreadcrumbCmdBuffers = pCmdBuffer;
+}
+
+// =====================================================================================================================
+void Device::UnregisterBreadcrumbs(
+    CmdBuffer* pCmdBuffer)
+{
+    BreadcrumbRing* pRing = pCmdBuffer->GetBreadcrumbRing();
+
+    MutexAuto lock(&m_breadcrumbLock);
+
+    if (pRing->pPrev != nullptr)
+    {
+        pRing->pPrev->GetBreadcrumbRing()->pNext = pRing->pNext;
+    }
+    else
+    {
+        VK_ASSERT(m_pBreadcrumbCmdBuffers == pCmdBuffer);
+
+        m_pBreadcrumbCmdBuffers = pRing->pNext;
+    }
+
+    if (pRing->pNext != nullptr)
+    {
+        pRing->pNext->GetBreadcrumbRing()->pPrev = pRing->pPrev;
+    }
+
+    pRing->pPrev = nullptr;
+    pRing->pNext = nullptr;
+}
+
+// =====================================================================================================================
+// Returns a new device-wide submission ID for command buffers with breadcrumbs (see CmdBuffer::MarkBreadcrumbSubmit).
+uint64 Device::NextBreadcrumbSubmitId()
+{
+    return Util::AtomicIncrement64(&m_nextBreadcrumbSubmitId);
+}
+
+// =====================================================================================================================
+// Appends the breadcrumbs of every command buffer whose last execution did not reach its final marker to a log file in
+// the BreadcrumbLogDirectory.  This is called when a device loss is detected, but may be called at any time to inspect
+// GPU progress.
+void Device::ReportBreadcrumbs()
+{
+    const char* pLogDir = m_settings.breadcrumbLogDirectory;
+
+    if (pLogDir[0] != '\0')
+    {
+        char fileName[Util::PathBufferLen];
+
+        Util::Snprintf(fileName, sizeof(fileName), "%s/Breadcrumbs_%p.txt", pLogDir, this);
+
+        Util::File file;
+
+        if (file.Open(fileName, Util::FileAccessAppend) == Pal::Result::Success)
+        {
+            MutexAuto lock(&m_breadcrumbLock);
+
+            file.Printf("Device %p lost\n", this);
+
+            for (CmdBuffer* pCmdBuffer = m_pBreadcrumbCmdBuffers;
+                 pCmdBuffer != nullptr;
+                 pCmdBuffer = pCmdBuffer->GetBreadcrumbRing()->pNext)
+            {
+                pCmdBuffer->ReportBreadcrumbs(&file, true);
+            }
+
+            file.Close();
+        }
+    }
+}
+
 // =====================================================================================================================
 bool Device::ReserveFastPrivateDataSlot(
         uint64*                         pIndex)
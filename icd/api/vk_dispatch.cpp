@@ -35,6 +35,7 @@
 #include "include/vk_buffer.h"
 #include "include/vk_buffer_view.h"
 #include "include/vk_cmdbuffer.h"
+#include "include/vk_deferred_operation.h"
 #include "include/vk_descriptor_pool.h"
 #include "include/vk_descriptor_set.h"
 #include "include/vk_descriptor_set_layout.h"
@@ -627,6 +628,36 @@ void DispatchTable::Init()
 
     INIT_DISPATCH_ENTRY(vkCmdSetColorWriteEnableEXT                     );
 
+    INIT_DISPATCH_ENTRY(vkCmdPushDescriptorSetKHR                       );
+    INIT_DISPATCH_ENTRY(vkCmdPushDescriptorSetWithTemplateKHR           );
+
+    INIT_DISPATCH_ENTRY(vkCmdDrawMultiEXT                               );
+    INIT_DISPATCH_ENTRY(vkCmdDrawMultiIndexedEXT                        );
+
+    INIT_DISPATCH_ENTRY(vkCreateDeferredOperationKHR                    );
+    INIT_DISPATCH_ENTRY(vkDestroyDeferredOperationKHR                   );
+    INIT_DISPATCH_ENTRY(vkGetDeferredOperationMaxConcurrencyKHR         );
+    INIT_DISPATCH_ENTRY(vkGetDeferredOperationResultKHR                 );
+    INIT_DISPATCH_ENTRY(vkDeferredOperationJoinKHR                      );
+
+    INIT_DISPATCH_ENTRY(vkCmdBeginRenderingKHR                          );
+    INIT_DISPATCH_ENTRY(vkCmdEndRenderingKHR                            );
+
+    INIT_DISPATCH_ENTRY(vkCmdSetPatchControlPointsEXT                   );
+    INIT_DISPATCH_ENTRY(vkCmdSetRasterizerDiscardEnableEXT              );
+    INIT_DISPATCH_ENTRY(vkCmdSetDepthBiasEnableEXT                      );
+    INIT_DISPATCH_ENTRY(vkCmdSetLogicOpEXT                              );
+    INIT_DISPATCH_ENTRY(vkCmdSetPrimitiveRestartEnableEXT               );
+
+    INIT_DISPATCH_ENTRY(vkGetShaderModuleIdentifierEXT                  );
+    INIT_DISPATCH_ENTRY(vkGetShaderModuleCreateInfoIdentifierEXT        );
+
+    INIT_DISPATCH_ENTRY(vkGetDeviceBufferMemoryRequirementsKHR          );
+    INIT_DISPATCH_ENTRY(vkGetDeviceImageMemoryRequirementsKHR           );
+    INIT_DISPATCH_ENTRY(vkGetDeviceImageSparseMemoryRequirementsKHR     );
+    INIT_DISPATCH_ENTRY(vkCreateHeadlessSurfaceEXT                      );
+    INIT_DISPATCH_ENTRY(vkWaitForPresentKHR                             );
+
 }
 
 // =====================================================================================================================
@@ -32,6 +32,8 @@
 #include "include/vk_instance.h"
 #include "include/vk_render_pass.h"
 
+#include "sqtt/sqtt_rgp_annotations.h"
+
 #include "palColorTargetView.h"
 #include "palDepthStencilView.h"
 #include "palVectorImpl.h"
@@ -134,7 +136,11 @@ Framebuffer::Framebuffer(const VkFramebufferCreateInfo& info,
                          Attachment*                    pAttachments,
                          const RuntimeSettings&         runTimeSettings)
         : m_attachmentCount (info.attachmentCount),
-		  m_settings(runTimeSettings)
+          m_settings(runTimeSettings),
+          m_imageless((info.flags & VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT) != 0),
+          m_pPrograms(nullptr),
+          m_programCount(0),
+          m_pRetiredPrograms(nullptr)
 {
     m_globalScissorParams.scissorRegion.offset.x      = 0;
     m_globalScissorParams.scissorRegion.offset.y      = 0;
@@ -147,18 +153,25 @@ Framebuffer::Framebuffer(const VkFramebufferCreateInfo& info,
 
     for (uint32_t i = 0; i < m_attachmentCount; ++i)
     {
-        const VkImageView& src        = info.pAttachments[i];
-        Attachment* pAttachment       = &pAttachments[i];
-        pAttachment->pView            = ImageView::ObjectFromHandle(info.pAttachments[i]);
-        pAttachment->pImage           = pAttachment->pView->GetImage();
-        pAttachment->viewFormat       = VkToPalFormat(pAttachment->pView->GetViewFormat(), m_settings);
-        pAttachment->zRange           = pAttachment->pView->GetZRange();
-        pAttachment->subresRangeCount = 0;
+        pAttachments[i] = ImageView::ObjectFromHandle(info.pAttachments[i])->GetFramebufferAttachment();
+    }
+}
 
-        const Image* pImage = pAttachment->pImage;
+// =====================================================================================================================
+// Fills in the cached attachment information for the given image view.  This is called once when the view is created;
+// framebuffers and dynamic rendering instances copy the result via ImageView::GetFramebufferAttachment().
+void Framebuffer::InitAttachment(
+    const ImageView*       pView,
+    const RuntimeSettings& settings,
+    Attachment*            pAttachment)
+{
+    pAttachment->pView            = pView;
+    pAttachment->pImage           = pView->GetImage();
+    pAttachment->viewFormat       = VkToPalFormat(pView->GetViewFormat(), settings);
+    pAttachment->zRange           = pView->GetZRange();
+    pAttachment->subresRangeCount = 0;
 
-        SetSubresRanges(pImage, pAttachment);
-    }
+    SetSubresRanges(pAttachment->pImage, pAttachment);
 }
 
 // =====================================================================================================================
@@ -167,6 +180,25 @@ VkResult Framebuffer::Destroy(
     Device*                         pDevice,
     const VkAllocationCallbacks*    pAllocator)
 {
+    while (m_pPrograms != nullptr)
+    {
+        RPInstanceProgram* pNext = m_pPrograms->pNext;
+
+        pDevice->VkInstance()->FreeMem(m_pPrograms);
+
+        m_pPrograms = pNext;
+    }
+
+    // Command buffers still referencing a retired program are invalidated along with the framebuffer
+    while (m_pRetiredPrograms != nullptr)
+    {
+        RPInstanceProgram* pNext = m_pRetiredPrograms->pNext;
+
+        pDevice->VkInstance()->FreeMem(m_pRetiredPrograms);
+
+        m_pRetiredPrograms = pNext;
+    }
+
     // Call destructor
     Util::Destructor(this);
 
@@ -178,23 +210,8 @@ VkResult Framebuffer::Destroy(
 }
 
 // =====================================================================================================================
-// Set ImageViews for a Framebuffer attachment
-void Framebuffer::SetImageViews(
-    const VkImageView& imageView,
-    Attachment*        pAttachments)
-{
-    pAttachments->pView  = ImageView::ObjectFromHandle(imageView);
-    pAttachments->zRange = pAttachments->pView->GetZRange();
-
-    const Image* pImage      = pAttachments->pView->GetImage();
-    pAttachments->pImage     = pImage;
-    pAttachments->viewFormat = VkToPalFormat(pImage->GetFormat(), m_settings);
-
-    SetSubresRanges(pImage, pAttachments);
-}
-
-// =====================================================================================================================
-// Set ImageViews for a Framebuffer attachment
+// Set ImageViews for the attachments of an imageless framebuffer.  The attachment information is precomputed by each
+// image view, so this is a plain copy.
 void Framebuffer::SetImageViews(
     const VkRenderPassAttachmentBeginInfo* pRenderPassAttachmentBeginInfo)
 {
@@ -202,9 +219,9 @@ void Framebuffer::SetImageViews(
 
     for (uint32_t i = 0; i < pRenderPassAttachmentBeginInfo->attachmentCount; i++)
     {
-        SetImageViews(
-            pRenderPassAttachmentBeginInfo->pAttachments[i],
-            &(pAttachments[i]));
+        const ImageView* pView = ImageView::ObjectFromHandle(pRenderPassAttachmentBeginInfo->pAttachments[i]);
+
+        pAttachments[i] = pView->GetFramebufferAttachment();
     }
 }
 
@@ -259,6 +276,457 @@ void Framebuffer::SetSubresRanges(
         pAttachment->subresRange[0].startSubres.mipLevel);
 }
 
+// =====================================================================================================================
+// Returns the sync point of a render pass with the given RPSyncPointIndex().
+static const RPSyncPointInfo& GetSyncPointInfo(
+    const RenderPassExecuteInfo& executeInfo,
+    uint32_t                     subpassCount,
+    uint32_t                     syncPointIndex)
+{
+    const RPSyncPointInfo* pSyncPoint = &executeInfo.end.syncEnd;
+
+    if (syncPointIndex < RPSyncPointIndex(subpassCount, RPSyncPointTop))
+    {
+        const RPExecuteSubpassInfo& subpass = executeInfo.pSubpasses[syncPointIndex / RPSyncPointSlotCount];
+
+        switch (syncPointIndex % RPSyncPointSlotCount)
+        {
+        case RPSyncPointTop:
+            pSyncPoint = &subpass.begin.syncTop;
+            break;
+        case RPSyncPointPreResolve:
+            pSyncPoint = &subpass.end.syncPreResolve;
+            break;
+        default:
+            pSyncPoint = &subpass.end.syncBottom;
+            break;
+        }
+    }
+
+    return *pSyncPoint;
+}
+
+// =====================================================================================================================
+// Folds the barrier of a sync point into the barrier of an earlier one executed with no work in between.  Fails if the
+// two transition the same image, which a single barrier can't express even when the attachments differ, or if the
+// pipe points don't fit.
+static bool MergeSyncPointPrograms(
+    RPSyncPointProgram* pDst,
+    RPSyncPointProgram* pSrc)
+{
+    bool canMerge = true;
+
+    for (uint32_t s = 0; (s < pSrc->barrier.transitionCount) && canMerge; ++s)
+    {
+        for (uint32_t d = 0; (d < pDst->barrier.transitionCount) && canMerge; ++d)
+        {
+            canMerge = (pSrc->ppImages[s] != pDst->ppImages[d]);
+        }
+    }
+
+    Pal::HwPipePoint pipePoints[MaxHwPipePoints];
+    uint32_t         pipePointCount = pDst->barrier.pipePointWaitCount;
+
+    memcpy(pipePoints, pDst->pipePoints, sizeof(pipePoints));
+
+    for (uint32_t i = 0; (i < pSrc->barrier.pipePointWaitCount) && canMerge; ++i)
+    {
+        const Pal::HwPipePoint point = pSrc->pipePoints[i];
+
+        bool seen = false;
+
+        for (uint32_t j = 0; (j < pipePointCount) && (seen == false); ++j)
+        {
+            seen = (pipePoints[j] == point);
+        }
+
+        if (seen == false)
+        {
+            if (pipePointCount < MaxHwPipePoints)
+            {
+                pipePoints[pipePointCount++] = point;
+            }
+            else
+            {
+                canMerge = false;
+            }
+        }
+    }
+
+    if (canMerge)
+    {
+        // The transitions of both sync points are adjacent in the program storage
+        VK_ASSERT((pSrc->barrier.transitionCount == 0) ||
+                  (pSrc->pTransitions == (pDst->pTransitions + pDst->barrier.transitionCount)));
+
+        memcpy(pDst->pipePoints, pipePoints, sizeof(pipePoints));
+
+        pDst->barrier.pipePointWaitCount  = pipePointCount;
+        pDst->barrier.waitPoint           = Util::Min(pDst->barrier.waitPoint, pSrc->barrier.waitPoint);
+        pDst->barrier.globalSrcCacheMask |= pSrc->barrier.globalSrcCacheMask;
+        pDst->barrier.globalDstCacheMask |= pSrc->barrier.globalDstCacheMask;
+        pDst->barrier.transitionCount    += pSrc->barrier.transitionCount;
+
+        pDst->flags.hasSamplePatterns |= pSrc->flags.hasSamplePatterns;
+        pDst->flags.discardsContents  |= pSrc->flags.discardsContents;
+
+        pSrc->barrier.transitionCount = 0;
+        pSrc->flags.u32All            = 0;
+        pSrc->flags.merged            = 1;
+    }
+
+    return canMerge;
+}
+
+// =====================================================================================================================
+// Resolves all sync points of a render pass instance against the attachments of this framebuffer: the layout
+// transitions each of them does are computed by walking the attachment layouts from their initial layouts, so that
+// replaying a sync point just issues a ready-made barrier.  Adjacent sync points without work in between are merged.
+RPInstanceProgram* Framebuffer::BuildRenderPassProgram(
+    const Device*     pDevice,
+    const RenderPass* pRenderPass,
+    uint32_t          queueFamilyIndex
+    ) const
+{
+    const RenderPassExecuteInfo& executeInfo     = *pRenderPass->GetExecuteInfo();
+    const uint32_t               subpassCount    = pRenderPass->GetSubpassCount();
+    const uint32_t               attachmentCount = pRenderPass->GetAttachmentCount();
+    const uint32_t               syncPointCount  = RPSyncPointIndex(subpassCount, RPSyncPointTop) + 1;
+
+    VK_ASSERT(attachmentCount == m_attachmentCount);
+
+    uint32_t maxTransitionCount = 0;
+
+    for (uint32_t i = 0; i < syncPointCount; ++i)
+    {
+        const RPSyncPointInfo& syncPoint = GetSyncPointInfo(executeInfo, subpassCount, i);
+
+        for (uint32_t t = 0; t < syncPoint.transitionCount; ++t)
+        {
+            maxTransitionCount += GetAttachment(syncPoint.pTransitions[t].attachment).subresRangeCount;
+        }
+    }
+
+    const size_t syncPointOffset  = Util::Pow2Align(sizeof(RPInstanceProgram), alignof(RPSyncPointProgram));
+    const size_t transitionOffset = Util::Pow2Align(syncPointOffset + (sizeof(RPSyncPointProgram) * syncPointCount),
+                                                    alignof(Pal::BarrierTransition));
+    const size_t imageOffset      = transitionOffset + (sizeof(Pal::BarrierTransition) * maxTransitionCount);
+    const size_t targetOffset     = imageOffset + (sizeof(const Image*) * maxTransitionCount);
+    const size_t layoutOffset     = Util::Pow2Align(targetOffset + (sizeof(RPTransitionTarget) * maxTransitionCount),
+                                                    alignof(Pal::ImageLayout));
+    const size_t programSize      = layoutOffset + (sizeof(Pal::ImageLayout) * Pal::MaxNumPlanes * attachmentCount);
+
+    // The current attachment layouts are only needed while building, but they are allocated along with the program.
+    void* pMemory = pDevice->VkInstance()->AllocMem(programSize, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+    RPInstanceProgram* pProgram = nullptr;
+
+    if (pMemory != nullptr)
+    {
+        memset(pMemory, 0, programSize);
+
+        pProgram = static_cast<RPInstanceProgram*>(pMemory);
+
+        pProgram->renderPassHash   = pRenderPass->GetHash();
+        pProgram->queueFamilyIndex = queueFamilyIndex;
+        pProgram->syncPointCount   = syncPointCount;
+        pProgram->pSyncPoints      = static_cast<RPSyncPointProgram*>(Util::VoidPtrInc(pMemory, syncPointOffset));
+
+        auto* const pTransitions = static_cast<Pal::BarrierTransition*>(Util::VoidPtrInc(pMemory, transitionOffset));
+        auto* const ppImages     = static_cast<const Image**>(Util::VoidPtrInc(pMemory, imageOffset));
+        auto* const pTargets     = static_cast<RPTransitionTarget*>(Util::VoidPtrInc(pMemory, targetOffset));
+        auto* const pLayouts     = static_cast<Pal::ImageLayout*>(Util::VoidPtrInc(pMemory, layoutOffset));
+
+        // Start from the initial layouts, the same way CmdBuffer::BeginRenderPass() does
+        for (uint32_t a = 0; a < attachmentCount; ++a)
+        {
+            const Attachment&            attachment = GetAttachment(a);
+            const AttachmentDescription& desc       = pRenderPass->GetAttachmentDesc(a);
+            const uint32_t               firstPlane = attachment.subresRange[0].startSubres.plane;
+            Pal::ImageLayout*            pLayout    = &pLayouts[a * Pal::MaxNumPlanes];
+
+            const RPImageLayout initialLayout = { desc.initialLayout, 0 };
+
+            if (attachment.pImage->IsDepthStencilFormat() == false)
+            {
+                pLayout[firstPlane] = attachment.pImage->GetAttachmentLayout(initialLayout,
+                                                                             firstPlane,
+                                                                             queueFamilyIndex);
+            }
+            else
+            {
+                const RPImageLayout initialStencilLayout = { desc.stencilInitialLayout, 0 };
+
+                pLayout[0] = attachment.pImage->GetAttachmentLayout(initialLayout, 0, queueFamilyIndex);
+                pLayout[1] = attachment.pImage->GetAttachmentLayout(initialStencilLayout, 1, queueFamilyIndex);
+            }
+        }
+
+        RPSyncPointProgram* pMergeTarget    = nullptr;
+        uint32_t            transitionCount = 0;
+
+        for (uint32_t i = 0; i < syncPointCount; ++i)
+        {
+            const RPSyncPointInfo& syncPoint = GetSyncPointInfo(executeInfo, subpassCount, i);
+            RPSyncPointProgram*    pSync     = &pProgram->pSyncPoints[i];
+            const uint32_t         subpass   = Util::Min(i / RPSyncPointSlotCount, subpassCount - 1);
+
+            pSync->barrier.reason      = RgpBarrierExternalRenderPassSync;
+            pSync->barrier.pPipePoints = pSync->pipePoints;
+            pSync->pTransitions        = &pTransitions[transitionCount];
+            pSync->ppImages            = &ppImages[transitionCount];
+            pSync->pTargets            = &pTargets[transitionCount];
+
+            if (syncPoint.flags.active)
+            {
+                const RPBarrierInfo& rpBarrier = syncPoint.barrier;
+
+                pSync->barrier.waitPoint          = rpBarrier.waitPoint;
+                pSync->barrier.pipePointWaitCount = rpBarrier.pipePointCount;
+
+                memcpy(pSync->pipePoints, rpBarrier.pipePoints, sizeof(pSync->pipePoints));
+
+                if (rpBarrier.flags.needsGlobalTransition)
+                {
+                    pSync->barrier.globalSrcCacheMask = rpBarrier.globalSrcCacheMask;
+                    pSync->barrier.globalDstCacheMask = rpBarrier.globalDstCacheMask;
+                }
+
+                for (uint32_t t = 0; t < syncPoint.transitionCount; ++t)
+                {
+                    const RPTransitionInfo& tr         = syncPoint.pTransitions[t];
+                    const Attachment&       attachment = GetAttachment(tr.attachment);
+
+                    for (uint32_t sr = 0; sr < attachment.subresRangeCount; ++sr)
+                    {
+                        const uint32_t plane = attachment.subresRange[sr].startSubres.plane;
+
+                        const RPImageLayout nextLayout = (plane == 1) ? tr.nextStencilLayout : tr.nextLayout;
+
+                        const Pal::ImageLayout newLayout = attachment.pImage->GetAttachmentLayout(
+                            nextLayout,
+                            plane,
+                            queueFamilyIndex);
+
+                        Pal::ImageLayout* pOldLayout = &pLayouts[(tr.attachment * Pal::MaxNumPlanes) + plane];
+
+                        if ((pOldLayout->usages & Pal::LayoutUninitializedTarget) != 0)
+                        {
+                            pSync->flags.discardsContents = 1;
+                        }
+
+                        if ((pOldLayout->usages  != newLayout.usages) ||
+                            (pOldLayout->engines != newLayout.engines))
+                        {
+                            const uint32_t idx = pSync->barrier.transitionCount++;
+
+                            VK_ASSERT((transitionCount + idx) < maxTransitionCount);
+
+                            Pal::BarrierTransition* pLayoutTransition = &pSync->pTransitions[idx];
+                            RPTransitionTarget*     pTarget           = &pSync->pTargets[idx];
+
+                            pSync->ppImages[idx] = attachment.pImage;
+
+                            pLayoutTransition->imageInfo.pImage      = attachment.pImage->PalImage(DefaultDeviceIndex);
+                            pLayoutTransition->imageInfo.oldLayout   = *pOldLayout;
+                            pLayoutTransition->imageInfo.newLayout   = newLayout;
+                            pLayoutTransition->imageInfo.subresRange = attachment.subresRange[sr];
+
+                            pTarget->attachment          = tr.attachment;
+                            pTarget->plane               = plane;
+                            pTarget->subpass             = subpass;
+                            pTarget->samplePatternSource = RPSamplePatternNone;
+
+                            if (attachment.pImage->GetImageSamples() > 1)
+                            {
+                                pTarget->samplePatternSource = (attachment.pImage->IsSampleLocationsCompatibleDepth() &&
+                                                                tr.flags.isInitialLayoutTransition) ?
+                                                               RPSamplePatternInitial : RPSamplePatternSubpass;
+
+                                pSync->flags.hasSamplePatterns = 1;
+                            }
+
+                            *pOldLayout = newLayout;
+                        }
+                    }
+                }
+
+                pSync->barrier.pTransitions = pSync->pTransitions;
+
+                // Same test as CmdBuffer::RPSyncPoint() uses to skip barriers that don't do anything
+                pSync->flags.execute = (pSync->barrier.waitPoint != Pal::HwPipeBottom) ||
+                                       (pSync->barrier.transitionCount > 0) ||
+                                       (pSync->barrier.pipePointWaitCount > 1) ||
+                                       ((pSync->barrier.pipePointWaitCount == 1) &&
+                                        (pSync->pipePoints[0] != Pal::HwPipeTop));
+
+                transitionCount += pSync->barrier.transitionCount;
+            }
+
+            if (pSync->flags.execute)
+            {
+                if ((pMergeTarget == nullptr) || (MergeSyncPointPrograms(pMergeTarget, pSync) == false))
+                {
+                    pMergeTarget = pSync;
+                }
+            }
+
+            // Subpass contents follow the top sync point and resolves may follow the pre-resolve one, so neither can
+            // be merged with the next sync point.
+            const uint32_t slot = i % RPSyncPointSlotCount;
+
+            if ((i < RPSyncPointIndex(subpassCount, RPSyncPointTop)) &&
+                ((slot == RPSyncPointTop) ||
+                 ((slot == RPSyncPointPreResolve) && (executeInfo.pSubpasses[subpass].end.resolveCount > 0))))
+            {
+                pMergeTarget = nullptr;
+            }
+        }
+    }
+
+    return pProgram;
+}
+
+// =====================================================================================================================
+// Returns the sync points of the given render pass precompiled for this framebuffer, building them on first use.  The
+// least recently used program is evicted once MaxRenderPassPrograms are kept.  A returned program is referenced until
+// ReleaseRenderPassProgram() is called.  Returns nullptr if the render pass instance has to execute its sync points
+// dynamically.
+const RPInstanceProgram* Framebuffer::GetRenderPassProgram(
+    const Device*     pDevice,
+    const RenderPass* pRenderPass,
+    uint32_t          queueFamilyIndex)
+{
+    RPInstanceProgram* pProgram = nullptr;
+
+    // The attachments of an imageless framebuffer may change with every render pass instance
+    if (m_settings.renderPassPrecompiledSyncPoints && (m_imageless == false))
+    {
+        const uint64_t renderPassHash = pRenderPass->GetHash();
+        const uint32_t syncPointCount = RPSyncPointIndex(pRenderPass->GetSubpassCount(), RPSyncPointTop) + 1;
+
+        Util::MutexAuto lock(&m_programLock);
+
+        RPInstanceProgram** ppLink = &m_pPrograms;
+
+        while (((*ppLink) != nullptr) &&
+               (((*ppLink)->renderPassHash   != renderPassHash)   ||
+                ((*ppLink)->queueFamilyIndex != queueFamilyIndex) ||
+                ((*ppLink)->syncPointCount   != syncPointCount)))
+        {
+            ppLink = &(*ppLink)->pNext;
+        }
+
+        pProgram = *ppLink;
+
+        if (pProgram != nullptr)
+        {
+            // Move the program to the front of the list
+            *ppLink = pProgram->pNext;
+        }
+        else
+        {
+            if (m_programCount == MaxRenderPassPrograms)
+            {
+                EvictRenderPassProgram(pDevice);
+            }
+
+            pProgram = BuildRenderPassProgram(pDevice, pRenderPass, queueFamilyIndex);
+
+            if (pProgram != nullptr)
+            {
+                m_programCount++;
+            }
+        }
+
+        if (pProgram != nullptr)
+        {
+            pProgram->refCount++;
+            pProgram->pNext = m_pPrograms;
+            m_pPrograms     = pProgram;
+        }
+    }
+
+    return pProgram;
+}
+
+// =====================================================================================================================
+// Removes the least recently used program.  It is freed right away unless a render pass instance is still being
+// recorded with it, in which case it is retired until the last reference is released.  Must be called with
+// m_programLock held.
+void Framebuffer::EvictRenderPassProgram(
+    const Device* pDevice)
+{
+    RPInstanceProgram** ppLink = &m_pPrograms;
+
+    while (((*ppLink) != nullptr) && ((*ppLink)->pNext != nullptr))
+    {
+        ppLink = &(*ppLink)->pNext;
+    }
+
+    RPInstanceProgram* pProgram = *ppLink;
+
+    if (pProgram != nullptr)
+    {
+        *ppLink = nullptr;
+        m_programCount--;
+
+        if (pProgram->refCount == 0)
+        {
+            pDevice->VkInstance()->FreeMem(pProgram);
+        }
+        else
+        {
+            pProgram->pNext    = m_pRetiredPrograms;
+            m_pRetiredPrograms = pProgram;
+        }
+    }
+}
+
+// =====================================================================================================================
+// Drops a reference taken by GetRenderPassProgram() at the end of a render pass instance, freeing the program if it was
+// evicted in the meantime.
+void Framebuffer::ReleaseRenderPassProgram(
+    const Device*            pDevice,
+    const RPInstanceProgram* pProgram)
+{
+    Util::MutexAuto lock(&m_programLock);
+
+    RPInstanceProgram* pLive = m_pPrograms;
+
+    while ((pLive != nullptr) && (pLive != pProgram))
+    {
+        pLive = pLive->pNext;
+    }
+
+    if (pLive != nullptr)
+    {
+        VK_ASSERT(pLive->refCount > 0);
+
+        pLive->refCount--;
+    }
+    else
+    {
+        RPInstanceProgram** ppLink = &m_pRetiredPrograms;
+
+        while (((*ppLink) != nullptr) && ((*ppLink) != pProgram))
+        {
+            ppLink = &(*ppLink)->pNext;
+        }
+
+        RPInstanceProgram* pRetired = *ppLink;
+
+        VK_ASSERT((pRetired != nullptr) && (pRetired->refCount > 0));
+
+        if ((pRetired != nullptr) && (--pRetired->refCount == 0))
+        {
+            *ppLink = pRetired->pNext;
+
+            pDevice->VkInstance()->FreeMem(pRetired);
+        }
+    }
+}
+
 namespace entry
 {
 
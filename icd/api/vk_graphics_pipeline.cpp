@@ -27,6 +27,7 @@
 #include "include/vk_conv.h"
 #include "include/vk_device.h"
 #include "include/vk_graphics_pipeline.h"
+#include "include/vk_graphics_pipeline_library.h"
 #include "include/vk_instance.h"
 #include "include/vk_memory.h"
 #include "include/vk_pipeline_cache.h"
@@ -50,6 +51,19 @@ using namespace Util;
 namespace vk
 {
 
+// =====================================================================================================================
+// Returns true if the pipeline statically discards all primitives before rasterization.  If rasterizer discard enable
+// is dynamic, the pipeline is built with rasterization enabled and all post-rasterization state must be honored.
+static bool IsRasterizationDisabled(
+    const VkGraphicsPipelineCreateInfo* pCreateInfo,
+    uint32_t                            staticStateMask)
+{
+    const uint32_t discardMask = 1 << static_cast<uint32_t>(DynamicStatesInternal::RasterizerDiscardEnableExt);
+
+    return (pCreateInfo->pRasterizationState->rasterizerDiscardEnable == VK_TRUE) &&
+           ((staticStateMask & discardMask) != 0);
+}
+
 // =====================================================================================================================
 // Generates a hash using the contents of a VkPipelineVertexInputStateCreateInfo struct
 // Pipeline compilation affected by:
@@ -442,7 +456,7 @@ void GraphicsPipeline::GenerateHashFromColorBlendStateCreateInfo(
 //     - pCreateInfo->pMultisampleState
 //     - pCreateInfo->pColorBlendState
 //     - pCreateInfo->layout
-//     - pCreateInfo->renderPass
+//     - pCreateInfo->renderPass (or VkPipelineRenderingCreateInfoKHR without one)
 //     - pCreateInfo->subpass
 uint64_t GraphicsPipeline::BuildApiHash(
     const VkGraphicsPipelineCreateInfo* pCreateInfo,
@@ -452,7 +466,12 @@ uint64_t GraphicsPipeline::BuildApiHash(
     Util::MetroHash128 baseHasher;
     Util::MetroHash128 apiHasher;
 
-    baseHasher.Update(pCreateInfo->flags);
+    const bool rasterizationDisabled = IsRasterizationDisabled(pCreateInfo, pInfo->staticStateMask);
+
+    // Flags which only control how the pipeline is created are left out of the base hash, so that a pipeline created
+    // from shader module identifiers matches the earlier creation from the modules themselves.
+    baseHasher.Update(PipelineCompiler::GetCacheIdControlFlags(pCreateInfo->flags));
+    apiHasher.Update(pCreateInfo->flags);
     baseHasher.Update(pCreateInfo->stageCount);
 
     for (uint32_t i = 0; i < pCreateInfo->stageCount; i++)
@@ -476,7 +495,7 @@ uint64_t GraphicsPipeline::BuildApiHash(
         GenerateHashFromTessellationStateCreateInfo(&baseHasher, *pCreateInfo->pTessellationState);
     }
 
-    if ((pCreateInfo->pRasterizationState->rasterizerDiscardEnable != VK_TRUE) && (pCreateInfo->pViewportState != nullptr))
+    if ((rasterizationDisabled == false) && (pCreateInfo->pViewportState != nullptr))
     {
         GenerateHashFromViewportStateCreateInfo(&apiHasher, *pCreateInfo->pViewportState, pInfo->staticStateMask);
     }
@@ -486,17 +505,17 @@ uint64_t GraphicsPipeline::BuildApiHash(
         GenerateHashFromRasterizationStateCreateInfo(&baseHasher, &apiHasher, *pCreateInfo->pRasterizationState);
     }
 
-    if ((pCreateInfo->pRasterizationState->rasterizerDiscardEnable != VK_TRUE) && (pCreateInfo->pMultisampleState != nullptr))
+    if ((rasterizationDisabled == false) && (pCreateInfo->pMultisampleState != nullptr))
     {
         GenerateHashFromMultisampleStateCreateInfo(&baseHasher, &apiHasher, *pCreateInfo->pMultisampleState);
     }
 
-    if ((pCreateInfo->pRasterizationState->rasterizerDiscardEnable != VK_TRUE) && (pCreateInfo->pDepthStencilState != nullptr))
+    if ((rasterizationDisabled == false) && (pCreateInfo->pDepthStencilState != nullptr))
     {
         GenerateHashFromDepthStencilStateCreateInfo(&apiHasher, *pCreateInfo->pDepthStencilState);
     }
 
-    if ((pCreateInfo->pRasterizationState->rasterizerDiscardEnable != VK_TRUE) && (pCreateInfo->pColorBlendState != nullptr))
+    if ((rasterizationDisabled == false) && (pCreateInfo->pColorBlendState != nullptr))
     {
         GenerateHashFromColorBlendStateCreateInfo(&baseHasher, &apiHasher, *pCreateInfo->pColorBlendState);
     }
@@ -512,6 +531,27 @@ uint64_t GraphicsPipeline::BuildApiHash(
     {
         baseHasher.Update(RenderPass::ObjectFromHandle(pCreateInfo->renderPass)->GetHash());
     }
+    else
+    {
+        const VkPipelineRenderingCreateInfoKHR* pPipelineRenderingCreateInfo =
+            utils::GetExtensionStructure<VkPipelineRenderingCreateInfoKHR>(
+                pCreateInfo,
+                VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR);
+
+        if (pPipelineRenderingCreateInfo != nullptr)
+        {
+            baseHasher.Update(pPipelineRenderingCreateInfo->viewMask);
+            baseHasher.Update(pPipelineRenderingCreateInfo->colorAttachmentCount);
+
+            for (uint32_t i = 0; i < pPipelineRenderingCreateInfo->colorAttachmentCount; ++i)
+            {
+                baseHasher.Update(pPipelineRenderingCreateInfo->pColorAttachmentFormats[i]);
+            }
+
+            baseHasher.Update(pPipelineRenderingCreateInfo->depthAttachmentFormat);
+            baseHasher.Update(pPipelineRenderingCreateInfo->stencilAttachmentFormat);
+        }
+    }
 
     baseHasher.Update(pCreateInfo->subpass);
 
@@ -649,7 +689,11 @@ void GraphicsPipeline::BuildRasterizationState(
     pInfo->immedInfo.depthBiasParams.depthBiasClamp             = pIn->depthBiasClamp;
     pInfo->immedInfo.depthBiasParams.slopeScaledDepthBias       = pIn->depthBiasSlopeFactor;
 
-    if (pIn->depthBiasEnable && (dynamicStateFlags[VK_DYNAMIC_STATE_DEPTH_BIAS] == false))
+    // The depth bias parameters are needed whenever depth bias may be enabled, including through dynamic state
+    const bool depthBiasMayBeEnabled = pIn->depthBiasEnable ||
+        dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::DepthBiasEnableExt)];
+
+    if (depthBiasMayBeEnabled && (dynamicStateFlags[VK_DYNAMIC_STATE_DEPTH_BIAS] == false))
     {
         pInfo->staticStateMask |= 1 << VK_DYNAMIC_STATE_DEPTH_BIAS;
     }
@@ -826,7 +870,8 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
         pIn,
         GRAPHICS_PIPELINE_CREATE_INFO)
 
-    const RenderPass* pRenderPass = nullptr;
+    const RenderPass*                       pRenderPass                  = nullptr;
+    const VkPipelineRenderingCreateInfoKHR* pPipelineRenderingCreateInfo = nullptr;
 
     // Set the states which are allowed to call CmdSetxxx outside of the PSO
     bool dynamicStateFlags[uint32_t(DynamicStatesInternal::DynamicStatesInternalCount)];
@@ -844,6 +889,14 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
 
         pRenderPass = RenderPass::ObjectFromHandle(pGraphicsPipelineCreateInfo->renderPass);
 
+        // Without a render pass the pipeline is used with dynamic rendering, which provides the attachment formats
+        if (pRenderPass == nullptr)
+        {
+            pPipelineRenderingCreateInfo = utils::GetExtensionStructure<VkPipelineRenderingCreateInfoKHR>(
+                pGraphicsPipelineCreateInfo,
+                VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR);
+        }
+
         if (pGraphicsPipelineCreateInfo->layout != VK_NULL_HANDLE)
         {
             pInfo->pLayout = PipelineLayout::ObjectFromHandle(pGraphicsPipelineCreateInfo->layout);
@@ -946,6 +999,25 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
                     case  VK_DYNAMIC_STATE_COLOR_WRITE_ENABLE_EXT:
                         dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::ColorWriteEnableExt)] = true;
                         break;
+                    case  VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT:
+                        dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::RasterizerDiscardEnableExt)]
+                            = true;
+                        break;
+                    case  VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT:
+                        dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::DepthBiasEnableExt)] = true;
+                        break;
+                    case  VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT:
+                        dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::PrimitiveRestartEnableExt)]
+                            = true;
+                        break;
+
+                    case  VK_DYNAMIC_STATE_LOGIC_OP_EXT:
+                    case  VK_DYNAMIC_STATE_PATCH_CONTROL_POINTS_EXT:
+                    case  VK_DYNAMIC_STATE_VERTEX_INPUT_EXT:
+                        // extendedDynamicState2LogicOp, extendedDynamicState2PatchControlPoints and
+                        // VK_EXT_vertex_input_dynamic_state are not supported, so the state stays static.
+                        VK_NEVER_CALLED();
+                        break;
 
                     default:
                         // skip unknown dynamic state
@@ -1014,6 +1086,21 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
             pInfo->staticStateMask |= 1 << static_cast<uint32_t>(DynamicStatesInternal::ColorWriteEnableExt);
         }
 
+        if (dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::RasterizerDiscardEnableExt)] == false)
+        {
+            pInfo->staticStateMask |= 1 << static_cast<uint32_t>(DynamicStatesInternal::RasterizerDiscardEnableExt);
+        }
+
+        if (dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::DepthBiasEnableExt)] == false)
+        {
+            pInfo->staticStateMask |= 1 << static_cast<uint32_t>(DynamicStatesInternal::DepthBiasEnableExt);
+        }
+
+        if (dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::PrimitiveRestartEnableExt)] == false)
+        {
+            pInfo->staticStateMask |= 1 << static_cast<uint32_t>(DynamicStatesInternal::PrimitiveRestartEnableExt);
+        }
+
         pInfo->bindDepthStencilObject =
             !(dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::StencilOpExt)] ||
               dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::StencilTestEnableExt)] ||
@@ -1024,7 +1111,8 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
 
         pInfo->bindTriangleRasterState =
             !(dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::CullModeExt)] ||
-              dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::FrontFaceExt)]);
+              dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::FrontFaceExt)] ||
+              dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::DepthBiasEnableExt)]);
 
         pInfo->bindStencilRefMasks =
             !(dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::StencilCompareMask)] ||
@@ -1032,13 +1120,16 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
               dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::StencilReference)]);
 
         pInfo->bindInputAssemblyState =
-            !dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::PrimitiveTopologyExt)];
+            !(dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::PrimitiveTopologyExt)] ||
+              dynamicStateFlags[static_cast<uint32_t>(DynamicStatesInternal::PrimitiveRestartEnableExt)]);
+
+        const bool rasterizationDisabled = IsRasterizationDisabled(pGraphicsPipelineCreateInfo, pInfo->staticStateMask);
 
         const VkPipelineViewportStateCreateInfo* pVp = pGraphicsPipelineCreateInfo->pViewportState;
 
         pInfo->pipeline.viewportInfo.depthRange = Pal::DepthRange::ZeroToOne;
 
-        if ((pIn->pRasterizationState->rasterizerDiscardEnable != VK_TRUE) && (pVp != nullptr))
+        if ((rasterizationDisabled == false) && (pVp != nullptr))
         {
             const VkPipelineMultisampleStateCreateInfo* pMs = pGraphicsPipelineCreateInfo->pMultisampleState;
 
@@ -1156,7 +1247,7 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
 
         const VkPipelineMultisampleStateCreateInfo* pMs = pGraphicsPipelineCreateInfo->pMultisampleState;
 
-        if ((pIn->pRasterizationState->rasterizerDiscardEnable != VK_TRUE) && (pMs != nullptr))
+        if ((rasterizationDisabled == false) && (pMs != nullptr))
         {
             // Sample Locations
             EXTRACT_VK_STRUCTURES_1(
@@ -1267,7 +1358,7 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
         bool blendingEnabled = false;
         bool dualSourceBlend = false;
 
-        if ((pIn->pRasterizationState->rasterizerDiscardEnable == VK_TRUE) || (pCb == nullptr))
+        if (rasterizationDisabled || (pCb == nullptr))
         {
             pInfo->pipeline.cbState.logicOp = Pal::LogicOp::Copy;
         }
@@ -1319,6 +1410,12 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
                     cbFormat[i] = pRenderPass->GetColorAttachmentFormat(pGraphicsPipelineCreateInfo->subpass, i);
                     pCbDst->swizzledFormat = VkToPalFormat(cbFormat[i], pDevice->GetRuntimeSettings());
                 }
+                else if ((pPipelineRenderingCreateInfo != nullptr) &&
+                         (i < pPipelineRenderingCreateInfo->colorAttachmentCount))
+                {
+                    cbFormat[i] = pPipelineRenderingCreateInfo->pColorAttachmentFormats[i];
+                    pCbDst->swizzledFormat = VkToPalFormat(cbFormat[i], pDevice->GetRuntimeSettings());
+                }
 
                 // If the sub pass attachment format is UNDEFINED, then it means that that subpass does not
                 // want to write to any attachment for that output (VK_ATTACHMENT_UNUSED).  Under such cases,
@@ -1374,6 +1471,12 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
         {
             dbFormat = pRenderPass->GetDepthStencilAttachmentFormat(pGraphicsPipelineCreateInfo->subpass);
         }
+        else if (pPipelineRenderingCreateInfo != nullptr)
+        {
+            dbFormat = (pPipelineRenderingCreateInfo->depthAttachmentFormat != VK_FORMAT_UNDEFINED) ?
+                       pPipelineRenderingCreateInfo->depthAttachmentFormat :
+                       pPipelineRenderingCreateInfo->stencilAttachmentFormat;
+        }
 
         // If the sub pass attachment format is UNDEFINED, then it means that that subpass does not
         // want to write any depth-stencil data (VK_ATTACHMENT_UNUSED).  Under such cases, I think we have to
@@ -1422,7 +1525,7 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
             pInfo->immedInfo.depthStencilCreateInfo.stencilEnable     = false;
         }
 
-        if ((pIn->pRasterizationState->rasterizerDiscardEnable != VK_TRUE) && (pDs != nullptr))
+        if ((rasterizationDisabled == false) && (pDs != nullptr))
         {
             pInfo->immedInfo.depthStencilCreateInfo.front.stencilFailOp      = VkToPalStencilOp(pDs->front.failOp);
             pInfo->immedInfo.depthStencilCreateInfo.front.stencilPassOp      = VkToPalStencilOp(pDs->front.passOp);
@@ -1450,7 +1553,9 @@ void GraphicsPipeline::ConvertGraphicsPipelineInfo(
         pInfo->pipeline.viewInstancingDesc = Pal::ViewInstancingDescriptor { };
 
         if (((pRenderPass != nullptr) &&
-             pRenderPass->IsMultiviewEnabled())
+             pRenderPass->IsMultiviewEnabled()) ||
+            ((pPipelineRenderingCreateInfo != nullptr) &&
+             (pPipelineRenderingCreateInfo->viewMask != 0))
             )
         {
             pInfo->pipeline.viewInstancingDesc.viewInstanceCount = Pal::MaxViewInstanceCount;
@@ -1473,8 +1578,23 @@ VkResult GraphicsPipeline::Create(
     const VkAllocationCallbacks*            pAllocator,
     VkPipeline*                             pPipeline)
 {
+    if ((pCreateInfo->flags & VK_PIPELINE_CREATE_LIBRARY_BIT_KHR) != 0)
+    {
+        return GraphicsPipelineLibrary::Create(pDevice, pPipelineCache, pCreateInfo, pAllocator, pPipeline);
+    }
+
     uint64 startTime = vk::utils::GetTimeNano();
 
+    // A pipeline linked from libraries is built from the state gathered from them exactly as if it had been specified
+    // directly, so that it shares cache entries with the equivalent monolithic pipeline.  The shader parts compiled
+    // when the libraries were created are picked up from the compiler's shader cache.
+    GraphicsPipelineLinkInfo linkInfo;
+
+    if (GraphicsPipelineLibrary::BuildLinkInfo(pCreateInfo, &linkInfo))
+    {
+        pCreateInfo = &linkInfo.createInfo;
+    }
+
     // Parse the create info and build patched AMDIL shaders
     CreateInfo                  localPipelineInfo                  = {};
     VbBindingInfo               vbInfo                             = {};
@@ -1510,7 +1630,9 @@ VkResult GraphicsPipeline::Create(
 
     const uint32_t numPalDevices = pDevice->NumPalDevices();
 
-    uint64_t pipelineHash = Vkgc::IPipelineDumper::GetPipelineHash(&binaryCreateInfo.pipelineInfo);
+    // The LLPC pipeline hash needs module data, which stages given by module identifiers don't have
+    uint64_t pipelineHash = binaryCreateInfo.usesModuleIdentifiers ?
+        apiPsoHash : Vkgc::IPipelineDumper::GetPipelineHash(&binaryCreateInfo.pipelineInfo);
     for (uint32_t i = 0; (result == VK_SUCCESS) && (i < numPalDevices)
         ; ++i)
     {
@@ -1533,6 +1655,8 @@ VkResult GraphicsPipeline::Create(
             pDefaultCompiler->ConvertGraphicsPipelineInfo(
                     pDevice, pCreateInfo, &binaryCreateInfoMGPU, &vbInfoMGPU, nullptr);
 
+            binaryCreateInfoMGPU.basePipelineHash = binaryCreateInfo.basePipelineHash;
+
             result = pDevice->GetCompiler(i)->CreateGraphicsPipelineBinary(
                 pDevice,
                 i,
@@ -1666,7 +1790,8 @@ VkResult GraphicsPipeline::Create(
 
                 // Force full sample shading if the app didn't enable it, but the shader wants
                 // per-sample shading by the use of SampleId or similar features.
-                if ((pCreateInfo->pRasterizationState->rasterizerDiscardEnable != VK_TRUE) && (pMs != nullptr) &&
+                if ((IsRasterizationDisabled(pCreateInfo, localPipelineInfo.staticStateMask) == false) &&
+                    (pMs != nullptr) &&
                     (pMs->sampleShadingEnable == false))
                 {
                     const auto& info = pPalPipeline[deviceIdx]->GetInfo();
@@ -2135,7 +2260,17 @@ void GraphicsPipeline::BindToCmdBuffer(
         pRenderState->triangleRasterState.frontFillMode   = m_info.triangleRasterState.frontFillMode;
         pRenderState->triangleRasterState.backFillMode    = m_info.triangleRasterState.backFillMode;
         pRenderState->triangleRasterState.provokingVertex = m_info.triangleRasterState.provokingVertex;
-        pRenderState->triangleRasterState.flags.u32All    = m_info.triangleRasterState.flags.u32All;
+        if (ContainsStaticState(DynamicStatesInternal::DepthBiasEnableExt))
+        {
+            pRenderState->triangleRasterState.flags.u32All = m_info.triangleRasterState.flags.u32All;
+        }
+        else
+        {
+            const uint32_t depthBiasEnable = pRenderState->triangleRasterState.flags.depthBiasEnable;
+
+            pRenderState->triangleRasterState.flags.u32All          = m_info.triangleRasterState.flags.u32All;
+            pRenderState->triangleRasterState.flags.depthBiasEnable = depthBiasEnable;
+        }
 
         if (ContainsStaticState(DynamicStatesInternal::FrontFaceExt))
         {
@@ -2195,11 +2330,19 @@ void GraphicsPipeline::BindToCmdBuffer(
     if (m_flags.bindInputAssemblyState == false)
     {
         // Update the static states to renderState
-        pRenderState->inputAssemblyState.primitiveRestartIndex =
-            m_info.inputAssemblyState.primitiveRestartIndex;
+        if (ContainsStaticState(DynamicStatesInternal::PrimitiveRestartEnableExt))
+        {
+            pRenderState->inputAssemblyState.primitiveRestartIndex =
+                m_info.inputAssemblyState.primitiveRestartIndex;
+
+            pRenderState->inputAssemblyState.primitiveRestartEnable =
+                m_info.inputAssemblyState.primitiveRestartEnable;
+        }
 
-        pRenderState->inputAssemblyState.primitiveRestartEnable =
-            m_info.inputAssemblyState.primitiveRestartEnable;
+        if (ContainsStaticState(DynamicStatesInternal::PrimitiveTopologyExt))
+        {
+            pRenderState->inputAssemblyState.topology = m_info.inputAssemblyState.topology;
+        }
 
         pRenderState->dirty.inputAssembly = 1;
     }
@@ -2208,6 +2351,15 @@ void GraphicsPipeline::BindToCmdBuffer(
         pRenderState->inputAssemblyState = m_info.inputAssemblyState;
     }
 
+    // A pipeline with static rasterizer discard state applies it through its own registers, so any dynamic discard
+    // emulation set up for a previous pipeline has to be dropped.
+    if (ContainsStaticState(DynamicStatesInternal::RasterizerDiscardEnableExt) &&
+        pRenderState->rasterizerDiscardEnable)
+    {
+        pRenderState->rasterizerDiscardEnable = false;
+        pRenderState->dirty.scissor           = 1;
+    }
+
     const uint64_t oldHash = pRenderState->boundGraphicsPipelineHash;
     const uint64_t newHash = PalPipelineHash();
 
@@ -0,0 +1,897 @@
+/*
+ ***********************************************************************************************************************
+ *
+ *  Copyright (c) 2021 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ **********************************************************************************************************************/
+
+#include "include/vk_graphics_pipeline_library.h"
+#include "include/pipeline_compiler.h"
+#include "include/vk_device.h"
+#include "include/vk_pipeline_layout.h"
+#include "include/vk_render_pass.h"
+#include "include/vk_shader.h"
+#include "include/vk_utils.h"
+
+#include "palInlineFuncs.h"
+
+#include <string.h>
+
+namespace vk
+{
+
+// =====================================================================================================================
+// Helper which lays out copies of Vulkan structures in a single block of memory.  When constructed without memory it
+// only measures the space required, so the same copy routine is run twice: once to size the allocation and once to
+// fill it.
+class StructCopier
+{
+public:
+    explicit StructCopier(void* pMemory)
+        :
+        m_pMemory(pMemory),
+        m_size(0)
+    {
+    }
+
+    // Copies count elements of pSrc and returns the location of the copy, or nullptr while measuring.
+    template<typename T>
+    T* Copy(const T* pSrc, size_t count = 1)
+    {
+        T* pDst = nullptr;
+
+        if ((pSrc != nullptr) && (count > 0))
+        {
+            m_size = Util::Pow2Align(m_size, alignof(T));
+
+            if (m_pMemory != nullptr)
+            {
+                pDst = static_cast<T*>(Util::VoidPtrInc(m_pMemory, m_size));
+                memcpy(pDst, pSrc, sizeof(T) * count);
+            }
+
+            m_size += sizeof(T) * count;
+        }
+
+        return pDst;
+    }
+
+    const char* CopyString(const char* pSrc)
+    {
+        return (pSrc != nullptr) ? Copy(pSrc, strlen(pSrc) + 1) : nullptr;
+    }
+
+    size_t Size() const { return m_size; }
+
+private:
+    void*  m_pMemory;
+    size_t m_size;
+};
+
+// =====================================================================================================================
+// Copies a structure without any array members, attaching the given (already copied) pNext chain.
+template<typename T>
+static const T* CopyStruct(
+    StructCopier* pCopier,
+    const void*   pSrc,
+    const void*   pNext)
+{
+    T copy     = *static_cast<const T*>(pSrc);
+    copy.pNext = pNext;
+
+    return pCopier->Copy(&copy);
+}
+
+// =====================================================================================================================
+// Copies the extension structures of a pipeline create info chain that graphics pipeline creation consumes.  Any other
+// structure is dropped from the copy.
+static const void* CopyNextChain(
+    StructCopier* pCopier,
+    const void*   pNext)
+{
+    const VkStructHeader* pHeader = static_cast<const VkStructHeader*>(pNext);
+    const void*           pCopy   = nullptr;
+
+    if (pHeader != nullptr)
+    {
+        const void* pNextCopy = CopyNextChain(pCopier, pHeader->pNext);
+
+        switch (static_cast<uint32_t>(pHeader->sType))
+        {
+        case VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_DIVISOR_STATE_CREATE_INFO_EXT:
+        {
+            VkPipelineVertexInputDivisorStateCreateInfoEXT info =
+                *reinterpret_cast<const VkPipelineVertexInputDivisorStateCreateInfoEXT*>(pHeader);
+
+            info.pNext                  = pNextCopy;
+            info.pVertexBindingDivisors = pCopier->Copy(info.pVertexBindingDivisors, info.vertexBindingDivisorCount);
+
+            pCopy = pCopier->Copy(&info);
+            break;
+        }
+        case VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_DOMAIN_ORIGIN_STATE_CREATE_INFO:
+            pCopy = CopyStruct<VkPipelineTessellationDomainOriginStateCreateInfo>(pCopier, pHeader, pNextCopy);
+            break;
+        case VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_CONSERVATIVE_STATE_CREATE_INFO_EXT:
+            pCopy = CopyStruct<VkPipelineRasterizationConservativeStateCreateInfoEXT>(pCopier, pHeader, pNextCopy);
+            break;
+        case VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_RASTERIZATION_ORDER_AMD:
+            pCopy = CopyStruct<VkPipelineRasterizationStateRasterizationOrderAMD>(pCopier, pHeader, pNextCopy);
+            break;
+        case VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_STREAM_CREATE_INFO_EXT:
+            pCopy = CopyStruct<VkPipelineRasterizationStateStreamCreateInfoEXT>(pCopier, pHeader, pNextCopy);
+            break;
+        case VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_DEPTH_CLIP_STATE_CREATE_INFO_EXT:
+            pCopy = CopyStruct<VkPipelineRasterizationDepthClipStateCreateInfoEXT>(pCopier, pHeader, pNextCopy);
+            break;
+        case VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_LINE_STATE_CREATE_INFO_EXT:
+            pCopy = CopyStruct<VkPipelineRasterizationLineStateCreateInfoEXT>(pCopier, pHeader, pNextCopy);
+            break;
+        case VK_STRUCTURE_TYPE_PIPELINE_SAMPLE_LOCATIONS_STATE_CREATE_INFO_EXT:
+        {
+            VkPipelineSampleLocationsStateCreateInfoEXT info =
+                *reinterpret_cast<const VkPipelineSampleLocationsStateCreateInfoEXT*>(pHeader);
+
+            info.pNext                                = pNextCopy;
+            info.sampleLocationsInfo.pNext            = nullptr;
+            info.sampleLocationsInfo.pSampleLocations = pCopier->Copy(info.sampleLocationsInfo.pSampleLocations,
+                                                                      info.sampleLocationsInfo.sampleLocationsCount);
+
+            pCopy = pCopier->Copy(&info);
+            break;
+        }
+        case VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_ADVANCED_STATE_CREATE_INFO_EXT:
+            pCopy = CopyStruct<VkPipelineColorBlendAdvancedStateCreateInfoEXT>(pCopier, pHeader, pNextCopy);
+            break;
+        case VK_STRUCTURE_TYPE_PIPELINE_COLOR_WRITE_CREATE_INFO_EXT:
+        {
+            VkPipelineColorWriteCreateInfoEXT info =
+                *reinterpret_cast<const VkPipelineColorWriteCreateInfoEXT*>(pHeader);
+
+            info.pNext              = pNextCopy;
+            info.pColorWriteEnables = pCopier->Copy(info.pColorWriteEnables, info.attachmentCount);
+
+            pCopy = pCopier->Copy(&info);
+            break;
+        }
+        case VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR:
+        {
+            VkPipelineRenderingCreateInfoKHR info = *reinterpret_cast<const VkPipelineRenderingCreateInfoKHR*>(pHeader);
+
+            info.pNext                   = pNextCopy;
+            info.pColorAttachmentFormats = pCopier->Copy(info.pColorAttachmentFormats, info.colorAttachmentCount);
+
+            pCopy = pCopier->Copy(&info);
+            break;
+        }
+        case VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO:
+        {
+            // A shader module create info chained to a stage in place of a module
+            VkShaderModuleCreateInfo info = *reinterpret_cast<const VkShaderModuleCreateInfo*>(pHeader);
+
+            info.pNext = pNextCopy;
+            info.pCode = pCopier->Copy(info.pCode, info.codeSize / sizeof(uint32_t));
+
+            pCopy = pCopier->Copy(&info);
+            break;
+        }
+        case VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_MODULE_IDENTIFIER_CREATE_INFO_EXT:
+        {
+            VkPipelineShaderStageModuleIdentifierCreateInfoEXT info =
+                *reinterpret_cast<const VkPipelineShaderStageModuleIdentifierCreateInfoEXT*>(pHeader);
+
+            info.pNext       = pNextCopy;
+            info.pIdentifier = pCopier->Copy(info.pIdentifier, info.identifierSize);
+
+            pCopy = pCopier->Copy(&info);
+            break;
+        }
+        default:
+            pCopy = pNextCopy;
+            break;
+        }
+    }
+
+    return pCopy;
+}
+
+// =====================================================================================================================
+// Returns true if the given state is listed in the dynamic state create info.
+static bool IsDynamicStateEnabled(
+    const VkPipelineDynamicStateCreateInfo* pDynamicState,
+    VkDynamicState                          state)
+{
+    bool enabled = false;
+
+    if (pDynamicState != nullptr)
+    {
+        for (uint32_t i = 0; (i < pDynamicState->dynamicStateCount) && (enabled == false); ++i)
+        {
+            enabled = (pDynamicState->pDynamicStates[i] == state);
+        }
+    }
+
+    return enabled;
+}
+
+// =====================================================================================================================
+// Returns the graphics pipeline library part a shader stage belongs to.
+static VkGraphicsPipelineLibraryFlagsEXT GetStageLibraryFlag(
+    VkShaderStageFlagBits stage)
+{
+    return (stage == VK_SHADER_STAGE_FRAGMENT_BIT) ? VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT
+                                                   : VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+}
+
+// =====================================================================================================================
+// Returns the library parts described directly by a graphics pipeline create info (i.e. not through libraries).
+static VkGraphicsPipelineLibraryFlagsEXT GetCreateInfoLibraryFlags(
+    const VkGraphicsPipelineCreateInfo* pCreateInfo)
+{
+    const auto* pGraphicsLibraryInfo = utils::GetExtensionStructure<VkGraphicsPipelineLibraryCreateInfoEXT>(
+        pCreateInfo, static_cast<VkStructureType>(VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT));
+    const auto* pLibraryInfo         = utils::GetExtensionStructure<VkPipelineLibraryCreateInfoKHR>(
+        pCreateInfo, VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR);
+
+    VkGraphicsPipelineLibraryFlagsEXT flags = GraphicsPipelineLibraryAll;
+
+    if (pGraphicsLibraryInfo != nullptr)
+    {
+        flags = pGraphicsLibraryInfo->flags;
+    }
+    else if (((pCreateInfo->flags & VK_PIPELINE_CREATE_LIBRARY_BIT_KHR) != 0) ||
+             ((pLibraryInfo != nullptr) && (pLibraryInfo->libraryCount > 0)))
+    {
+        // Without VkGraphicsPipelineLibraryCreateInfoEXT a library or a link doesn't describe any state of its own
+        flags = 0;
+    }
+
+    return flags;
+}
+
+// =====================================================================================================================
+// Deep copies a shader stage.  Module handles are copied as is and are replaced by the caller.
+static VkPipelineShaderStageCreateInfo CopyShaderStage(
+    StructCopier*                          pCopier,
+    const VkPipelineShaderStageCreateInfo& src)
+{
+    VkPipelineShaderStageCreateInfo stage = src;
+
+    stage.pNext = CopyNextChain(pCopier, src.pNext);
+    stage.pName = pCopier->CopyString(src.pName);
+
+    if (src.pSpecializationInfo != nullptr)
+    {
+        VkSpecializationInfo specInfo = *src.pSpecializationInfo;
+
+        specInfo.pMapEntries = pCopier->Copy(specInfo.pMapEntries, specInfo.mapEntryCount);
+        specInfo.pData       = pCopier->Copy(static_cast<const uint8_t*>(specInfo.pData), specInfo.dataSize);
+
+        stage.pSpecializationInfo = pCopier->Copy(&specInfo);
+    }
+
+    return stage;
+}
+
+// =====================================================================================================================
+// Deep copies the members of a graphics pipeline create info that belong to the given library parts.
+static void CopyCreateInfo(
+    StructCopier*                       pCopier,
+    const VkGraphicsPipelineCreateInfo& src,
+    VkGraphicsPipelineLibraryFlagsEXT   libraryFlags,
+    VkGraphicsPipelineCreateInfo*       pDst)
+{
+    memset(pDst, 0, sizeof(*pDst));
+
+    pDst->sType              = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pDst->pNext              = CopyNextChain(pCopier, src.pNext);
+    pDst->flags              = src.flags;
+    pDst->layout             = src.layout;
+    pDst->renderPass         = src.renderPass;
+    pDst->subpass            = src.subpass;
+    pDst->basePipelineHandle = VK_NULL_HANDLE;
+    pDst->basePipelineIndex  = -1;
+
+    VkPipelineShaderStageCreateInfo stages[ShaderStage::ShaderStageGfxCount] = {};
+    VkShaderStageFlags              stageMask                                = 0;
+
+    for (uint32_t i = 0; i < src.stageCount; ++i)
+    {
+        if ((GetStageLibraryFlag(src.pStages[i].stage) & libraryFlags) != 0)
+        {
+            VK_ASSERT(pDst->stageCount < ShaderStage::ShaderStageGfxCount);
+
+            stages[pDst->stageCount++] = CopyShaderStage(pCopier, src.pStages[i]);
+            stageMask                 |= src.pStages[i].stage;
+        }
+    }
+
+    pDst->pStages = pCopier->Copy(stages, pDst->stageCount);
+
+    if ((libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT) != 0)
+    {
+        if (src.pVertexInputState != nullptr)
+        {
+            VkPipelineVertexInputStateCreateInfo info = *src.pVertexInputState;
+
+            info.pNext                        = CopyNextChain(pCopier, info.pNext);
+            info.pVertexBindingDescriptions   = pCopier->Copy(info.pVertexBindingDescriptions,
+                                                              info.vertexBindingDescriptionCount);
+            info.pVertexAttributeDescriptions = pCopier->Copy(info.pVertexAttributeDescriptions,
+                                                              info.vertexAttributeDescriptionCount);
+
+            pDst->pVertexInputState = pCopier->Copy(&info);
+        }
+
+        if (src.pInputAssemblyState != nullptr)
+        {
+            pDst->pInputAssemblyState = CopyStruct<VkPipelineInputAssemblyStateCreateInfo>(
+                pCopier, src.pInputAssemblyState, CopyNextChain(pCopier, src.pInputAssemblyState->pNext));
+        }
+    }
+
+    if ((libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT) != 0)
+    {
+        bool rasterizerDiscard = false;
+
+        if (src.pRasterizationState != nullptr)
+        {
+            pDst->pRasterizationState = CopyStruct<VkPipelineRasterizationStateCreateInfo>(
+                pCopier, src.pRasterizationState, CopyNextChain(pCopier, src.pRasterizationState->pNext));
+
+            rasterizerDiscard = (src.pRasterizationState->rasterizerDiscardEnable == VK_TRUE) &&
+                (IsDynamicStateEnabled(src.pDynamicState, VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT) == false);
+        }
+
+        // Tessellation state is ignored, and may be invalid, without tessellation shaders
+        if ((src.pTessellationState != nullptr) &&
+            ((stageMask & (VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT)) != 0))
+        {
+            pDst->pTessellationState = CopyStruct<VkPipelineTessellationStateCreateInfo>(
+                pCopier, src.pTessellationState, CopyNextChain(pCopier, src.pTessellationState->pNext));
+        }
+
+        // Likewise viewport state is ignored when rasterization is statically disabled, and the viewport and scissor
+        // arrays are ignored when they are dynamic.
+        if ((src.pViewportState != nullptr) && (rasterizerDiscard == false))
+        {
+            VkPipelineViewportStateCreateInfo info = *src.pViewportState;
+
+            const bool dynamicViewports =
+                IsDynamicStateEnabled(src.pDynamicState, VK_DYNAMIC_STATE_VIEWPORT) ||
+                IsDynamicStateEnabled(src.pDynamicState, VK_DYNAMIC_STATE_VIEWPORT_WITH_COUNT_EXT);
+            const bool dynamicScissors  =
+                IsDynamicStateEnabled(src.pDynamicState, VK_DYNAMIC_STATE_SCISSOR) ||
+                IsDynamicStateEnabled(src.pDynamicState, VK_DYNAMIC_STATE_SCISSOR_WITH_COUNT_EXT);
+
+            info.pNext      = CopyNextChain(pCopier, info.pNext);
+            info.pViewports = dynamicViewports ? nullptr : pCopier->Copy(info.pViewports, info.viewportCount);
+            info.pScissors  = dynamicScissors  ? nullptr : pCopier->Copy(info.pScissors, info.scissorCount);
+
+            pDst->pViewportState = pCopier->Copy(&info);
+        }
+    }
+
+    if ((libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT) != 0)
+    {
+        if (src.pDepthStencilState != nullptr)
+        {
+            pDst->pDepthStencilState = CopyStruct<VkPipelineDepthStencilStateCreateInfo>(
+                pCopier, src.pDepthStencilState, CopyNextChain(pCopier, src.pDepthStencilState->pNext));
+        }
+    }
+
+    if ((libraryFlags & (VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT |
+                         VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT)) != 0)
+    {
+        if (src.pMultisampleState != nullptr)
+        {
+            VkPipelineMultisampleStateCreateInfo info = *src.pMultisampleState;
+
+            info.pNext       = CopyNextChain(pCopier, info.pNext);
+            info.pSampleMask = pCopier->Copy(info.pSampleMask, (info.rasterizationSamples + 31) / 32);
+
+            pDst->pMultisampleState = pCopier->Copy(&info);
+        }
+    }
+
+    if ((libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT) != 0)
+    {
+        if (src.pColorBlendState != nullptr)
+        {
+            VkPipelineColorBlendStateCreateInfo info = *src.pColorBlendState;
+
+            info.pNext        = CopyNextChain(pCopier, info.pNext);
+            info.pAttachments = pCopier->Copy(info.pAttachments, info.attachmentCount);
+
+            pDst->pColorBlendState = pCopier->Copy(&info);
+        }
+    }
+
+    if (src.pDynamicState != nullptr)
+    {
+        VkPipelineDynamicStateCreateInfo info = *src.pDynamicState;
+
+        info.pNext          = nullptr;
+        info.pDynamicStates = pCopier->Copy(info.pDynamicStates, info.dynamicStateCount);
+
+        pDst->pDynamicState = pCopier->Copy(&info);
+    }
+}
+
+// =====================================================================================================================
+// Adds the members of a create info that belong to the given library parts to the link info.
+static void MergeLibraryParts(
+    const VkGraphicsPipelineCreateInfo& src,
+    VkGraphicsPipelineLibraryFlagsEXT   libraryFlags,
+    GraphicsPipelineLinkInfo*           pLinkInfo)
+{
+    VkGraphicsPipelineCreateInfo* pCreateInfo = &pLinkInfo->createInfo;
+
+    for (uint32_t i = 0; i < src.stageCount; ++i)
+    {
+        if ((GetStageLibraryFlag(src.pStages[i].stage) & libraryFlags) != 0)
+        {
+            VK_ASSERT(pCreateInfo->stageCount < ShaderStage::ShaderStageGfxCount);
+
+            pLinkInfo->stages[pCreateInfo->stageCount++] = src.pStages[i];
+        }
+    }
+
+    if ((libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT) != 0)
+    {
+        pCreateInfo->pVertexInputState   = src.pVertexInputState;
+        pCreateInfo->pInputAssemblyState = src.pInputAssemblyState;
+    }
+
+    if ((libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT) != 0)
+    {
+        pCreateInfo->pTessellationState  = src.pTessellationState;
+        pCreateInfo->pViewportState      = src.pViewportState;
+        pCreateInfo->pRasterizationState = src.pRasterizationState;
+    }
+
+    if ((libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT) != 0)
+    {
+        pCreateInfo->pDepthStencilState = src.pDepthStencilState;
+
+        if (pCreateInfo->pMultisampleState == nullptr)
+        {
+            pCreateInfo->pMultisampleState = src.pMultisampleState;
+        }
+    }
+
+    if ((libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT) != 0)
+    {
+        pCreateInfo->pColorBlendState = src.pColorBlendState;
+
+        // The fragment output interface's multisample state takes precedence over the fragment shader's copy
+        if (src.pMultisampleState != nullptr)
+        {
+            pCreateInfo->pMultisampleState = src.pMultisampleState;
+        }
+    }
+
+    if (libraryFlags != 0)
+    {
+        if ((pCreateInfo->layout == VK_NULL_HANDLE) &&
+            ((libraryFlags & (VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT |
+                              VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT)) != 0))
+        {
+            pCreateInfo->layout = src.layout;
+        }
+
+        if ((pCreateInfo->renderPass == VK_NULL_HANDLE) && (src.renderPass != VK_NULL_HANDLE))
+        {
+            pCreateInfo->renderPass = src.renderPass;
+            pCreateInfo->subpass    = src.subpass;
+        }
+
+        const auto* pRenderingInfo = utils::GetExtensionStructure<VkPipelineRenderingCreateInfoKHR>(
+            &src, VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR);
+
+        if (pRenderingInfo != nullptr)
+        {
+            VkPipelineRenderingCreateInfoKHR* pDstRenderingInfo = &pLinkInfo->renderingInfo;
+
+            pDstRenderingInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+
+            if ((libraryFlags & (VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT |
+                                 VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT)) != 0)
+            {
+                pDstRenderingInfo->viewMask = pRenderingInfo->viewMask;
+            }
+
+            if ((libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT) != 0)
+            {
+                pDstRenderingInfo->colorAttachmentCount    = pRenderingInfo->colorAttachmentCount;
+                pDstRenderingInfo->pColorAttachmentFormats = pRenderingInfo->pColorAttachmentFormats;
+                pDstRenderingInfo->depthAttachmentFormat   = pRenderingInfo->depthAttachmentFormat;
+                pDstRenderingInfo->stencilAttachmentFormat = pRenderingInfo->stencilAttachmentFormat;
+            }
+        }
+
+        // Dynamic states of all parts are combined
+        if (src.pDynamicState != nullptr)
+        {
+            for (uint32_t i = 0; i < src.pDynamicState->dynamicStateCount; ++i)
+            {
+                const VkDynamicState state = src.pDynamicState->pDynamicStates[i];
+
+                if ((IsDynamicStateEnabled(&pLinkInfo->dynamicState, state) == false) &&
+                    (pLinkInfo->dynamicState.dynamicStateCount < VK_ARRAY_SIZE(pLinkInfo->dynamicStates)))
+                {
+                    pLinkInfo->dynamicStates[pLinkInfo->dynamicState.dynamicStateCount++] = state;
+                }
+            }
+        }
+    }
+
+    pLinkInfo->libraryFlags |= libraryFlags;
+}
+
+// =====================================================================================================================
+// Assembles the complete create info of a graphics pipeline created with VkPipelineLibraryCreateInfoKHR.  Returns false
+// if the create info doesn't reference any libraries, in which case pLinkInfo is left untouched.
+bool GraphicsPipelineLibrary::BuildLinkInfo(
+    const VkGraphicsPipelineCreateInfo* pCreateInfo,
+    GraphicsPipelineLinkInfo*           pLinkInfo)
+{
+    const auto* pLibraryInfo = utils::GetExtensionStructure<VkPipelineLibraryCreateInfoKHR>(
+        pCreateInfo, VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR);
+
+    const bool linked = (pLibraryInfo != nullptr) && (pLibraryInfo->libraryCount > 0);
+
+    if (linked)
+    {
+        memset(pLinkInfo, 0, sizeof(*pLinkInfo));
+
+        VkGraphicsPipelineCreateInfo* pLinkCreateInfo = &pLinkInfo->createInfo;
+
+        pLinkCreateInfo->sType              = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pLinkCreateInfo->flags              = pCreateInfo->flags;
+        pLinkCreateInfo->pStages            = pLinkInfo->stages;
+        pLinkCreateInfo->layout             = pCreateInfo->layout;
+        pLinkCreateInfo->renderPass         = pCreateInfo->renderPass;
+        pLinkCreateInfo->subpass            = pCreateInfo->subpass;
+        pLinkCreateInfo->basePipelineHandle = pCreateInfo->basePipelineHandle;
+        pLinkCreateInfo->basePipelineIndex  = pCreateInfo->basePipelineIndex;
+
+        pLinkInfo->dynamicState.sType          = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        pLinkInfo->dynamicState.pDynamicStates = pLinkInfo->dynamicStates;
+
+        MergeLibraryParts(*pCreateInfo, GetCreateInfoLibraryFlags(pCreateInfo), pLinkInfo);
+
+        for (uint32_t i = 0; i < pLibraryInfo->libraryCount; ++i)
+        {
+            const GraphicsPipelineLibrary* pLibrary = GraphicsPipelineLibrary::ObjectFromHandle(
+                pLibraryInfo->pLibraries[i]);
+
+            MergeLibraryParts(pLibrary->GetCreateInfo(), pLibrary->GetLibraryFlags(), pLinkInfo);
+        }
+
+        if (pLinkInfo->dynamicState.dynamicStateCount > 0)
+        {
+            pLinkCreateInfo->pDynamicState = &pLinkInfo->dynamicState;
+        }
+
+        if (pLinkInfo->renderingInfo.sType == VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR)
+        {
+            pLinkCreateInfo->pNext = &pLinkInfo->renderingInfo;
+        }
+
+        // Stage feedback is written to scratch storage as the application only sized its array for the stages it
+        // passed in directly.
+        const auto* pFeedbackInfo = utils::GetExtensionStructure<VkPipelineCreationFeedbackCreateInfoEXT>(
+            pCreateInfo, VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT);
+
+        if (pFeedbackInfo != nullptr)
+        {
+            pLinkInfo->feedbackInfo                                    = *pFeedbackInfo;
+            pLinkInfo->feedbackInfo.pNext                              = pLinkCreateInfo->pNext;
+            pLinkInfo->feedbackInfo.pipelineStageCreationFeedbackCount = pLinkCreateInfo->stageCount;
+            pLinkInfo->feedbackInfo.pPipelineStageCreationFeedbacks    = pLinkInfo->stageFeedback;
+
+            pLinkCreateInfo->pNext = &pLinkInfo->feedbackInfo;
+        }
+    }
+
+    return linked;
+}
+
+// =====================================================================================================================
+// Compiles the shader parts (pre-rasterization and fragment shaders) held by a library ahead of any link.  LLPC keeps
+// the fragment and non-fragment halves of a graphics pipeline as separate shader cache entries and merges the cached
+// halves when a pipeline is built, so that a link only compiles the halves that haven't been built before.  State of
+// the parts outside the library is given neutral defaults; a half whose cache entry doesn't match the state it is
+// linked with is compiled again by the link.
+static void CompileLibraryParts(
+    Device*                             pDevice,
+    PipelineCache*                      pPipelineCache,
+    const VkGraphicsPipelineCreateInfo& createInfo)
+{
+    static constexpr VkGraphicsPipelineLibraryFlagsEXT ShaderParts[] =
+    {
+        VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT
+    };
+
+    VkPipelineInputAssemblyStateCreateInfo defaultInputAssembly = {};
+
+    defaultInputAssembly.sType    = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    defaultInputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineRasterizationStateCreateInfo defaultRasterization = {};
+
+    defaultRasterization.sType       = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    defaultRasterization.polygonMode = VK_POLYGON_MODE_FILL;
+    defaultRasterization.cullMode    = VK_CULL_MODE_NONE;
+    defaultRasterization.frontFace   = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    defaultRasterization.lineWidth   = 1.0f;
+
+    PipelineCompiler* pDefaultCompiler = pDevice->GetCompiler(DefaultDeviceIndex);
+
+    for (uint32_t part = 0; (part < VK_ARRAY_SIZE(ShaderParts)) && (createInfo.layout != VK_NULL_HANDLE); ++part)
+    {
+        VkPipelineShaderStageCreateInfo stages[ShaderStage::ShaderStageGfxCount];
+        VkGraphicsPipelineCreateInfo    partInfo = createInfo;
+
+        partInfo.flags     &= ~VK_PIPELINE_CREATE_LIBRARY_BIT_KHR;
+        partInfo.stageCount = 0;
+        partInfo.pStages    = stages;
+
+        for (uint32_t i = 0; i < createInfo.stageCount; ++i)
+        {
+            if (GetStageLibraryFlag(createInfo.pStages[i].stage) == ShaderParts[part])
+            {
+                stages[partInfo.stageCount++] = createInfo.pStages[i];
+            }
+        }
+
+        if (partInfo.stageCount > 0)
+        {
+            if (partInfo.pInputAssemblyState == nullptr)
+            {
+                partInfo.pInputAssemblyState = &defaultInputAssembly;
+            }
+
+            if (partInfo.pRasterizationState == nullptr)
+            {
+                partInfo.pRasterizationState = &defaultRasterization;
+            }
+
+            GraphicsPipelineCreateInfo binaryCreateInfo = {};
+            VbBindingInfo              vbInfo           = {};
+
+            VkResult result = pDefaultCompiler->ConvertGraphicsPipelineInfo(
+                pDevice, &partInfo, &binaryCreateInfo, &vbInfo, nullptr);
+
+            // A part that fails to compile here is left for the link to compile and report
+            for (uint32_t deviceIdx = 0; (result == VK_SUCCESS) && (deviceIdx < pDevice->NumPalDevices()); ++deviceIdx)
+            {
+                result = pDevice->GetCompiler(deviceIdx)->BuildGraphicsPipelinePart(
+                    pDevice, deviceIdx, pPipelineCache, &binaryCreateInfo);
+            }
+
+            pDefaultCompiler->FreeGraphicsPipelineCreateInfo(&binaryCreateInfo);
+        }
+    }
+}
+
+// =====================================================================================================================
+// Create a graphics pipeline library object.
+VkResult GraphicsPipelineLibrary::Create(
+    Device*                                 pDevice,
+    PipelineCache*                          pPipelineCache,
+    const VkGraphicsPipelineCreateInfo*     pCreateInfo,
+    const VkAllocationCallbacks*            pAllocator,
+    VkPipeline*                             pPipeline)
+{
+    uint64 startTime = vk::utils::GetTimeNano();
+
+    // A library may itself include other libraries, in which case their parts are folded into this one
+    GraphicsPipelineLinkInfo            linkInfo;
+    const VkGraphicsPipelineCreateInfo* pLibraryCreateInfo = pCreateInfo;
+    VkGraphicsPipelineLibraryFlagsEXT   libraryFlags       = GetCreateInfoLibraryFlags(pCreateInfo);
+
+    if (BuildLinkInfo(pCreateInfo, &linkInfo))
+    {
+        pLibraryCreateInfo = &linkInfo.createInfo;
+        libraryFlags       = linkInfo.libraryFlags;
+    }
+
+    VkResult result = VK_SUCCESS;
+
+    // Measure the copy of the create info, which is stored right after the object
+    StructCopier                 sizer(nullptr);
+    VkGraphicsPipelineCreateInfo sizerCreateInfo;
+
+    CopyCreateInfo(&sizer, *pLibraryCreateInfo, libraryFlags, &sizerCreateInfo);
+
+    const size_t objSize = Util::Pow2Align(sizeof(GraphicsPipelineLibrary), VK_DEFAULT_MEM_ALIGN);
+
+    void* pSystemMem = pDevice->AllocApiObject(pAllocator, objSize + sizer.Size());
+
+    if (pSystemMem == nullptr)
+    {
+        result = VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    if (result == VK_SUCCESS)
+    {
+        VK_PLACEMENT_NEW(pSystemMem) GraphicsPipelineLibrary(pDevice, libraryFlags);
+
+        GraphicsPipelineLibrary* pLibrary = static_cast<GraphicsPipelineLibrary*>(pSystemMem);
+
+        StructCopier copier(Util::VoidPtrInc(pSystemMem, objSize));
+
+        CopyCreateInfo(&copier, *pLibraryCreateInfo, libraryFlags, &pLibrary->m_createInfo);
+
+        VK_ASSERT(copier.Size() == sizer.Size());
+
+        // The layout and render pass are copied too, as the application may destroy its own objects as soon as the
+        // library has been created
+        if (pLibrary->m_createInfo.layout != VK_NULL_HANDLE)
+        {
+            result = PipelineLayout::ObjectFromHandle(pLibrary->m_createInfo.layout)->Clone(
+                pDevice, pAllocator, &pLibrary->m_layout);
+
+            pLibrary->m_createInfo.layout = pLibrary->m_layout;
+        }
+
+        if ((result == VK_SUCCESS) && (pLibrary->m_createInfo.renderPass != VK_NULL_HANDLE))
+        {
+            result = RenderPass::ObjectFromHandle(pLibrary->m_createInfo.renderPass)->Clone(
+                pDevice, pAllocator, &pLibrary->m_renderPass);
+
+            pLibrary->m_createInfo.renderPass = pLibrary->m_renderPass;
+        }
+
+        // Translate the SPIR-V of each stage now, ahead of compiling the parts below
+        VkPipelineShaderStageCreateInfo* pStages =
+            const_cast<VkPipelineShaderStageCreateInfo*>(pLibrary->m_createInfo.pStages);
+
+        for (uint32_t i = 0; (i < pLibrary->m_createInfo.stageCount) && (result == VK_SUCCESS); ++i)
+        {
+            VkShaderModuleCreateInfo moduleCreateInfo = {};
+
+            moduleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+
+            const auto* pInlineModule = utils::GetExtensionStructure<VkShaderModuleCreateInfo>(
+                &pStages[i], VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO);
+
+            if (pStages[i].module != VK_NULL_HANDLE)
+            {
+                const ShaderModule* pModule = ShaderModule::ObjectFromHandle(pStages[i].module);
+
+                moduleCreateInfo.codeSize = pModule->GetCodeSize();
+                moduleCreateInfo.pCode    = static_cast<const uint32_t*>(pModule->GetCode());
+            }
+            else if (pInlineModule != nullptr)
+            {
+                moduleCreateInfo.codeSize = pInlineModule->codeSize;
+                moduleCreateInfo.pCode    = pInlineModule->pCode;
+            }
+            else
+            {
+                // The stage is given only by a shader module identifier, which stays in the copied chain and is
+                // resolved against the pipeline cache when the library is linked.  An identifier that this driver
+                // can't have produced can never match a cached pipeline, and no later stage may clear that result.
+                ShaderModuleIdentifier identifier = {};
+
+                if (ShaderModule::GetStageIdentifier(pStages[i], &identifier) == false)
+                {
+                    result = VK_PIPELINE_COMPILE_REQUIRED_EXT;
+
+                    break;
+                }
+
+                continue;
+            }
+
+            result = ShaderModule::Create(pDevice, &moduleCreateInfo, pAllocator, &pLibrary->m_shaderModules[i]);
+
+            pStages[i].module = pLibrary->m_shaderModules[i];
+        }
+
+        if ((result == VK_SUCCESS) &&
+            ((pCreateInfo->flags & VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_EXT) == 0))
+        {
+            CompileLibraryParts(pDevice, pPipelineCache, pLibrary->m_createInfo);
+        }
+
+        if (result == VK_SUCCESS)
+        {
+            *pPipeline = GraphicsPipelineLibrary::HandleFromVoidPointer(pSystemMem);
+        }
+        else
+        {
+            pLibrary->Destroy(pDevice, pAllocator);
+        }
+    }
+
+    if (result == VK_SUCCESS)
+    {
+        const auto* pFeedbackInfo = utils::GetExtensionStructure<VkPipelineCreationFeedbackCreateInfoEXT>(
+            pCreateInfo, VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT);
+
+        if (pFeedbackInfo != nullptr)
+        {
+            PipelineCreationFeedback feedback = {};
+
+            feedback.feedbackValid = true;
+            feedback.duration      = vk::utils::GetTimeNano() - startTime;
+
+            pDevice->GetCompiler(DefaultDeviceIndex)->UpdatePipelineCreationFeedback(
+                pFeedbackInfo->pPipelineCreationFeedback, &feedback);
+
+            for (uint32_t i = 0; i < pFeedbackInfo->pipelineStageCreationFeedbackCount; ++i)
+            {
+                pFeedbackInfo->pPipelineStageCreationFeedbacks[i].flags    = 0;
+                pFeedbackInfo->pPipelineStageCreationFeedbacks[i].duration = 0;
+            }
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+GraphicsPipelineLibrary::GraphicsPipelineLibrary(
+    Device*                             pDevice,
+    VkGraphicsPipelineLibraryFlagsEXT   libraryFlags)
+    :
+    Pipeline(pDevice, VK_PIPELINE_BIND_POINT_GRAPHICS),
+    m_libraryFlags(libraryFlags),
+    m_createInfo(),
+    m_layout(VK_NULL_HANDLE),
+    m_renderPass(VK_NULL_HANDLE)
+{
+    memset(m_shaderModules, 0, sizeof(m_shaderModules));
+}
+
+// =====================================================================================================================
+VkResult GraphicsPipelineLibrary::Destroy(
+    Device*                         pDevice,
+    const VkAllocationCallbacks*    pAllocator)
+{
+    for (uint32_t i = 0; i < VK_ARRAY_SIZE(m_shaderModules); ++i)
+    {
+        if (m_shaderModules[i] != VK_NULL_HANDLE)
+        {
+            ShaderModule::ObjectFromHandle(m_shaderModules[i])->Destroy(pDevice, pAllocator);
+        }
+    }
+
+    if (m_layout != VK_NULL_HANDLE)
+    {
+        PipelineLayout::ObjectFromHandle(m_layout)->Destroy(pDevice, pAllocator);
+    }
+
+    if (m_renderPass != VK_NULL_HANDLE)
+    {
+        RenderPass::ObjectFromHandle(m_renderPass)->Destroy(pDevice, pAllocator);
+    }
+
+    return Pipeline::Destroy(pDevice, pAllocator);
+}
+
+} // namespace vk
@@ -43,6 +43,7 @@
 #include "palGpuMemory.h"
 #include "palImage.h"
 #include "palAutoBuffer.h"
+#include "palMetroHash.h"
 
 namespace vk
 {
@@ -1149,6 +1150,86 @@ VkResult Image::CreatePresentableImage(
     return PalToVkResult(result);
 }
 
+// =====================================================================================================================
+// Create an image for a headless swap chain.  There is no window system to hand the image to, so this is an ordinary
+// image with its own dedicated memory that additionally supports the present layouts.
+VkResult Image::CreateHeadlessPresentableImage(
+    Device*                         pDevice,
+    const VkImageCreateInfo*        pCreateInfo,
+    const VkAllocationCallbacks*    pAllocator,
+    VkImage*                        pImage,
+    VkDeviceMemory*                 pDeviceMemory)
+{
+    VkImage        image    = VK_NULL_HANDLE;
+    VkDeviceMemory memory   = VK_NULL_HANDLE;
+    Image*         pObject  = nullptr;
+    VkResult       result   = Image::Create(pDevice, pCreateInfo, pAllocator, &image);
+
+    VkMemoryRequirements memReqs = {};
+
+    if (result == VK_SUCCESS)
+    {
+        pObject = Image::ObjectFromHandle(image);
+
+        // Recreate the barrier policy so that transitions to VK_IMAGE_LAYOUT_PRESENT_SRC_KHR are allowed.
+        Util::Destructor(&pObject->m_barrierPolicy);
+
+        VK_PLACEMENT_NEW (&pObject->m_barrierPolicy) ImageBarrierPolicy(
+            pDevice,
+            pCreateInfo->usage,
+            pCreateInfo->sharingMode,
+            pCreateInfo->queueFamilyIndexCount,
+            pCreateInfo->pQueueFamilyIndices,
+            false, // presentable images are never multisampled
+            pCreateInfo->format,
+            GetPresentLayoutUsage(Pal::PresentMode::Windowed));
+
+        result = pObject->GetMemoryRequirements(pDevice, &memReqs);
+    }
+
+    if (result == VK_SUCCESS)
+    {
+        VkMemoryDedicatedAllocateInfo dedicatedInfo = {};
+        dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+        dedicatedInfo.image = image;
+
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType          = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.pNext          = &dedicatedInfo;
+        allocInfo.allocationSize = memReqs.size;
+
+        // The lowest supported memory type is the preferred one for images.
+        Util::BitMaskScanForward(&allocInfo.memoryTypeIndex, memReqs.memoryTypeBits);
+
+        result = Memory::Create(pDevice, &allocInfo, pAllocator, &memory);
+    }
+
+    if (result == VK_SUCCESS)
+    {
+        result = pObject->BindMemory(pDevice, memory, 0, 0, nullptr, 0, nullptr);
+    }
+
+    if (result == VK_SUCCESS)
+    {
+        *pImage        = image;
+        *pDeviceMemory = memory;
+    }
+    else
+    {
+        if (memory != VK_NULL_HANDLE)
+        {
+            Memory::ObjectFromHandle(memory)->Free(pDevice, pAllocator);
+        }
+
+        if (pObject != nullptr)
+        {
+            pObject->Destroy(pDevice, pAllocator);
+        }
+    }
+
+    return result;
+}
+
 // =====================================================================================================================
 // Destroy image object
 VkResult Image::Destroy(
@@ -1747,6 +1828,156 @@ VkResult Image::GetMemoryRequirements(
     return VK_SUCCESS;
 }
 
+// =====================================================================================================================
+// Gathers every part of an image create info that can affect the image's memory requirements.  Returns false if the
+// create info chains a structure that isn't part of the key, in which case the requirements must not be cached.
+static bool BuildImageMemoryRequirementsKey(
+    const VkImageCreateInfo*              pCreateInfo,
+    VkImageAspectFlagBits                 planeAspect,
+    Device::ImageMemoryRequirementsKey*   pKey)
+{
+    bool cacheable = true;
+
+    memset(pKey, 0, sizeof(*pKey));
+
+    pKey->flags       = pCreateInfo->flags;
+    pKey->imageType   = pCreateInfo->imageType;
+    pKey->format      = pCreateInfo->format;
+    pKey->extent      = pCreateInfo->extent;
+    pKey->mipLevels   = pCreateInfo->mipLevels;
+    pKey->arrayLayers = pCreateInfo->arrayLayers;
+    pKey->samples     = pCreateInfo->samples;
+    pKey->tiling      = pCreateInfo->tiling;
+    pKey->usage       = pCreateInfo->usage;
+    pKey->planeAspect = planeAspect;
+
+    // The sharing mode and queue families only affect barriers, not the memory layout.
+
+    union
+    {
+        const VkStructHeader*                  pInfo;
+        const VkExternalMemoryImageCreateInfo* pExternalInfo;
+        const VkImageFormatListCreateInfo*     pFormatListInfo;
+        const VkImageStencilUsageCreateInfo*   pStencilUsageInfo;
+    };
+
+    pInfo = static_cast<const VkStructHeader*>(pCreateInfo->pNext);
+
+    while ((pInfo != nullptr) && cacheable)
+    {
+        switch (static_cast<uint32_t>(pInfo->sType))
+        {
+        case VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO:
+            pKey->chainedStructMask  |= 0x1;
+            pKey->externalHandleTypes = pExternalInfo->handleTypes;
+            break;
+        case VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO:
+            pKey->chainedStructMask |= 0x2;
+            pKey->viewFormatCount    = pFormatListInfo->viewFormatCount;
+
+            cacheable = (pFormatListInfo->viewFormatCount <= Device::ImageMemoryRequirementsKey::MaxViewFormats);
+
+            if (cacheable)
+            {
+                memcpy(pKey->viewFormats, pFormatListInfo->pViewFormats, pKey->viewFormatCount * sizeof(VkFormat));
+            }
+            break;
+        case VK_STRUCTURE_TYPE_IMAGE_STENCIL_USAGE_CREATE_INFO:
+            pKey->chainedStructMask |= 0x4;
+            pKey->stencilUsage       = pStencilUsageInfo->stencilUsage;
+            break;
+        default:
+            cacheable = false;
+            break;
+        }
+
+        pInfo = pInfo->pNext;
+    }
+
+    return cacheable;
+}
+
+// =====================================================================================================================
+// Implementation of vkGetDeviceImageMemoryRequirements.  PAL can only report the requirements of a created image, so a
+// temporary image is created the first time a description is seen and the result is cached on the device.  Repeated
+// queries for the same description are then answered without creating anything.
+void Image::CalculateMemoryRequirements(
+    Device*                                   pDevice,
+    const VkDeviceImageMemoryRequirementsKHR* pInfo,
+    VkMemoryRequirements2*                    pMemoryRequirements)
+{
+    Device::ImageMemoryRequirements requirements = {};
+
+    Device::ImageMemoryRequirementsKey key;
+
+    const bool cacheable = BuildImageMemoryRequirementsKey(pInfo->pCreateInfo, pInfo->planeAspect, &key);
+
+    if ((cacheable == false) || (pDevice->FindImageMemoryRequirements(key, &requirements) == false))
+    {
+        const VkAllocationCallbacks* pAllocator = pDevice->VkInstance()->GetAllocCallbacks();
+        VkImage                      image      = VK_NULL_HANDLE;
+
+        if (Create(pDevice, pInfo->pCreateInfo, pAllocator, &image) == VK_SUCCESS)
+        {
+            Image* pImage = Image::ObjectFromHandle(image);
+
+            pImage->GetMemoryRequirements(pDevice, &requirements.memoryRequirements);
+            requirements.dedicatedRequired = pImage->DedicatedMemoryRequired();
+
+            pImage->Destroy(pDevice, pAllocator);
+
+            if (cacheable)
+            {
+                pDevice->CacheImageMemoryRequirements(key, requirements);
+            }
+        }
+    }
+
+    pMemoryRequirements->memoryRequirements = requirements.memoryRequirements;
+
+    VkMemoryDedicatedRequirements* pMemDedicatedRequirements =
+        static_cast<VkMemoryDedicatedRequirements*>(pMemoryRequirements->pNext);
+
+    if ((pMemDedicatedRequirements != nullptr) &&
+        (pMemDedicatedRequirements->sType == VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS))
+    {
+        pMemDedicatedRequirements->prefersDedicatedAllocation  = requirements.dedicatedRequired;
+        pMemDedicatedRequirements->requiresDedicatedAllocation = requirements.dedicatedRequired;
+    }
+}
+
+// =====================================================================================================================
+// Implementation of vkGetDeviceImageSparseMemoryRequirements.  Only sparse images have any, so the temporary image is
+// skipped for everything else.
+void Image::CalculateSparseMemoryRequirements(
+    Device*                                   pDevice,
+    const VkDeviceImageMemoryRequirementsKHR* pInfo,
+    uint32_t*                                 pSparseMemoryRequirementCount,
+    VkSparseImageMemoryRequirements2*         pSparseMemoryRequirements)
+{
+    VkImage image = VK_NULL_HANDLE;
+
+    const VkAllocationCallbacks* pAllocator = pDevice->VkInstance()->GetAllocCallbacks();
+
+    if (((pInfo->pCreateInfo->flags & SparseEnablingFlags) != 0) &&
+        (Create(pDevice, pInfo->pCreateInfo, pAllocator, &image) == VK_SUCCESS))
+    {
+        Image* pImage = Image::ObjectFromHandle(image);
+
+        auto memReqsView = utils::ArrayView<VkSparseImageMemoryRequirements>(
+            pSparseMemoryRequirements,
+            &pSparseMemoryRequirements->memoryRequirements);
+
+        pImage->GetSparseMemoryRequirements(pDevice, pSparseMemoryRequirementCount, memReqsView);
+
+        pImage->Destroy(pDevice, pAllocator);
+    }
+    else
+    {
+        *pSparseMemoryRequirementCount = 0;
+    }
+}
+
 // =====================================================================================================================
 // This is a function used to convert PAL PresentMode to Vk equivalents.
 uint32_t Image::GetPresentLayoutUsage(
@@ -1782,11 +2013,21 @@ Pal::ImageLayout Image::GetAttachmentLayout(
     uint32_t             plane,
     const CmdBuffer*     pCmdBuffer
     ) const
+{
+    return GetAttachmentLayout(layout, plane, pCmdBuffer->GetQueueFamilyIndex());
+}
+
+// =====================================================================================================================
+// Returns the PAL layout of the given attachment layout for use on the given queue family.
+Pal::ImageLayout Image::GetAttachmentLayout(
+    const RPImageLayout& layout,
+    uint32_t             plane,
+    uint32_t             queueFamilyIndex
+    ) const
 {
     Pal::ImageLayout palLayout;
 
-    palLayout = GetBarrierPolicy().GetAspectLayout(
-    layout.layout, plane, pCmdBuffer->GetQueueFamilyIndex(), GetFormat());
+    palLayout = GetBarrierPolicy().GetAspectLayout(layout.layout, plane, queueFamilyIndex, GetFormat());
 
     // Add any requested extra PAL usage
     palLayout.usages |= layout.extraUsage;
@@ -1935,6 +2176,29 @@ VKAPI_ATTR void VKAPI_CALL vkGetImageSparseMemoryRequirements2(
     }
 }
 
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceImageMemoryRequirementsKHR(
+    VkDevice                                    device,
+    const VkDeviceImageMemoryRequirementsKHR*   pInfo,
+    VkMemoryRequirements2*                      pMemoryRequirements)
+{
+    Device* pDevice = ApiDevice::ObjectFromHandle(device);
+
+    Image::CalculateMemoryRequirements(pDevice, pInfo, pMemoryRequirements);
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceImageSparseMemoryRequirementsKHR(
+    VkDevice                                    device,
+    const VkDeviceImageMemoryRequirementsKHR*   pInfo,
+    uint32_t*                                   pSparseMemoryRequirementCount,
+    VkSparseImageMemoryRequirements2*           pSparseMemoryRequirements)
+{
+    Device* pDevice = ApiDevice::ObjectFromHandle(device);
+
+    Image::CalculateSparseMemoryRequirements(pDevice, pInfo, pSparseMemoryRequirementCount, pSparseMemoryRequirements);
+}
+
 } // namespace entry
 
 } // namespace vk
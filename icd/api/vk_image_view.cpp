@@ -662,6 +662,12 @@ VkResult ImageView::Create(
             needsFmaskViewSrds,
             numDevices);
 
+        ImageView* pView = static_cast<ImageView*>(pMemory);
+
+        // Precompute the framebuffer attachment info so binding this view to an imageless framebuffer or a dynamic
+        // rendering instance doesn't need to rebuild it every time.
+        Framebuffer::InitAttachment(pView, pDevice->GetRuntimeSettings(), &pView->m_fbAttachment);
+
         *pImageView = ImageView::HandleFromVoidPointer(pMemory);
 
         return VK_SUCCESS;
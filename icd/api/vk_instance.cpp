@@ -94,6 +94,11 @@ Instance::Instance(
     m_pDevModeMgr(nullptr),
     m_debugReportCallbacks(&m_palAllocator),
     m_debugUtilsMessengers(&m_palAllocator),
+    m_pDebugCallbacks(nullptr),
+    m_pRetiredDebugCallbacks(nullptr),
+    m_debugReportFlags(0),
+    m_debugMessengerSeverityFlags(0),
+    m_debugMessengerTypeFlags(0),
     m_logTagIdMask(0)
 {
     m_flags.u32All = 0;
@@ -705,6 +710,18 @@ VkResult Instance::Destroy(void)
         FreeMem(m_pPalPlatform);
     }
 
+    // PAL may log until it is destroyed, so the debug callback snapshots are freed last.
+    FreeMem(m_pDebugCallbacks);
+
+    while (m_pRetiredDebugCallbacks != nullptr)
+    {
+        DebugCallbackSnapshot* pNext = m_pRetiredDebugCallbacks->pNextRetired;
+
+        FreeMem(m_pRetiredDebugCallbacks);
+
+        m_pRetiredDebugCallbacks = pNext;
+    }
+
     // This was created with placement new. Need to explicitly call destructor.
     this->~Instance();
 
@@ -788,6 +805,7 @@ const InstanceExtensions::Supported& Instance::GetSupportedExtensions()
         supportedExtensions.AddExtension(VK_INSTANCE_EXTENSION(KHR_GET_DISPLAY_PROPERTIES2));
 
         supportedExtensions.AddExtension(VK_INSTANCE_EXTENSION(EXT_DIRECT_MODE_DISPLAY));
+        supportedExtensions.AddExtension(VK_INSTANCE_EXTENSION(EXT_HEADLESS_SURFACE));
 #endif
         supportedExtensionsPopulated = true;
     }
@@ -1148,13 +1166,27 @@ void PAL_STDCALL Instance::LogCallback(
 VkResult Instance::RegisterDebugCallback(
     DebugReportCallback* pCallback)
 {
+    Util::MutexAuto lock(&m_debugCallbackMutex);
+
     VkResult result = VK_SUCCESS;
 
     Pal::Result palResult = m_debugReportCallbacks.PushBack(pCallback);
 
     if (palResult == Pal::Result::Success)
     {
-        result = VK_SUCCESS;
+        result = PublishDebugCallbacks();
+
+        if (result != VK_SUCCESS)
+        {
+            auto it = m_debugReportCallbacks.Begin();
+
+            while (*it.Get() != pCallback)
+            {
+                it.Next();
+            }
+
+            m_debugReportCallbacks.Erase(&it);
+        }
     }
     else
     {
@@ -1165,10 +1197,13 @@ VkResult Instance::RegisterDebugCallback(
 }
 
 // =====================================================================================================================
-// Remove the given Debug Report Callback from the instance.
+// Remove the given Debug Report Callback from the instance.  Once this returns, the callback is only still called by
+// dispatches that were already in progress.
 void Instance::UnregisterDebugCallback(
     DebugReportCallback* pCallback)
 {
+    Util::MutexAuto lock(&m_debugCallbackMutex);
+
     auto it = m_debugReportCallbacks.Begin();
 
     DebugReportCallback* element = *it.Get();
@@ -1188,6 +1223,13 @@ void Instance::UnregisterDebugCallback(
             element = *it.Get();
         }
     }
+
+    // Without memory for a new snapshot, stop dispatching altogether rather than keep calling the removed callback.
+    // The next registration publishes the remaining callbacks again.
+    if (PublishDebugCallbacks() != VK_SUCCESS)
+    {
+        ReplaceDebugCallbacks(nullptr, 0, 0, 0);
+    }
 }
 
 // =====================================================================================================================
@@ -1197,9 +1239,6 @@ void Instance::LogMessage(uint32_t    level,
                           const char* pFormat,
                           va_list     args)
 {
-    // Guarantee serialization of this function to keep internal log messages from getting intermixed
-    m_logCallbackInternalOnlyMutex.Lock();
-
     uint32_t flags = 0;
     VkDebugUtilsMessageSeverityFlagBitsEXT debugUtilsSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
     VkDebugUtilsMessageTypeFlagsEXT        debugUtilsTypes = 0;
@@ -1251,47 +1290,60 @@ void Instance::LogMessage(uint32_t    level,
         debugUtilsTypes    = VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
     }
 
-    constexpr uint64_t  object = 0;
-    constexpr size_t    location = 0;
-    constexpr int32_t   messageCode = 0;
-    constexpr char      layerPrefix[] = "AMDVLK\0";
-
-    constexpr uint32_t messageSize = 256;
-    char message[messageSize];
-
-    Util::Vsnprintf(message,
-                    messageSize,
-                    pFormat,
-                    args);
-
-    CallExternalCallbacks(flags,
-                          VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT,
-                          object,
-                          location,
-                          messageCode,
-                          layerPrefix,
-                          message);
-
-    VkDebugUtilsMessengerCallbackDataEXT callbackData = {};
-
-    callbackData.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CALLBACK_DATA_EXT;
-    callbackData.pNext = nullptr;
-    callbackData.flags = 0; // reserved for future use
-    callbackData.pMessageIdName = nullptr;
-    callbackData.messageIdNumber = 0;
-    callbackData.pMessage = message;
-    callbackData.queueLabelCount = 0;
-    callbackData.pQueueLabels = nullptr;
-    callbackData.cmdBufLabelCount = 0;
-    callbackData.pCmdBufLabels = nullptr;
-    callbackData.objectCount = 0;
-    callbackData.pObjects = nullptr;
-
-    CallExternalMessengers(debugUtilsSeverity,
-                           debugUtilsTypes,
-                           &callbackData);
-
-    m_logCallbackInternalOnlyMutex.Unlock();
+    // Nobody is subscribed to most messages, so drop them before spending any time on formatting.
+    const bool reportWanted    = ((flags & m_debugReportFlags) != 0);
+    const bool messengerWanted = ((debugUtilsSeverity & m_debugMessengerSeverityFlags) != 0) &&
+                                 ((debugUtilsTypes & m_debugMessengerTypeFlags) != 0);
+
+    if (reportWanted || messengerWanted)
+    {
+        constexpr uint64_t  object = 0;
+        constexpr size_t    location = 0;
+        constexpr int32_t   messageCode = 0;
+        constexpr char      layerPrefix[] = "AMDVLK\0";
+
+        // The message is formatted on the stack of the logging thread, so concurrent messages don't need serializing.
+        constexpr uint32_t messageSize = 256;
+        char message[messageSize];
+
+        Util::Vsnprintf(message,
+                        messageSize,
+                        pFormat,
+                        args);
+
+        if (reportWanted)
+        {
+            CallExternalCallbacks(flags,
+                                  VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT,
+                                  object,
+                                  location,
+                                  messageCode,
+                                  layerPrefix,
+                                  message);
+        }
+
+        if (messengerWanted)
+        {
+            VkDebugUtilsMessengerCallbackDataEXT callbackData = {};
+
+            callbackData.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CALLBACK_DATA_EXT;
+            callbackData.pNext = nullptr;
+            callbackData.flags = 0; // reserved for future use
+            callbackData.pMessageIdName = nullptr;
+            callbackData.messageIdNumber = 0;
+            callbackData.pMessage = message;
+            callbackData.queueLabelCount = 0;
+            callbackData.pQueueLabels = nullptr;
+            callbackData.cmdBufLabelCount = 0;
+            callbackData.pCmdBufLabels = nullptr;
+            callbackData.objectCount = 0;
+            callbackData.pObjects = nullptr;
+
+            CallExternalMessengers(debugUtilsSeverity,
+                                   debugUtilsTypes,
+                                   &callbackData);
+        }
+    }
 }
 
 // =====================================================================================================================
@@ -1305,23 +1357,26 @@ void Instance::CallExternalCallbacks(
     const char*                 pLayerPrefix,
     const char*                 pMessage)
 {
-    // Guarantee serialization of this function to keep internal and external log messages from getting intermixed
-    m_logCallbackInternalExternalMutex.Lock();
-
-    for (auto it = m_debugReportCallbacks.Begin(); it.Get() != nullptr; it.Next())
+    if ((flags & m_debugReportFlags) != 0)
     {
-        DebugReportCallback* element = *it.Get();
+        DebugCallbackSnapshot* pSnapshot = AcquireDebugCallbacks();
 
-        if (flags & element->GetFlags())
+        if (pSnapshot != nullptr)
         {
-            PFN_vkDebugReportCallbackEXT pfnCallback = element->GetCallbackFunc();
-            void* pUserData = element->GetUserData();
+            for (uint32_t i = 0; i < pSnapshot->reportCount; ++i)
+            {
+                const DebugReportEntry& entry = pSnapshot->pReports[i];
+
+                if (flags & entry.flags)
+                {
+                    (*entry.pfnCallback)(
+                        flags, objectType, object, location, messageCode, pLayerPrefix, pMessage, entry.pUserData);
+                }
+            }
 
-            (*pfnCallback)(flags, objectType, object, location, messageCode, pLayerPrefix, pMessage, pUserData);
+            ReleaseDebugCallbacks(pSnapshot);
         }
     }
-
-    m_logCallbackInternalExternalMutex.Unlock();
 }
 
 // =====================================================================================================================
@@ -1329,13 +1384,27 @@ void Instance::CallExternalCallbacks(
 VkResult Instance::RegisterDebugUtilsMessenger(
     DebugUtilsMessenger* pMessenger)
 {
+    Util::MutexAuto lock(&m_debugCallbackMutex);
+
     VkResult result = VK_SUCCESS;
 
     Pal::Result palResult = m_debugUtilsMessengers.PushBack(pMessenger);
 
     if (palResult == Pal::Result::Success)
     {
-        result = VK_SUCCESS;
+        result = PublishDebugCallbacks();
+
+        if (result != VK_SUCCESS)
+        {
+            auto it = m_debugUtilsMessengers.Begin();
+
+            while (*it.Get() != pMessenger)
+            {
+                it.Next();
+            }
+
+            m_debugUtilsMessengers.Erase(&it);
+        }
     }
     else
     {
@@ -1346,10 +1415,13 @@ VkResult Instance::RegisterDebugUtilsMessenger(
 }
 
 // =====================================================================================================================
-// Remove the given Debug Utils Messenger from the instance.
+// Remove the given Debug Utils Messenger from the instance.  Once this returns, the messenger is only still called by
+// dispatches that were already in progress.
 void Instance::UnregisterDebugUtilsMessenger(
     DebugUtilsMessenger* pMessenger)
 {
+    Util::MutexAuto lock(&m_debugCallbackMutex);
+
     auto it = m_debugUtilsMessengers.Begin();
 
     DebugUtilsMessenger* element = *it.Get();
@@ -1369,6 +1441,13 @@ void Instance::UnregisterDebugUtilsMessenger(
             element = *it.Get();
         }
     }
+
+    // Without memory for a new snapshot, stop dispatching altogether rather than keep calling the removed callback.
+    // The next registration publishes the remaining callbacks again.
+    if (PublishDebugCallbacks() != VK_SUCCESS)
+    {
+        ReplaceDebugCallbacks(nullptr, 0, 0, 0);
+    }
 }
 
 // =====================================================================================================================
@@ -1378,26 +1457,192 @@ void Instance::CallExternalMessengers(
     VkDebugUtilsMessageTypeFlagsEXT             messageTypes,
     const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData)
 {
-    // Guarantee serialization of this function to keep internal and external log messages from getting intermixed
-    m_logCallbackInternalExternalMutex.Lock();
+    if (((messageSeverity & m_debugMessengerSeverityFlags) != 0) && ((messageTypes & m_debugMessengerTypeFlags) != 0))
+    {
+        DebugCallbackSnapshot* pSnapshot = AcquireDebugCallbacks();
+
+        if (pSnapshot != nullptr)
+        {
+            for (uint32_t i = 0; i < pSnapshot->messengerCount; ++i)
+            {
+                const DebugMessengerEntry& entry = pSnapshot->pMessengers[i];
+
+                if ((messageSeverity & entry.severityFlags) && (messageTypes & entry.typeFlags))
+                {
+                    (*entry.pfnCallback)(messageSeverity, messageTypes, pCallbackData, entry.pUserData);
+                }
+            }
+
+            ReleaseDebugCallbacks(pSnapshot);
+        }
+    }
+}
+
+// =====================================================================================================================
+// Returns the current debug callback snapshot, or null if no callback is registered, and counts the calling thread as
+// one of its readers until ReleaseDebugCallbacks() is called.  The snapshot is re-checked after registering as a reader
+// since a concurrent PublishDebugCallbacks() may have replaced it in between.
+Instance::DebugCallbackSnapshot* Instance::AcquireDebugCallbacks()
+{
+    DebugCallbackSnapshot* pSnapshot = m_pDebugCallbacks;
+
+    while (pSnapshot != nullptr)
+    {
+        Util::AtomicIncrement(&pSnapshot->readerCount);
+
+        if (pSnapshot == m_pDebugCallbacks)
+        {
+            break;
+        }
+
+        Util::AtomicDecrement(&pSnapshot->readerCount);
+
+        pSnapshot = m_pDebugCallbacks;
+    }
+
+    return pSnapshot;
+}
+
+// =====================================================================================================================
+void Instance::ReleaseDebugCallbacks(
+    DebugCallbackSnapshot* pSnapshot)
+{
+    Util::AtomicDecrement(&pSnapshot->readerCount);
+}
+
+// =====================================================================================================================
+// Rebuilds the debug callback snapshot from the registered callback lists and makes it current.  A retired snapshot
+// that is large enough and not read by anyone is reused; otherwise a new one is allocated.  The replaced snapshot is
+// retired without waiting for its readers, as a debug callback may itself register or unregister callbacks while the
+// calling thread still reads it; it is reused once its readers are gone.  A dispatch already in progress may therefore
+// still call a callback that has just been removed.  Must be called with m_debugCallbackMutex held.
+VkResult Instance::PublishDebugCallbacks()
+{
+    const uint32_t reportCount    = m_debugReportCallbacks.NumElements();
+    const uint32_t messengerCount = m_debugUtilsMessengers.NumElements();
+    const uint32_t entryCount     = Util::Max(reportCount, messengerCount);
+
+    VkResult               result    = VK_SUCCESS;
+    DebugCallbackSnapshot* pSnapshot = nullptr;
 
-    for (auto it = m_debugUtilsMessengers.Begin(); it.Get() != nullptr; it.Next())
+    if (entryCount > 0)
     {
-        DebugUtilsMessenger* element = *it.Get();
+        DebugCallbackSnapshot** ppIdle = nullptr;
 
-        if (messageSeverity & element->GetMessageSeverityFlags())
+        for (DebugCallbackSnapshot** ppRetired = &m_pRetiredDebugCallbacks;
+             (*ppRetired != nullptr) && (ppIdle == nullptr);
+             ppRetired = &(*ppRetired)->pNextRetired)
         {
-            if (messageTypes & element->GetMessageTypeFlags())
+            if (((*ppRetired)->capacity >= entryCount) && ((*ppRetired)->readerCount == 0))
             {
-                PFN_vkDebugUtilsMessengerCallbackEXT pfnCallback = element->GetCallbackFunc();
-                void* pUserData = element->GetUserData();
+                ppIdle = ppRetired;
+            }
+        }
 
-                (*pfnCallback)(messageSeverity, messageTypes, pCallbackData, pUserData);
+        if (ppIdle != nullptr)
+        {
+            pSnapshot = *ppIdle;
+            *ppIdle   = pSnapshot->pNextRetired;
+        }
+        else
+        {
+            const uint32_t capacity = Util::Pow2Align(entryCount, 4u);
+
+            void* pMemory = AllocMem(
+                sizeof(DebugCallbackSnapshot) +
+                (capacity * (sizeof(DebugReportEntry) + sizeof(DebugMessengerEntry))),
+                VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+
+            if (pMemory != nullptr)
+            {
+                pSnapshot = static_cast<DebugCallbackSnapshot*>(pMemory);
+
+                pSnapshot->readerCount = 0;
+                pSnapshot->capacity    = capacity;
+                pSnapshot->pReports    = static_cast<DebugReportEntry*>(
+                    Util::VoidPtrInc(pMemory, sizeof(DebugCallbackSnapshot)));
+                pSnapshot->pMessengers = static_cast<DebugMessengerEntry*>(
+                    Util::VoidPtrInc(pSnapshot->pReports, capacity * sizeof(DebugReportEntry)));
+            }
+            else
+            {
+                result = VK_ERROR_OUT_OF_HOST_MEMORY;
             }
         }
     }
 
-    m_logCallbackInternalExternalMutex.Unlock();
+    if (result == VK_SUCCESS)
+    {
+        VkDebugReportFlagsEXT               reportFlags    = 0;
+        VkDebugUtilsMessageSeverityFlagsEXT severityFlags  = 0;
+        VkDebugUtilsMessageTypeFlagsEXT     typeFlags      = 0;
+
+        if (pSnapshot != nullptr)
+        {
+            pSnapshot->reportCount    = reportCount;
+            pSnapshot->messengerCount = messengerCount;
+            pSnapshot->pNextRetired   = nullptr;
+
+            uint32_t i = 0;
+
+            for (auto it = m_debugReportCallbacks.Begin(); it.Get() != nullptr; it.Next(), ++i)
+            {
+                DebugReportCallback* pCallback = *it.Get();
+                DebugReportEntry*    pEntry    = &pSnapshot->pReports[i];
+
+                pEntry->flags       = pCallback->GetFlags();
+                pEntry->pfnCallback = pCallback->GetCallbackFunc();
+                pEntry->pUserData   = pCallback->GetUserData();
+
+                reportFlags |= pEntry->flags;
+            }
+
+            i = 0;
+
+            for (auto it = m_debugUtilsMessengers.Begin(); it.Get() != nullptr; it.Next(), ++i)
+            {
+                DebugUtilsMessenger* pMessenger = *it.Get();
+                DebugMessengerEntry* pEntry     = &pSnapshot->pMessengers[i];
+
+                pEntry->severityFlags = pMessenger->GetMessageSeverityFlags();
+                pEntry->typeFlags     = pMessenger->GetMessageTypeFlags();
+                pEntry->pfnCallback   = pMessenger->GetCallbackFunc();
+                pEntry->pUserData     = pMessenger->GetUserData();
+
+                severityFlags |= pEntry->severityFlags;
+                typeFlags     |= pEntry->typeFlags;
+            }
+        }
+
+        ReplaceDebugCallbacks(pSnapshot, reportFlags, severityFlags, typeFlags);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Makes the given snapshot, which may be null, current together with the message filters of its callbacks, and retires
+// the replaced snapshot.  Must be called with m_debugCallbackMutex held.
+void Instance::ReplaceDebugCallbacks(
+    DebugCallbackSnapshot*              pSnapshot,
+    VkDebugReportFlagsEXT               reportFlags,
+    VkDebugUtilsMessageSeverityFlagsEXT severityFlags,
+    VkDebugUtilsMessageTypeFlagsEXT     typeFlags)
+{
+    DebugCallbackSnapshot* pOldSnapshot = static_cast<DebugCallbackSnapshot*>(
+        Util::AtomicExchangePointer(reinterpret_cast<void* volatile*>(&m_pDebugCallbacks), pSnapshot));
+
+    // The filters may briefly be stale in either direction, which at worst lets a message through that no callback
+    // wants or drops one for a callback that is still being registered.
+    m_debugReportFlags            = reportFlags;
+    m_debugMessengerSeverityFlags = severityFlags;
+    m_debugMessengerTypeFlags     = typeFlags;
+
+    if (pOldSnapshot != nullptr)
+    {
+        pOldSnapshot->pNextRetired = m_pRetiredDebugCallbacks;
+        m_pRetiredDebugCallbacks   = pOldSnapshot;
+    }
 }
 
 namespace entry
@@ -29,6 +29,7 @@
  ***********************************************************************************************************************
  */
 
+#include "include/gpu_address_map.h"
 #include "include/vk_conv.h"
 #include "include/vk_device.h"
 #include "include/vk_instance.h"
@@ -419,6 +420,27 @@ VkResult Memory::Create(
              VK_NEVER_CALLED();
         }
 
+        GpuAddressMap* pAddressMap = pDevice->GetGpuAddressMap();
+
+        if (pAddressMap != nullptr)
+        {
+            for (uint32_t deviceIdx = 0; deviceIdx < pDevice->NumPalDevices(); ++deviceIdx)
+            {
+                const Pal::IGpuMemory* pGpuMemory = pMemory->PalMemory(deviceIdx);
+
+                if (pGpuMemory != nullptr)
+                {
+                    GpuAddressMap::Range range = {};
+                    range.gpuVirtAddr = pGpuMemory->Desc().gpuVirtAddr;
+                    range.size        = pGpuMemory->Desc().size;
+                    range.type        = GpuAddressMap::ObjectType::Memory;
+                    range.pObject     = pMemory;
+
+                    pAddressMap->Insert(deviceIdx, range);
+                }
+            }
+        }
+
         // When share a dedicated image, metadata(width/height/mips/...) info is necessary in handle,
         // so driver calls bindMemory here to update metadata at allocation time.
         // For dedicated buffer, only base address and total size needed to be filled in handle for sharing,
@@ -968,12 +990,25 @@ void Memory::Free(
         }
     }
 
+    GpuAddressMap* pAddressMap = pDevice->GetGpuAddressMap();
+
     // Free the parent memory
     for (uint32_t i = 0; i < m_pDevice->NumPalDevices(); ++i)
     {
         Pal::IGpuMemory* pGpuMemory = m_pPalMemory[i][i];
         if (pGpuMemory != nullptr)
         {
+            if (pAddressMap != nullptr)
+            {
+                GpuAddressMap::Range range = {};
+                range.gpuVirtAddr = pGpuMemory->Desc().gpuVirtAddr;
+                range.size        = pGpuMemory->Desc().size;
+                range.type        = GpuAddressMap::ObjectType::Memory;
+                range.pObject     = this;
+
+                pAddressMap->Remove(i, range);
+            }
+
             Pal::IDevice* pPalDevice = pDevice->PalDevice(i);
             pDevice->RemoveMemReference(pPalDevice, pGpuMemory);
 
@@ -41,6 +41,7 @@
 #include "include/vk_utils.h"
 #include "include/vk_conv.h"
 #include "include/vk_surface.h"
+#include "include/vk_swapchain.h"
 
 #include "include/khronos/vk_icd.h"
 
@@ -2045,8 +2046,10 @@ bool PhysicalDevice::QueueSupportsPresents(
     Pal::PresentMode presentMode =
         (platform == VK_ICD_WSI_PLATFORM_DISPLAY)? Pal::PresentMode::Fullscreen : Pal::PresentMode::Windowed;
 
+    // Headless presents never reach the window system, so any queue can perform them.
     return (engineProps.engineCount > 0) &&
-           (m_pPalDevice->GetSupportedSwapChainModes(VkToPalWsiPlatform(platform), presentMode) != 0);
+           ((platform == VK_ICD_WSI_PLATFORM_HEADLESS) ||
+            (m_pPalDevice->GetSupportedSwapChainModes(VkToPalWsiPlatform(platform), presentMode) != 0));
 
 }
 
@@ -2731,6 +2734,36 @@ void PhysicalDevice::PopulateLimits()
 
 }
 
+// =====================================================================================================================
+// Fills in the swap chain properties of a headless surface.  There is no window system behind these surfaces, so the
+// extent follows the swap chain and the limits only reflect what a regular 2D image of this device can support.
+void PhysicalDevice::GetHeadlessSwapChainProperties(
+    Pal::SwapChainProperties* pSwapChainProperties) const
+{
+    // Magic width/height value meaning that the surface is resized to match the swapchain's extent.
+    constexpr uint32_t SwapchainBasedSize = 0xFFFFFFFF;
+
+    pSwapChainProperties->currentExtent.width   = SwapchainBasedSize;
+    pSwapChainProperties->currentExtent.height  = SwapchainBasedSize;
+    pSwapChainProperties->minImageExtent.width  = 1;
+    pSwapChainProperties->minImageExtent.height = 1;
+    pSwapChainProperties->maxImageExtent.width  = m_limits.maxImageDimension2D;
+    pSwapChainProperties->maxImageExtent.height = m_limits.maxImageDimension2D;
+    pSwapChainProperties->maxImageArraySize     = 1;
+    pSwapChainProperties->minImageCount         = HeadlessPresenter::MinImageCount;
+    pSwapChainProperties->maxImageCount         = HeadlessPresenter::MaxImageCount;
+    pSwapChainProperties->supportedTransforms   = Pal::SurfaceTransformNone;
+    pSwapChainProperties->currentTransforms     = Pal::SurfaceTransformNone;
+
+#if PAL_CLIENT_INTERFACE_MAJOR_VERSION >= 610
+    pSwapChainProperties->compositeAlphaMode    = static_cast<uint32>(Pal::CompositeAlphaMode::Opaque);
+#endif
+
+    pSwapChainProperties->supportedUsageFlags.colorTarget = 1;
+    pSwapChainProperties->supportedUsageFlags.shaderRead  = 1;
+    pSwapChainProperties->supportedUsageFlags.shaderWrite = 1;
+}
+
 // =====================================================================================================================
 // Retrieve surface capabilities. Called in response to vkGetPhysicalDeviceSurfaceCapabilitiesKHR
 template <typename T>
@@ -2763,11 +2796,18 @@ VkResult PhysicalDevice::GetSurfaceCapabilities(
             swapChainProperties.currentExtent.height = pDisplaySurface->imageExtent.height;
         }
 #endif
-        result = PalToVkResult(m_pPalDevice->GetSwapChainInfo(
-            displayableInfo.displayHandle,
-            displayableInfo.windowHandle,
-            displayableInfo.palPlatform,
-            &swapChainProperties));
+        if (displayableInfo.icdPlatform == VK_ICD_WSI_PLATFORM_HEADLESS)
+        {
+            GetHeadlessSwapChainProperties(&swapChainProperties);
+        }
+        else
+        {
+            result = PalToVkResult(m_pPalDevice->GetSwapChainInfo(
+                displayableInfo.displayHandle,
+                displayableInfo.windowHandle,
+                displayableInfo.palPlatform,
+                &swapChainProperties));
+        }
 
         if (result == VK_SUCCESS)
         {
@@ -2980,7 +3020,14 @@ VkResult PhysicalDevice::GetSurfacePresentModes(
 
     // Get which swap chain modes are supported for the given present type (windowed vs fullscreen)
     uint32_t swapChainModes = 0;
-    if (presentType == Pal::PresentMode::Count)
+    if (displayableInfo.icdPlatform == VK_ICD_WSI_PLATFORM_HEADLESS)
+    {
+        // Headless swap chains emulate these modes against a simulated refresh clock.
+        swapChainModes = Pal::SwapChainModeSupport::SupportImmediateSwapChain |
+                         Pal::SwapChainModeSupport::SupportMailboxSwapChain   |
+                         Pal::SwapChainModeSupport::SupportFifoSwapChain;
+    }
+    else if (presentType == Pal::PresentMode::Count)
     {
         swapChainModes  = m_pPalDevice->GetSupportedSwapChainModes(displayableInfo.palPlatform, Pal::PresentMode::Windowed);
         swapChainModes |= m_pPalDevice->GetSupportedSwapChainModes(displayableInfo.palPlatform, Pal::PresentMode::Fullscreen);
@@ -3053,6 +3100,11 @@ VkResult PhysicalDevice::UnpackDisplayableSurface(
         DisplayModeObject* pDisplayMode = reinterpret_cast<DisplayModeObject*>(pDisplaySurface->displayMode);
         pInfo->pScreen       = pDisplayMode->pScreen;
     }
+    else if (pSurface->GetHeadlessSurface()->base.platform == VK_ICD_WSI_PLATFORM_HEADLESS)
+    {
+        pInfo->icdPlatform   = pSurface->GetHeadlessSurface()->base.platform;
+        pInfo->palPlatform   = VkToPalWsiPlatform(pSurface->GetHeadlessSurface()->base.platform);
+    }
 #ifdef VK_USE_PLATFORM_XCB_KHR
     else if (pSurface->GetXcbSurface()->base.platform == VK_ICD_WSI_PLATFORM_XCB)
     {
@@ -3649,6 +3701,24 @@ DeviceExtensions::Supported PhysicalDevice::GetAvailableExtensions(
         availableExtensions.AddExtension(VK_DEVICE_EXTENSION(EXT_CUSTOM_BORDER_COLOR));
         availableExtensions.AddExtension(VK_DEVICE_EXTENSION(EXT_COLOR_WRITE_ENABLE));
 
+        // Push descriptor tables live in command buffer embedded memory which has no shadow copy for fmask
+        // descriptors, so the extension can only be exposed when fmask based MSAA reads are disabled.
+        if ((pPhysicalDevice == nullptr) || (pPhysicalDevice->GetRuntimeSettings().enableFmaskBasedMsaaRead == false))
+        {
+            availableExtensions.AddExtension(VK_DEVICE_EXTENSION(KHR_PUSH_DESCRIPTOR));
+        }
+
+        availableExtensions.AddExtension(VK_DEVICE_EXTENSION(EXT_MULTI_DRAW));
+        availableExtensions.AddExtension(VK_DEVICE_EXTENSION(KHR_DEFERRED_HOST_OPERATIONS));
+        availableExtensions.AddExtension(VK_DEVICE_EXTENSION(KHR_DYNAMIC_RENDERING));
+        availableExtensions.AddExtension(VK_DEVICE_EXTENSION(EXT_EXTENDED_DYNAMIC_STATE2));
+        availableExtensions.AddExtension(VK_DEVICE_EXTENSION(KHR_PIPELINE_LIBRARY));
+        availableExtensions.AddExtension(VK_DEVICE_EXTENSION(EXT_GRAPHICS_PIPELINE_LIBRARY));
+        availableExtensions.AddExtension(VK_DEVICE_EXTENSION(EXT_SHADER_MODULE_IDENTIFIER));
+        availableExtensions.AddExtension(VK_DEVICE_EXTENSION(KHR_MAINTENANCE4));
+        availableExtensions.AddExtension(VK_DEVICE_EXTENSION(KHR_PRESENT_ID));
+        availableExtensions.AddExtension(VK_DEVICE_EXTENSION(KHR_PRESENT_WAIT));
+
     bool disableAMDVendorExtensions = false;
     if (pPhysicalDevice != nullptr)
     {
@@ -5167,6 +5237,67 @@ void PhysicalDevice::GetFeatures2(
                 break;
             }
 
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT:
+            {
+                auto* pExtInfo = reinterpret_cast<VkPhysicalDeviceMultiDrawFeaturesEXT*>(pHeader);
+                pExtInfo->multiDraw = VK_TRUE;
+                break;
+            }
+
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR:
+            {
+                auto* pExtInfo = reinterpret_cast<VkPhysicalDeviceDynamicRenderingFeaturesKHR*>(pHeader);
+                pExtInfo->dynamicRendering = VK_TRUE;
+                break;
+            }
+
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT:
+            {
+                auto* pExtInfo = reinterpret_cast<VkPhysicalDeviceExtendedDynamicState2FeaturesEXT*>(pHeader);
+                pExtInfo->extendedDynamicState2 = VK_TRUE;
+
+                // The logic op and the patch control point count are compiled into the hardware pipeline and cannot
+                // be changed without a pipeline rebuild.
+                pExtInfo->extendedDynamicState2LogicOp            = VK_FALSE;
+                pExtInfo->extendedDynamicState2PatchControlPoints = VK_FALSE;
+                break;
+            }
+
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT:
+            {
+                auto* pExtInfo = reinterpret_cast<VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT*>(pHeader);
+                pExtInfo->graphicsPipelineLibrary = VK_TRUE;
+                break;
+            }
+
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MODULE_IDENTIFIER_FEATURES_EXT:
+            {
+                auto* pExtInfo = reinterpret_cast<VkPhysicalDeviceShaderModuleIdentifierFeaturesEXT*>(pHeader);
+                pExtInfo->shaderModuleIdentifier = VK_TRUE;
+                break;
+            }
+
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_4_FEATURES_KHR:
+            {
+                auto* pExtInfo = reinterpret_cast<VkPhysicalDeviceMaintenance4FeaturesKHR*>(pHeader);
+                pExtInfo->maintenance4 = VK_TRUE;
+                break;
+            }
+
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR:
+            {
+                auto* pExtInfo = reinterpret_cast<VkPhysicalDevicePresentIdFeaturesKHR*>(pHeader);
+                pExtInfo->presentId = VK_TRUE;
+                break;
+            }
+
+            case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR:
+            {
+                auto* pExtInfo = reinterpret_cast<VkPhysicalDevicePresentWaitFeaturesKHR*>(pHeader);
+                pExtInfo->presentWait = VK_TRUE;
+                break;
+            }
+
             default:
             {
                 // skip any unsupported extension structures
@@ -5738,6 +5869,56 @@ void PhysicalDevice::GetDeviceProperties2(
             break;
         }
 
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR:
+        {
+            auto* pProps = static_cast<VkPhysicalDevicePushDescriptorPropertiesKHR*>(pNext);
+            pProps->maxPushDescriptors = MaxPushDescriptors;
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_PROPERTIES_EXT:
+        {
+            auto* pProps = static_cast<VkPhysicalDeviceMultiDrawPropertiesEXT*>(pNext);
+            pProps->maxMultiDrawCount = UINT32_MAX;
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT:
+        {
+            auto* pProps = static_cast<VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT*>(pNext);
+
+            // Linking compiles the complete pipeline, so it is no faster than creating it directly.
+            pProps->graphicsPipelineLibraryFastLinking                        = VK_FALSE;
+            pProps->graphicsPipelineLibraryIndependentInterpolationDecoration = VK_FALSE;
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MODULE_IDENTIFIER_PROPERTIES_EXT:
+        {
+            auto* pProps = static_cast<VkPhysicalDeviceShaderModuleIdentifierPropertiesEXT*>(pNext);
+
+            // Identifies the SPIR-V code hash and size layout of ShaderModuleIdentifier.  This must change whenever
+            // either changes so that applications discard identifiers saved by an older driver.
+            static constexpr uint8_t IdentifierAlgorithmUuid[VK_UUID_SIZE] =
+            {
+                0x9c, 0x4e, 0x1d, 0x2a, 0x71, 0xb3, 0x4f, 0x08, 0xa6, 0x35, 0xe2, 0x5d, 0x0b, 0x97, 0xc8, 0x01
+            };
+
+            memcpy(pProps->shaderModuleIdentifierAlgorithmUUID, IdentifierAlgorithmUuid, VK_UUID_SIZE);
+            break;
+        }
+
+        case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_4_PROPERTIES_KHR:
+        {
+            auto* pProps = static_cast<VkPhysicalDeviceMaintenance4PropertiesKHR*>(pNext);
+
+            // A non-sparse buffer has to fit in a single allocation
+            uint32_t maxPerSetDescriptors = 0;
+
+            GetPhysicalDeviceMaintenance3Properties(&maxPerSetDescriptors, &pProps->maxBufferSize);
+            break;
+        }
+
         default:
             break;
         }
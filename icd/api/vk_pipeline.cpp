@@ -122,7 +122,18 @@ void Pipeline::GenerateHashFromShaderStageCreateInfo(
 {
     pHasher->Update(desc.flags);
     pHasher->Update(desc.stage);
-    pHasher->Update(ShaderModule::ObjectFromHandle(desc.module)->GetCodeHash(desc.pName));
+
+    // A stage given by a module identifier hashes the same as one given by the module itself
+    ShaderModuleIdentifier identifier = {};
+
+    if (ShaderModule::GetStageIdentifier(desc, &identifier))
+    {
+        pHasher->Update(ShaderModule::GetCodeHash(identifier.codeHash, desc.pName));
+    }
+    else
+    {
+        pHasher->Update(ShaderModule::ObjectFromHandle(desc.module)->GetCodeHash(desc.pName));
+    }
 
     if (desc.pSpecializationInfo != nullptr)
     {
@@ -676,6 +676,61 @@ VkResult PipelineLayout::BuildLlpcPipelineMapping(
     return VK_SUCCESS;
 }
 
+// =====================================================================================================================
+// Creates an independent copy of this pipeline layout, including its copies of the descriptor set layouts, for objects
+// that must outlive the application's handle (e.g. graphics pipeline libraries).
+VkResult PipelineLayout::Clone(
+    Device*                         pDevice,
+    const VkAllocationCallbacks*    pAllocator,
+    VkPipelineLayout*               pPipelineLayout
+    ) const
+{
+    const size_t apiSize                 = sizeof(PipelineLayout);
+    const size_t setUserDataLayoutSize   = SetUserDataLayoutSize();
+    const size_t descriptorSetLayoutSize =
+        Util::Pow2Align((m_info.setCount * sizeof(DescriptorSetLayout*)), ExtraDataAlignment());
+
+    size_t setLayoutsArraySize = 0;
+
+    for (uint32_t i = 0; i < m_info.setCount; ++i)
+    {
+        setLayoutsArraySize += GetSetLayouts(i)->GetObjectSize();
+    }
+
+    const size_t objSize = apiSize + setUserDataLayoutSize + descriptorSetLayoutSize + setLayoutsArraySize;
+
+    void* pSysMem = pDevice->AllocApiObject(pAllocator, objSize);
+
+    if (pSysMem == nullptr)
+    {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    memcpy(Util::VoidPtrInc(pSysMem, apiSize), Util::VoidPtrInc(this, apiSize), setUserDataLayoutSize);
+
+    DescriptorSetLayout** ppSetLayouts = static_cast<DescriptorSetLayout**>(
+        Util::VoidPtrInc(pSysMem, apiSize + setUserDataLayoutSize));
+
+    size_t currentSetLayoutOffset = apiSize + setUserDataLayoutSize + descriptorSetLayoutSize;
+
+    for (uint32_t i = 0; i < m_info.setCount; ++i)
+    {
+        const DescriptorSetLayout* pLayout = GetSetLayouts(i);
+
+        ppSetLayouts[i] = reinterpret_cast<DescriptorSetLayout*>(Util::VoidPtrInc(pSysMem, currentSetLayoutOffset));
+
+        pLayout->Copy(pDevice, ppSetLayouts[i]);
+
+        currentSetLayoutOffset += pLayout->GetObjectSize();
+    }
+
+    VK_PLACEMENT_NEW(pSysMem) PipelineLayout(pDevice, m_info, m_pipelineInfo, m_apiHash);
+
+    *pPipelineLayout = PipelineLayout::HandleFromVoidPointer(pSysMem);
+
+    return VK_SUCCESS;
+}
+
 // =====================================================================================================================
 // Destroy pipeline layout object
 VkResult PipelineLayout::Destroy(
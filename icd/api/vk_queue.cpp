@@ -496,6 +496,10 @@ VkResult Queue::Submit(
 
             const uint32_t deviceCount = (pDeviceGroupInfo == nullptr) ? 1 : m_pDevice->NumPalDevices();
 
+            // Command buffers with breadcrumbs remember which submission they were last part of
+            const uint64 breadcrumbSubmitId = (m_pDevice->GetRuntimeSettings().breadcrumbRingEntries > 0) ?
+                                              m_pDevice->NextBreadcrumbSubmitId() : 0;
+
             for (uint32_t deviceIdx = 0; (deviceIdx < deviceCount) && (result == VK_SUCCESS); deviceIdx++)
             {
                 // Get the PAL command buffer object from each Vulkan object and put it
@@ -509,6 +513,14 @@ VkResult Queue::Submit(
 
                 const uint32_t deviceMask = 1 << deviceIdx;
 
+#if ICD_GPUOPEN_DEVMODE_BUILD
+                // Submits to queues that support timing are timed; the command buffers' API and SQTT IDs are gathered
+                // below
+                Pal::uint64* pApiCmdBufIds  = nullptr;
+                Pal::uint32* pSqttCmdBufIds = timedQueueEvents ?
+                    m_pDevModeMgr->GetTimedSubmitCmdBufIds(deviceIdx, this, cmdBufferCount, &pApiCmdBufIds) : nullptr;
+#endif
+
                 for (uint32_t i = 0; i < cmdBufferCount; ++i)
                 {
                     if ((deviceCount > 1) &&
@@ -522,9 +534,19 @@ VkResult Queue::Submit(
 
                     if (cmdBuf.IsProtected() == protectedSubmit)
                     {
+#if ICD_GPUOPEN_DEVMODE_BUILD
+                        if (pSqttCmdBufIds != nullptr)
+                        {
+                            pApiCmdBufIds[perSubQueueInfo.cmdBufferCount]  =
+                                reinterpret_cast<Pal::uint64>(pCmdBuffers[i]);
+                            pSqttCmdBufIds[perSubQueueInfo.cmdBufferCount] = cmdBuf.GetSqttCmdBufId();
+                        }
+#endif
 
                         pPalCmdBuffers[perSubQueueInfo.cmdBufferCount++] = cmdBuf.PalCmdBuffer(deviceIdx);
 
+                        cmdBuf.MarkBreadcrumbSubmit(this, breadcrumbSubmitId);
+
                         const uint32_t stackSizeInDwords =
                             Util::NumBytesToNumDwords(cmdBuf.PerGpuState(deviceIdx)->maxPipelineStackSize);
 
@@ -552,7 +574,9 @@ VkResult Queue::Submit(
                 {
                     Pal::Result palResult = Pal::Result::Success;
 
-                    if (timedQueueEvents == false)
+#if ICD_GPUOPEN_DEVMODE_BUILD
+                    if (pSqttCmdBufIds == nullptr)
+#endif
                     {
                         const Pal::DeviceProperties& deviceProps = m_pDevice->VkPhysicalDevice(deviceIdx)->PalProperties();
 
@@ -613,23 +637,21 @@ VkResult Queue::Submit(
                             palResult = PalQueue(deviceIdx)->Submit(palSubmitInfo);
                         }
                     }
+#if ICD_GPUOPEN_DEVMODE_BUILD
                     else
                     {
-#if ICD_GPUOPEN_DEVMODE_BUILD
                         // TMZ is NOT supported for GPUOPEN path.
                         VK_ASSERT((*pCommandBuffers[0])->IsProtected() == false);
+                        VK_ASSERT(perSubQueueInfo.cmdBufferCount == cmdBufferCount);
 
                         palResult = m_pDevModeMgr->TimedQueueSubmit(
                             deviceIdx,
                             this,
-                            cmdBufferCount,
-                            pCmdBuffers,
-                            palSubmitInfo,
-                            &virtStackFrame);
-#else
-                        VK_NEVER_CALLED();
-#endif
+                            pApiCmdBufIds,
+                            pSqttCmdBufIds,
+                            palSubmitInfo);
                     }
+#endif
 
                     result = PalToVkResult(palResult);
                 }
@@ -695,6 +717,11 @@ VkResult Queue::Submit(
         }
     }
 
+    if ((result == VK_ERROR_DEVICE_LOST) && (m_pDevice->GetRuntimeSettings().breadcrumbRingEntries > 0))
+    {
+        m_pDevice->ReportBreadcrumbs();
+    }
+
     return result;
 }
 
@@ -713,7 +740,14 @@ VkResult Queue::WaitIdle(void)
         palResult = PalQueue(deviceIdx)->WaitIdle();
     }
 
-    return PalToVkResult(palResult);
+    const VkResult result = PalToVkResult(palResult);
+
+    if ((result == VK_ERROR_DEVICE_LOST) && (m_pDevice->GetRuntimeSettings().breadcrumbRingEntries > 0))
+    {
+        m_pDevice->ReportBreadcrumbs();
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
@@ -921,6 +955,7 @@ VkResult Queue::Present(
 
     const VkPresentRegionsKHR* pVkRegions = nullptr;
     const VkDeviceGroupPresentInfoKHR* pDeviceGroupPresentInfoKHR = nullptr;
+    const VkPresentIdKHR* pPresentIds = nullptr;
 
     if (pPresentInfo == nullptr)
     {
@@ -957,6 +992,12 @@ VkResult Queue::Present(
             VK_ASSERT(pVkRegions->swapchainCount == pPresentInfo->swapchainCount);
             break;
         }
+        case VK_STRUCTURE_TYPE_PRESENT_ID_KHR:
+        {
+            pPresentIds = static_cast<const VkPresentIdKHR*>(pNext);
+            VK_ASSERT(pPresentIds->swapchainCount == pPresentInfo->swapchainCount);
+            break;
+        }
         default:
             // Skip any unknown extension structures
             break;
@@ -1100,8 +1141,39 @@ VkResult Queue::Present(
             needSemaphoreFlush = false;
         }
 
-        // Perform the actual present
-        Pal::Result palResult = pPresentQueue->PresentSwapChain(presentInfo);
+        // Perform the actual present.  Headless swap chains have no PAL swap chain, so their images are handed to the
+        // emulated presentation engine instead.  An identifier of zero means the present is untagged.
+        Pal::Result    palResult = Pal::Result::Success;
+        const uint64_t presentId = ((pPresentIds != nullptr) && (pPresentIds->pPresentIds != nullptr)) ?
+                                   pPresentIds->pPresentIds[curSwapchain] : 0;
+
+#if ICD_PRESENT_TIMING
+        const uint64_t presentStart = utils::GetTimeNano();
+#endif
+
+        if (pSwapChain->IsHeadless())
+        {
+            palResult = pSwapChain->GetHeadlessPresenter()->Present(pPresentQueue, imageIndex, presentId);
+        }
+        else
+        {
+            palResult = pPresentQueue->PresentSwapChain(presentInfo);
+        }
+
+#if ICD_PRESENT_TIMING
+        if (pSwapChain->GetPresentTimingLog() != nullptr)
+        {
+            pSwapChain->GetPresentTimingLog()->AddStageTime(PresentTimingLog::StagePresentSubmit,
+                                                            utils::GetTimeNano() - presentStart);
+        }
+#endif
+
+        // Track the completion of presents tagged with an identifier for vkWaitForPresentKHR.  Headless swap chains
+        // have no timeline since their presentation engine tracks it.
+        if ((palResult == Pal::Result::Success) && (presentId != 0) && (pSwapChain->GetPresentTimeline() != nullptr))
+        {
+            palResult = pSwapChain->GetPresentTimeline()->MarkPresent(pPresentQueue, presentId);
+        }
 
         result = NotifyFlipMetadataAfterPresent(presentationDeviceIdx, &presentInfo);
 
@@ -1128,6 +1200,12 @@ VkResult Queue::Present(
             curResult = VK_SUBOPTIMAL_KHR;
         }
 
+        // No further presents can be made to the swap chain, so fail the waits for presents that never arrived.
+        if ((curResult == VK_ERROR_OUT_OF_DATE_KHR) || (curResult == VK_ERROR_SURFACE_LOST_KHR))
+        {
+            pSwapChain->MarkPresentsOutOfDate();
+        }
+
         if (pPresentInfo->pResults)
         {
             pPresentInfo->pResults[curSwapchain] = curResult;
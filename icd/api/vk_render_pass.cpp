@@ -229,7 +229,8 @@ AttachmentDescription::AttachmentDescription()
     initialLayout       (VK_IMAGE_LAYOUT_UNDEFINED),
     finalLayout         (VK_IMAGE_LAYOUT_UNDEFINED),
     stencilInitialLayout(VK_IMAGE_LAYOUT_UNDEFINED),
-    stencilFinalLayout  (VK_IMAGE_LAYOUT_UNDEFINED)
+    stencilFinalLayout  (VK_IMAGE_LAYOUT_UNDEFINED),
+    palFormat           (Pal::UndefinedSwizzledFormat)
 {
 }
 
@@ -797,6 +798,63 @@ RenderPass::RenderPass(
 {
 }
 
+// =====================================================================================================================
+// Builds the execute info of a render pass whose create info has been laid out after the object in pMemory, and
+// constructs the render pass object.  pMemory is freed on failure.
+static VkResult BuildRenderPass(
+    Device*                             pDevice,
+    const RenderPassCreateInfo&         renderPassInfo,
+    const VkAllocationCallbacks*        pAllocator,
+    void*                               pMemory,
+    VkRenderPass*                       pOutRenderPass)
+{
+    utils::TempMemArena buildArena(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+
+    RenderPassExecuteInfo* pExecuteInfo = nullptr;
+    RenderPassLogger*      pLogger      = nullptr;
+
+#if ICD_LOG_RENDER_PASSES
+    RenderPassLogger logger(&buildArena, pDevice);
+
+    pLogger = &logger;
+#endif
+
+    RenderPassLogBegin(pLogger, &renderPassInfo);
+
+    RenderPassBuilder builder(pDevice, &buildArena, pLogger);
+
+    VkResult result = builder.Build(
+        &renderPassInfo,
+        pAllocator,
+        &pExecuteInfo);
+
+    if (result != VK_SUCCESS)
+    {
+        if (pExecuteInfo != nullptr)
+        {
+            pExecuteInfo->~RenderPassExecuteInfo();
+            pAllocator->pfnFree(pAllocator->pUserData, pExecuteInfo);
+        }
+
+        if (pMemory != nullptr)
+        {
+            pDevice->FreeApiObject(pAllocator, pMemory);
+        }
+
+        return result;
+    }
+
+    RenderPassLogExecuteInfo(pLogger, pExecuteInfo);
+
+    RenderPassLogEnd(pLogger);
+
+    VK_PLACEMENT_NEW(pMemory) RenderPass(&renderPassInfo, pExecuteInfo);
+
+    *pOutRenderPass = RenderPass::HandleFromVoidPointer(pMemory);
+
+    return result;
+}
+
 // =====================================================================================================================
 // Creates a render pass
 template <typename RenderPassCreateInfoType>
@@ -806,10 +864,7 @@ static VkResult CreateRenderPass(
     const VkAllocationCallbacks*        pAllocator,
     VkRenderPass*                       pOutRenderPass)
 {
-    VkResult result  = VK_SUCCESS;
-    void*    pMemory = nullptr;
-
-    utils::TempMemArena buildArena(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    void* pMemory = nullptr;
 
     RenderPassExtCreateInfo renderPassExt;
 
@@ -862,49 +917,14 @@ static VkResult CreateRenderPass(
         pMemoryInfo,
         infoMemorySize);
 
-    RenderPassExecuteInfo* pExecuteInfo = nullptr;
-    RenderPassLogger*      pLogger      = nullptr;
-
-#if ICD_LOG_RENDER_PASSES
-    RenderPassLogger logger(&buildArena, pDevice);
-
-    pLogger = &logger;
-#endif
-
-    RenderPassLogBegin(pLogger, &renderPassInfo);
-
-    RenderPassBuilder builder(pDevice, &buildArena, pLogger);
-
-    result = builder.Build(
-        &renderPassInfo,
-        pAllocator,
-        &pExecuteInfo);
-
-    if (result != VK_SUCCESS)
+    for (uint32_t i = 0; i < renderPassInfo.attachmentCount; ++i)
     {
-        if (pExecuteInfo != nullptr)
-        {
-            pExecuteInfo->~RenderPassExecuteInfo();
-            pAllocator->pfnFree(pAllocator->pUserData, pExecuteInfo);
-        }
+        AttachmentDescription* pAttachment = &renderPassInfo.pAttachments[i];
 
-        if (pMemory != nullptr)
-        {
-            pDevice->FreeApiObject(pAllocator, pMemory);
-        }
-
-        return result;
+        pAttachment->palFormat = VkToPalFormat(pAttachment->format, pDevice->GetRuntimeSettings());
     }
 
-    RenderPassLogExecuteInfo(pLogger, pExecuteInfo);
-
-    RenderPassLogEnd(pLogger);
-
-    VK_PLACEMENT_NEW(pMemory) RenderPass(&renderPassInfo, pExecuteInfo);
-
-    *pOutRenderPass = RenderPass::HandleFromVoidPointer(pMemory);
-
-    return result;
+    return BuildRenderPass(pDevice, renderPassInfo, pAllocator, pMemory, pOutRenderPass);
 }
 
 // =====================================================================================================================
@@ -935,6 +955,104 @@ VkResult RenderPass::Create(
         pRenderPass);
 }
 
+// =====================================================================================================================
+// Creates an independent copy of this render pass for objects that must outlive the application's handle (e.g. graphics
+// pipeline libraries).  The create info is deep copied and the execute info is rebuilt from it.
+VkResult RenderPass::Clone(
+    Device*                             pDevice,
+    const VkAllocationCallbacks*        pAllocator,
+    VkRenderPass*                       pRenderPass
+    ) const
+{
+    const RenderPassCreateInfo& src = m_createInfo;
+
+    // Lay the copy out from the most to the least aligned array
+    size_t refCount = 0;
+
+    for (uint32_t i = 0; i < src.subpassCount; ++i)
+    {
+        const SubpassDescription& subpass = src.pSubpasses[i];
+
+        refCount += subpass.inputAttachmentCount + subpass.colorAttachmentCount;
+        refCount += (subpass.pResolveAttachments != nullptr) ? subpass.colorAttachmentCount : 0;
+    }
+
+    const size_t apiSize         = Util::Pow2Align(sizeof(RenderPass), VK_DEFAULT_MEM_ALIGN);
+    const size_t subpassesSize   = src.subpassCount * sizeof(SubpassDescription);
+    const size_t dependencySize  = src.dependencyCount * sizeof(SubpassDependency);
+    const size_t attachmentsSize = src.attachmentCount * sizeof(AttachmentDescription);
+    const size_t refsSize        = refCount * sizeof(AttachmentReference);
+
+    size_t indexCount = src.correlatedViewMaskCount;
+
+    for (uint32_t i = 0; i < src.subpassCount; ++i)
+    {
+        indexCount += src.pSubpasses[i].preserveAttachmentCount;
+    }
+
+    const size_t infoMemorySize = subpassesSize + dependencySize + attachmentsSize + refsSize +
+                                  (indexCount * sizeof(uint32_t));
+
+    void* pMemory = pDevice->AllocApiObject(pAllocator, apiSize + infoMemorySize);
+
+    if (pMemory == nullptr)
+    {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    RenderPassCreateInfo renderPassInfo = src;
+
+    void* pNextMem = Util::VoidPtrInc(pMemory, apiSize);
+
+    renderPassInfo.pSubpasses = static_cast<SubpassDescription*>(pNextMem);
+    pNextMem                  = Util::VoidPtrInc(pNextMem, subpassesSize);
+
+    renderPassInfo.pDependencies = static_cast<SubpassDependency*>(pNextMem);
+    pNextMem                     = Util::VoidPtrInc(pNextMem, dependencySize);
+
+    renderPassInfo.pAttachments = static_cast<AttachmentDescription*>(pNextMem);
+    pNextMem                    = Util::VoidPtrInc(pNextMem, attachmentsSize);
+
+    AttachmentReference* pRefs    = static_cast<AttachmentReference*>(pNextMem);
+    uint32_t*            pIndices = static_cast<uint32_t*>(Util::VoidPtrInc(pNextMem, refsSize));
+
+    memcpy(renderPassInfo.pSubpasses,    src.pSubpasses,    subpassesSize);
+    memcpy(renderPassInfo.pDependencies, src.pDependencies, dependencySize);
+    memcpy(renderPassInfo.pAttachments,  src.pAttachments,  attachmentsSize);
+
+    for (uint32_t i = 0; i < src.subpassCount; ++i)
+    {
+        const SubpassDescription& srcSubpass = src.pSubpasses[i];
+        SubpassDescription*       pSubpass   = &renderPassInfo.pSubpasses[i];
+
+        pSubpass->pInputAttachments = pRefs;
+        memcpy(pRefs, srcSubpass.pInputAttachments, srcSubpass.inputAttachmentCount * sizeof(AttachmentReference));
+        pRefs += srcSubpass.inputAttachmentCount;
+
+        pSubpass->pColorAttachments = pRefs;
+        memcpy(pRefs, srcSubpass.pColorAttachments, srcSubpass.colorAttachmentCount * sizeof(AttachmentReference));
+        pRefs += srcSubpass.colorAttachmentCount;
+
+        if (srcSubpass.pResolveAttachments != nullptr)
+        {
+            pSubpass->pResolveAttachments = pRefs;
+            memcpy(pRefs,
+                   srcSubpass.pResolveAttachments,
+                   srcSubpass.colorAttachmentCount * sizeof(AttachmentReference));
+            pRefs += srcSubpass.colorAttachmentCount;
+        }
+
+        pSubpass->pPreserveAttachments = pIndices;
+        memcpy(pIndices, srcSubpass.pPreserveAttachments, srcSubpass.preserveAttachmentCount * sizeof(uint32_t));
+        pIndices += srcSubpass.preserveAttachmentCount;
+    }
+
+    renderPassInfo.pCorrelatedViewMasks = pIndices;
+    memcpy(pIndices, src.pCorrelatedViewMasks, src.correlatedViewMaskCount * sizeof(uint32_t));
+
+    return BuildRenderPass(pDevice, renderPassInfo, pAllocator, pMemory, pRenderPass);
+}
+
 // =====================================================================================================================
 // Returns the output format of a particular color attachment in a particular subpass
 VkFormat RenderPass::GetColorAttachmentFormat(
@@ -959,6 +1077,30 @@ VkFormat RenderPass::GetColorAttachmentFormat(
     return format;
 }
 
+// =====================================================================================================================
+// Returns the PAL format of a particular color attachment in a particular subpass
+Pal::SwizzledFormat RenderPass::GetColorAttachmentPalFormat(
+    uint32_t subpassIndex,
+    uint32_t colorTarget
+    ) const
+{
+    const SubpassDescription& subPass = m_createInfo.pSubpasses[subpassIndex];
+    const uint32_t attachIndex        = subPass.pColorAttachments[colorTarget].attachment;
+
+    Pal::SwizzledFormat format;
+
+    if (subPass.colorAttachmentCount > 0 && attachIndex != VK_ATTACHMENT_UNUSED)
+    {
+        format = m_createInfo.pAttachments[attachIndex].palFormat;
+    }
+    else
+    {
+        format = Pal::UndefinedSwizzledFormat;
+    }
+
+    return format;
+}
+
 // =====================================================================================================================
 // Returns the depth stencil format in a particular subpass
 VkFormat RenderPass::GetDepthStencilAttachmentFormat(
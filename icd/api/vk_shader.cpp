@@ -74,12 +74,12 @@ VK_INLINE void MetroHashTo128Bit(
 }
 
 // =====================================================================================================================
-// Returns a 128-bit hash based on this module's SPIRV code plus an optional entry point combination.
+// Returns a 128-bit hash based on a module's SPIRV code hash plus an optional entry point combination.
 Pal::ShaderHash ShaderModule::GetCodeHash(
-    const char* pEntryPoint
-    ) const
+    Pal::ShaderHash codeHash,
+    const char*     pEntryPoint)
 {
-    Pal::ShaderHash hash = m_codeHash;
+    Pal::ShaderHash hash = codeHash;
 
     if (pEntryPoint != nullptr)
     {
@@ -103,6 +103,55 @@ Pal::ShaderHash ShaderModule::GetCodeHash(
     return hash;
 }
 
+// =====================================================================================================================
+// Builds the identifier of the given SPIRV code.  The hash is the one used by profile-guided compilation parameter
+// tuning and pipeline API hashing, so an identifier can stand in for the module in both.
+void ShaderModule::BuildIdentifier(
+    size_t                  codeSize,
+    const void*             pCode,
+    ShaderModuleIdentifier* pIdentifier)
+{
+    Util::MetroHash::Hash codeHash = {};
+    Util::MetroHash128::Hash(static_cast<const uint8_t*>(pCode), codeSize, codeHash.bytes);
+
+    MetroHashTo128Bit(codeHash, &pIdentifier->codeHash.lower, &pIdentifier->codeHash.upper);
+    pIdentifier->codeSize = codeSize;
+}
+
+// =====================================================================================================================
+void ShaderModule::GetIdentifier(
+    ShaderModuleIdentifier* pIdentifier) const
+{
+    pIdentifier->codeHash = m_codeHash;
+    pIdentifier->codeSize = m_codeSize;
+}
+
+// =====================================================================================================================
+// Returns the module identifier given in place of a module for a pipeline shader stage, if any.
+bool ShaderModule::GetStageIdentifier(
+    const VkPipelineShaderStageCreateInfo& stage,
+    ShaderModuleIdentifier*                pIdentifier)
+{
+    const VkPipelineShaderStageModuleIdentifierCreateInfoEXT* pIdentifierInfo = nullptr;
+
+    if (stage.module == VK_NULL_HANDLE)
+    {
+        pIdentifierInfo = utils::GetExtensionStructure<VkPipelineShaderStageModuleIdentifierCreateInfoEXT>(
+            &stage,
+            static_cast<VkStructureType>(VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_MODULE_IDENTIFIER_CREATE_INFO_EXT));
+    }
+
+    // Identifiers of any other size can't have come from this driver
+    const bool valid = (pIdentifierInfo != nullptr) && (pIdentifierInfo->identifierSize == sizeof(*pIdentifier));
+
+    if (valid)
+    {
+        memcpy(pIdentifier, pIdentifierInfo->pIdentifier, sizeof(*pIdentifier));
+    }
+
+    return valid;
+}
+
 // =====================================================================================================================
 // Gets shader data per compiler type.
 void* ShaderModule::GetShaderData(
@@ -139,10 +188,10 @@ ShaderModule::ShaderModule(
 
     // Calculate a 128-bit hash from the SPIRV code.  This is used by profile-guided compilation
     // parameter tuning.
-    Util::MetroHash::Hash codeHash = {};
-    Util::MetroHash128::Hash(static_cast<const uint8_t*>(pCode), codeSize, codeHash.bytes);
+    ShaderModuleIdentifier identifier = {};
+    BuildIdentifier(codeSize, pCode, &identifier);
 
-    MetroHashTo128Bit(codeHash, &m_codeHash.lower, &m_codeHash.upper);
+    m_codeHash = identifier.codeHash;
     memset(&m_handle, 0, sizeof(m_handle));
 }
 
@@ -224,6 +273,36 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyShaderModule(
     }
 }
 
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkGetShaderModuleIdentifierEXT(
+    VkDevice                                    device,
+    VkShaderModule                              shaderModule,
+    VkShaderModuleIdentifierEXT*                pIdentifier)
+{
+    ShaderModuleIdentifier identifier = {};
+
+    ShaderModule::ObjectFromHandle(shaderModule)->GetIdentifier(&identifier);
+
+    static_assert(sizeof(identifier) <= sizeof(pIdentifier->identifier), "Shader module identifier is too large");
+
+    pIdentifier->identifierSize = sizeof(identifier);
+    memcpy(pIdentifier->identifier, &identifier, sizeof(identifier));
+}
+
+// =====================================================================================================================
+VKAPI_ATTR void VKAPI_CALL vkGetShaderModuleCreateInfoIdentifierEXT(
+    VkDevice                                    device,
+    const VkShaderModuleCreateInfo*             pCreateInfo,
+    VkShaderModuleIdentifierEXT*                pIdentifier)
+{
+    ShaderModuleIdentifier identifier = {};
+
+    ShaderModule::BuildIdentifier(pCreateInfo->codeSize, pCreateInfo->pCode, &identifier);
+
+    pIdentifier->identifierSize = sizeof(identifier);
+    memcpy(pIdentifier->identifier, &identifier, sizeof(identifier));
+}
+
 } // namespace entry
 
 } // namespace vk
@@ -51,6 +51,7 @@ VkResult Surface::Create(
     VkIcdSurfaceXlib xlibSurface = {};
 #endif
     VkIcdSurfaceDisplay displaySurface = {};
+    VkIcdSurfaceHeadless headlessSurface = {};
 #ifdef VK_USE_PLATFORM_WAYLAND_KHR
     VkIcdSurfaceWayland waylandSurface = {};
 #endif
@@ -108,6 +109,13 @@ VkResult Surface::Create(
             break;
         }
 
+        case VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT:
+        {
+            headlessSurface.base.platform = VK_ICD_WSI_PLATFORM_HEADLESS;
+
+            break;
+        }
+
 #ifdef VK_USE_PLATFORM_WAYLAND_KHR
         case VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR:
         {
@@ -153,6 +161,10 @@ VkResult Surface::Create(
         {
             pSurface = VK_PLACEMENT_NEW(pMemory) Surface(pInstance, displaySurface);
         }
+        else if (headlessSurface.base.platform == VK_ICD_WSI_PLATFORM_HEADLESS)
+        {
+            pSurface = VK_PLACEMENT_NEW(pMemory) Surface(pInstance, headlessSurface);
+        }
 #ifdef VK_USE_PLATFORM_XCB_KHR
         else if (xcbSurface.base.platform == VK_ICD_WSI_PLATFORM_XCB)
         {
@@ -241,6 +253,17 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateDisplayPlaneSurfaceKHR(
         reinterpret_cast<const VkStructHeader*>(pCreateInfo), pAllocator, pSurface);
 }
 
+// =====================================================================================================================
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateHeadlessSurfaceEXT(
+    VkInstance                                  instance,
+    const VkHeadlessSurfaceCreateInfoEXT*       pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkSurfaceKHR*                               pSurface)
+{
+    return Surface::Create(Instance::ObjectFromHandle(instance),
+        reinterpret_cast<const VkStructHeader*>(pCreateInfo), pAllocator, pSurface);
+}
+
 // =====================================================================================================================
 VKAPI_ATTR void VKAPI_CALL vkDestroySurfaceKHR(
     VkInstance                                   instance,
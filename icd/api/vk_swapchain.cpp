@@ -49,6 +49,10 @@
 #include "palSwapChain.h"
 #include "palAutoBuffer.h"
 
+#if ICD_PRESENT_TIMING
+#include "palFile.h"
+#endif
+
 #include <stdio.h>
 
 namespace vk
@@ -68,6 +72,8 @@ SwapChain::SwapChain(
     const Properties&   properties,
     VkPresentModeKHR    presentMode,
     FullscreenMgr*      pFullscreenMgr,
+    HeadlessPresenter*  pHeadlessPresenter,
+    PresentTimeline*    pPresentTimeline,
     Pal::ISwapChain*    pPalSwapChain)
     :
     m_pDevice(pDevice),
@@ -77,6 +83,11 @@ SwapChain::SwapChain(
     m_colorParams({}),
     m_pFullscreenMgr(pFullscreenMgr),
     m_pSwCompositor(nullptr),
+    m_pHeadlessPresenter(pHeadlessPresenter),
+    m_pPresentTimeline(pPresentTimeline),
+#if ICD_PRESENT_TIMING
+    m_pPresentTimingLog(nullptr),
+#endif
     m_appOwnedImageCount(0),
     m_presentCount(0),
     m_presentMode(presentMode),
@@ -115,6 +126,10 @@ VkResult SwapChain::Create(
 
     result = PhysicalDevice::UnpackDisplayableSurface(pSurface, &properties.displayableInfo);
 
+    // Headless swap chains are backed by ordinary images and an emulated presentation engine instead of a PAL swap
+    // chain.
+    const bool isHeadless = (properties.displayableInfo.icdPlatform == VK_ICD_WSI_PLATFORM_HEADLESS);
+
     if (pDevice->VkInstance()->GetProperties().supportExplicitPresentMode)
     {
         properties.imagePresentSupport = Pal::PresentMode::Windowed;
@@ -287,9 +302,14 @@ VkResult SwapChain::Create(
                        FullscreenMgr::Implicit;
     // Find the monitor is associated with the given window handle
     Pal::IDevice* pPalDevice = pDevice->PalDevice(properties.presentationDeviceIdx);
-    Pal::IScreen* pScreen    = pDevice->VkInstance()->FindScreen(pPalDevice,
-                                                                 swapChainCreateInfo.hWindow,
-                                                                 properties.imageCreateInfo.hDisplay);
+    Pal::IScreen* pScreen    = nullptr;
+
+    if (isHeadless == false)
+    {
+        pScreen = pDevice->VkInstance()->FindScreen(pPalDevice,
+                                                    swapChainCreateInfo.hWindow,
+                                                    properties.imageCreateInfo.hDisplay);
+    }
 
     Pal::ScreenProperties screenProperties = {};
 
@@ -310,7 +330,10 @@ VkResult SwapChain::Create(
     primaryInfoInput.height         = properties.imageCreateInfo.extent.height;
     primaryInfoInput.swizzledFormat = properties.imageCreateInfo.swizzledFormat;
 
-    pPalDevice->GetPrimaryInfo(primaryInfoInput, &primaryInfoOutput);
+    if (isHeadless == false)
+    {
+        pPalDevice->GetPrimaryInfo(primaryInfoInput, &primaryInfoOutput);
+    }
 
     if ((primaryInfoOutput.flags.dvoHwMode | primaryInfoOutput.flags.xdmaHwMode) != 0)
     {
@@ -331,9 +354,13 @@ VkResult SwapChain::Create(
 
     // Allocate system memory for all objects
     const size_t vkSwapChainSize  = sizeof(SwapChain);
-    size_t       palSwapChainSize = pPalDevice->GetSwapChainSize(swapChainCreateInfo,
-                                                                 &palResult);
-    VK_ASSERT(palResult == Pal::Result::Success);
+    size_t       palSwapChainSize = 0;
+
+    if (isHeadless == false)
+    {
+        palSwapChainSize = pPalDevice->GetSwapChainSize(swapChainCreateInfo, &palResult);
+        VK_ASSERT(palResult == Pal::Result::Success);
+    }
 
     size_t          queueFamilyArraySize = sizeof(uint32_t*) * pCreateInfo->queueFamilyIndexCount;
     size_t          imageArraySize       = sizeof(VkImage) * swapImageCount;
@@ -353,20 +380,50 @@ VkResult SwapChain::Create(
 
     size_t offset = vkSwapChainSize;
 
-    palResult = pPalDevice->CreateSwapChain(
-        swapChainCreateInfo,
-        Util::VoidPtrInc(pMemory, offset),
-        &pPalSwapChain);
+    HeadlessPresenter* pHeadlessPresenter = nullptr;
 
-    offset += palSwapChainSize;
+    if (isHeadless)
+    {
+        result = HeadlessPresenter::Create(
+            pDevice,
+            pAllocator,
+            swapImageCount,
+            pCreateInfo->presentMode,
+            &pHeadlessPresenter);
+    }
+    else
+    {
+        palResult = pPalDevice->CreateSwapChain(
+            swapChainCreateInfo,
+            Util::VoidPtrInc(pMemory, offset),
+            &pPalSwapChain);
 
-    result = PalToVkResult(palResult);
+        result = PalToVkResult(palResult);
+    }
 
-    if (result == VK_SUCCESS)
+    offset += palSwapChainSize;
+
+    if ((result == VK_SUCCESS) && (pPalSwapChain != nullptr))
     {
         properties.imageCreateInfo.pSwapChain = pPalSwapChain;
     }
 
+    PresentTimeline* pPresentTimeline = nullptr;
+
+    // Headless swap chains track present completion in their emulated presentation engine.
+    if ((result == VK_SUCCESS) &&
+        (isHeadless == false) &&
+        pDevice->IsExtensionEnabled(DeviceExtensions::KHR_PRESENT_WAIT))
+    {
+        // Every image can have a present in flight, plus as many again while their earlier presents retire.
+        pPresentTimeline = PresentTimeline::Create(pDevice,
+                                                   properties.presentationDeviceIdx,
+                                                   pAllocator,
+                                                   swapImageCount * 2);
+
+        result = (pPresentTimeline != nullptr) ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
     // Allocate memory for the fullscreen manager if it's enabled.  We need to create it first before the
     // swap chain because it needs to have a say in how presentable images are created.
     FullscreenMgr* pFullscreenMgr = nullptr;
@@ -422,26 +479,81 @@ VkResult SwapChain::Create(
     // memcpy queue family indices
     memcpy(properties.pQueueFamilyIndices, pCreateInfo->pQueueFamilyIndices, queueFamilyArraySize);
 
+    // Headless images go through the regular image path, so translate the swap chain parameters to image ones.
+    VkImageFormatListCreateInfoKHR headlessFormatList      = {};
+    VkImageCreateInfo              headlessImageCreateInfo = {};
+
+    if (isHeadless)
+    {
+        headlessImageCreateInfo.sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        headlessImageCreateInfo.imageType             = VK_IMAGE_TYPE_2D;
+        headlessImageCreateInfo.format                = pCreateInfo->imageFormat;
+        headlessImageCreateInfo.extent                = { pCreateInfo->imageExtent.width,
+                                                          pCreateInfo->imageExtent.height,
+                                                          1 };
+        headlessImageCreateInfo.mipLevels             = 1;
+        headlessImageCreateInfo.arrayLayers           = pCreateInfo->imageArrayLayers;
+        headlessImageCreateInfo.samples               = VK_SAMPLE_COUNT_1_BIT;
+        headlessImageCreateInfo.tiling                = VK_IMAGE_TILING_OPTIMAL;
+        headlessImageCreateInfo.usage                 = pCreateInfo->imageUsage;
+        headlessImageCreateInfo.sharingMode           = pCreateInfo->imageSharingMode;
+        headlessImageCreateInfo.queueFamilyIndexCount = pCreateInfo->queueFamilyIndexCount;
+        headlessImageCreateInfo.pQueueFamilyIndices   = pCreateInfo->pQueueFamilyIndices;
+        headlessImageCreateInfo.initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if ((pCreateInfo->flags & VK_SWAPCHAIN_CREATE_PROTECTED_BIT_KHR) != 0)
+        {
+            headlessImageCreateInfo.flags |= VK_IMAGE_CREATE_PROTECTED_BIT;
+        }
+
+        if (mutableFormat)
+        {
+            headlessImageCreateInfo.flags |= (VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT);
+
+            if (viewFormatCount > 0)
+            {
+                headlessFormatList.sType           = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO_KHR;
+                headlessFormatList.viewFormatCount = viewFormatCount;
+                headlessFormatList.pViewFormats    = pViewFormats;
+
+                headlessImageCreateInfo.pNext = &headlessFormatList;
+            }
+        }
+    }
+
     for (properties.imageCount = 0; properties.imageCount < swapImageCount; ++properties.imageCount)
     {
         if (result == VK_SUCCESS)
         {
-            // Create presentable image
-            result = Image::CreatePresentableImage(
-                pDevice,
-                &properties.imageCreateInfo,
-                pAllocator,
-                properties.usage,
-                properties.imagePresentSupport,
-                &properties.images[properties.imageCount],
-                properties.format,
-                properties.sharingMode,
-                properties.queueFamilyIndexCount,
-                properties.pQueueFamilyIndices,
-                &properties.imageMemory[properties.imageCount]);
+            if (isHeadless)
+            {
+                result = Image::CreateHeadlessPresentableImage(
+                    pDevice,
+                    &headlessImageCreateInfo,
+                    pAllocator,
+                    &properties.images[properties.imageCount],
+                    &properties.imageMemory[properties.imageCount]);
+            }
+            else
+            {
+                // Create presentable image
+                result = Image::CreatePresentableImage(
+                    pDevice,
+                    &properties.imageCreateInfo,
+                    pAllocator,
+                    properties.usage,
+                    properties.imagePresentSupport,
+                    &properties.images[properties.imageCount],
+                    properties.format,
+                    properties.sharingMode,
+                    properties.queueFamilyIndexCount,
+                    properties.pQueueFamilyIndices,
+                    &properties.imageMemory[properties.imageCount]);
+            }
         }
 
-        if (result == VK_SUCCESS)
+        // Headless image memory is allocated through the regular path, which already references it.
+        if ((result == VK_SUCCESS) && (isHeadless == false))
         {
             palResult = Pal::Result::Success;
 
@@ -479,6 +591,8 @@ VkResult SwapChain::Create(
                                             properties,
                                             pCreateInfo->presentMode,
                                             pFullscreenMgr,
+                                            pHeadlessPresenter,
+                                            pPresentTimeline,
                                             pPalSwapChain);
 
         *pSwapChain = SwapChain::HandleFromVoidPointer(pMemory);
@@ -513,6 +627,16 @@ VkResult SwapChain::Create(
             pPalSwapChain->Destroy();
         }
 
+        if (pHeadlessPresenter != nullptr)
+        {
+            pHeadlessPresenter->Destroy(pAllocator);
+        }
+
+        if (pPresentTimeline != nullptr)
+        {
+            pPresentTimeline->Destroy(pAllocator);
+        }
+
         // Delete allocated memory
         pDevice->FreeApiObject(pAllocator, pMemory);
     }
@@ -532,6 +656,15 @@ void SwapChain::Init(const VkAllocationCallbacks* pAllocator)
 {
     VkResult result = VK_SUCCESS;
 
+#if ICD_PRESENT_TIMING
+    const uint32_t timingRecordCount = m_pDevice->GetRuntimeSettings().presentTimingRecordCount;
+
+    // The timings are purely diagnostic, so the swap chain is still usable if they can't be recorded.
+    if (timingRecordCount > 0)
+    {
+        m_pPresentTimingLog = PresentTimingLog::Create(pAllocator, m_properties.imageCount, timingRecordCount);
+    }
+#endif
 }
 
 // =====================================================================================================================
@@ -570,6 +703,11 @@ VkResult SwapChain::Destroy(const VkAllocationCallbacks* pAllocator)
         m_pPalSwapChain->WaitIdle();
     }
 
+    if (m_pHeadlessPresenter != nullptr)
+    {
+        m_pHeadlessPresenter->WaitIdle();
+    }
+
     if (m_pFullscreenMgr != nullptr)
     {
         m_pFullscreenMgr->Destroy(pAllocator);
@@ -592,6 +730,34 @@ VkResult SwapChain::Destroy(const VkAllocationCallbacks* pAllocator)
         m_pPalSwapChain->Destroy();
     }
 
+    if (m_pHeadlessPresenter != nullptr)
+    {
+        m_pHeadlessPresenter->Destroy(pAllocator);
+    }
+
+    if (m_pPresentTimeline != nullptr)
+    {
+        m_pPresentTimeline->Destroy(pAllocator);
+    }
+
+#if ICD_PRESENT_TIMING
+    if (m_pPresentTimingLog != nullptr)
+    {
+        const char* pLogDir = m_pDevice->GetRuntimeSettings().presentTimingLogDirectory;
+
+        if (pLogDir[0] != '\0')
+        {
+            char fileName[Util::PathBufferLen];
+
+            Util::Snprintf(fileName, sizeof(fileName), "%s/PresentTiming_%p.csv", pLogDir, this);
+
+            DumpPresentTimings(fileName, pAllocator);
+        }
+
+        m_pPresentTimingLog->Destroy(pAllocator);
+    }
+#endif
+
     Util::Destructor(this);
 
     m_pDevice->FreeApiObject(pAllocator, this);
@@ -653,7 +819,15 @@ VkResult SwapChain::AcquireNextImage(
         Semaphore* pSemaphore = Semaphore::ObjectFromHandle(semaphore);
         Fence*     pFence     = Fence::ObjectFromHandle(fence);
 
-        if (result == VK_SUCCESS)
+#if ICD_PRESENT_TIMING
+        const uint64_t acquireStart = utils::GetTimeNano();
+#endif
+
+        if (m_pHeadlessPresenter != nullptr)
+        {
+            result = m_pHeadlessPresenter->AcquireNextImage(timeout, pSemaphore, pFence, pImageIndex);
+        }
+        else if (result == VK_SUCCESS)
         {
             acquireInfo.timeout    = timeout;
             acquireInfo.pSemaphore = (pSemaphore != nullptr) ? pSemaphore->PalSemaphore(DefaultDeviceIndex) : nullptr;
@@ -667,6 +841,13 @@ VkResult SwapChain::AcquireNextImage(
             result = PalToVkResult(m_pPalSwapChain->AcquireNextImage(acquireInfo, pImageIndex));
         }
 
+#if ICD_PRESENT_TIMING
+        if ((m_pPresentTimingLog != nullptr) && ((result == VK_SUCCESS) || (result == VK_SUBOPTIMAL_KHR)))
+        {
+            m_pPresentTimingLog->AddAcquireWait(*pImageIndex, utils::GetTimeNano() - acquireStart);
+        }
+#endif
+
         if (result == VK_SUCCESS)
         {
             m_appOwnedImageCount++;
@@ -699,10 +880,26 @@ void SwapChain::PostPresent(
 {
     if (m_pFullscreenMgr != nullptr)
     {
+#if ICD_PRESENT_TIMING
+        const uint64_t flipStart = utils::GetTimeNano();
+#endif
 
         m_pFullscreenMgr->PostPresent(this, presentInfo, pPresentResult);
 
+#if ICD_PRESENT_TIMING
+        if (m_pPresentTimingLog != nullptr)
+        {
+            m_pPresentTimingLog->AddStageTime(PresentTimingLog::StageFlipModeChange, utils::GetTimeNano() - flipStart);
+        }
+#endif
+    }
+
+#if ICD_PRESENT_TIMING
+    if (m_pPresentTimingLog != nullptr)
+    {
+        m_pPresentTimingLog->EndFrame(presentInfo.imageIndex, presentInfo.presentMode);
     }
+#endif
 
     m_appOwnedImageCount--;
     m_presentCount++;
@@ -783,9 +980,18 @@ Pal::IGpuMemory* SwapChain::UpdatePresentInfo(
     // information in case it has enabled fullscreen.
     if (m_pFullscreenMgr != nullptr)
     {
+#if ICD_PRESENT_TIMING
+        const uint64_t flipStart = utils::GetTimeNano();
+#endif
 
         m_pFullscreenMgr->UpdatePresentInfo(this, pPresentInfo);
 
+#if ICD_PRESENT_TIMING
+        if (m_pPresentTimingLog != nullptr)
+        {
+            m_pPresentTimingLog->AddStageTime(PresentTimingLog::StageFlipModeChange, utils::GetTimeNano() - flipStart);
+        }
+#endif
     }
 
     return pSrcImageGpuMemory;
@@ -818,6 +1024,10 @@ Pal::IQueue* SwapChain::PrePresent(
 
         if (m_pSwCompositor != nullptr)
         {
+#if ICD_PRESENT_TIMING
+            const uint64_t compositingStart = utils::GetTimeNano();
+#endif
+
             if (*pHasPostProcessing)
             {
                 // Submit to the original presentation queue before compositing.
@@ -839,6 +1049,14 @@ Pal::IQueue* SwapChain::PrePresent(
                                                          pPresentInfo,
                                                          ppSrcImageGpuMemory,
                                                          pPresentQueue);
+
+#if ICD_PRESENT_TIMING
+            if (m_pPresentTimingLog != nullptr)
+            {
+                m_pPresentTimingLog->AddStageTime(PresentTimingLog::StageCompositing,
+                                                  utils::GetTimeNano() - compositingStart);
+            }
+#endif
         }
     }
 
@@ -854,7 +1072,8 @@ bool SwapChain::IsSuboptimal(uint32_t deviceIdx)
     Pal::OsDisplayHandle     displayHandle       = 0;
     VkResult                 result              = VK_SUCCESS;
 
-    if (m_pDevice->GetRuntimeSettings().ignoreSuboptimalSwapchainSize == false)
+    // Headless surfaces always take the extent of the swap chain, so they can never become suboptimal.
+    if ((m_pDevice->GetRuntimeSettings().ignoreSuboptimalSwapchainSize == false) && (IsHeadless() == false))
     {
         VK_ASSERT(m_properties.pSurface != nullptr);
 
@@ -889,7 +1108,121 @@ bool SwapChain::IsSuboptimal(uint32_t deviceIdx)
 void SwapChain::MarkAsDeprecated()
 {
     m_deprecated = true;
+
+    MarkPresentsOutOfDate();
+}
+
+// =====================================================================================================================
+// Fails the present waits that can no longer be satisfied because no further presents will be made to this swap chain.
+void SwapChain::MarkPresentsOutOfDate()
+{
+    if (m_pHeadlessPresenter != nullptr)
+    {
+        m_pHeadlessPresenter->MarkOutOfDate();
+    }
+
+    if (m_pPresentTimeline != nullptr)
+    {
+        m_pPresentTimeline->MarkOutOfDate();
+    }
+}
+
+// =====================================================================================================================
+// Waits for the completion of a present tagged with a VK_KHR_present_id identifier.
+VkResult SwapChain::WaitForPresent(
+    uint64_t presentId,
+    uint64_t timeout)
+{
+    VkResult result = VK_SUCCESS;
+
+    if (m_pHeadlessPresenter != nullptr)
+    {
+        result = m_pHeadlessPresenter->WaitForPresent(presentId, timeout);
+    }
+    else
+    {
+        VK_ASSERT(m_pPresentTimeline != nullptr);
+
+        result = m_pPresentTimeline->WaitForPresent(presentId, timeout);
+    }
+
+    return result;
+}
+
+#if ICD_PRESENT_TIMING
+// =====================================================================================================================
+// Writes the frames recorded by the timing log to the given file as CSV with one line per frame and all times in
+// nanoseconds.  The records are copied out first so that the file is not written while presents are blocked on the log.
+Pal::Result SwapChain::DumpPresentTimings(
+    const char*                  pFileName,
+    const VkAllocationCallbacks* pAllocator)
+{
+    Pal::Result result      = Pal::Result::Success;
+    uint32_t    recordCount = 0;
+
+    m_pPresentTimingLog->GetRecords(&recordCount, nullptr);
+
+    PresentTimingLog::Record* pRecords = nullptr;
+
+    if (recordCount > 0)
+    {
+        pRecords = static_cast<PresentTimingLog::Record*>(pAllocator->pfnAllocation(
+            pAllocator->pUserData,
+            sizeof(PresentTimingLog::Record) * recordCount,
+            VK_DEFAULT_MEM_ALIGN,
+            VK_SYSTEM_ALLOCATION_SCOPE_COMMAND));
+
+        if (pRecords != nullptr)
+        {
+            // Nothing presents on a swap chain that is being destroyed, so the count cannot have grown meanwhile.
+            m_pPresentTimingLog->GetRecords(&recordCount, pRecords);
+        }
+        else
+        {
+            result = Pal::Result::ErrorOutOfMemory;
+        }
+    }
+
+    Util::File file;
+
+    if (result == Pal::Result::Success)
+    {
+        result = file.Open(pFileName, Util::FileAccessWrite);
+    }
+
+    if (result == Pal::Result::Success)
+    {
+        file.Printf("Frame,PresentTime,Image,PresentMode,AcquireWait,Compositing,PresentSubmit,FlipModeChange\n");
+
+        for (uint32_t i = 0; i < recordCount; ++i)
+        {
+            const PresentTimingLog::Record& record = pRecords[i];
+
+            const char* pModeName = (record.presentMode == Pal::PresentMode::Fullscreen) ? "Fullscreen" :
+                                    (record.presentMode == Pal::PresentMode::Windowed)   ? "Windowed"   : "Unknown";
+
+            file.Printf("%llu,%llu,%u,%s,%llu,%llu,%llu,%llu\n",
+                        static_cast<unsigned long long>(record.frameIndex),
+                        static_cast<unsigned long long>(record.presentTime),
+                        record.imageIndex,
+                        pModeName,
+                        static_cast<unsigned long long>(record.stageTime[PresentTimingLog::StageAcquireWait]),
+                        static_cast<unsigned long long>(record.stageTime[PresentTimingLog::StageCompositing]),
+                        static_cast<unsigned long long>(record.stageTime[PresentTimingLog::StagePresentSubmit]),
+                        static_cast<unsigned long long>(record.stageTime[PresentTimingLog::StageFlipModeChange]));
+        }
+
+        file.Close();
+    }
+
+    if (pRecords != nullptr)
+    {
+        pAllocator->pfnFree(pAllocator->pUserData, pRecords);
+    }
+
+    return result;
 }
+#endif
 
 // =====================================================================================================================
 // Set HDR Metadata
@@ -1313,33 +1646,59 @@ SwCompositor::SwCompositor(
     const Device*     pDevice,
     uint32_t          presentationDeviceIdx,
     uint32_t          imageCount,
+    uint32_t          ringSize,
     Pal::QueueType    queueType,
+    size_t            palCmdBufferSize,
     Pal::IImage**     ppBltImages[],
     Pal::IGpuMemory** ppBltMemory[],
-    Pal::ICmdBuffer** ppBltCmdBuffers[])
+    Pal::ICmdBuffer** ppBltCmdBuffers[],
+    void*             pCmdBufferMemory[],
+    RingSlot*         pSlots,
+    const VkImage*    pSrcImages)
     :
     m_presentationDeviceIdx(presentationDeviceIdx),
     m_imageCount(imageCount),
-    m_queueType(queueType)
+    m_pSrcImages(pSrcImages),
+    m_ringSize(ringSize),
+    m_nextSlot(0),
+    m_lastSlot(InvalidSlot),
+    m_shownSlot(InvalidSlot),
+    m_pLastPresentQueue(nullptr),
+    m_queueType(queueType),
+    m_palCmdBufferSize(palCmdBufferSize),
+    m_pSlots(pSlots)
 {
     for (uint32_t deviceIdx = 0; deviceIdx < pDevice->NumPalDevices(); ++deviceIdx)
     {
-        m_ppBltImages[deviceIdx]     = ppBltImages[deviceIdx];
-        m_ppBltMemory[deviceIdx]     = ppBltMemory[deviceIdx];
-        m_ppBltCmdBuffers[deviceIdx] = ppBltCmdBuffers[deviceIdx];
+        m_ppBltImages[deviceIdx]      = ppBltImages[deviceIdx];
+        m_ppBltMemory[deviceIdx]      = ppBltMemory[deviceIdx];
+        m_ppBltCmdBuffers[deviceIdx]  = ppBltCmdBuffers[deviceIdx];
+        m_pCmdBufferMemory[deviceIdx] = pCmdBufferMemory[deviceIdx];
 
-        for (uint32_t i = 0; i < m_imageCount; ++i)
+        for (uint32_t slot = 0; slot < m_ringSize; ++slot)
+        {
+            m_ppBltImages[deviceIdx][slot] = nullptr;
+            m_ppBltMemory[deviceIdx][slot] = nullptr;
+        }
+
+        for (uint32_t i = 0; i < (m_imageCount * m_ringSize); ++i)
         {
-            m_ppBltImages[deviceIdx][i]     = nullptr;
-            m_ppBltMemory[deviceIdx][i]     = nullptr;
             m_ppBltCmdBuffers[deviceIdx][i] = nullptr;
         }
     }
+
+    memset(m_pSlots, 0, sizeof(RingSlot) * m_ringSize);
 }
 
 // =====================================================================================================================
-// One time setup for this swapchain/device combination.  Creates intermediate images and command buffers to perform the
-// composition BLTs to the presentation device.
+// One time setup for this swapchain/device combination.  Creates the ring of intermediate images on the presentation
+// device along with their peer images, release fences and semaphores.  The composition BLT of each swap chain image and
+// ring slot pair is recorded the first time it is needed.
+//
+// The ring is sized independently of the swap chain (SwCompositingRingSize).  An intermediate image stays on screen
+// until a later present replaces it, so a slot is only released once the present queue has executed the present that
+// follows its own, and a copy into the slot waits for that release.  The ring always has at least two slots so the
+// slot on screen is never the next one written.
 SwCompositor* SwCompositor::Create(
     const Device*                pDevice,
     const VkAllocationCallbacks* pAllocator,
@@ -1353,8 +1712,15 @@ SwCompositor* SwCompositor::Create(
     size_t        palPeerImageSize  = 0;
     size_t        palPeerMemorySize = 0;
     size_t        palCmdBufferSize  = 0;
+    size_t        palSemaphoreSize  = 0;
+    size_t        palFenceSize      = 0;
     Pal::Result   palResult;
 
+    const uint32_t numDevices = pDevice->NumPalDevices();
+    const uint32_t imageCount = properties.imageCount;
+    const uint32_t ringSize   = Util::Max(2u, (pDevice->GetRuntimeSettings().swCompositingRingSize > 0) ?
+                                              pDevice->GetRuntimeSettings().swCompositingRingSize : imageCount);
+
     pPalDevice->GetPresentableImageSizes(properties.imageCreateInfo, &palImageSize, &palMemorySize, &palResult);
     VK_ASSERT(palResult == Pal::Result::Success);
 
@@ -1364,6 +1730,15 @@ SwCompositor* SwCompositor::Create(
     pPalDevice->GetPeerImageSizes(peerInfo, &palPeerImageSize, &palPeerMemorySize, &palResult);
     VK_ASSERT(palResult == Pal::Result::Success);
 
+    Pal::QueueSemaphoreCreateInfo semaphoreCreateInfo = {};
+    semaphoreCreateInfo.maxCount = 1;
+
+    palSemaphoreSize = pPalDevice->GetQueueSemaphoreSize(semaphoreCreateInfo, &palResult);
+    VK_ASSERT(palResult == Pal::Result::Success);
+
+    palFenceSize = pPalDevice->GetFenceSize(&palResult);
+    VK_ASSERT(palResult == Pal::Result::Success);
+
     Pal::CmdBufferCreateInfo cmdBufCreateInfo = {};
 
     if (useSdmaCompositingBlt)
@@ -1381,221 +1756,251 @@ SwCompositor* SwCompositor::Create(
     VK_ASSERT(palResult == Pal::Result::Success);
 
     // Total size for: 1. this object
-    //                 2. pBltImages, pBltMemory, pBltCmdBuffers for all images and devices
-    //                 3. the intermediate images for the presentation device
-    //                 4. the peer images for all of the other devices
-    size_t imageArraysOffset       = sizeof(SwCompositor);
-    size_t presentableDeviceOffset = imageArraysOffset +
-                                     ((sizeof(Pal::IImage*) + sizeof(Pal::IGpuMemory*) + sizeof(Pal::ICmdBuffer*)) *
-                                      properties.imageCount * pDevice->NumPalDevices());
-    size_t otherDevicesOffset      = presentableDeviceOffset + ((palImageSize + palMemorySize) * properties.imageCount);
-    size_t totalSize               = otherDevicesOffset +
-                                     ((palPeerImageSize + palPeerMemorySize + palCmdBufferSize) *
-                                         properties.imageCount * (pDevice->NumPalDevices() - 1));
+    //                 2. pBltImages, pBltMemory for all slots and pBltCmdBuffers for all image/slot pairs and devices
+    //                 3. the ring slots
+    //                 4. the intermediate images and release fences for the presentation device
+    //                 5. the peer images and command buffers for all of the other devices
+    //                 6. the copy semaphores on the other devices
+    const size_t cmdBufferCount          = imageCount * ringSize;
+    const size_t imageArraysOffset       = sizeof(SwCompositor);
+    const size_t slotsOffset             = imageArraysOffset +
+                                           ((((sizeof(Pal::IImage*) + sizeof(Pal::IGpuMemory*)) * ringSize) +
+                                             (sizeof(Pal::ICmdBuffer*) * cmdBufferCount)) * numDevices);
+    const size_t presentableDeviceOffset = slotsOffset + (sizeof(RingSlot) * ringSize);
+    const size_t otherDevicesOffset      = presentableDeviceOffset +
+                                           ((palImageSize + palMemorySize + palFenceSize) * ringSize);
+    const size_t perOtherDeviceSize      = ((palPeerImageSize + palPeerMemorySize) * ringSize) +
+                                           (palCmdBufferSize * cmdBufferCount);
+    const size_t semaphoresOffset        = otherDevicesOffset + (perOtherDeviceSize * (numDevices - 1));
+    const size_t totalSize               = semaphoresOffset + (palSemaphoreSize * ringSize * 2 * (numDevices - 1));
 
     void* pMemory = pDevice->VkInstance()->AllocMem(totalSize, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
 
     if (pMemory != nullptr)
     {
-        // Setup the image count array pointers for all devices
+        // Setup the ring and command buffer array pointers for all devices
         Pal::IImage**     ppBltImages[MaxPalDevices];
         Pal::IGpuMemory** ppBltMemory[MaxPalDevices];
         Pal::ICmdBuffer** ppBltCmdBuffers[MaxPalDevices];
+        void*             pCmdBufferMemory[MaxPalDevices];
+
+        void*             pPeerMemory[MaxPalDevices];
 
         void* pNextImageArrays = Util::VoidPtrInc(pMemory, imageArraysOffset);
+        void* pNextPeerMemory  = Util::VoidPtrInc(pMemory, otherDevicesOffset);
 
-        for (uint32_t deviceIdx = 0; deviceIdx < pDevice->NumPalDevices(); ++deviceIdx)
+        for (uint32_t deviceIdx = 0; deviceIdx < numDevices; ++deviceIdx)
         {
             ppBltImages[deviceIdx]     = static_cast<Pal::IImage**>(pNextImageArrays);
             ppBltMemory[deviceIdx]     = static_cast<Pal::IGpuMemory**>(Util::VoidPtrInc(ppBltImages[deviceIdx],
-                                            (sizeof(Pal::IImage*) * properties.imageCount)));
+                                            (sizeof(Pal::IImage*) * ringSize)));
             ppBltCmdBuffers[deviceIdx] = static_cast<Pal::ICmdBuffer**>(Util::VoidPtrInc(ppBltMemory[deviceIdx],
-                                            (sizeof(Pal::IGpuMemory*) * properties.imageCount)));
+                                            (sizeof(Pal::IGpuMemory*) * ringSize)));
             pNextImageArrays           = Util::VoidPtrInc(ppBltCmdBuffers[deviceIdx],
-                                            (sizeof(Pal::ICmdBuffer*) * properties.imageCount));
+                                            (sizeof(Pal::ICmdBuffer*) * cmdBufferCount));
+
+            if (deviceIdx != properties.presentationDeviceIdx)
+            {
+                // The command buffers follow the peer images and memory of each non-presenting device
+                pPeerMemory[deviceIdx]      = pNextPeerMemory;
+                pCmdBufferMemory[deviceIdx] = Util::VoidPtrInc(pNextPeerMemory,
+                                                               ((palPeerImageSize + palPeerMemorySize) * ringSize));
+                pNextPeerMemory             = Util::VoidPtrInc(pNextPeerMemory, perOtherDeviceSize);
+            }
+            else
+            {
+                pPeerMemory[deviceIdx]      = nullptr;
+                pCmdBufferMemory[deviceIdx] = nullptr;
+            }
         }
 
+        RingSlot* pSlots = static_cast<RingSlot*>(Util::VoidPtrInc(pMemory, slotsOffset));
+
         // Construct the object after setting up the member array bases
         pObject = VK_PLACEMENT_NEW(pMemory) SwCompositor(
             pDevice,
             properties.presentationDeviceIdx,
-            properties.imageCount,
+            imageCount,
+            ringSize,
             cmdBufCreateInfo.queueType,
+            palCmdBufferSize,
             ppBltImages,
             ppBltMemory,
-            ppBltCmdBuffers);
+            ppBltCmdBuffers,
+            pCmdBufferMemory,
+            pSlots,
+            properties.images);
 
-        // Setup for the intermediate destination images for the presentation device
-        void* pImageMemory  = Util::VoidPtrInc(pMemory, presentableDeviceOffset);
-        void* pMemoryMemory = Util::VoidPtrInc(pImageMemory, (palImageSize * properties.imageCount));
+        // Setup for the intermediate destination images and release fences for the presentation device
+        void* pImageMemory     = Util::VoidPtrInc(pMemory, presentableDeviceOffset);
+        void* pMemoryMemory    = Util::VoidPtrInc(pImageMemory, (palImageSize * ringSize));
+        void* pFenceMemory     = Util::VoidPtrInc(pMemoryMemory, (palMemorySize * ringSize));
+        void* pSemaphoreMemory = Util::VoidPtrInc(pMemory, semaphoresOffset);
 
-        for (uint32_t i = 0; i < properties.imageCount; ++i)
+        Pal::FenceCreateInfo fenceCreateInfo = {};
+
+        for (uint32_t slot = 0; (slot < ringSize) && (palResult == Pal::Result::Success); ++slot)
         {
             palResult = pPalDevice->CreatePresentableImage(
                 properties.imageCreateInfo,
                 pImageMemory,
                 pMemoryMemory,
-                &ppBltImages[properties.presentationDeviceIdx][i],
-                &ppBltMemory[properties.presentationDeviceIdx][i]);
+                &ppBltImages[properties.presentationDeviceIdx][slot],
+                &ppBltMemory[properties.presentationDeviceIdx][slot]);
 
             pImageMemory  = Util::VoidPtrInc(pImageMemory, palImageSize);
             pMemoryMemory = Util::VoidPtrInc(pMemoryMemory, palMemorySize);
 
-            // Clean up and break if any error is encountered
-            if (palResult != Pal::Result::Success)
+            if (palResult == Pal::Result::Success)
             {
-                pObject->Destroy(pDevice, pAllocator);
-                pObject = nullptr;
+                palResult = pPalDevice->CreateFence(fenceCreateInfo, pFenceMemory, &pSlots[slot].pReleased);
 
-                break;
+                pFenceMemory = Util::VoidPtrInc(pFenceMemory, palFenceSize);
             }
         }
 
-        // Next, setup the peer copies to the intermediate destinations
-        void* pPeerImageMemory  = Util::VoidPtrInc(pMemory, otherDevicesOffset);
-        void* pPeerMemoryMemory = Util::VoidPtrInc(pPeerImageMemory, (palPeerImageSize * properties.imageCount));
-        void* pCmdBufferMemory  = Util::VoidPtrInc(pPeerMemoryMemory, (palPeerMemorySize * properties.imageCount));
-
-        // Composition BLT common setup.  Only the destination image varies.
-        Pal::ImageLayout     srcLayout = { Pal::LayoutCopySrc, cmdBufCreateInfo.engineType };
-        Pal::ImageLayout     dstLayout = { Pal::LayoutCopyDst, cmdBufCreateInfo.engineType };
-        Pal::ImageCopyRegion region    = {};
-
-        region.extent    = peerInfo.pOriginalImage->GetImageCreateInfo().extent;
-        region.numSlices = 1;
-
-        region.srcSubres.plane     = 0;
-        region.srcSubres.arraySlice = 0;
-        region.srcSubres.mipLevel   = 0;
+        // Next, open the peer copies of the intermediate destinations and create the copy semaphores
+        Pal::GpuMemoryRef      gpuMemoryRef   = {};
+        Pal::GpuMemoryRefFlags memoryRefFlags = static_cast<Pal::GpuMemoryRefFlags>(0);
 
-        region.dstSubres.plane     = 0;
-        region.dstSubres.arraySlice = 0;
-        region.dstSubres.mipLevel   = 0;
-
-        Pal::CmdBufferBuildInfo buildInfo      = {};
-        Pal::GpuMemoryRef       gpuMemoryRef   = {};
-        Pal::GpuMemoryRefFlags  memoryRefFlags = static_cast<Pal::GpuMemoryRefFlags>(0);
-
-        for (uint32_t deviceIdx = 0;
-             (deviceIdx < pDevice->NumPalDevices()) && (palResult == Pal::Result::Success);
-             ++deviceIdx)
+        for (uint32_t deviceIdx = 0; (deviceIdx < numDevices) && (palResult == Pal::Result::Success); ++deviceIdx)
         {
             pPalDevice = pDevice->PalDevice(deviceIdx);
 
-            cmdBufCreateInfo.pCmdAllocator = pDevice->GetSharedCmdAllocator(deviceIdx);
+            void* pPeerImageMemory  = pPeerMemory[deviceIdx];
+            void* pPeerMemoryMemory = (pPeerImageMemory != nullptr) ?
+                                      Util::VoidPtrInc(pPeerImageMemory, (palPeerImageSize * ringSize)) : nullptr;
 
-            VK_ASSERT(palCmdBufferSize == pPalDevice->GetCmdBufferSize(cmdBufCreateInfo, nullptr));
-
-            // Create/open all of the peer images/memory together and generate the BLT commands on first use
-            for (uint32_t i = 0; i < properties.imageCount; ++i)
+            for (uint32_t slot = 0; (slot < ringSize) && (palResult == Pal::Result::Success); ++slot)
             {
                 // The presentation device image setup was performed above
                 if (deviceIdx != properties.presentationDeviceIdx)
                 {
-                    peerInfo.pOriginalImage = ppBltImages[properties.presentationDeviceIdx][i];
+                    peerInfo.pOriginalImage = ppBltImages[properties.presentationDeviceIdx][slot];
 
                     size_t assertPalImageSize;
                     size_t assertPalMemorySize;
                     pPalDevice->GetPeerImageSizes(peerInfo, &assertPalImageSize, &assertPalMemorySize, nullptr);
                     VK_ASSERT((assertPalImageSize == palPeerImageSize) &&
-                              (assertPalMemorySize == assertPalMemorySize));
+                              (assertPalMemorySize == palPeerMemorySize));
 
                     palResult = pPalDevice->OpenPeerImage(peerInfo,
                         pPeerImageMemory,
                         pPeerMemoryMemory,
-                        &ppBltImages[deviceIdx][i],
-                        &ppBltMemory[deviceIdx][i]);
+                        &ppBltImages[deviceIdx][slot],
+                        &ppBltMemory[deviceIdx][slot]);
 
                     pPeerImageMemory  = Util::VoidPtrInc(pPeerImageMemory, palPeerImageSize);
                     pPeerMemoryMemory = Util::VoidPtrInc(pPeerMemoryMemory, palPeerMemorySize);
 
                     if (palResult == Pal::Result::Success)
                     {
-                        palResult = pPalDevice->CreateCmdBuffer(
-                            cmdBufCreateInfo,
-                            pCmdBufferMemory,
-                            &ppBltCmdBuffers[deviceIdx][i]);
-
-                        pCmdBufferMemory = Util::VoidPtrInc(pCmdBufferMemory, palCmdBufferSize);
-
-                        // Generate the BLT to the appropriate peer destination image
-                        if (palResult == Pal::Result::Success)
-                        {
-                            ppBltCmdBuffers[deviceIdx][i]->Begin(buildInfo);
-
-                            ppBltCmdBuffers[deviceIdx][i]->CmdCopyImage(
-                                *Image::ObjectFromHandle(properties.images[i])->PalImage(deviceIdx),
-                                srcLayout,
-                                *ppBltImages[deviceIdx][i],
-                                dstLayout,
-                                1,
-                                &region,
-                                nullptr,
-                                0);
-
-                            ppBltCmdBuffers[deviceIdx][i]->End();
-                        }
+                        palResult = pPalDevice->CreateQueueSemaphore(
+                            semaphoreCreateInfo,
+                            pSemaphoreMemory,
+                            &pSlots[slot].pRenderDone[deviceIdx]);
+
+                        pSemaphoreMemory = Util::VoidPtrInc(pSemaphoreMemory, palSemaphoreSize);
+                    }
+
+                    if (palResult == Pal::Result::Success)
+                    {
+                        palResult = pPalDevice->CreateQueueSemaphore(
+                            semaphoreCreateInfo,
+                            pSemaphoreMemory,
+                            &pSlots[slot].pCopyDone[deviceIdx]);
+
+                        pSemaphoreMemory = Util::VoidPtrInc(pSemaphoreMemory, palSemaphoreSize);
                     }
                 }
 
                 // Add memory references to the presentable image memory
                 if (palResult == Pal::Result::Success)
                 {
-                    gpuMemoryRef.pGpuMemory = ppBltMemory[deviceIdx][i];
+                    gpuMemoryRef.pGpuMemory = ppBltMemory[deviceIdx][slot];
 
                     palResult = pPalDevice->AddGpuMemoryReferences(1, &gpuMemoryRef, nullptr, memoryRefFlags);
                 }
-
-                // Clean up and break if any error is encountered
-                if (palResult != Pal::Result::Success)
-                {
-                    pObject->Destroy(pDevice, pAllocator);
-                    pObject = nullptr;
-
-                    break;
-                }
             }
         }
+
+        // Clean up if any error is encountered
+        if (palResult != Pal::Result::Success)
+        {
+            pObject->Destroy(pDevice, pAllocator);
+            pObject = nullptr;
+        }
     }
 
     return pObject;
 }
 
 // =====================================================================================================================
-// Destroy the software compositor object
+// Destroy the software compositor object.  Release fences still in flight are waited on first.
 void SwCompositor::Destroy(
     const Device*                pDevice,
     const VkAllocationCallbacks* pAllocator)
 {
+    Pal::IDevice* pPresentationDevice = pDevice->PalDevice(m_presentationDeviceIdx);
+
+    for (uint32_t slot = 0; slot < m_ringSize; ++slot)
+    {
+        if (m_pSlots[slot].pReleased != nullptr)
+        {
+            if (m_pSlots[slot].releasePending)
+            {
+                pPresentationDevice->WaitForFences(1, &m_pSlots[slot].pReleased, true, UINT64_MAX);
+            }
+
+            m_pSlots[slot].pReleased->Destroy();
+            m_pSlots[slot].pReleased = nullptr;
+        }
+    }
+
     // Remove all GPU memory references before destroying the memory itself because there's a dependency of peer memory
     // on the original memory on the presenting device.
     for (uint32_t deviceIdx = 0; deviceIdx < pDevice->NumPalDevices(); ++deviceIdx)
     {
-        for (uint32_t i = 0; i < m_imageCount; ++i)
+        for (uint32_t slot = 0; slot < m_ringSize; ++slot)
         {
-            if (m_ppBltMemory[deviceIdx][i] != nullptr)
+            if (m_ppBltMemory[deviceIdx][slot] != nullptr)
             {
-                pDevice->PalDevice(deviceIdx)->RemoveGpuMemoryReferences(1, &m_ppBltMemory[deviceIdx][i], nullptr);
+                pDevice->PalDevice(deviceIdx)->RemoveGpuMemoryReferences(1, &m_ppBltMemory[deviceIdx][slot], nullptr);
             }
         }
     }
 
     for (uint32_t deviceIdx = 0; deviceIdx < pDevice->NumPalDevices(); ++deviceIdx)
     {
-        for (uint32_t i = 0; i < m_imageCount; ++i)
+        for (uint32_t slot = 0; slot < m_ringSize; ++slot)
         {
-            if (m_ppBltMemory[deviceIdx][i] != nullptr)
+            if (m_ppBltMemory[deviceIdx][slot] != nullptr)
             {
-                m_ppBltMemory[deviceIdx][i]->Destroy();
-                m_ppBltMemory[deviceIdx][i] = nullptr;
+                m_ppBltMemory[deviceIdx][slot]->Destroy();
+                m_ppBltMemory[deviceIdx][slot] = nullptr;
             }
 
-            if (m_ppBltImages[deviceIdx][i] != nullptr)
+            if (m_ppBltImages[deviceIdx][slot] != nullptr)
             {
-                m_ppBltImages[deviceIdx][i]->Destroy();
-                m_ppBltImages[deviceIdx][i] = nullptr;
+                m_ppBltImages[deviceIdx][slot]->Destroy();
+                m_ppBltImages[deviceIdx][slot] = nullptr;
             }
 
+            if (m_pSlots[slot].pRenderDone[deviceIdx] != nullptr)
+            {
+                m_pSlots[slot].pRenderDone[deviceIdx]->Destroy();
+                m_pSlots[slot].pRenderDone[deviceIdx] = nullptr;
+            }
+
+            if (m_pSlots[slot].pCopyDone[deviceIdx] != nullptr)
+            {
+                m_pSlots[slot].pCopyDone[deviceIdx]->Destroy();
+                m_pSlots[slot].pCopyDone[deviceIdx] = nullptr;
+            }
+        }
+
+        for (uint32_t i = 0; i < (m_imageCount * m_ringSize); ++i)
+        {
             if (m_ppBltCmdBuffers[deviceIdx][i] != nullptr)
             {
                 m_ppBltCmdBuffers[deviceIdx][i]->Destroy();
@@ -1610,45 +2015,1139 @@ void SwCompositor::Destroy(
 }
 
 // =====================================================================================================================
-// Perform the software compositing BLT if this is the non presentable device and returns the queue for the present.
-Pal::IQueue* SwCompositor::DoSwCompositing(
-    Device*                    pDevice,
-    uint32_t                   deviceIdx,
-    Pal::PresentSwapChainInfo* pPresentInfo,
-    Pal::IGpuMemory**          ppSrcImageGpuMemory,
-    const Queue*               pPresentQueue)
+// Called at the start of every compositing call, when the present of the previous call has been queued.  That present
+// replaces the slot shown before it, so the slot's release fence is submitted on the same queue right after it and
+// signals once the replacing present has executed.
+Pal::Result SwCompositor::ReleaseReplacedSlot(
+    const Device* pDevice)
 {
-    Pal::IQueue* pPalQueue = pDevice->PerformSwCompositing(deviceIdx,
-                                                           m_presentationDeviceIdx,
-                                                           m_ppBltCmdBuffers[deviceIdx][pPresentInfo->imageIndex],
-                                                           m_queueType,
-                                                           pPresentQueue);
+    Pal::Result palResult = Pal::Result::Success;
 
-    if (pPalQueue != nullptr)
+    if (m_pLastPresentQueue != nullptr)
     {
-        if (deviceIdx != m_presentationDeviceIdx)
+        if (m_shownSlot != InvalidSlot)
         {
-            // Update the present info and full screen flip metadata to use the intermediate image and memory on the
-            // on the presentable device instead of the original source image and memory.
-            pPresentInfo->pSrcImage = m_ppBltImages[m_presentationDeviceIdx][pPresentInfo->imageIndex];
-            *ppSrcImageGpuMemory    = m_ppBltMemory[m_presentationDeviceIdx][pPresentInfo->imageIndex];
+            RingSlot* pSlot = &m_pSlots[m_shownSlot];
+
+            VK_ASSERT(pSlot->releasePending == false);
+
+            palResult = pDevice->PalDevice(m_presentationDeviceIdx)->ResetFences(1, &pSlot->pReleased);
+
+            if (palResult == Pal::Result::Success)
+            {
+                Pal::SubmitInfo            submitInfo      = {};
+                Pal::PerSubQueueSubmitInfo perSubQueueInfo = {};
+
+                submitInfo.pPerSubQueueInfo     = &perSubQueueInfo;
+                submitInfo.perSubQueueInfoCount = 1;
+                submitInfo.ppFences             = &pSlot->pReleased;
+                submitInfo.fenceCount           = 1;
+
+                palResult = m_pLastPresentQueue->Submit(submitInfo);
+            }
+
+            pSlot->releasePending = (palResult == Pal::Result::Success);
         }
-    }
-    else
-    {
-        // Give up if any errors were encountered, and reset to the original presentation queue.
-        pPalQueue = pPresentQueue->PalQueue(deviceIdx);
-        VK_ASSERT(false);
+
+        m_shownSlot = m_lastSlot;
     }
 
-    return pPalQueue;
+    return palResult;
 }
 
-/**
- ***********************************************************************************************************************
- * C-Callable entry points start here. These entries go in the dispatch table(s).
- ***********************************************************************************************************************
- */
+// =====================================================================================================================
+// Waits until the given slot may be overwritten, which is once the present that replaced it on screen has executed.
+// With a ring of at least two slots, the release of a slot has always been submitted by the time it comes round again.
+Pal::Result SwCompositor::AcquireSlot(
+    const Device* pDevice,
+    uint32_t      slot)
+{
+    VK_ASSERT((slot != m_shownSlot) && (slot != m_lastSlot));
+
+    Pal::Result palResult = Pal::Result::Success;
+    RingSlot*   pSlot     = &m_pSlots[slot];
+
+    if (pSlot->releasePending)
+    {
+        palResult = pDevice->PalDevice(m_presentationDeviceIdx)->WaitForFences(1, &pSlot->pReleased, true, UINT64_MAX);
+
+        pSlot->releasePending = (palResult != Pal::Result::Success);
+    }
+
+    return palResult;
+}
+
+// =====================================================================================================================
+// Returns the command buffer copying the given swap chain image into the peer image of the given ring slot, recording
+// it the first time the pair is used.  The command buffer is replayed as-is on every later use of the pair.
+Pal::ICmdBuffer* SwCompositor::GetBltCmdBuffer(
+    const Device* pDevice,
+    uint32_t      deviceIdx,
+    uint32_t      imageIndex,
+    uint32_t      slot)
+{
+    VK_ASSERT(deviceIdx != m_presentationDeviceIdx);
+
+    const uint32_t    cmdBufferIdx = (imageIndex * m_ringSize) + slot;
+    Pal::ICmdBuffer** ppCmdBuffer  = &m_ppBltCmdBuffers[deviceIdx][cmdBufferIdx];
+
+    if (*ppCmdBuffer == nullptr)
+    {
+        Pal::CmdBufferCreateInfo cmdBufCreateInfo = {};
+
+        cmdBufCreateInfo.pCmdAllocator = pDevice->GetSharedCmdAllocator(deviceIdx);
+        cmdBufCreateInfo.queueType     = m_queueType;
+        cmdBufCreateInfo.engineType    = (m_queueType == Pal::QueueType::QueueTypeDma) ?
+                                         Pal::EngineType::EngineTypeDma : Pal::EngineType::EngineTypeUniversal;
+
+        VK_ASSERT(m_palCmdBufferSize == pDevice->PalDevice(deviceIdx)->GetCmdBufferSize(cmdBufCreateInfo, nullptr));
+
+        Pal::ICmdBuffer* pCmdBuffer = nullptr;
+        Pal::Result      palResult  = pDevice->PalDevice(deviceIdx)->CreateCmdBuffer(
+            cmdBufCreateInfo,
+            Util::VoidPtrInc(m_pCmdBufferMemory[deviceIdx], (m_palCmdBufferSize * cmdBufferIdx)),
+            &pCmdBuffer);
+
+        if (palResult == Pal::Result::Success)
+        {
+            const Pal::IImage&   srcImage  = *Image::ObjectFromHandle(m_pSrcImages[imageIndex])->PalImage(deviceIdx);
+            Pal::ImageLayout     srcLayout = { Pal::LayoutCopySrc, cmdBufCreateInfo.engineType };
+            Pal::ImageLayout     dstLayout = { Pal::LayoutCopyDst, cmdBufCreateInfo.engineType };
+            Pal::ImageCopyRegion region    = {};
+
+            region.extent    = srcImage.GetImageCreateInfo().extent;
+            region.numSlices = 1;
+
+            Pal::CmdBufferBuildInfo buildInfo = {};
+
+            palResult = pCmdBuffer->Begin(buildInfo);
+
+            if (palResult == Pal::Result::Success)
+            {
+                pCmdBuffer->CmdCopyImage(
+                    srcImage,
+                    srcLayout,
+                    *m_ppBltImages[deviceIdx][slot],
+                    dstLayout,
+                    1,
+                    &region,
+                    nullptr,
+                    0);
+
+                palResult = pCmdBuffer->End();
+            }
+
+            if (palResult == Pal::Result::Success)
+            {
+                *ppCmdBuffer = pCmdBuffer;
+            }
+            else
+            {
+                pCmdBuffer->Destroy();
+            }
+        }
+    }
+
+    return *ppCmdBuffer;
+}
+
+// =====================================================================================================================
+// Perform the software compositing BLT if this is the non presentable device and returns the queue for the present.
+Pal::IQueue* SwCompositor::DoSwCompositing(
+    Device*                    pDevice,
+    uint32_t                   deviceIdx,
+    Pal::PresentSwapChainInfo* pPresentInfo,
+    Pal::IGpuMemory**          ppSrcImageGpuMemory,
+    const Queue*               pPresentQueue)
+{
+    Pal::IQueue*     pPalQueue  = nullptr;
+    Pal::ICmdBuffer* pCmdBuffer = nullptr;
+    uint32_t         slot       = InvalidSlot;
+
+    SwCompositingSync sync = {};
+
+    Pal::Result palResult = ReleaseReplacedSlot(pDevice);
+
+    if ((palResult == Pal::Result::Success) && (deviceIdx != m_presentationDeviceIdx))
+    {
+        slot      = m_nextSlot;
+        palResult = AcquireSlot(pDevice, slot);
+
+        if (palResult == Pal::Result::Success)
+        {
+            pCmdBuffer = GetBltCmdBuffer(pDevice, deviceIdx, pPresentInfo->imageIndex, slot);
+        }
+
+        sync.pRenderDone = m_pSlots[slot].pRenderDone[deviceIdx];
+        sync.pCopyDone   = m_pSlots[slot].pCopyDone[deviceIdx];
+    }
+
+    if ((palResult == Pal::Result::Success) &&
+        ((deviceIdx == m_presentationDeviceIdx) || (pCmdBuffer != nullptr)))
+    {
+        pPalQueue = pDevice->PerformSwCompositing(deviceIdx,
+                                                  m_presentationDeviceIdx,
+                                                  pCmdBuffer,
+                                                  m_queueType,
+                                                  pPresentQueue,
+                                                  &sync);
+    }
+
+    if (pPalQueue != nullptr)
+    {
+        if (deviceIdx != m_presentationDeviceIdx)
+        {
+            // Update the present info and full screen flip metadata to use the intermediate image and memory on the
+            // on the presentable device instead of the original source image and memory.
+            pPresentInfo->pSrcImage = m_ppBltImages[m_presentationDeviceIdx][slot];
+            *ppSrcImageGpuMemory    = m_ppBltMemory[m_presentationDeviceIdx][slot];
+
+            m_nextSlot = (m_nextSlot + 1) % m_ringSize;
+        }
+    }
+    else
+    {
+        // Give up if any errors were encountered, and reset to the original presentation queue.
+        pPalQueue = pPresentQueue->PalQueue(deviceIdx);
+        VK_ASSERT(false);
+
+        slot = InvalidSlot;
+    }
+
+    // Whatever is presented now replaces the slot presented last
+    m_pLastPresentQueue = pPalQueue;
+    m_lastSlot          = slot;
+
+    return pPalQueue;
+}
+
+// =====================================================================================================================
+HeadlessPresenter::HeadlessPresenter(
+    Device*          pDevice,
+    VkPresentModeKHR presentMode,
+    uint32_t         imageCount,
+    ImageInfo*       pImages,
+    uint32_t*        pQueuedImages,
+    Pal::IQueue*     pPalQueue)
+    :
+    m_pDevice(pDevice),
+    m_presentMode(presentMode),
+    m_imageCount(imageCount),
+    m_pImages(pImages),
+    m_pQueuedImages(pQueuedImages),
+    m_queueHead(0),
+    m_queueCount(0),
+    m_displayedImage(InvalidImageIndex),
+    m_refreshPeriod(0),
+    m_nextRefresh(0),
+    m_pPalQueue(pPalQueue),
+    m_lastPresentId(0),
+    m_latchedPresentId(0),
+    m_outOfDate(false)
+{
+    const uint32_t refreshRate = pDevice->GetRuntimeSettings().headlessSurfaceRefreshRate;
+
+    if (refreshRate > 0)
+    {
+        m_refreshPeriod = NANOSECONDS_IN_A_SECOND / refreshRate;
+    }
+
+    m_nextRefresh = utils::GetTimeNano() + m_refreshPeriod;
+}
+
+// =====================================================================================================================
+// Creates the emulated presentation engine of a headless swap chain along with the internal queue used to signal
+// acquires and one fence per image to track when presented images are done rendering.
+VkResult HeadlessPresenter::Create(
+    Device*                      pDevice,
+    const VkAllocationCallbacks* pAllocator,
+    uint32_t                     imageCount,
+    VkPresentModeKHR             presentMode,
+    HeadlessPresenter**          ppPresenter)
+{
+    VkResult           result     = VK_ERROR_OUT_OF_HOST_MEMORY;
+    HeadlessPresenter* pObject    = nullptr;
+    Pal::IDevice*      pPalDevice = pDevice->PalDevice(DefaultDeviceIndex);
+    Pal::Result        palResult  = Pal::Result::Success;
+
+    // Any engine can signal semaphores and fences, so use the one backing the first queue family.
+    Pal::QueueCreateInfo queueCreateInfo = {};
+
+    queueCreateInfo.engineIndex = 0;
+    queueCreateInfo.engineType  = pDevice->GetQueueFamilyPalEngineType(0);
+    queueCreateInfo.queueType   = pDevice->GetQueueFamilyPalQueueType(0);
+
+    const size_t palQueueSize = pPalDevice->GetQueueSize(queueCreateInfo, &palResult);
+    VK_ASSERT(palResult == Pal::Result::Success);
+
+    const size_t palFenceSize = pPalDevice->GetFenceSize(&palResult);
+    VK_ASSERT(palResult == Pal::Result::Success);
+
+    // Total size for: 1. this object
+    //                 2. the per image state
+    //                 3. the internal queue
+    //                 4. the present fences
+    //                 5. the ring of queued image indices
+    const size_t imagesOffset = sizeof(HeadlessPresenter);
+    const size_t queueOffset  = imagesOffset + (sizeof(ImageInfo) * imageCount);
+    const size_t fencesOffset = queueOffset + palQueueSize;
+    const size_t ringOffset   = fencesOffset + (palFenceSize * imageCount);
+    const size_t totalSize    = ringOffset + (sizeof(uint32_t) * imageCount);
+
+    void* pMemory = pAllocator->pfnAllocation(
+        pAllocator->pUserData,
+        totalSize,
+        VK_DEFAULT_MEM_ALIGN,
+        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+    if (pMemory != nullptr)
+    {
+        ImageInfo*   pImages   = static_cast<ImageInfo*>(Util::VoidPtrInc(pMemory, imagesOffset));
+        Pal::IQueue* pPalQueue = nullptr;
+
+        palResult = pPalDevice->CreateQueue(queueCreateInfo, Util::VoidPtrInc(pMemory, queueOffset), &pPalQueue);
+
+        // Present fences start out signaled so that they can be reset unconditionally on present.
+        Pal::FenceCreateInfo fenceCreateInfo = {};
+        fenceCreateInfo.flags.signaled = 1;
+
+        for (uint32_t i = 0; i < imageCount; ++i)
+        {
+            pImages[i].state         = ImageState::Available;
+            pImages[i].pPresentFence = nullptr;
+            pImages[i].presentId     = 0;
+
+            if (palResult == Pal::Result::Success)
+            {
+                palResult = pPalDevice->CreateFence(
+                    fenceCreateInfo,
+                    Util::VoidPtrInc(pMemory, fencesOffset + (palFenceSize * i)),
+                    &pImages[i].pPresentFence);
+            }
+        }
+
+        pObject = VK_PLACEMENT_NEW(pMemory) HeadlessPresenter(
+            pDevice,
+            presentMode,
+            imageCount,
+            pImages,
+            static_cast<uint32_t*>(Util::VoidPtrInc(pMemory, ringOffset)),
+            pPalQueue);
+
+        if (palResult == Pal::Result::Success)
+        {
+            Util::EventCreateFlags flags = {};
+            flags.manualReset       = false;
+            flags.initiallySignaled = false;
+
+            palResult = pObject->m_releaseEvent.Init(flags);
+        }
+
+        result = PalToVkResult(palResult);
+
+        // Clean up if any error is encountered
+        if (result != VK_SUCCESS)
+        {
+            pObject->Destroy(pAllocator);
+            pObject = nullptr;
+        }
+    }
+
+    *ppPresenter = pObject;
+
+    return result;
+}
+
+// =====================================================================================================================
+// Destroy the headless presenter object
+void HeadlessPresenter::Destroy(
+    const VkAllocationCallbacks* pAllocator)
+{
+    for (uint32_t i = 0; i < m_imageCount; ++i)
+    {
+        if (m_pImages[i].pPresentFence != nullptr)
+        {
+            m_pImages[i].pPresentFence->Destroy();
+            m_pImages[i].pPresentFence = nullptr;
+        }
+    }
+
+    if (m_pPalQueue != nullptr)
+    {
+        m_pPalQueue->Destroy();
+        m_pPalQueue = nullptr;
+    }
+
+    this->~HeadlessPresenter();
+
+    pAllocator->pfnFree(pAllocator->pUserData, this);
+}
+
+// =====================================================================================================================
+// Returns true once all the work submitted ahead of the present of the given image has completed.
+bool HeadlessPresenter::IsRenderingDone(
+    uint32_t imageIndex) const
+{
+    return (m_pImages[imageIndex].pPresentFence->GetStatus() == Pal::Result::Success);
+}
+
+// =====================================================================================================================
+// Moves the oldest queued image onto the simulated display, releasing the image it replaces.  This is the point where
+// the present of the image completes for VK_KHR_present_wait, along with any present dropped from the mailbox before
+// it.
+void HeadlessPresenter::LatchQueuedImage()
+{
+    VK_ASSERT(m_queueCount > 0);
+
+    const uint32_t imageIndex = m_pQueuedImages[m_queueHead];
+
+    if (m_displayedImage != InvalidImageIndex)
+    {
+        m_pImages[m_displayedImage].state = ImageState::Available;
+    }
+
+    m_pImages[imageIndex].state = ImageState::Displayed;
+    m_displayedImage            = imageIndex;
+    m_latchedPresentId          = Util::Max(m_latchedPresentId, m_pImages[imageIndex].presentId);
+
+    m_queueHead = (m_queueHead + 1) % m_imageCount;
+    m_queueCount--;
+
+    m_releaseEvent.Set();
+}
+
+// =====================================================================================================================
+// Returns the images dropped from the mailbox whose rendering is done to the application.  Must be called with m_lock
+// held.
+void HeadlessPresenter::ReleaseDroppedImages()
+{
+    for (uint32_t i = 0; i < m_imageCount; ++i)
+    {
+        if ((m_pImages[i].state == ImageState::Dropped) && IsRenderingDone(i))
+        {
+            m_pImages[i].state = ImageState::Available;
+        }
+    }
+}
+
+// =====================================================================================================================
+// Runs the simulated display up to the given time.  Without vertical sync, images are latched as soon as their
+// rendering is done.  Otherwise, at most one image is latched per elapsed refresh.  Must be called with m_lock held.
+void HeadlessPresenter::AdvanceClock(
+    uint64_t now)
+{
+    ReleaseDroppedImages();
+
+    if ((m_presentMode == VK_PRESENT_MODE_IMMEDIATE_KHR) || (m_refreshPeriod == 0))
+    {
+        while ((m_queueCount > 0) && IsRenderingDone(m_pQueuedImages[m_queueHead]))
+        {
+            LatchQueuedImage();
+        }
+    }
+    else if (now >= m_nextRefresh)
+    {
+        const uint64_t elapsedRefreshes = ((now - m_nextRefresh) / m_refreshPeriod) + 1;
+
+        for (uint64_t refresh = 0;
+             (refresh < elapsedRefreshes) && (m_queueCount > 0) && IsRenderingDone(m_pQueuedImages[m_queueHead]);
+             ++refresh)
+        {
+            LatchQueuedImage();
+        }
+
+        m_nextRefresh += (elapsedRefreshes * m_refreshPeriod);
+    }
+}
+
+// =====================================================================================================================
+// Sleeps until the next refresh, a present or the rendering of the oldest queued or dropped image makes progress, but
+// no later than the deadline.  Must be called with m_lock held, which is released while sleeping.  Updates the current
+// time on return.
+void HeadlessPresenter::WaitForProgress(
+    uint64_t* pNow,
+    uint64_t  deadline)
+{
+    // Upper bound of a single sleep so that a missed wake-up never stalls the caller for long.
+    constexpr uint64_t MaxEventWaitTime = NANOSECONDS_IN_A_SECOND / 10;
+
+    const uint64_t now      = *pNow;
+    uint64_t       waitTime = deadline - now;
+
+    if ((m_presentMode != VK_PRESENT_MODE_IMMEDIATE_KHR) && (m_refreshPeriod > 0))
+    {
+        waitTime = Util::Min(waitTime, m_nextRefresh - now);
+    }
+
+    Pal::IFence* pPendingFence = nullptr;
+
+    if ((m_queueCount > 0) && (IsRenderingDone(m_pQueuedImages[m_queueHead]) == false))
+    {
+        pPendingFence = m_pImages[m_pQueuedImages[m_queueHead]].pPresentFence;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < m_imageCount; ++i)
+        {
+            if (m_pImages[i].state == ImageState::Dropped)
+            {
+                pPendingFence = m_pImages[i].pPresentFence;
+                break;
+            }
+        }
+    }
+
+    m_lock.Unlock();
+
+    if (pPendingFence != nullptr)
+    {
+        m_pDevice->PalDevice(DefaultDeviceIndex)->WaitForFences(1, &pPendingFence, true, waitTime);
+    }
+    else
+    {
+        waitTime = Util::Min(waitTime, MaxEventWaitTime);
+
+        m_releaseEvent.Wait(static_cast<float>(waitTime) / static_cast<float>(NANOSECONDS_IN_A_SECOND));
+    }
+
+    m_lock.Lock();
+
+    *pNow = utils::GetTimeNano();
+}
+
+// =====================================================================================================================
+// Waits until the simulated display releases an image and returns it to the application.  The returned image is idle,
+// so the semaphore and fence are signaled right away on the internal queue.
+VkResult HeadlessPresenter::AcquireNextImage(
+    uint64_t    timeout,
+    Semaphore*  pSemaphore,
+    Fence*      pFence,
+    uint32_t*   pImageIndex)
+{
+    uint64_t       now        = utils::GetTimeNano();
+    const uint64_t deadline   = (timeout > (UINT64_MAX - now)) ? UINT64_MAX : (now + timeout);
+    uint32_t       imageIndex = InvalidImageIndex;
+
+    m_lock.Lock();
+
+    while (true)
+    {
+        AdvanceClock(now);
+
+        for (uint32_t i = 0; i < m_imageCount; ++i)
+        {
+            if (m_pImages[i].state == ImageState::Available)
+            {
+                imageIndex = i;
+                break;
+            }
+        }
+
+        if ((imageIndex != InvalidImageIndex) || (now >= deadline))
+        {
+            break;
+        }
+
+        WaitForProgress(&now, deadline);
+    }
+
+    VkResult result = VK_TIMEOUT;
+
+    if (imageIndex != InvalidImageIndex)
+    {
+        Pal::Result palResult = Pal::Result::Success;
+
+        if (pSemaphore != nullptr)
+        {
+            palResult = m_pPalQueue->SignalQueueSemaphore(pSemaphore->PalSemaphore(DefaultDeviceIndex), 0);
+        }
+
+        if ((palResult == Pal::Result::Success) && (pFence != nullptr))
+        {
+            // Do a dummy submit just so the fence is signaled.
+            Pal::SubmitInfo            submitInfo      = {};
+            Pal::PerSubQueueSubmitInfo perSubQueueInfo = {};
+            Pal::IFence*               pPalFence       = nullptr;
+
+            submitInfo.pPerSubQueueInfo     = &perSubQueueInfo;
+            submitInfo.perSubQueueInfoCount = 1;
+
+            pFence->SetActiveDevice(DefaultDeviceIndex);
+            pPalFence = pFence->PalFence(DefaultDeviceIndex);
+
+            submitInfo.ppFences   = &pPalFence;
+            submitInfo.fenceCount = 1;
+
+            palResult = m_pPalQueue->Submit(submitInfo);
+        }
+
+        result = PalToVkResult(palResult);
+
+        if (result == VK_SUCCESS)
+        {
+            m_pImages[imageIndex].state = ImageState::Acquired;
+
+            *pImageIndex = imageIndex;
+        }
+    }
+
+    m_lock.Unlock();
+
+    return result;
+}
+
+// =====================================================================================================================
+// Queues a presented image for the simulated display.  The present fence is submitted on the presenting queue after
+// its wait semaphores and any post processing, which is the point where a real presentation engine would pick the
+// image up.
+Pal::Result HeadlessPresenter::Present(
+    Pal::IQueue* pPalQueue,
+    uint32_t     imageIndex,
+    uint64_t     presentId)
+{
+    Util::MutexAuto lock(&m_lock);
+
+    ImageInfo* pImage = &m_pImages[imageIndex];
+
+    VK_ASSERT(pImage->state == ImageState::Acquired);
+
+    Pal::Result palResult = m_pDevice->PalDevice(DefaultDeviceIndex)->ResetFences(1, &pImage->pPresentFence);
+
+    if (palResult == Pal::Result::Success)
+    {
+        Pal::SubmitInfo            submitInfo      = {};
+        Pal::PerSubQueueSubmitInfo perSubQueueInfo = {};
+
+        submitInfo.pPerSubQueueInfo     = &perSubQueueInfo;
+        submitInfo.perSubQueueInfoCount = 1;
+        submitInfo.ppFences             = &pImage->pPresentFence;
+        submitInfo.fenceCount           = 1;
+
+        palResult = pPalQueue->Submit(submitInfo);
+    }
+
+    if (palResult == Pal::Result::Success)
+    {
+        // A mailbox only holds the newest image, so an image still waiting for a refresh is dropped.  Its rendering may
+        // still be in flight, so it only becomes available once its present fence has signaled.
+        if ((m_presentMode == VK_PRESENT_MODE_MAILBOX_KHR) && (m_queueCount > 0))
+        {
+            m_pImages[m_pQueuedImages[m_queueHead]].state = ImageState::Dropped;
+            m_queueCount = 0;
+        }
+
+        m_pQueuedImages[(m_queueHead + m_queueCount) % m_imageCount] = imageIndex;
+        m_queueCount++;
+
+        pImage->state     = ImageState::Queued;
+        pImage->presentId = presentId;
+
+        m_lastPresentId = Util::Max(m_lastPresentId, presentId);
+
+        AdvanceClock(utils::GetTimeNano());
+
+        m_releaseEvent.Set();
+    }
+
+    return palResult;
+}
+
+// =====================================================================================================================
+// Waits until the simulated display has latched a present with an identifier greater than or equal to presentId.  The
+// clock is advanced while waiting, so this makes progress without the application acquiring further images.
+VkResult HeadlessPresenter::WaitForPresent(
+    uint64_t presentId,
+    uint64_t timeout)
+{
+    uint64_t       now      = utils::GetTimeNano();
+    const uint64_t deadline = (timeout > (UINT64_MAX - now)) ? UINT64_MAX : (now + timeout);
+    VkResult       result   = VK_TIMEOUT;
+
+    m_lock.Lock();
+
+    while (true)
+    {
+        AdvanceClock(now);
+
+        if (m_latchedPresentId >= presentId)
+        {
+            result = VK_SUCCESS;
+            break;
+        }
+
+        // Every present up to m_lastPresentId is still going to be latched, but a later one can no longer arrive.
+        if (m_outOfDate && (presentId > m_lastPresentId))
+        {
+            result = VK_ERROR_OUT_OF_DATE_KHR;
+            break;
+        }
+
+        if (now >= deadline)
+        {
+            break;
+        }
+
+        WaitForProgress(&now, deadline);
+    }
+
+    m_lock.Unlock();
+
+    return result;
+}
+
+// =====================================================================================================================
+// Fails the waits for presents that have not been queued yet, once the swap chain has been retired or lost its surface.
+void HeadlessPresenter::MarkOutOfDate()
+{
+    Util::MutexAuto lock(&m_lock);
+
+    m_outOfDate = true;
+
+    m_releaseEvent.Set();
+}
+
+// =====================================================================================================================
+// Waits for all presented images and signals of the internal queue to complete.
+void HeadlessPresenter::WaitIdle()
+{
+    Util::MutexAuto lock(&m_lock);
+
+    for (uint32_t i = 0; i < m_imageCount; ++i)
+    {
+        if ((m_pImages[i].state == ImageState::Queued) || (m_pImages[i].state == ImageState::Dropped))
+        {
+            m_pDevice->PalDevice(DefaultDeviceIndex)->WaitForFences(1, &m_pImages[i].pPresentFence, true, UINT64_MAX);
+        }
+    }
+
+    m_pPalQueue->WaitIdle();
+}
+
+// =====================================================================================================================
+PresentTimeline::PresentTimeline(
+    Device*  pDevice,
+    uint32_t deviceIdx,
+    uint32_t slotCount,
+    Slot*    pSlots)
+    :
+    m_pDevice(pDevice),
+    m_deviceIdx(deviceIdx),
+    m_slotCount(slotCount),
+    m_pSlots(pSlots),
+    m_head(0),
+    m_count(0),
+    m_completedPresentId(0),
+    m_lastPresentId(0),
+    m_outOfDate(false)
+{
+    Util::EventCreateFlags flags = {};
+    flags.manualReset       = false;
+    flags.initiallySignaled = false;
+    m_presentEvent.Init(flags);
+}
+
+// =====================================================================================================================
+// Creates the present completion tracker of a swap chain with room for slotCount in-flight presents.
+PresentTimeline* PresentTimeline::Create(
+    Device*                      pDevice,
+    uint32_t                     deviceIdx,
+    const VkAllocationCallbacks* pAllocator,
+    uint32_t                     slotCount)
+{
+    PresentTimeline* pObject    = nullptr;
+    Pal::IDevice*    pPalDevice = pDevice->PalDevice(deviceIdx);
+    Pal::Result      palResult  = Pal::Result::Success;
+
+    const size_t palFenceSize = pPalDevice->GetFenceSize(&palResult);
+    VK_ASSERT(palResult == Pal::Result::Success);
+
+    // Total size for: 1. this object
+    //                 2. the ring of slots
+    //                 3. one fence per slot
+    const size_t slotsOffset  = sizeof(PresentTimeline);
+    const size_t fencesOffset = slotsOffset + (sizeof(Slot) * slotCount);
+    const size_t totalSize    = fencesOffset + (palFenceSize * slotCount);
+
+    void* pMemory = pAllocator->pfnAllocation(
+        pAllocator->pUserData,
+        totalSize,
+        VK_DEFAULT_MEM_ALIGN,
+        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+    if (pMemory != nullptr)
+    {
+        Slot* pSlots = static_cast<Slot*>(Util::VoidPtrInc(pMemory, slotsOffset));
+
+        Pal::FenceCreateInfo fenceCreateInfo = {};
+
+        for (uint32_t i = 0; i < slotCount; ++i)
+        {
+            pSlots[i].presentId = 0;
+            pSlots[i].pFence    = nullptr;
+
+            if (palResult == Pal::Result::Success)
+            {
+                palResult = pPalDevice->CreateFence(
+                    fenceCreateInfo,
+                    Util::VoidPtrInc(pMemory, fencesOffset + (palFenceSize * i)),
+                    &pSlots[i].pFence);
+            }
+        }
+
+        pObject = VK_PLACEMENT_NEW(pMemory) PresentTimeline(pDevice, deviceIdx, slotCount, pSlots);
+
+        // Clean up if any error is encountered
+        if (palResult != Pal::Result::Success)
+        {
+            pObject->Destroy(pAllocator);
+            pObject = nullptr;
+        }
+    }
+
+    return pObject;
+}
+
+// =====================================================================================================================
+// Destroy the present timeline object.  Presents still in flight are waited on first since they reference the fences.
+void PresentTimeline::Destroy(
+    const VkAllocationCallbacks* pAllocator)
+{
+    Pal::IDevice* pPalDevice = m_pDevice->PalDevice(m_deviceIdx);
+
+    for (uint32_t i = 0; i < m_count; ++i)
+    {
+        pPalDevice->WaitForFences(1, &m_pSlots[(m_head + i) % m_slotCount].pFence, true, UINT64_MAX);
+    }
+
+    for (uint32_t i = 0; i < m_slotCount; ++i)
+    {
+        if (m_pSlots[i].pFence != nullptr)
+        {
+            m_pSlots[i].pFence->Destroy();
+            m_pSlots[i].pFence = nullptr;
+        }
+    }
+
+    this->~PresentTimeline();
+
+    pAllocator->pfnFree(pAllocator->pUserData, this);
+}
+
+// =====================================================================================================================
+// Pops every present whose fence has signaled off the ring and advances the completed identifier.  Must be called with
+// m_lock held.
+void PresentTimeline::RetireCompleted()
+{
+    while ((m_count > 0) && (m_pSlots[m_head].pFence->GetStatus() == Pal::Result::Success))
+    {
+        m_completedPresentId = Util::Max(m_completedPresentId, m_pSlots[m_head].presentId);
+
+        m_head = (m_head + 1) % m_slotCount;
+        m_count--;
+    }
+}
+
+// =====================================================================================================================
+// Records a present tagged with the given identifier.  The fence is submitted on the queue the present was issued on,
+// after the present itself, so it signals once the present has executed and PAL has handed the image to the window
+// system.  PAL reports nothing later than that through the swap chain interface, so this can complete a present up to
+// a refresh before the image is actually scanned out.
+Pal::Result PresentTimeline::MarkPresent(
+    Pal::IQueue* pPalQueue,
+    uint64_t     presentId)
+{
+    VK_ASSERT(presentId != 0);
+
+    Pal::IDevice*   pPalDevice = m_pDevice->PalDevice(m_deviceIdx);
+    Util::MutexAuto lock(&m_lock);
+
+    RetireCompleted();
+
+    // The ring only fills up if the application presents far ahead of the GPU, in which case the oldest present is
+    // guaranteed to be close to completion.
+    if (m_count == m_slotCount)
+    {
+        pPalDevice->WaitForFences(1, &m_pSlots[m_head].pFence, true, UINT64_MAX);
+
+        RetireCompleted();
+    }
+
+    Slot* pSlot = &m_pSlots[(m_head + m_count) % m_slotCount];
+
+    Pal::Result palResult = pPalDevice->ResetFences(1, &pSlot->pFence);
+
+    if (palResult == Pal::Result::Success)
+    {
+        Pal::SubmitInfo            submitInfo      = {};
+        Pal::PerSubQueueSubmitInfo perSubQueueInfo = {};
+
+        submitInfo.pPerSubQueueInfo     = &perSubQueueInfo;
+        submitInfo.perSubQueueInfoCount = 1;
+        submitInfo.ppFences             = &pSlot->pFence;
+        submitInfo.fenceCount           = 1;
+
+        palResult = pPalQueue->Submit(submitInfo);
+    }
+
+    if (palResult == Pal::Result::Success)
+    {
+        pSlot->presentId = presentId;
+        m_count++;
+
+        m_lastPresentId = Util::Max(m_lastPresentId, presentId);
+
+        m_presentEvent.Set();
+    }
+
+    return palResult;
+}
+
+// =====================================================================================================================
+// Fails the waits for presents that have not been recorded yet, once the swap chain has been retired or lost its
+// surface.
+void PresentTimeline::MarkOutOfDate()
+{
+    Util::MutexAuto lock(&m_lock);
+
+    m_outOfDate = true;
+
+    m_presentEvent.Set();
+}
+
+// =====================================================================================================================
+// Waits until a present with an identifier greater than or equal to presentId has completed.  The identifier may not
+// have been presented yet, in which case this sleeps until the next tagged present.
+VkResult PresentTimeline::WaitForPresent(
+    uint64_t presentId,
+    uint64_t timeout)
+{
+    // Upper bound of a single sleep so that a missed wake-up never stalls the wait for long.
+    constexpr uint64_t MaxEventWaitTime = NANOSECONDS_IN_A_SECOND / 10;
+
+    Pal::IDevice*  pPalDevice = m_pDevice->PalDevice(m_deviceIdx);
+    uint64_t       now        = utils::GetTimeNano();
+    const uint64_t deadline   = (timeout > (UINT64_MAX - now)) ? UINT64_MAX : (now + timeout);
+    VkResult       result     = VK_TIMEOUT;
+
+    m_lock.Lock();
+
+    while (true)
+    {
+        RetireCompleted();
+
+        if (m_completedPresentId >= presentId)
+        {
+            result = VK_SUCCESS;
+            break;
+        }
+
+        // Every recorded present is still going to complete, but a later one can no longer arrive.
+        if (m_outOfDate && (presentId > m_lastPresentId))
+        {
+            result = VK_ERROR_OUT_OF_DATE_KHR;
+            break;
+        }
+
+        if (now >= deadline)
+        {
+            break;
+        }
+
+        Pal::IFence* pFence = nullptr;
+
+        for (uint32_t i = 0; i < m_count; ++i)
+        {
+            const Slot& slot = m_pSlots[(m_head + i) % m_slotCount];
+
+            if (slot.presentId >= presentId)
+            {
+                pFence = slot.pFence;
+                break;
+            }
+        }
+
+        m_lock.Unlock();
+
+        // The fence may be recycled for a later present while we wait on it, which only delays the wake-up since
+        // completion is re-checked under the lock.
+        if (pFence != nullptr)
+        {
+            Pal::Result palResult = pPalDevice->WaitForFences(1, &pFence, true, deadline - now);
+
+            if ((palResult != Pal::Result::Success) && (palResult != Pal::Result::Timeout))
+            {
+                result = PalToVkResult(palResult);
+            }
+        }
+        else
+        {
+            const uint64_t waitTime = Util::Min(deadline - now, MaxEventWaitTime);
+
+            m_presentEvent.Wait(static_cast<float>(waitTime) / static_cast<float>(NANOSECONDS_IN_A_SECOND));
+        }
+
+        m_lock.Lock();
+
+        if ((result != VK_TIMEOUT) && (result != VK_SUCCESS))
+        {
+            break;
+        }
+
+        now = utils::GetTimeNano();
+    }
+
+    m_lock.Unlock();
+
+    return result;
+}
+
+#if ICD_PRESENT_TIMING
+// =====================================================================================================================
+PresentTimingLog::PresentTimingLog(
+    uint32_t  imageCount,
+    uint32_t  recordCount,
+    uint64_t* pAcquireWaits,
+    Record*   pRecords)
+    :
+    m_imageCount(imageCount),
+    m_recordCount(recordCount),
+    m_pAcquireWaits(pAcquireWaits),
+    m_pRecords(pRecords),
+    m_head(0),
+    m_count(0),
+    m_frameIndex(0),
+    m_current({})
+{
+    memset(m_pAcquireWaits, 0, sizeof(uint64_t) * imageCount);
+}
+
+// =====================================================================================================================
+// Creates the timing log of a swap chain with imageCount images that remembers the last recordCount frames.
+PresentTimingLog* PresentTimingLog::Create(
+    const VkAllocationCallbacks* pAllocator,
+    uint32_t                     imageCount,
+    uint32_t                     recordCount)
+{
+    PresentTimingLog* pObject = nullptr;
+
+    // Total size for: 1. this object
+    //                 2. the ring of frame records
+    //                 3. one pending acquire wait per image
+    const size_t recordsOffset = sizeof(PresentTimingLog);
+    const size_t waitsOffset   = recordsOffset + (sizeof(Record) * recordCount);
+    const size_t totalSize     = waitsOffset + (sizeof(uint64_t) * imageCount);
+
+    void* pMemory = pAllocator->pfnAllocation(
+        pAllocator->pUserData,
+        totalSize,
+        VK_DEFAULT_MEM_ALIGN,
+        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+    if (pMemory != nullptr)
+    {
+        pObject = VK_PLACEMENT_NEW(pMemory) PresentTimingLog(
+            imageCount,
+            recordCount,
+            static_cast<uint64_t*>(Util::VoidPtrInc(pMemory, waitsOffset)),
+            static_cast<Record*>(Util::VoidPtrInc(pMemory, recordsOffset)));
+    }
+
+    return pObject;
+}
+
+// =====================================================================================================================
+void PresentTimingLog::Destroy(
+    const VkAllocationCallbacks* pAllocator)
+{
+    this->~PresentTimingLog();
+
+    pAllocator->pfnFree(pAllocator->pUserData, this);
+}
+
+// =====================================================================================================================
+// Remembers how long the acquire of the given image blocked until the image is presented.  Applications may acquire
+// several images ahead, so the wait is kept per image rather than per frame.
+void PresentTimingLog::AddAcquireWait(
+    uint32_t imageIndex,
+    uint64_t time)
+{
+    VK_ASSERT(imageIndex < m_imageCount);
+
+    m_pAcquireWaits[imageIndex] = time;
+}
+
+// =====================================================================================================================
+// Finishes the record of the frame that was just presented and moves it into the ring, evicting the oldest record if
+// the ring is full.
+void PresentTimingLog::EndFrame(
+    uint32_t         imageIndex,
+    Pal::PresentMode presentMode)
+{
+    VK_ASSERT(imageIndex < m_imageCount);
+
+    m_current.frameIndex                  = m_frameIndex++;
+    m_current.presentTime                 = utils::GetTimeNano();
+    m_current.imageIndex                  = imageIndex;
+    m_current.presentMode                 = presentMode;
+    m_current.stageTime[StageAcquireWait] = m_pAcquireWaits[imageIndex];
+
+    m_pAcquireWaits[imageIndex] = 0;
+
+    Util::MutexAuto lock(&m_lock);
+
+    if (m_count == m_recordCount)
+    {
+        m_head = (m_head + 1) % m_recordCount;
+        m_count--;
+    }
+
+    m_pRecords[(m_head + m_count) % m_recordCount] = m_current;
+    m_count++;
+
+    m_current = {};
+}
+
+// =====================================================================================================================
+// Copies the recorded frames out, oldest first.  Follows the usual Vulkan enumeration rules: with a null pRecords only
+// the number of available records is returned, otherwise VK_INCOMPLETE is returned if not all of them fit.
+VkResult PresentTimingLog::GetRecords(
+    uint32_t* pRecordCount,
+    Record*   pRecords)
+{
+    Util::MutexAuto lock(&m_lock);
+
+    VkResult result = VK_SUCCESS;
+
+    if (pRecords == nullptr)
+    {
+        *pRecordCount = m_count;
+    }
+    else
+    {
+        if (*pRecordCount < m_count)
+        {
+            result = VK_INCOMPLETE;
+        }
+        else
+        {
+            *pRecordCount = m_count;
+        }
+
+        for (uint32_t i = 0; i < *pRecordCount; ++i)
+        {
+            pRecords[i] = m_pRecords[(m_head + i) % m_recordCount];
+        }
+    }
+
+    return result;
+}
+#endif
+
+/**
+ ***********************************************************************************************************************
+ * C-Callable entry points start here. These entries go in the dispatch table(s).
+ ***********************************************************************************************************************
+ */
 
 namespace entry
 {
@@ -1743,6 +3242,16 @@ VKAPI_ATTR void VKAPI_CALL vkSetHdrMetadataEXT(
     }
 }
 
+// =====================================================================================================================
+VKAPI_ATTR VkResult VKAPI_CALL vkWaitForPresentKHR(
+    VkDevice                                    device,
+    VkSwapchainKHR                              swapchain,
+    uint64_t                                    presentId,
+    uint64_t                                    timeout)
+{
+    return SwapChain::ObjectFromHandle(swapchain)->WaitForPresent(presentId, timeout);
+}
+
 } // namespace entry
 
 } // namespace vk
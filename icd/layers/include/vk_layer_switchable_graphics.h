@@ -36,7 +36,7 @@
 
 #include "include/khronos/vulkan.h"
 #include "include/khronos/vk_layer.h"
-#include "palHashMap.h"
+#include "palMutex.h"
 
 namespace vk
 {
@@ -52,7 +52,31 @@ struct NextLinkFuncPointers
     PFN_vkEnumeratePhysicalDeviceGroupsKHR      pfnEnumeratePhysicalDeviceGroupsKHR;
 };
 
-typedef Util::HashMap<VkInstance, NextLinkFuncPointers, vk::PalAllocator> DispatchTableHashMap;
+// Per-instance state of the layer.  Besides the next link's entry points it caches the physical devices and device
+// groups the layer reports, so repeated enumeration neither re-queries device properties nor re-filters the devices as
+// long as the next link keeps returning the same physical devices.
+struct LayerInstanceData
+{
+    VkInstance                       instance;
+    NextLinkFuncPointers             nextLinkFuncs;
+
+    Util::Mutex                      cacheLock;            // Serializes enumeration on this instance
+
+    uint32_t                         deviceCapacity;       // Number of entries of the device arrays below
+    uint32_t                         deviceCount;          // Number of devices the next link returned
+    uint32_t                         reportedDeviceCount;  // Number of devices the layer reports
+    bool                             deviceCacheValid;
+    uint32_t                         generation;           // Incremented whenever the device cache is rebuilt
+    VkPhysicalDeviceProperties*      pProperties;          // Properties of pDevices, start of the device cache memory
+    VkPhysicalDevice*                pDevices;             // Devices the next link returned
+    VkPhysicalDevice*                pScratchDevices;      // Devices the next link returned for the current call
+    uint32_t*                        pReportedIndices;     // Indices into pDevices of the devices the layer reports
+
+    uint32_t                         groupCapacity;        // Number of entries of pGroups
+    uint32_t                         reportedGroupCount;   // Number of device groups the layer reports
+    uint32_t                         groupGeneration;      // Generation of the device cache pGroups was filtered with
+    VkPhysicalDeviceGroupProperties* pGroups;              // Device groups the layer reports
+};
 
 typedef VkResult (VKAPI_PTR *PFN_vkCreateInstance_SG)(
     const VkInstanceCreateInfo*                 pCreateInfo,
@@ -29,19 +29,448 @@
  ***********************************************************************************************************************
  */
 
+
 #include <string.h>
 #include "include/vk_alloccb.h"
 #include "include/vk_utils.h"
 #include "include/vk_layer_switchable_graphics.h"
 #include "include/query_dlist.h"
-#include "palHashMapImpl.h"
 #include "palMutex.h"
 
 namespace vk
 {
 
-DispatchTableHashMap* g_pDispatchTables;
-Util::Mutex g_traceMutex;
+// Number of instances tracked by one block of the instance table
+constexpr uint32_t InstanceSlotsPerBlock = 16;
+
+// The instance table maps instance handles to the layer's per-instance data.  It is a linked list of blocks of slots
+// that are never freed, so lookups walk it without taking a lock.  Slots are only written while holding
+// g_instanceTableMutex: a slot's data pointer is set before its instance handle is published and the handle is cleared
+// before the data is freed.  Lookups only read a slot's data pointer after matching its handle, and the application may
+// not use an instance while it is being created or destroyed, so a lookup never sees a slot in transition.
+struct InstanceSlot
+{
+    VkInstance volatile         instance;
+    LayerInstanceData* volatile pData;
+};
+
+struct InstanceTableBlock
+{
+    InstanceSlot                 slots[InstanceSlotsPerBlock];
+    InstanceTableBlock* volatile pNext;
+};
+
+static InstanceTableBlock g_instanceTable;
+static Util::Mutex        g_instanceTableMutex;
+
+// =====================================================================================================================
+static void* AllocLayerMem(
+    size_t size)
+{
+    const VkAllocationCallbacks* pAllocCb = &allocator::g_DefaultAllocCallback;
+
+    return pAllocCb->pfnAllocation(pAllocCb->pUserData,
+                                   size,
+                                   VK_DEFAULT_MEM_ALIGN,
+                                   VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+}
+
+// =====================================================================================================================
+static void FreeLayerMem(
+    void* pMem)
+{
+    if (pMem != nullptr)
+    {
+        const VkAllocationCallbacks* pAllocCb = &allocator::g_DefaultAllocCallback;
+
+        pAllocCb->pfnFree(pAllocCb->pUserData, pMem);
+    }
+}
+
+// =====================================================================================================================
+// Returns the layer's data of the given instance, or nullptr if the instance wasn't created through the layer.
+static LayerInstanceData* FindInstanceData(
+    VkInstance instance)
+{
+    LayerInstanceData* pData = nullptr;
+
+    if (instance != VK_NULL_HANDLE)
+    {
+        for (const InstanceTableBlock* pBlock = &g_instanceTable;
+             (pData == nullptr) && (pBlock != nullptr);
+             pBlock = pBlock->pNext)
+        {
+            for (uint32_t i = 0; i < InstanceSlotsPerBlock; i++)
+            {
+                if (pBlock->slots[i].instance == instance)
+                {
+                    pData = pBlock->slots[i].pData;
+                    break;
+                }
+            }
+        }
+    }
+
+    return pData;
+}
+
+// =====================================================================================================================
+// Publishes the layer's data of a new instance in the instance table.
+static VkResult AddInstanceData(
+    LayerInstanceData* pData)
+{
+    Util::MutexAuto lock(&g_instanceTableMutex);
+
+    VkResult            result = VK_SUCCESS;
+    InstanceSlot*       pSlot  = nullptr;
+    InstanceTableBlock* pBlock = &g_instanceTable;
+
+    while (pSlot == nullptr)
+    {
+        for (uint32_t i = 0; i < InstanceSlotsPerBlock; i++)
+        {
+            if (pBlock->slots[i].instance == VK_NULL_HANDLE)
+            {
+                pSlot = &pBlock->slots[i];
+                break;
+            }
+        }
+
+        if (pSlot == nullptr)
+        {
+            if (pBlock->pNext == nullptr)
+            {
+                void* pMem = AllocLayerMem(sizeof(InstanceTableBlock));
+
+                if (pMem == nullptr)
+                {
+                    result = VK_ERROR_OUT_OF_HOST_MEMORY;
+                    break;
+                }
+
+                memset(pMem, 0, sizeof(InstanceTableBlock));
+
+                Util::AtomicExchangePointer(reinterpret_cast<void* volatile*>(&pBlock->pNext), pMem);
+            }
+
+            pBlock = pBlock->pNext;
+        }
+    }
+
+    if (pSlot != nullptr)
+    {
+        pSlot->pData = pData;
+
+        Util::AtomicExchangePointer(reinterpret_cast<void* volatile*>(&pSlot->instance), pData->instance);
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Removes an instance from the instance table.
+static void RemoveInstanceData(
+    VkInstance instance)
+{
+    Util::MutexAuto lock(&g_instanceTableMutex);
+
+    for (InstanceTableBlock* pBlock = &g_instanceTable; pBlock != nullptr; pBlock = pBlock->pNext)
+    {
+        for (uint32_t i = 0; i < InstanceSlotsPerBlock; i++)
+        {
+            if (pBlock->slots[i].instance == instance)
+            {
+                Util::AtomicExchangePointer(reinterpret_cast<void* volatile*>(&pBlock->slots[i].instance), nullptr);
+
+                pBlock->slots[i].pData = nullptr;
+            }
+        }
+    }
+}
+
+// =====================================================================================================================
+// Reallocates the device cache of an instance so that it holds at least the given number of devices.  The cached
+// devices are dropped.
+static VkResult GrowDeviceCache(
+    LayerInstanceData* pData,
+    uint32_t           deviceCount)
+{
+    VkResult result = VK_SUCCESS;
+
+    if (deviceCount > pData->deviceCapacity)
+    {
+        const uint32_t capacity = Util::Max(deviceCount, 4u);
+
+        void* pMem = AllocLayerMem(capacity * (sizeof(VkPhysicalDeviceProperties) +
+                                               (2 * sizeof(VkPhysicalDevice)) +
+                                               sizeof(uint32_t)));
+
+        FreeLayerMem(pData->pProperties);
+
+        pData->deviceCacheValid = false;
+
+        if (pMem != nullptr)
+        {
+            pData->deviceCapacity   = capacity;
+            pData->pProperties      = static_cast<VkPhysicalDeviceProperties*>(pMem);
+            pData->pDevices         = reinterpret_cast<VkPhysicalDevice*>(pData->pProperties + capacity);
+            pData->pScratchDevices  = pData->pDevices + capacity;
+            pData->pReportedIndices = reinterpret_cast<uint32_t*>(pData->pScratchDevices + capacity);
+        }
+        else
+        {
+            pData->deviceCapacity   = 0;
+            pData->pProperties      = nullptr;
+            pData->pDevices         = nullptr;
+            pData->pScratchDevices  = nullptr;
+            pData->pReportedIndices = nullptr;
+
+            result = VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Selects the devices the layer reports out of the cached devices of the next link by checking hybrid graphics platform
+static void SelectReportedDevices(
+    LayerInstanceData* pData)
+{
+    const VkPhysicalDeviceProperties* pProperties = pData->pProperties;
+    uint32_t                          reportCount = 0;
+
+#if defined(__unix__)
+    bool radvExists = false;
+
+    // Determine whether RADV Vulkan driver exists
+    for (uint32_t i = 0; i < pData->deviceCount; i++)
+    {
+        if (((pProperties[i].vendorID == VENDOR_ID_AMD) || (pProperties[i].vendorID == VENDOR_ID_ATI)) &&
+            (strstr(pProperties[i].deviceName, "RADV") != nullptr))
+        {
+            radvExists = true;
+        }
+    }
+
+    if ((pData->deviceCount > 1) && radvExists)
+    {
+        // Return specified physical devices according to environment variable AMD_VULKAN_ICD
+        const char* pEnv = getenv("AMD_VULKAN_ICD");
+
+        // Environment variable AMD_VULKAN_ICD = RADV indicates apps want to use RADV driver
+        const bool useRadv = (pEnv != nullptr) && (strcmp(pEnv, "RADV") == 0);
+
+        for (uint32_t i = 0; i < pData->deviceCount; i++)
+        {
+            bool report = false;
+
+            if (useRadv)
+            {
+                // Don't report AMD Vulkan driver returned physical devices
+                report = ((pProperties[i].vendorID != VENDOR_ID_AMD) && (pProperties[i].vendorID != VENDOR_ID_ATI)) ||
+                         (strstr(pProperties[i].deviceName, "RADV") != nullptr);
+            }
+            else
+            {
+                // Apps want to use AMD Vulkan driver instead of RADV, don't report RADV&llvmpipe driver returned
+                // physical devices
+                report = (strstr(pProperties[i].deviceName, "RADV") == nullptr) &&
+                         (strstr(pProperties[i].deviceName, "llvmpipe") == nullptr);
+            }
+
+            if (report)
+            {
+                pData->pReportedIndices[reportCount++] = i;
+            }
+        }
+    }
+    else
+#endif
+    {
+        // Report all the physical devices to apps
+        for (uint32_t i = 0; i < pData->deviceCount; i++)
+        {
+            pData->pReportedIndices[reportCount++] = i;
+        }
+    }
+
+    pData->reportedDeviceCount = reportCount;
+}
+
+// =====================================================================================================================
+// Enumerates the physical devices of the next link and rebuilds the device cache of the instance if they differ from
+// the cached ones.  Device properties are only queried when the cache is rebuilt.
+static VkResult UpdateDeviceCache(
+    LayerInstanceData* pData)
+{
+    const NextLinkFuncPointers& nextLinkFuncs = pData->nextLinkFuncs;
+
+    uint32_t deviceCount = pData->deviceCapacity;
+    VkResult result      = VK_INCOMPLETE;
+
+    if (deviceCount > 0)
+    {
+        result = nextLinkFuncs.pfnEnumeratePhysicalDevices(pData->instance, &deviceCount, pData->pScratchDevices);
+    }
+
+    // The devices don't fit into the cache (or this is the first enumeration), grow the cache and enumerate again.
+    // This repeats if devices are added in between.
+    while (result == VK_INCOMPLETE)
+    {
+        deviceCount = 0;
+        result      = nextLinkFuncs.pfnEnumeratePhysicalDevices(pData->instance, &deviceCount, nullptr);
+
+        if (result == VK_SUCCESS)
+        {
+            result = GrowDeviceCache(pData, deviceCount);
+        }
+
+        if (result == VK_SUCCESS)
+        {
+            deviceCount = pData->deviceCapacity;
+            result      = nextLinkFuncs.pfnEnumeratePhysicalDevices(pData->instance,
+                                                                    &deviceCount,
+                                                                    pData->pScratchDevices);
+        }
+    }
+
+    if ((result == VK_SUCCESS) &&
+        ((pData->deviceCacheValid == false) ||
+         (deviceCount != pData->deviceCount) ||
+         (memcmp(pData->pScratchDevices, pData->pDevices, deviceCount * sizeof(VkPhysicalDevice)) != 0)))
+    {
+        memcpy(pData->pDevices, pData->pScratchDevices, deviceCount * sizeof(VkPhysicalDevice));
+
+        pData->deviceCount = deviceCount;
+
+        for (uint32_t i = 0; i < deviceCount; i++)
+        {
+            nextLinkFuncs.pfnGetPhysicalDeviceProperties(pData->pDevices[i], &pData->pProperties[i]);
+        }
+
+        SelectReportedDevices(pData);
+
+        pData->deviceCacheValid = true;
+        pData->generation++;
+    }
+
+    return result;
+}
+
+// =====================================================================================================================
+// Returns true if the given physical device matches one of the devices the layer reports.  Devices are matched by their
+// properties as the members of device groups needn't be the handles vkEnumeratePhysicalDevices returns.
+static bool IsReportedDevice(
+    const LayerInstanceData* pData,
+    VkPhysicalDevice         physicalDevice)
+{
+    VkPhysicalDeviceProperties        properties  = {};
+    const VkPhysicalDeviceProperties* pProperties = nullptr;
+
+    for (uint32_t i = 0; i < pData->deviceCount; i++)
+    {
+        if (pData->pDevices[i] == physicalDevice)
+        {
+            pProperties = &pData->pProperties[i];
+            break;
+        }
+    }
+
+    if (pProperties == nullptr)
+    {
+        pData->nextLinkFuncs.pfnGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        pProperties = &properties;
+    }
+
+    bool reported = false;
+
+    for (uint32_t i = 0; (reported == false) && (i < pData->reportedDeviceCount); i++)
+    {
+        const VkPhysicalDeviceProperties& reportedProperties = pData->pProperties[pData->pReportedIndices[i]];
+
+        reported = (pProperties->vendorID == reportedProperties.vendorID) &&
+                   (pProperties->deviceID == reportedProperties.deviceID) &&
+                   (strcmp(pProperties->deviceName, reportedProperties.deviceName) == 0);
+    }
+
+    return reported;
+}
+
+// =====================================================================================================================
+// Rebuilds the device group cache of the instance if the device cache changed since it was last built.  Must be called
+// after UpdateDeviceCache().
+static VkResult UpdateDeviceGroupCache(
+    LayerInstanceData*           pData,
+    PFN_EnumPhysDeviceGroupsFunc pEnumPhysDeviceGroupsFunc)
+{
+    VkResult result = VK_SUCCESS;
+
+    if (pData->groupGeneration != pData->generation)
+    {
+        // Get real device groups count at first
+        uint32_t groupCount = 0;
+
+        result = pEnumPhysDeviceGroupsFunc(pData->instance, &groupCount, nullptr);
+
+        if ((result == VK_SUCCESS) && (groupCount > pData->groupCapacity))
+        {
+            FreeLayerMem(pData->pGroups);
+
+            pData->pGroups = static_cast<VkPhysicalDeviceGroupProperties*>(
+                AllocLayerMem(groupCount * sizeof(VkPhysicalDeviceGroupProperties)));
+
+            pData->groupCapacity = (pData->pGroups != nullptr) ? groupCount : 0;
+
+            if (pData->pGroups == nullptr)
+            {
+                result = VK_ERROR_OUT_OF_HOST_MEMORY;
+            }
+        }
+
+        // Call loader's terminator function into ICDs to get all the physical device groups
+        if (result == VK_SUCCESS)
+        {
+            for (uint32_t i = 0; i < groupCount; i++)
+            {
+                pData->pGroups[i].sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES;
+                pData->pGroups[i].pNext = nullptr;
+            }
+
+            result = pEnumPhysDeviceGroupsFunc(pData->instance, &groupCount, pData->pGroups);
+        }
+
+        if (result == VK_SUCCESS)
+        {
+            bool processDevices = false;
+
+            if (groupCount > 1)
+            {
+
+#if defined(__unix__)
+                processDevices = true;
+#endif
+            }
+
+            // Only report the device groups whose first physical device is reported
+            uint32_t reportCount = 0;
+
+            for (uint32_t i = 0; i < groupCount; i++)
+            {
+                if ((processDevices == false) || IsReportedDevice(pData, pData->pGroups[i].physicalDevices[0]))
+                {
+                    pData->pGroups[reportCount++] = pData->pGroups[i];
+                }
+            }
+
+            pData->reportedGroupCount = reportCount;
+            pData->groupGeneration    = pData->generation;
+        }
+    }
+
+    return result;
+}
 
 // =====================================================================================================================
 // Implement vkGetInstanceProcAddr for implicit instance layer VK_LAYER_AMD_switchable_graphics, the layer dispatch
@@ -71,10 +500,14 @@ static PFN_vkVoidFunction GetInstanceProcAddrSG(
     // implementation for the layer interface
     if (pFunc == nullptr)
     {
-        g_traceMutex.Lock();
-        NextLinkFuncPointers nextLinkFuncs = *(g_pDispatchTables->FindKey(instance));
-        g_traceMutex.Unlock();
-        pFunc = reinterpret_cast<void*>(nextLinkFuncs.pfnGetInstanceProcAddr(instance, pName));
+        const LayerInstanceData* pData = FindInstanceData(instance);
+
+        VK_ASSERT(pData != nullptr);
+
+        if (pData != nullptr)
+        {
+            pFunc = reinterpret_cast<void*>(pData->nextLinkFuncs.pfnGetInstanceProcAddr(instance, pName));
+        }
     }
 
     return reinterpret_cast<PFN_vkVoidFunction>(pFunc);
@@ -123,44 +556,54 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance_SG(
                 result = pfnCreateInstance(pCreateInfo, pAllocator, pInstance);
                 if (result == VK_SUCCESS)
                 {
-                    Util::MutexAuto lock(&g_traceMutex);
-                    const VkAllocationCallbacks* pAllocCb = &allocator::g_DefaultAllocCallback;
-                    static PalAllocator palAllocater(const_cast<VkAllocationCallbacks*>(pAllocCb));
-                    static DispatchTableHashMap dispatchTables(32, &palAllocater);
-                    g_pDispatchTables = &dispatchTables;
-
-                    // Initialize HashMap once
-                    static bool isInitialized = false;
-                    if (!isInitialized)
+                    void* pMem = AllocLayerMem(sizeof(LayerInstanceData));
+
+                    if (pMem != nullptr)
                     {
-                        g_pDispatchTables->Init();
-                        isInitialized = true;
+                        LayerInstanceData* pData = VK_PLACEMENT_NEW(pMem) LayerInstanceData();
+
+                        pData->instance = *pInstance;
+
+                        // Store the next link's dispatch table function pointers that we need in the layer
+                        NextLinkFuncPointers* pNextLinkFuncs = &pData->nextLinkFuncs;
+
+                        pNextLinkFuncs->pfnGetInstanceProcAddr = pfnGetInstanceProcAddr;
+                        pNextLinkFuncs->pfnCreateInstance = pfnCreateInstance;
+                        pNextLinkFuncs->pfnDestroyInstance =
+                            reinterpret_cast<PFN_vkDestroyInstance>(
+                                pfnGetInstanceProcAddr(*pInstance, "vkDestroyInstance"));
+                        pNextLinkFuncs->pfnEnumeratePhysicalDevices =
+                            reinterpret_cast<PFN_vkEnumeratePhysicalDevices>(
+                                pfnGetInstanceProcAddr(*pInstance, "vkEnumeratePhysicalDevices"));
+                        pNextLinkFuncs->pfnGetPhysicalDeviceProperties =
+                            reinterpret_cast<PFN_vkGetPhysicalDeviceProperties>(
+                                pfnGetInstanceProcAddr(*pInstance, "vkGetPhysicalDeviceProperties"));
+                        pNextLinkFuncs->pfnEnumeratePhysicalDeviceGroups =
+                            reinterpret_cast<PFN_vkEnumeratePhysicalDeviceGroups>(
+                                pfnGetInstanceProcAddr(*pInstance, "vkEnumeratePhysicalDeviceGroups"));
+                        pNextLinkFuncs->pfnEnumeratePhysicalDeviceGroupsKHR =
+                            reinterpret_cast<PFN_vkEnumeratePhysicalDeviceGroupsKHR>(
+                                pfnGetInstanceProcAddr(*pInstance, "vkEnumeratePhysicalDeviceGroupsKHR"));
+
+                        // Store the next link's dispatch table to the instance table
+                        result = AddInstanceData(pData);
+
+                        if (result != VK_SUCCESS)
+                        {
+                            Util::Destructor(pData);
+                            FreeLayerMem(pData);
+                        }
+                    }
+                    else
+                    {
+                        result = VK_ERROR_OUT_OF_HOST_MEMORY;
                     }
 
-                    // Temporary store the next link's dispatch table
-                    NextLinkFuncPointers nextLinkFuncs;
-
-                    // Store the next link's dispatch table function pointers that we need in the layer
-                    nextLinkFuncs.pfnGetInstanceProcAddr = pfnGetInstanceProcAddr;
-                    nextLinkFuncs.pfnCreateInstance = pfnCreateInstance;
-                    nextLinkFuncs.pfnDestroyInstance =
+                    if (result != VK_SUCCESS)
+                    {
                         reinterpret_cast<PFN_vkDestroyInstance>(
-                            pfnGetInstanceProcAddr(*pInstance, "vkDestroyInstance"));
-                    nextLinkFuncs.pfnEnumeratePhysicalDevices =
-                        reinterpret_cast<PFN_vkEnumeratePhysicalDevices>(
-                            pfnGetInstanceProcAddr(*pInstance, "vkEnumeratePhysicalDevices"));
-                    nextLinkFuncs.pfnGetPhysicalDeviceProperties =
-                        reinterpret_cast<PFN_vkGetPhysicalDeviceProperties>(
-                            pfnGetInstanceProcAddr(*pInstance, "vkGetPhysicalDeviceProperties"));
-                    nextLinkFuncs.pfnEnumeratePhysicalDeviceGroups =
-                        reinterpret_cast<PFN_vkEnumeratePhysicalDeviceGroups>(
-                            pfnGetInstanceProcAddr(*pInstance, "vkEnumeratePhysicalDeviceGroups"));
-                    nextLinkFuncs.pfnEnumeratePhysicalDeviceGroupsKHR =
-                        reinterpret_cast<PFN_vkEnumeratePhysicalDeviceGroupsKHR>(
-                            pfnGetInstanceProcAddr(*pInstance, "vkEnumeratePhysicalDeviceGroupsKHR"));
-
-                    // Store the next link's dispatch table to the hashmap
-                    g_pDispatchTables->Insert(*pInstance, nextLinkFuncs);
+                            pfnGetInstanceProcAddr(*pInstance, "vkDestroyInstance"))(*pInstance, pAllocator);
+                    }
                 }
             }
             break;
@@ -177,331 +620,120 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyInstance_SG(
     VkInstance                                  instance,
     const VkAllocationCallbacks*                pAllocator)
 {
-    Util::MutexAuto lock(&g_traceMutex);
-    NextLinkFuncPointers nextLinkFuncs = *g_pDispatchTables->FindKey(instance);
-    nextLinkFuncs.pfnDestroyInstance(instance, pAllocator);
-    g_pDispatchTables->Erase(instance);
+    LayerInstanceData* pData = FindInstanceData(instance);
+
+    VK_ASSERT(pData != nullptr);
+
+    if (pData != nullptr)
+    {
+        pData->nextLinkFuncs.pfnDestroyInstance(instance, pAllocator);
+
+        RemoveInstanceData(instance);
+
+        FreeLayerMem(pData->pProperties);
+        FreeLayerMem(pData->pGroups);
+
+        Util::Destructor(pData);
+        FreeLayerMem(pData);
+    }
 }
 
 // =====================================================================================================================
 // Layer's implementation for vkEnumeratePhysicalDevices, call next link's vkEnumeratePhysicalDevices implementation,
-// then adjust the returned physical devices result by checking hybrid graphics platform and querying Dlist interface
+// then adjust the returned physical devices result by checking hybrid graphics platform and querying Dlist interface.
+// The adjusted result is cached per instance and only recomputed when the next link returns different devices.
 VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDevices_SG(
     VkInstance                                  instance,
     uint32_t*                                   pPhysicalDeviceCount,
     VkPhysicalDevice*                           pPhysicalDevices)
 {
-    g_traceMutex.Lock();
-    NextLinkFuncPointers nextLinkFuncs = *g_pDispatchTables->FindKey(instance);
-    g_traceMutex.Unlock();
-    VkResult result = VK_SUCCESS;
-    const VkAllocationCallbacks* pAllocCb = &allocator::g_DefaultAllocCallback;
-    VK_ASSERT(pAllocCb != nullptr);
+    LayerInstanceData* pData = FindInstanceData(instance);
 
+    VK_ASSERT(pData != nullptr);
     VK_ASSERT(pPhysicalDeviceCount != nullptr);
-    uint32_t physicalDeviceCount = *pPhysicalDeviceCount;
-    VkPhysicalDevice* pLayerPhysicalDevices = nullptr;
 
-    if (pPhysicalDevices != nullptr)
-    {
-        void* pMemory = pAllocCb->pfnAllocation(pAllocCb->pUserData,
-                                                physicalDeviceCount * sizeof(VkPhysicalDevice),
-                                                sizeof(void*),
-                                                VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
-        if (pMemory == nullptr)
-        {
-            result = VK_ERROR_OUT_OF_HOST_MEMORY;
-        }
-        else
-        {
-            pLayerPhysicalDevices = static_cast<VkPhysicalDevice*>(pMemory);
-        }
-    }
-
-    // Call loader's terminator function into ICDs to get all the physical devices
-    if (result == VK_SUCCESS)
-    {
-        result = nextLinkFuncs.pfnEnumeratePhysicalDevices(instance, &physicalDeviceCount, pLayerPhysicalDevices);
-    }
-#if defined(__unix__)
-
-    if (pPhysicalDevices == nullptr)
-    {
-        void* pMemory = pAllocCb->pfnAllocation(pAllocCb->pUserData,
-                                  physicalDeviceCount * sizeof(VkPhysicalDevice),
-                                  sizeof(void*),
-                                  VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
-
-        if (pMemory == nullptr)
-        {
-            result = VK_ERROR_OUT_OF_HOST_MEMORY;
-        }
-        else
-        {
-            pLayerPhysicalDevices = static_cast<VkPhysicalDevice*>(pMemory);
-        }
-
-        result = nextLinkFuncs.pfnEnumeratePhysicalDevices(instance, &physicalDeviceCount, pLayerPhysicalDevices);
-    }
+    VkResult result = VK_ERROR_INITIALIZATION_FAILED;
 
-    if (result == VK_SUCCESS)
+    if (pData != nullptr)
     {
-        bool radvExists = false;
+        Util::MutexAuto lock(&pData->cacheLock);
 
-        // Allocate memory space to place the PhysicalDeviceProperties
-        void* pPropertiesMemory = pAllocCb->pfnAllocation(pAllocCb->pUserData,
-                                  physicalDeviceCount * sizeof(VkPhysicalDeviceProperties),
-                                  sizeof(void*),
-                                  VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
-        VkPhysicalDeviceProperties* pProperties = static_cast<VkPhysicalDeviceProperties*>(pPropertiesMemory);
-
-        if (pProperties == nullptr)
-        {
-            result = VK_ERROR_OUT_OF_HOST_MEMORY;
-        }
-        else
-        {
-            for (uint32_t i = 0; i < physicalDeviceCount; i++)
-            {
-                // Determine whether RADV Vulkan driver exists and get all physical device properites
-                nextLinkFuncs.pfnGetPhysicalDeviceProperties(pLayerPhysicalDevices[i], &pProperties[i]);
-                if (((pProperties[i].vendorID == VENDOR_ID_AMD) || (pProperties[i].vendorID == VENDOR_ID_ATI)) &&
-                   (strstr(pProperties[i].deviceName, "RADV") != nullptr))
-                {
-                    radvExists = true;
-                }
-            }
-        }
+        result = UpdateDeviceCache(pData);
 
         if (result == VK_SUCCESS)
         {
-            if ((physicalDeviceCount > 1) && radvExists)
+            if (pPhysicalDevices == nullptr)
             {
-                // Return specified physical devices according to environment variable AMD_VULKAN_ICD
-                const char* pEnv = getenv("AMD_VULKAN_ICD");
-                size_t reportPhysicalDeviceCount = 0;
-
-                if ((pEnv != nullptr) && (strcmp(pEnv, "RADV") == 0))
-                {
-                    // Environment variable AMD_VULKAN_ICD = RADV indicates apps want to use RADV driver
-                    // So only reports RADV returned physical devices
-                    for (uint32_t i = 0; i < physicalDeviceCount; i++)
-                    {
-                        // Don't report AMD Vulkan driver returned physical devices
-                        if (((pProperties[i].vendorID != VENDOR_ID_AMD) && (pProperties[i].vendorID != VENDOR_ID_ATI)) ||
-                            (strstr(pProperties[i].deviceName, "RADV") != nullptr))
-                        {
-                            if (pPhysicalDevices != nullptr)
-                            {
-                                pPhysicalDevices[reportPhysicalDeviceCount] = pLayerPhysicalDevices[i];
-                            }
-                            reportPhysicalDeviceCount++;
-                        }
-                    }
-                }
-                else
-                {
-                    // In this case, apps want to use AMD Vulkan driver instead of RADV
-                    for (uint32_t i = 0; i < physicalDeviceCount; i++)
-                    {
-                        // Don't report RADV&llvmpipe driver returned physical devices
-                        if ((strstr(pProperties[i].deviceName, "RADV") == nullptr) &&
-                            (strstr(pProperties[i].deviceName, "llvmpipe") == nullptr))
-                        {
-                            if (pPhysicalDevices != nullptr)
-                            {
-                                pPhysicalDevices[reportPhysicalDeviceCount] = pLayerPhysicalDevices[i];
-                            }
-                            reportPhysicalDeviceCount++;
-                        }
-                    }
-                }
-                // Modify the PhysicalDeviceCount
-                *pPhysicalDeviceCount = reportPhysicalDeviceCount;
+                *pPhysicalDeviceCount = pData->reportedDeviceCount;
             }
             else
             {
-                // Return all the physical devices to apps
-                if (pPhysicalDevices != nullptr)
+                const uint32_t deviceCount = Util::Min(*pPhysicalDeviceCount, pData->reportedDeviceCount);
+
+                for (uint32_t i = 0; i < deviceCount; i++)
                 {
-                    for (uint32_t i = 0; i < physicalDeviceCount; i++)
-                    {
-                        pPhysicalDevices[i] = pLayerPhysicalDevices[i];
-                    }
+                    pPhysicalDevices[i] = pData->pDevices[pData->pReportedIndices[i]];
                 }
-                *pPhysicalDeviceCount = physicalDeviceCount;
-            }
-        }
 
-        if (pProperties != nullptr)
-        {
-            // Free previous allocated PhysicalDeviceProperties memory
-            pAllocCb->pfnFree(pAllocCb->pUserData, pProperties);
+                *pPhysicalDeviceCount = deviceCount;
+
+                result = (deviceCount < pData->reportedDeviceCount) ? VK_INCOMPLETE : VK_SUCCESS;
+            }
         }
     }
-#endif
-    if (pLayerPhysicalDevices != nullptr)
-    {
-        pAllocCb->pfnFree(pAllocCb->pUserData, pLayerPhysicalDevices);
-    }
 
     return result;
 }
 
 // =====================================================================================================================
-// General part for both vkEnumeratePhysicalDeviceGroups_SG and vkEnumeratePhysicalDeviceGroupsKHR_SG
+// General part for both vkEnumeratePhysicalDeviceGroups_SG and vkEnumeratePhysicalDeviceGroupsKHR_SG.  The device
+// groups are filtered against the cached physical devices and cached alongside them.
 static VkResult vkEnumeratePhysicalDeviceGroupsComm(
-    VkInstance                                  instance,
+    LayerInstanceData*                          pData,
     uint32_t*                                   pPhysicalDeviceGroupCount,
     VkPhysicalDeviceGroupProperties*            pPhysicalDeviceGroupProperties,
     PFN_EnumPhysDeviceGroupsFunc                pEnumPhysDeviceGroupsFunc)
 {
-    g_traceMutex.Lock();
-    NextLinkFuncPointers nextLinkFuncs = *g_pDispatchTables->FindKey(instance);
-    g_traceMutex.Unlock();
-    VkResult result = VK_SUCCESS;
-    const VkAllocationCallbacks* pAllocCb = &allocator::g_DefaultAllocCallback;
-    VK_ASSERT(pAllocCb != nullptr);
-
     VK_ASSERT(pPhysicalDeviceGroupCount != nullptr);
-    uint32_t physicalDeviceGroupCount = *pPhysicalDeviceGroupCount;
-    VkPhysicalDeviceGroupProperties* pLayerPhysicalDeviceGroups = nullptr;
 
-    // Get real device groups count at first
-    result = pEnumPhysDeviceGroupsFunc(instance, &physicalDeviceGroupCount, nullptr);
+    Util::MutexAuto lock(&pData->cacheLock);
 
-    if (result == VK_SUCCESS)
-    {
-        void* pMemory = pAllocCb->pfnAllocation(pAllocCb->pUserData,
-                                                physicalDeviceGroupCount * sizeof(VkPhysicalDeviceGroupProperties),
-                                                sizeof(void*),
-                                                VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
-        if (pMemory == nullptr)
-        {
-            result = VK_ERROR_OUT_OF_HOST_MEMORY;
-        }
-        else
-        {
-            pLayerPhysicalDeviceGroups = static_cast<VkPhysicalDeviceGroupProperties*>(pMemory);
-        }
-    }
+    VkResult result = UpdateDeviceCache(pData);
 
-    // Call loader's terminator function into ICDs to get all the physical device groups
     if (result == VK_SUCCESS)
     {
-        for (uint32_t i = 0; i < physicalDeviceGroupCount; i++)
-        {
-            pLayerPhysicalDeviceGroups[i].sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES;
-            pLayerPhysicalDeviceGroups[i].pNext = nullptr;
-        }
-
-        result = pEnumPhysDeviceGroupsFunc(instance, &physicalDeviceGroupCount, pLayerPhysicalDeviceGroups);
+        result = UpdateDeviceGroupCache(pData, pEnumPhysDeviceGroupsFunc);
     }
 
     if (result == VK_SUCCESS)
     {
-        bool processDevices = false;
-
-        if (physicalDeviceGroupCount > 1)
+        if (pPhysicalDeviceGroupProperties == nullptr)
         {
-
-#if defined(__unix__)
-            processDevices = true;
-#endif
+            *pPhysicalDeviceGroupCount = pData->reportedGroupCount;
         }
-
-        if (processDevices)
+        else
         {
-            uint32_t physicalDeviceCount = 0;
-            nextLinkFuncs.pfnEnumeratePhysicalDevices(instance, &physicalDeviceCount, nullptr);
-            void* pTmpLayerPhysicalDeviceMemory = pAllocCb->pfnAllocation(pAllocCb->pUserData,
-                                                        physicalDeviceCount * sizeof(VkPhysicalDevice),
-                                                        sizeof(void*),
-                                                        VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
-            void* pPropertiesMemory = pAllocCb->pfnAllocation(pAllocCb->pUserData,
-                                                    physicalDeviceCount * sizeof(VkPhysicalDeviceProperties),
-                                                    sizeof(void*),
-                                                    VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
-            VkPhysicalDevice* pTmpLayerPhysicalDevice = static_cast<VkPhysicalDevice*>(pTmpLayerPhysicalDeviceMemory);
-            VkPhysicalDeviceProperties* pProperties = static_cast<VkPhysicalDeviceProperties*>(pPropertiesMemory);
-
-            if ((pTmpLayerPhysicalDevice == nullptr) || (pProperties == nullptr))
-            {
-                result = VK_ERROR_OUT_OF_HOST_MEMORY;
-            }
-            else
-            {
-                // Call vkEnumeratePhysicalDevices_SG to get all valid physical devices, store all valid
-                // physical device properies in pProperties
-                result = vkEnumeratePhysicalDevices_SG(instance, &physicalDeviceCount, pTmpLayerPhysicalDevice);
-                if (result == VK_SUCCESS)
-                {
-                    for (uint32_t i = 0; i < physicalDeviceCount; i++)
-                    {
-                       nextLinkFuncs.pfnGetPhysicalDeviceProperties(pTmpLayerPhysicalDevice[i], &pProperties[i]);
-                    }
-                }
-            }
+            const uint32_t groupCount = Util::Min(*pPhysicalDeviceGroupCount, pData->reportedGroupCount);
 
-            if (result == VK_SUCCESS)
+            // Leave sType and pNext of the application's structures alone
+            for (uint32_t i = 0; i < groupCount; i++)
             {
-                uint32_t deviceGroupCount = 0;
+                const VkPhysicalDeviceGroupProperties& group = pData->pGroups[i];
 
-                // Check the physical devices in device group, only report the device groups which contains valid
-                // physical devices
-                for (uint32_t i = 0; i < physicalDeviceGroupCount; i++)
-                {
-                    VkPhysicalDeviceProperties properties = {};
-                    nextLinkFuncs.pfnGetPhysicalDeviceProperties(
-                            pLayerPhysicalDeviceGroups[i].physicalDevices[0], &properties);
-                    for (uint32_t j = 0; j < physicalDeviceCount; j++)
-                    {
-                        if ((properties.vendorID == pProperties[j].vendorID) &&
-                            (properties.deviceID == pProperties[j].deviceID) &&
-                            (strcmp(properties.deviceName, pProperties[j].deviceName) == 0))
-                        {
-                            if (pPhysicalDeviceGroupProperties != nullptr)
-                            {
-                                pPhysicalDeviceGroupProperties[deviceGroupCount] = pLayerPhysicalDeviceGroups[i];
-                            }
+                pPhysicalDeviceGroupProperties[i].physicalDeviceCount = group.physicalDeviceCount;
+                pPhysicalDeviceGroupProperties[i].subsetAllocation    = group.subsetAllocation;
 
-                            deviceGroupCount++;
-                            break;
-                        }
-                    }
-                }
-
-                *pPhysicalDeviceGroupCount = deviceGroupCount;
+                memcpy(pPhysicalDeviceGroupProperties[i].physicalDevices,
+                       group.physicalDevices,
+                       sizeof(group.physicalDevices));
             }
 
-            if (pTmpLayerPhysicalDevice != nullptr)
-            {
-                pAllocCb->pfnFree(pAllocCb->pUserData, pTmpLayerPhysicalDevice);
-            }
+            *pPhysicalDeviceGroupCount = groupCount;
 
-            if (pProperties != nullptr)
-            {
-                pAllocCb->pfnFree(pAllocCb->pUserData, pProperties);
-            }
-        }
-        else
-        {
-            *pPhysicalDeviceGroupCount = physicalDeviceGroupCount;
-            if (pPhysicalDeviceGroupProperties != nullptr)
-            {
-                for (uint32_t i = 0; i < physicalDeviceGroupCount; i++)
-                {
-                    pPhysicalDeviceGroupProperties[i] = pLayerPhysicalDeviceGroups[i];
-                }
-            }
+            result = (groupCount < pData->reportedGroupCount) ? VK_INCOMPLETE : VK_SUCCESS;
         }
     }
 
-    if (pLayerPhysicalDeviceGroups != nullptr)
-    {
-        pAllocCb->pfnFree(pAllocCb->pUserData, pLayerPhysicalDeviceGroups);
-    }
-
     return result;
 }
 
@@ -513,13 +745,20 @@ VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDeviceGroupsKHR_SG(
     uint32_t*                                   pPhysicalDeviceGroupCount,
     VkPhysicalDeviceGroupProperties*            pPhysicalDeviceGroupProperties)
 {
-    g_traceMutex.Lock();
-    PFN_EnumPhysDeviceGroupsFunc pEnumPhysDeviceGroupsFunc = (*(g_pDispatchTables->FindKey(instance))).pfnEnumeratePhysicalDeviceGroupsKHR;
-    g_traceMutex.Unlock();
-    return vkEnumeratePhysicalDeviceGroupsComm(instance,
-                                               pPhysicalDeviceGroupCount,
-                                               pPhysicalDeviceGroupProperties,
-                                               pEnumPhysDeviceGroupsFunc);
+    LayerInstanceData* pData  = FindInstanceData(instance);
+    VkResult           result = VK_ERROR_INITIALIZATION_FAILED;
+
+    VK_ASSERT(pData != nullptr);
+
+    if (pData != nullptr)
+    {
+        result = vkEnumeratePhysicalDeviceGroupsComm(pData,
+                                                     pPhysicalDeviceGroupCount,
+                                                     pPhysicalDeviceGroupProperties,
+                                                     pData->nextLinkFuncs.pfnEnumeratePhysicalDeviceGroupsKHR);
+    }
+
+    return result;
 }
 
 // =====================================================================================================================
@@ -530,13 +769,20 @@ VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDeviceGroups_SG(
     uint32_t*                                   pPhysicalDeviceGroupCount,
     VkPhysicalDeviceGroupProperties*            pPhysicalDeviceGroupProperties)
 {
-    g_traceMutex.Lock();
-    PFN_EnumPhysDeviceGroupsFunc pEnumPhysDeviceGroupsFunc = (*(g_pDispatchTables->FindKey(instance))).pfnEnumeratePhysicalDeviceGroups;
-    g_traceMutex.Unlock();
-    return vkEnumeratePhysicalDeviceGroupsComm(instance,
-                                               pPhysicalDeviceGroupCount,
-                                               pPhysicalDeviceGroupProperties,
-                                               pEnumPhysDeviceGroupsFunc);
+    LayerInstanceData* pData  = FindInstanceData(instance);
+    VkResult           result = VK_ERROR_INITIALIZATION_FAILED;
+
+    VK_ASSERT(pData != nullptr);
+
+    if (pData != nullptr)
+    {
+        result = vkEnumeratePhysicalDeviceGroupsComm(pData,
+                                                     pPhysicalDeviceGroupCount,
+                                                     pPhysicalDeviceGroupProperties,
+                                                     pData->nextLinkFuncs.pfnEnumeratePhysicalDeviceGroups);
+    }
+
+    return result;
 }
 
 // Helper macro used to create an entry for the "primary" entry point implementation (i.e. the one that goes straight
@@ -956,6 +956,12 @@ void VulkanSettingsLoader::ValidateSettings()
         m_settings.prefetchCommands = false;
     }
 
+    // Breadcrumbs are read back from the marker destinations, which are found through the GPU address map.
+    if (m_settings.breadcrumbRingEntries > 0)
+    {
+        m_settings.enableGpuAddressMap = true;
+    }
+
 }
 
 // =====================================================================================================================